@@ -0,0 +1,137 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 Project AERO.
+ */
+
+/**
+ * @file strategy_plugin.cpp
+ * @brief Example strategy plugin built on aero/strategy.h
+ *
+ * Usage: STRATEGY_PLUGIN=./libspread_monitor.so STRATEGY_ARGS=<bps>
+ *
+ * Tracks the top of book of every symbol and, once a second, logs the
+ * spread and the number of BBO changes per symbol, plus the depth behind
+ * the best levels when the gateway runs with a book mirror. Logs a line
+ * whenever a spread widens past <bps> basis points (default 10). Sends no
+ * orders.
+ */
+
+#include "aero/strategy.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+struct SymbolState {
+  aero_strategy_quote quote{};
+  uint64_t bbo_changes = 0;
+  bool wide = false;
+};
+
+struct SpreadMonitor {
+  const aero_strategy_host *host;
+  double alert_bps = 10.0;
+  uint64_t report_tsc = 0;
+  uint64_t next_report = 0;
+  std::vector<SymbolState> symbols; // By symbol id
+  std::vector<uint8_t> slot;        // Book mirror copy
+};
+
+double spread_bps(const aero_strategy_quote &q) {
+  if (q.bid_price == 0 || q.ask_price <= q.bid_price)
+    return 0.0;
+  double mid = (q.bid_price + q.ask_price) / 2.0;
+  return (q.ask_price - q.bid_price) / mid * 1e4;
+}
+
+void log_line(SpreadMonitor *m, uint32_t id, const char *fmt, double a,
+              double b) {
+  char name[64];
+  uint8_t exchange_id = 0;
+  if (m->host->symbol_name(m->host->ctx, id, &exchange_id, name,
+                           sizeof(name)) != 0)
+    std::snprintf(name, sizeof(name), "#%u", id);
+  char line[256];
+  int n = std::snprintf(line, sizeof(line), "%u:%s ", exchange_id, name);
+  std::snprintf(line + n, sizeof(line) - n, fmt, a, b);
+  m->host->log(m->host->ctx, line);
+}
+
+// Quantity resting in the top levels of both sides, from the book mirror
+bool mirror_depth(SpreadMonitor *m, uint32_t id, double &bid_qty,
+                  double &ask_qty) {
+  const aero_book_mirror_reader *r = m->host->book_mirror;
+  if (!r)
+    return false;
+  m->slot.resize(r->hdr->slot_size);
+  if (aero_book_mirror_read(r, id, m->slot.data(), 100) != 0)
+    return false;
+  auto *b = reinterpret_cast<const aero_book_mirror_book *>(m->slot.data());
+  const aero_book_mirror_level *bids = aero_book_mirror_bids(b);
+  const aero_book_mirror_level *asks = aero_book_mirror_asks(b, r->hdr->depth);
+  bid_qty = ask_qty = 0.0;
+  for (uint32_t i = 0; i < b->bid_count; i++)
+    bid_qty += bids[i].qty / 1e8;
+  for (uint32_t i = 0; i < b->ask_count; i++)
+    ask_qty += asks[i].qty / 1e8;
+  return true;
+}
+
+void on_bbo(void *state, const aero_strategy_bbo *ev) {
+  auto *m = static_cast<SpreadMonitor *>(state);
+  if (ev->symbol_id >= m->symbols.size())
+    m->symbols.resize(ev->symbol_id + 1);
+  SymbolState &s = m->symbols[ev->symbol_id];
+  s.quote = ev->quote;
+  s.bbo_changes++;
+
+  double bps = spread_bps(ev->quote);
+  bool wide = bps > m->alert_bps;
+  if (wide && !s.wide)
+    log_line(m, ev->symbol_id, "spread %.2f bps (was %.2f)", bps,
+             spread_bps(ev->prev));
+  s.wide = wide;
+}
+
+void on_idle(void *state, uint64_t now_tsc) {
+  auto *m = static_cast<SpreadMonitor *>(state);
+  if (now_tsc < m->next_report)
+    return;
+  m->next_report = now_tsc + m->report_tsc;
+
+  for (uint32_t id = 0; id < m->symbols.size(); id++) {
+    SymbolState &s = m->symbols[id];
+    if (s.bbo_changes == 0)
+      continue;
+    double bid_qty, ask_qty;
+    if (mirror_depth(m, id, bid_qty, ask_qty))
+      log_line(m, id, "depth bid=%.4f ask=%.4f", bid_qty, ask_qty);
+    log_line(m, id, "spread %.2f bps, %.0f BBO changes/s", spread_bps(s.quote),
+             static_cast<double>(s.bbo_changes));
+    s.bbo_changes = 0;
+  }
+}
+
+void on_stop(void *state) { delete static_cast<SpreadMonitor *>(state); }
+
+} // namespace
+
+extern "C" int aero_strategy_init(const aero_strategy_host *host,
+                                  aero_strategy_plugin *plugin) {
+  if (host->abi_version != AERO_STRATEGY_ABI_VERSION)
+    return -1;
+
+  auto *m = new SpreadMonitor;
+  m->host = host;
+  if (host->args[0] != '\0')
+    m->alert_bps = std::atof(host->args);
+  m->report_tsc = host->tsc_hz;
+
+  plugin->abi_version = AERO_STRATEGY_ABI_VERSION;
+  plugin->name = "spread_monitor";
+  plugin->state = m;
+  plugin->on_bbo = on_bbo;
+  plugin->on_idle = on_idle;
+  plugin->on_stop = on_stop;
+  return 0;
+}
@@ -0,0 +1,105 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 Project AERO.
+ */
+
+/**
+ * @file udp_receiver.cpp
+ * @brief Example UDP feed consumer built on aero/feed_receiver.h
+ *
+ * Usage: udp_receiver [address] [port] [channels] [iface]
+ *
+ * Busy-polls the feed, keeps every book and prints once a second the BBO
+ * of each book, sequence gaps and gateway-to-consumer latency. For a
+ * multicast feed with several channels, channel i is joined as
+ * address + i on the same port.
+ */
+
+#include "aero/feed_receiver.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static volatile std::sig_atomic_t running = 1;
+
+static void on_signal(int) { running = 0; }
+
+static std::string add_to_address(const std::string &address, uint32_t n) {
+  in_addr addr{};
+  inet_pton(AF_INET, address.c_str(), &addr);
+  addr.s_addr = htonl(ntohl(addr.s_addr) + n);
+  char buf[INET_ADDRSTRLEN];
+  inet_ntop(AF_INET, &addr, buf, sizeof(buf));
+  return buf;
+}
+
+int main(int argc, char **argv) {
+  std::string address = argc > 1 ? argv[1] : "127.0.0.1";
+  uint16_t port = static_cast<uint16_t>(argc > 2 ? std::atoi(argv[2]) : 13988);
+  int channels = argc > 3 ? std::atoi(argv[3]) : 1;
+  std::string iface = argc > 4 ? argv[4] : "";
+
+  aero::FeedReceiver rx;
+  if (!rx.open(address, port, iface)) {
+    std::fprintf(stderr, "open %s:%u: %s\n", address.c_str(), port,
+                 rx.last_error());
+    return 1;
+  }
+  in_addr addr{};
+  inet_pton(AF_INET, address.c_str(), &addr);
+  if (IN_MULTICAST(ntohl(addr.s_addr))) {
+    for (int i = 1; i < channels; i++) {
+      if (!rx.join(add_to_address(address, static_cast<uint32_t>(i)))) {
+        std::fprintf(stderr, "join: %s\n", rx.last_error());
+        return 1;
+      }
+    }
+  }
+  std::printf("Listening on %s:%u (%d channel(s))\n", address.c_str(), port,
+              channels);
+
+  std::signal(SIGINT, on_signal);
+  std::signal(SIGTERM, on_signal);
+
+  uint64_t updates = 0;
+  auto next_report = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (running) {
+    rx.poll([&updates](const aero::FeedBook &, const aero::FeedDatagram &) {
+      updates++;
+    });
+
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_report)
+      continue;
+    next_report = now + std::chrono::seconds(1);
+
+    rx.for_each_book([](const aero::FeedBook &book) {
+      if (book.bids().empty() || book.asks().empty())
+        return;
+      const auto &bid = book.bids()[0];
+      const auto &ask = book.asks()[0];
+      std::printf("  %-16s ex=%u %.8g x %.8g | %.8g x %.8g%s\n",
+                  book.symbol().c_str(), book.exchange_id(),
+                  bid.price_int / 1e8, bid.qty, ask.price_int / 1e8, ask.qty,
+                  book.stale() ? " (stale)" : "");
+    });
+
+    const aero::FeedReceiverStats &s = rx.stats();
+    aero::FeedLatencyStats &lat = rx.latency();
+    std::printf("updates=%lu datagrams=%lu syscalls=%lu gaps=%lu lost=%lu "
+                "dup=%lu reordered=%lu recovered=%lu parity=%lu "
+                "malformed=%lu\n",
+                updates, s.datagrams, s.syscalls, s.gaps, s.lost,
+                s.duplicates, s.reordered, s.recovered, s.parity,
+                s.malformed);
+    std::printf("latency us: p50=%.1f p99=%.1f p99.9=%.1f max=%.1f "
+                "(n=%lu, negative=%lu)\n",
+                lat.percentile_ns(0.50) / 1e3, lat.percentile_ns(0.99) / 1e3,
+                lat.percentile_ns(0.999) / 1e3, lat.max_ns() / 1e3,
+                lat.count(), lat.negative());
+    lat.reset();
+  }
+  return 0;
+}
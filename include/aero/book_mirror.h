@@ -0,0 +1,243 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 Project AERO.
+ */
+
+/**
+ * @file book_mirror.h
+ * @brief Shared-memory mirror of the gateway's order books (C and C++)
+ *
+ * The gateway keeps the top `depth` levels of every book in a file under
+ * /dev/shm. Other processes map it read-only and sample any book at any
+ * time, without subscribing to the feed. scripts/tools/book_mirror.py reads
+ * the same layout with numpy.
+ *
+ * File layout (all little-endian):
+ *   aero_book_mirror_header                     (4096 bytes)
+ *   aero_book_mirror_symbol x symbol_capacity   (directory, index = id)
+ *   book slot x symbol_capacity                 (slot_size bytes each)
+ *
+ * Book slot:
+ *   aero_book_mirror_book
+ *   aero_book_mirror_level bids[depth]   (best first)
+ *   aero_book_mirror_level asks[depth]   (best first)
+ *
+ * A slot is guarded by a seqlock: `seq` is odd while the gateway rewrites
+ * it. Copy the slot, then accept the copy only if seq was even and
+ * unchanged. Symbol ids match the other feeds (aero/shm_bus.h, compact UDP).
+ * Prices are in 1e8 units, quantities fixed-point 1e8.
+ *
+ * Minimal reader:
+ *
+ *   aero_book_mirror_reader r;
+ *   if (aero_book_mirror_open(&r, "/dev/shm/aero_book_mirror") == 0) {
+ *     int64_t id = aero_book_mirror_find(&r, 0, "BTC-USDT");
+ *     uint8_t buf[r.hdr->slot_size];
+ *     if (id >= 0 && aero_book_mirror_read(&r, id, buf, 100) == 0) {
+ *       const aero_book_mirror_book *b = (const aero_book_mirror_book *)buf;
+ *       const aero_book_mirror_level *bids = aero_book_mirror_bids(b);
+ *     }
+ *   }
+ */
+
+#ifndef AERO_BOOK_MIRROR_H
+#define AERO_BOOK_MIRROR_H
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AERO_BOOK_MIRROR_MAGIC 0x314D4B424F524541ULL /* "AEROBKM1" */
+#define AERO_BOOK_MIRROR_VERSION 1
+#define AERO_BOOK_MIRROR_HEADER_SIZE 4096
+
+/* aero_book_mirror_book.flags: levels were skipped under load, so depth
+ * may be missing or stale until the exchange's resync snapshot arrives */
+#define AERO_BOOK_MIRROR_DEGRADED 0x1u
+/* aero_book_mirror_book.flags: the best levels are a quote from the venue's
+ * top-of-book channel, newer than the depth behind them; levels the quote
+ * crossed were left out. Cleared by the next depth update. */
+#define AERO_BOOK_MIRROR_BBO 0x2u
+
+typedef struct {
+  uint64_t magic; /* Written last when the gateway finishes setup */
+  uint32_t version;
+  uint32_t depth;           /* Levels kept per side */
+  uint32_t symbol_capacity; /* Directory entries and book slots */
+  uint32_t slot_size;       /* Bytes per book slot, multiple of 64 */
+  uint64_t directory_offset;
+  uint64_t books_offset;
+  uint64_t session_ns;   /* Gateway start time (CLOCK_REALTIME) */
+  uint32_t symbol_count; /* Directory entries in use (release) */
+  uint32_t producer_pid;
+} aero_book_mirror_header;
+
+typedef struct {
+  uint32_t valid; /* Set to 1 (release) once the entry is filled */
+  uint8_t exchange_id;
+  uint8_t reserved[3];
+  char name[56]; /* NUL-terminated */
+} aero_book_mirror_symbol;
+
+typedef struct {
+  uint64_t seq; /* Seqlock: odd while being written */
+  uint64_t update_count;
+  uint64_t exchange_ts_ns; /* Exchange time of the last applied update */
+  uint64_t rx_tsc;         /* Gateway TSC of the last applied update */
+  uint64_t update_ns;      /* Gateway wall time of the last write */
+  uint32_t bid_count;
+  uint32_t ask_count;
+  uint32_t flags; /* AERO_BOOK_MIRROR_DEGRADED | AERO_BOOK_MIRROR_BBO */
+  uint32_t reserved0;
+  uint64_t reserved1;
+} aero_book_mirror_book;
+
+typedef struct {
+  uint64_t price;
+  uint64_t qty;
+} aero_book_mirror_level;
+
+/* ------------------------------------------------------------------------ */
+/* Reader                                                                   */
+/* ------------------------------------------------------------------------ */
+
+typedef struct {
+  const uint8_t *base;
+  size_t map_size;
+  const aero_book_mirror_header *hdr;
+  const aero_book_mirror_symbol *directory;
+  const uint8_t *books;
+  ino_t inode;
+} aero_book_mirror_reader;
+
+/**
+ * Map the mirror read-only.
+ * Returns 0 on success, -1 if the file is missing or not (yet) a valid mirror.
+ */
+static inline int aero_book_mirror_open(aero_book_mirror_reader *r,
+                                        const char *path) {
+  memset(r, 0, sizeof(*r));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || (size_t)st.st_size < AERO_BOOK_MIRROR_HEADER_SIZE) {
+    close(fd);
+    return -1;
+  }
+  void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED)
+    return -1;
+
+  r->base = (const uint8_t *)p;
+  r->map_size = (size_t)st.st_size;
+  r->hdr = (const aero_book_mirror_header *)p;
+  r->inode = st.st_ino;
+
+  if (__atomic_load_n(&r->hdr->magic, __ATOMIC_ACQUIRE) !=
+          AERO_BOOK_MIRROR_MAGIC ||
+      r->hdr->version != AERO_BOOK_MIRROR_VERSION ||
+      r->hdr->books_offset +
+              (uint64_t)r->hdr->symbol_capacity * r->hdr->slot_size >
+          r->map_size) {
+    munmap(p, r->map_size);
+    memset(r, 0, sizeof(*r));
+    return -1;
+  }
+
+  r->directory =
+      (const aero_book_mirror_symbol *)(r->base + r->hdr->directory_offset);
+  r->books = r->base + r->hdr->books_offset;
+  return 0;
+}
+
+static inline void aero_book_mirror_close(aero_book_mirror_reader *r) {
+  if (r->base)
+    munmap((void *)r->base, r->map_size);
+  memset(r, 0, sizeof(*r));
+}
+
+/**
+ * Symbol behind an id, or NULL if the gateway has not seen it yet.
+ */
+static inline const aero_book_mirror_symbol *
+aero_book_mirror_symbol_at(const aero_book_mirror_reader *r, uint32_t id) {
+  if (id >= r->hdr->symbol_capacity)
+    return NULL;
+  const aero_book_mirror_symbol *s = &r->directory[id];
+  return __atomic_load_n(&s->valid, __ATOMIC_ACQUIRE) ? s : NULL;
+}
+
+/**
+ * Id of (exchange_id, name), or -1 if it is not in the directory.
+ * Linear scan: resolve once and keep the id.
+ */
+static inline int64_t aero_book_mirror_find(const aero_book_mirror_reader *r,
+                                            uint8_t exchange_id,
+                                            const char *name) {
+  uint32_t n = __atomic_load_n(&r->hdr->symbol_count, __ATOMIC_ACQUIRE);
+  for (uint32_t id = 0; id < n && id < r->hdr->symbol_capacity; id++) {
+    const aero_book_mirror_symbol *s = aero_book_mirror_symbol_at(r, id);
+    if (s && s->exchange_id == exchange_id && strcmp(s->name, name) == 0)
+      return id;
+  }
+  return -1;
+}
+
+/**
+ * Consistent copy of one book slot into out (hdr->slot_size bytes). The
+ * copy starts with aero_book_mirror_book; the levels follow it.
+ * Returns 0 on success, -1 if the id is out of range or the slot kept
+ * changing for max_tries attempts.
+ */
+static inline int aero_book_mirror_read(const aero_book_mirror_reader *r,
+                                        uint32_t id, void *out, int max_tries) {
+  if (id >= r->hdr->symbol_capacity)
+    return -1;
+  const uint8_t *slot = r->books + (uint64_t)id * r->hdr->slot_size;
+  const uint64_t *seq = (const uint64_t *)slot;
+  for (int i = 0; i < max_tries; i++) {
+    uint64_t s1 = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+    if (s1 & 1)
+      continue;
+    memcpy(out, slot, r->hdr->slot_size);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(seq, __ATOMIC_RELAXED) == s1)
+      return 0;
+  }
+  return -1;
+}
+
+static inline const aero_book_mirror_level *
+aero_book_mirror_bids(const aero_book_mirror_book *b) {
+  return (const aero_book_mirror_level *)(b + 1);
+}
+
+static inline const aero_book_mirror_level *
+aero_book_mirror_asks(const aero_book_mirror_book *b, uint32_t depth) {
+  return (const aero_book_mirror_level *)(b + 1) + depth;
+}
+
+/**
+ * Non-zero if the gateway restarted and replaced the file; reopen then.
+ */
+static inline int aero_book_mirror_stale(const aero_book_mirror_reader *r,
+                                         const char *path) {
+  struct stat st;
+  return stat(path, &st) < 0 || st.st_ino != r->inode;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AERO_BOOK_MIRROR_H */
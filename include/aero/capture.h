@@ -0,0 +1,176 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 Project AERO.
+ */
+
+/**
+ * @file capture.h
+ * @brief Raw WebSocket capture files: layout and sequential reader (C and C++)
+ *
+ * The gateway can record every text frame its exchange connections
+ * receive, exactly as received, into a series of segment files. Segments
+ * are preallocated and memory-mapped by the writer and rolled by size or
+ * age; names sort in write order, so replaying a session is reading its
+ * segments one after the other.
+ *
+ * File layout:
+ *   aero_cap_header                     (4096 bytes)
+ *   record, record, ...                 (8-byte aligned)
+ *   zero fill up to the preallocated size (live segments only)
+ *
+ * Each record is an aero_cap_record followed by `length` payload bytes and
+ * padding to the next multiple of 8. The writer stores a record's `length`
+ * last (release), so a zero length word marks the end of the data, also
+ * while the segment is still being written. A closed segment is truncated
+ * to its data and has AERO_CAP_FLAG_CLOSED set.
+ *
+ * Every segment starts with one AERO_CAP_CONNECTION record per known
+ * connection (payload: the endpoint), so a segment can be replayed on its
+ * own.
+ *
+ * Minimal reader:
+ *
+ *   aero_cap_reader r;
+ *   if (aero_cap_reader_open(&r, path) == 0) {
+ *     const aero_cap_record *rec;
+ *     while ((rec = aero_cap_reader_next(&r)) != NULL)
+ *       handle(rec, aero_cap_record_payload(rec));
+ *     aero_cap_reader_close(&r);
+ *   }
+ */
+
+#ifndef AERO_CAPTURE_H
+#define AERO_CAPTURE_H
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AERO_CAP_MAGIC 0x315041434F524541ULL /* "AEROCAP1" */
+#define AERO_CAP_VERSION 1
+#define AERO_CAP_HEADER_SIZE 4096
+#define AERO_CAP_ALIGN 8
+
+/* aero_cap_header::flags */
+#define AERO_CAP_FLAG_CLOSED 0x01 /* Finished and truncated to data_size */
+
+/* aero_cap_record::type */
+#define AERO_CAP_FRAME 1      /* WebSocket text frame */
+#define AERO_CAP_CONNECTION 2 /* Connection id -> endpoint ("host:port/path") */
+
+typedef struct {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t flags; /* AERO_CAP_FLAG_* */
+  uint64_t session_ns; /* Writer start time (CLOCK_REALTIME) */
+  uint32_t segment;    /* Index within the session, from 0 */
+  uint32_t writer_pid;
+  uint64_t tsc_hz;     /* Writer TSC rate, for rx_tsc intervals */
+  uint64_t opened_ns;  /* Segment opened (CLOCK_REALTIME) */
+  uint64_t closed_ns;  /* Segment closed; 0 while live */
+  uint64_t data_size;  /* Record bytes after the header; set on close */
+  uint64_t records;    /* Records in the segment; set on close */
+  uint8_t pad[AERO_CAP_HEADER_SIZE - 72];
+} aero_cap_header;
+
+typedef struct {
+  uint32_t length; /* Payload bytes; written last, 0 = end of data */
+  uint8_t type;    /* AERO_CAP_* */
+  uint8_t exchange_id;
+  uint16_t conn_id;    /* Gateway connection that received the frame */
+  uint64_t rx_tsc;     /* Gateway TSC when the frame completed */
+  uint64_t rx_wall_ns; /* Same instant, CLOCK_REALTIME */
+} aero_cap_record;
+
+static inline size_t aero_cap_record_size(uint32_t length) {
+  return (sizeof(aero_cap_record) + length + AERO_CAP_ALIGN - 1) &
+         ~(size_t)(AERO_CAP_ALIGN - 1);
+}
+
+static inline const char *aero_cap_record_payload(const aero_cap_record *rec) {
+  return (const char *)(rec + 1);
+}
+
+/* ------------------------------------------------------------------------ */
+/* Reader                                                                   */
+/* ------------------------------------------------------------------------ */
+
+typedef struct {
+  const uint8_t *base;
+  size_t map_size;
+  const aero_cap_header *hdr;
+  size_t offset; /* Next record, from the start of the file */
+  uint64_t records;
+} aero_cap_reader;
+
+/**
+ * Map a segment and position the reader at its first record.
+ * Returns 0 on success, -1 if the file is missing or not a capture segment.
+ */
+static inline int aero_cap_reader_open(aero_cap_reader *r, const char *path) {
+  memset(r, 0, sizeof(*r));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || (size_t)st.st_size < AERO_CAP_HEADER_SIZE) {
+    close(fd);
+    return -1;
+  }
+  void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED)
+    return -1;
+
+  r->base = (const uint8_t *)p;
+  r->map_size = (size_t)st.st_size;
+  r->hdr = (const aero_cap_header *)p;
+  if (r->hdr->magic != AERO_CAP_MAGIC || r->hdr->version != AERO_CAP_VERSION) {
+    munmap(p, r->map_size);
+    memset(r, 0, sizeof(*r));
+    return -1;
+  }
+  /* Sequential access: let the kernel read ahead aggressively */
+  madvise(p, r->map_size, MADV_SEQUENTIAL);
+  r->offset = AERO_CAP_HEADER_SIZE;
+  return 0;
+}
+
+static inline void aero_cap_reader_close(aero_cap_reader *r) {
+  if (r->base)
+    munmap((void *)r->base, r->map_size);
+  memset(r, 0, sizeof(*r));
+}
+
+/**
+ * Next record, or NULL at the end of the data written so far. On a live
+ * segment a later call may return records written since.
+ */
+static inline const aero_cap_record *aero_cap_reader_next(aero_cap_reader *r) {
+  if (r->offset + sizeof(aero_cap_record) > r->map_size)
+    return NULL;
+  const aero_cap_record *rec = (const aero_cap_record *)(r->base + r->offset);
+  uint32_t length = __atomic_load_n(&rec->length, __ATOMIC_ACQUIRE);
+  if (length == 0)
+    return NULL;
+  size_t size = aero_cap_record_size(length);
+  if (r->offset + size > r->map_size)
+    return NULL; /* Torn tail of a segment that was not closed */
+  r->offset += size;
+  r->records++;
+  return rec;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AERO_CAPTURE_H */
@@ -0,0 +1,198 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 Project AERO.
+ */
+
+/**
+ * @file feed_chunk.h
+ * @brief Reassembly of chunked books for UDP feed consumers (header-only)
+ *
+ * The gateway splits books that do not fit one datagram into
+ * FEED_FLAG_CHUNKED datagrams on consecutive sequence numbers (see
+ * aero/feed_protocol.h). Every chunk can be applied on its own, so a
+ * consumer may ignore chunking altogether; FeedChunkAssembler is for
+ * consumers that want to apply a book only once all of it has arrived.
+ */
+
+#ifndef AERO_FEED_CHUNK_H
+#define AERO_FEED_CHUNK_H
+
+#include "aero/feed_protocol.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Header fields of a feed data datagram, in host order
+ */
+struct FeedChunkInfo {
+  uint64_t seq = 0;
+  uint64_t symbol_key = 0; // Symbol id (compact) or name hash (full)
+  uint16_t flags = 0;
+  uint16_t chunk_index = 0;
+  uint16_t chunk_count = 0; // 0 = not chunked
+};
+
+/**
+ * @brief Parse the header (and, compact, the chunk varints) of a datagram
+ * @return false if it is not a feed data datagram (e.g. FEC parity)
+ */
+inline bool feed_chunk_info(const uint8_t *data, size_t len,
+                            FeedChunkInfo &info) {
+  if (len < sizeof(CompactHeader))
+    return false;
+  uint32_t magic;
+  uint16_t version;
+  std::memcpy(&magic, data, sizeof(magic));
+  std::memcpy(&version, data + offsetof(UdpMarketHeader, version),
+              sizeof(version));
+  magic = __builtin_bswap32(magic);
+  version = __builtin_bswap16(version);
+  if (magic != UDP_FEED_MAGIC)
+    return false;
+
+  if (version == UDP_FEED_VERSION_COMPACT) {
+    CompactHeader h;
+    std::memcpy(&h, data, sizeof(h)); // Little-endian fields, x86 host
+    info.seq = h.seq_num;
+    info.symbol_key = (uint64_t(h.exchange_id) << 32) | h.symbol_id;
+    info.flags = h.flags;
+    info.chunk_index = info.chunk_count = 0;
+    if (info.flags & FEED_FLAG_CHUNKED) {
+      const uint8_t *p = data + sizeof(h);
+      size_t avail = len - sizeof(h);
+      uint64_t index, count;
+      size_t n = feed_get_varint(p, avail, index);
+      size_t m = n ? feed_get_varint(p + n, avail - n, count) : 0;
+      if (m == 0 || count == 0 || index >= count || count > UINT16_MAX)
+        return false;
+      info.chunk_index = static_cast<uint16_t>(index);
+      info.chunk_count = static_cast<uint16_t>(count);
+    }
+    return true;
+  }
+
+  if (version != UDP_FEED_VERSION || len < sizeof(UdpMarketHeader))
+    return false;
+  UdpMarketHeader h;
+  std::memcpy(&h, data, sizeof(h));
+  info.seq = __builtin_bswap64(h.seq_num);
+  info.flags = __builtin_bswap16(h.flags);
+  info.chunk_index = __builtin_bswap16(h.chunk_index);
+  info.chunk_count = __builtin_bswap16(h.chunk_count);
+  if (!(info.flags & FEED_FLAG_CHUNKED))
+    info.chunk_index = info.chunk_count = 0;
+  else if (info.chunk_count == 0 || info.chunk_index >= info.chunk_count)
+    return false;
+
+  uint32_t symbol_len = __builtin_bswap32(h.symbol_len);
+  if (symbol_len > len - sizeof(h))
+    return false;
+  info.symbol_key = feed_symbol_key(h.exchange_id, data + sizeof(h),
+                                    symbol_len);
+  return true;
+}
+
+/**
+ * @brief Groups the chunks of one channel back into whole books
+ *
+ * Feed it every datagram of one channel, in sequence order. Each call
+ * delivers zero or more datagram groups through the callback
+ * `deliver(std::span<const std::span<const uint8_t>> parts, bool complete)`:
+ *
+ *   - an unchunked datagram, on its own (complete)
+ *   - all chunks of a book, in order, once the last one arrived (complete)
+ *   - the chunks received so far when the sequence breaks (a chunk lost,
+ *     or a retransmitted one arriving late): not complete, but each chunk
+ *     is still valid to apply, the book just lacks some deeper levels until
+ *     the next snapshot
+ *
+ * Chunks are copied while a book is pending, since receive buffers are
+ * usually reused. Datagrams that are not feed data (FEC parity) are
+ * ignored. Call flush() when the channel goes quiet, so a book whose last
+ * chunk was lost is not held back indefinitely.
+ */
+class FeedChunkAssembler {
+public:
+  template <typename F>
+  void on_datagram(const uint8_t *data, size_t len, F &&deliver) {
+    FeedChunkInfo info;
+    if (!feed_chunk_info(data, len, info))
+      return;
+
+    bool continues = held_ > 0 && info.chunk_count == count_ &&
+                     info.chunk_index == held_ && info.seq == next_seq_ &&
+                     info.symbol_key == key_ &&
+                     !(info.flags & FEED_FLAG_RETRANSMIT);
+    if (held_ > 0 && !continues)
+      flush(deliver); // Sequence broken: hand over what we have
+
+    std::span<const uint8_t> in(data, len);
+    if (info.chunk_count == 0 || (info.flags & FEED_FLAG_RETRANSMIT) ||
+        (!continues && info.chunk_index != 0)) {
+      // Unchunked, gap-filled, or an orphan chunk whose book already broke
+      bool complete = info.chunk_count == 0;
+      if (!complete)
+        partial_++;
+      deliver(std::span<const std::span<const uint8_t>>(&in, 1), complete);
+      return;
+    }
+
+    if (held_ == 0) {
+      count_ = info.chunk_count;
+      key_ = info.symbol_key;
+    }
+    if (chunks_.size() <= held_)
+      chunks_.resize(held_ + 1);
+    chunks_[held_].assign(data, data + len);
+    held_++;
+    next_seq_ = info.seq + 1;
+
+    if (held_ == count_) {
+      complete_++;
+      deliver(parts(), true);
+      held_ = 0;
+    }
+  }
+
+  /**
+   * @brief Deliver a pending incomplete book, if any
+   */
+  template <typename F> void flush(F &&deliver) {
+    if (held_ == 0)
+      return;
+    partial_++;
+    deliver(parts(), false);
+    held_ = 0;
+  }
+
+  bool pending() const { return held_ > 0; }
+
+  // Counters
+  uint64_t complete() const { return complete_; } // Books fully reassembled
+  uint64_t partial() const { return partial_; }   // Delivered incomplete
+
+private:
+  std::span<const std::span<const uint8_t>> parts() {
+    parts_.clear();
+    for (size_t i = 0; i < held_; i++)
+      parts_.emplace_back(chunks_[i].data(), chunks_[i].size());
+    return parts_;
+  }
+
+  std::vector<std::vector<uint8_t>> chunks_; // Reused across books
+  std::vector<std::span<const uint8_t>> parts_;
+  size_t held_ = 0;
+  uint16_t count_ = 0;
+  uint64_t key_ = 0;
+  uint64_t next_seq_ = 0;
+  uint64_t complete_ = 0;
+  uint64_t partial_ = 0;
+};
+
+} // namespace aero
+
+#endif // AERO_FEED_CHUNK_H
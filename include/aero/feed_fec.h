@@ -0,0 +1,474 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 Project AERO.
+ */
+
+/**
+ * @file feed_fec.h
+ * @brief Forward error correction codec for the UDP feed (header-only)
+ *
+ * FeedFecEncoder is used by the gateway's UdpPublisher; FeedFecDecoder is
+ * for consumers: feed it every datagram of one channel and it hands back
+ * data datagrams it rebuilt from parity, with no request to the gateway.
+ * Wire format in aero/feed_protocol.h (FeedFecHeader).
+ *
+ * Codes are systematic: data datagrams go out unchanged. With one parity
+ * datagram per block the parity is the XOR of the block's symbols; with
+ * more, parity j is sum_i c(j, i) * symbol_i over GF(2^8) with the Cauchy
+ * coefficients c(j, i) = 1 / ((128 + j) xor i), so every square submatrix
+ * is invertible and any data_count received datagrams rebuild the block.
+ */
+
+#ifndef AERO_FEED_FEC_H
+#define AERO_FEED_FEC_H
+
+#include "aero/feed_protocol.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace aero {
+
+namespace fec_detail {
+
+struct GfTables {
+  uint8_t exp[512];
+  uint8_t log[256];
+
+  GfTables() {
+    uint16_t x = 1;
+    for (int i = 0; i < 255; i++) {
+      exp[i] = static_cast<uint8_t>(x);
+      log[x] = static_cast<uint8_t>(i);
+      x <<= 1;
+      if (x & 0x100)
+        x ^= 0x11d; // x^8 + x^4 + x^3 + x^2 + 1
+    }
+    for (int i = 255; i < 512; i++)
+      exp[i] = exp[i - 255];
+    log[0] = 0;
+  }
+};
+
+inline const GfTables &gf() {
+  static const GfTables tables;
+  return tables;
+}
+
+inline uint8_t gf_mul(uint8_t a, uint8_t b) {
+  if (a == 0 || b == 0)
+    return 0;
+  const GfTables &t = gf();
+  return t.exp[t.log[a] + t.log[b]];
+}
+
+inline uint8_t gf_inv(uint8_t a) {
+  const GfTables &t = gf();
+  return t.exp[255 - t.log[a]];
+}
+
+// dst ^= c * src
+inline void gf_mul_add(uint8_t *dst, const uint8_t *src, size_t len,
+                       uint8_t c) {
+  if (c == 0)
+    return;
+  if (c == 1) {
+    for (size_t i = 0; i < len; i++)
+      dst[i] ^= src[i];
+    return;
+  }
+  const GfTables &t = gf();
+  const unsigned lc = t.log[c];
+  for (size_t i = 0; i < len; i++) {
+    uint8_t s = src[i];
+    if (s)
+      dst[i] ^= t.exp[t.log[s] + lc];
+  }
+}
+
+inline uint8_t coefficient(uint8_t scheme, uint8_t parity_index,
+                           uint8_t data_index) {
+  if (scheme == FEED_FEC_XOR)
+    return 1;
+  return gf_inv(static_cast<uint8_t>((128 + parity_index) ^ data_index));
+}
+
+// Symbol of a data datagram = [len (BE16)][datagram], zero padding implied
+inline void fold_symbol(uint8_t *dst, const uint8_t *data, size_t len,
+                        uint8_t c) {
+  const uint8_t len_be[2] = {static_cast<uint8_t>(len >> 8),
+                             static_cast<uint8_t>(len)};
+  gf_mul_add(dst, len_be, 2, c);
+  gf_mul_add(dst + 2, data, len, c);
+}
+
+inline uint64_t load_be64(const uint8_t *p) {
+  uint64_t v = 0;
+  for (int i = 0; i < 8; i++)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+inline uint64_t load_le64(const uint8_t *p) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; i--)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+inline void store_be64(uint8_t *p, uint64_t v) {
+  for (int i = 7; i >= 0; i--) {
+    p[i] = static_cast<uint8_t>(v);
+    v >>= 8;
+  }
+}
+
+} // namespace fec_detail
+
+/**
+ * @brief Feed sequence number of a data datagram (full or compact format)
+ * @return false if the datagram is not a feed data datagram
+ */
+inline bool feed_datagram_seq(const uint8_t *data, size_t len, uint64_t &seq) {
+  if (len < 6)
+    return false;
+  uint32_t magic = (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) |
+                   (uint32_t(data[2]) << 8) | data[3];
+  uint16_t version = static_cast<uint16_t>((data[4] << 8) | data[5]);
+  if (magic != UDP_FEED_MAGIC)
+    return false;
+  if (version == UDP_FEED_VERSION_COMPACT && len >= sizeof(CompactHeader)) {
+    seq = fec_detail::load_le64(data + offsetof(CompactHeader, seq_num));
+    return true;
+  }
+  if (version == UDP_FEED_VERSION && len >= sizeof(UdpMarketHeader)) {
+    seq = fec_detail::load_be64(data + offsetof(UdpMarketHeader, seq_num));
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Parity builder for one channel
+ *
+ * Data datagrams are folded into the parity buffers as they are published,
+ * so nothing is buffered and the parity is ready as soon as the block
+ * closes. Cost per datagram is one pass over its bytes per parity datagram.
+ */
+class FeedFecEncoder {
+public:
+  FeedFecEncoder(uint8_t k, uint8_t m)
+      : k_(std::clamp<uint8_t>(k, 1, FEED_FEC_MAX_K)),
+        m_(std::clamp<uint8_t>(m, 1, FEED_FEC_MAX_M)),
+        scheme_(m_ == 1 ? FEED_FEC_XOR : FEED_FEC_RS), parity_(m_) {
+    for (auto &p : parity_)
+      p.reserve(FEED_FEC_MAX_SYMBOL);
+  }
+
+  /**
+   * @brief Fold a data datagram into the open block
+   * @return false if the datagram is too large to protect
+   */
+  bool add(uint64_t seq, const uint8_t *data, size_t len) {
+    if (len + 2 > FEED_FEC_MAX_SYMBOL)
+      return false;
+    if (count_ == 0)
+      block_seq_ = seq;
+    if (len + 2 > symbol_len_) {
+      symbol_len_ = len + 2;
+      for (auto &p : parity_)
+        p.resize(symbol_len_, 0);
+    }
+    for (uint8_t j = 0; j < m_; j++) {
+      fec_detail::fold_symbol(parity_[j].data(), data, len,
+                              fec_detail::coefficient(scheme_, j, count_));
+    }
+    count_++;
+    return true;
+  }
+
+  bool empty() const { return count_ == 0; }
+  bool full() const { return count_ == k_; }
+  uint64_t next_seq() const { return block_seq_ + count_; }
+  uint8_t parity_count() const { return m_; }
+  size_t parity_size() const { return sizeof(FeedFecHeader) + symbol_len_; }
+
+  /**
+   * @brief Serialize parity datagram `index` (parity_size() bytes)
+   */
+  void write_parity(uint8_t index, uint16_t channel, uint8_t *out) const {
+    FeedFecHeader h;
+    std::memset(&h, 0, sizeof(h));
+    uint8_t *b = reinterpret_cast<uint8_t *>(&h);
+    const uint32_t magic = FEED_FEC_MAGIC;
+    b[0] = static_cast<uint8_t>(magic >> 24);
+    b[1] = static_cast<uint8_t>(magic >> 16);
+    b[2] = static_cast<uint8_t>(magic >> 8);
+    b[3] = static_cast<uint8_t>(magic);
+    b[4] = 0;
+    b[5] = FEED_FEC_VERSION;
+    b[6] = static_cast<uint8_t>(channel >> 8);
+    b[7] = static_cast<uint8_t>(channel);
+    fec_detail::store_be64(b + offsetof(FeedFecHeader, block_seq), block_seq_);
+    h.data_count = count_;
+    h.parity_count = m_;
+    h.parity_index = index;
+    h.scheme = scheme_;
+    b[offsetof(FeedFecHeader, symbol_len)] =
+        static_cast<uint8_t>(symbol_len_ >> 8);
+    b[offsetof(FeedFecHeader, symbol_len) + 1] =
+        static_cast<uint8_t>(symbol_len_);
+    std::memcpy(out, &h, sizeof(h));
+    std::memcpy(out + sizeof(h), parity_[index].data(), symbol_len_);
+  }
+
+  /**
+   * @brief Start a new block (after the parity was sent)
+   */
+  void reset() {
+    count_ = 0;
+    symbol_len_ = 0;
+    for (auto &p : parity_)
+      p.clear();
+  }
+
+private:
+  uint8_t k_;
+  uint8_t m_;
+  uint8_t scheme_;
+  uint8_t count_ = 0;
+  uint64_t block_seq_ = 0;
+  size_t symbol_len_ = 0;
+  std::vector<std::vector<uint8_t>> parity_;
+};
+
+/**
+ * @brief Consumer-side recovery for one channel
+ *
+ * Pass every datagram received on the channel, data and parity, in arrival
+ * order. Recent data datagrams are kept in a ring of `history` entries;
+ * parity is held until its block is complete, recoverable, or too old.
+ *
+ *   FeedFecDecoder fec;
+ *   fec.on_datagram(buf, n, [&](const uint8_t *d, size_t len) {
+ *     handle_datagram(d, len); // A lost datagram, rebuilt
+ *   });
+ *
+ * Rebuilt datagrams are byte-identical to the originals. They are passed
+ * out as soon as their block can be solved, which may be after datagrams
+ * with higher seq; order them by seq_num as for gap-fill responses.
+ */
+class FeedFecDecoder {
+public:
+  explicit FeedFecDecoder(size_t history = 4096) {
+    size_t pow2 = 1;
+    while (pow2 < history)
+      pow2 <<= 1;
+    ring_.resize(pow2);
+    mask_ = pow2 - 1;
+  }
+
+  template <typename F>
+  void on_datagram(const uint8_t *data, size_t len, F &&on_recovered) {
+    uint64_t seq;
+    if (feed_datagram_seq(data, len, seq)) {
+      store(seq, data, len);
+      for (size_t i = 0; i < pending_.size();) {
+        Block &b = pending_[i];
+        if (seq >= b.block_seq && seq < b.block_seq + b.data_count &&
+            try_recover(b, on_recovered)) {
+          pending_.erase(pending_.begin() + static_cast<ptrdiff_t>(i));
+          continue;
+        }
+        i++;
+      }
+      expire();
+      return;
+    }
+
+    if (len < sizeof(FeedFecHeader))
+      return;
+    FeedFecHeader h;
+    std::memcpy(&h, data, sizeof(h));
+    const uint8_t *b = data;
+    uint32_t magic = (uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) |
+                     (uint32_t(b[2]) << 8) | b[3];
+    uint16_t symbol_len =
+        static_cast<uint16_t>((b[offsetof(FeedFecHeader, symbol_len)] << 8) |
+                              b[offsetof(FeedFecHeader, symbol_len) + 1]);
+    // Coefficients are only distinct and non-zero within MAX_K x MAX_M
+    if (magic != FEED_FEC_MAGIC || h.data_count == 0 ||
+        h.data_count > FEED_FEC_MAX_K || h.parity_count > FEED_FEC_MAX_M ||
+        h.parity_index >= h.parity_count ||
+        (h.scheme != FEED_FEC_XOR && h.scheme != FEED_FEC_RS) ||
+        len < sizeof(FeedFecHeader) + symbol_len)
+      return;
+    uint64_t block_seq =
+        fec_detail::load_be64(b + offsetof(FeedFecHeader, block_seq));
+
+    Block *blk = nullptr;
+    for (auto &p : pending_) {
+      if (p.block_seq == block_seq) {
+        blk = &p;
+        break;
+      }
+    }
+    if (blk == nullptr) {
+      if (block_seq + h.data_count <= done_below_)
+        return; // Block already completed or recovered
+      pending_.push_back(Block{block_seq, h.data_count, h.scheme, symbol_len,
+                               {}});
+      blk = &pending_.back();
+    }
+    for (const auto &p : blk->parity) {
+      if (p.index == h.parity_index)
+        return; // Duplicate
+    }
+    blk->parity.push_back(
+        Parity{h.parity_index,
+               std::vector<uint8_t>(data + sizeof(FeedFecHeader),
+                                    data + sizeof(FeedFecHeader) + symbol_len)});
+
+    if (try_recover(*blk, on_recovered)) {
+      pending_.erase(pending_.begin() + (blk - pending_.data()));
+    }
+    expire();
+  }
+
+  uint64_t recovered() const { return recovered_; }
+  uint64_t unrecoverable() const { return unrecoverable_; }
+
+private:
+  struct Slot {
+    uint64_t seq = 0;
+    std::vector<uint8_t> data;
+  };
+
+  struct Parity {
+    uint8_t index;
+    std::vector<uint8_t> bytes;
+  };
+
+  struct Block {
+    uint64_t block_seq;
+    uint8_t data_count;
+    uint8_t scheme;
+    uint16_t symbol_len;
+    std::vector<Parity> parity;
+  };
+
+  void store(uint64_t seq, const uint8_t *data, size_t len) {
+    Slot &s = ring_[seq & mask_];
+    s.seq = seq;
+    s.data.assign(data, data + len);
+    high_seq_ = std::max(high_seq_, seq);
+  }
+
+  const Slot *find(uint64_t seq) const {
+    const Slot &s = ring_[seq & mask_];
+    return s.seq == seq && seq != 0 ? &s : nullptr;
+  }
+
+  // Drop blocks whose datagrams have left the ring
+  void expire() {
+    for (size_t i = 0; i < pending_.size();) {
+      if (pending_[i].block_seq + mask_ < high_seq_) {
+        unrecoverable_++;
+        pending_.erase(pending_.begin() + static_cast<ptrdiff_t>(i));
+        continue;
+      }
+      i++;
+    }
+  }
+
+  // Returns true when the block needs no more attention
+  template <typename F> bool try_recover(const Block &b, F &&on_recovered) {
+    uint8_t missing[FEED_FEC_MAX_K];
+    size_t e = 0;
+    for (uint8_t i = 0; i < b.data_count; i++) {
+      if (!find(b.block_seq + i))
+        missing[e++] = i;
+    }
+    if (e == 0 || e > b.parity.size()) {
+      if (e == 0)
+        done_below_ = std::max(done_below_, b.block_seq + b.data_count);
+      return e == 0;
+    }
+
+    const size_t L = b.symbol_len;
+    // Syndromes: parity minus the contribution of the data we have
+    std::vector<std::vector<uint8_t>> syn(e);
+    for (size_t r = 0; r < e; r++) {
+      syn[r] = b.parity[r].bytes;
+      for (uint8_t i = 0; i < b.data_count; i++) {
+        const Slot *s = find(b.block_seq + i);
+        if (!s)
+          continue;
+        if (s->data.size() + 2 > L)
+          return false; // Not the block the parity was built from
+        fec_detail::fold_symbol(
+            syn[r].data(), s->data.data(), s->data.size(),
+            fec_detail::coefficient(b.scheme, b.parity[r].index, i));
+      }
+    }
+
+    // Invert the e x e coefficient matrix of the missing symbols
+    uint8_t a[FEED_FEC_MAX_K][2 * FEED_FEC_MAX_K];
+    for (size_t r = 0; r < e; r++) {
+      for (size_t c = 0; c < e; c++) {
+        a[r][c] = fec_detail::coefficient(b.scheme, b.parity[r].index,
+                                          missing[c]);
+        a[r][e + c] = (r == c);
+      }
+    }
+    for (size_t col = 0; col < e; col++) {
+      size_t piv = col;
+      while (piv < e && a[piv][col] == 0)
+        piv++;
+      if (piv == e)
+        return false; // Singular (XOR with e > 1): wait for more data
+      if (piv != col) {
+        for (size_t c = 0; c < 2 * e; c++)
+          std::swap(a[piv][c], a[col][c]);
+      }
+      uint8_t inv = fec_detail::gf_inv(a[col][col]);
+      for (size_t c = 0; c < 2 * e; c++)
+        a[col][c] = fec_detail::gf_mul(a[col][c], inv);
+      for (size_t r = 0; r < e; r++) {
+        if (r == col || a[r][col] == 0)
+          continue;
+        uint8_t f = a[r][col];
+        for (size_t c = 0; c < 2 * e; c++)
+          a[r][c] ^= fec_detail::gf_mul(f, a[col][c]);
+      }
+    }
+
+    std::vector<uint8_t> out(L);
+    for (size_t c = 0; c < e; c++) {
+      std::fill(out.begin(), out.end(), 0);
+      for (size_t r = 0; r < e; r++)
+        fec_detail::gf_mul_add(out.data(), syn[r].data(), L, a[c][e + r]);
+      size_t len = (static_cast<size_t>(out[0]) << 8) | out[1];
+      if (len + 2 > L)
+        continue;
+      store(b.block_seq + missing[c], out.data() + 2, len);
+      recovered_++;
+      on_recovered(static_cast<const uint8_t *>(out.data() + 2), len);
+    }
+    done_below_ = std::max(done_below_, b.block_seq + b.data_count);
+    return true;
+  }
+
+  std::vector<Slot> ring_;
+  size_t mask_ = 0;
+  std::vector<Block> pending_;
+  uint64_t high_seq_ = 0;
+  uint64_t done_below_ = 0; // Blocks ending at or below this are finished
+  uint64_t recovered_ = 0;
+  uint64_t unrecoverable_ = 0;
+};
+
+} // namespace aero
+
+#endif /* AERO_FEED_FEC_H */
@@ -0,0 +1,439 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 Project AERO.
+ */
+
+/**
+ * @file feed_protocol.h
+ * @brief Wire format of the UDP market data feed and its recovery service
+ *
+ * Shared by the gateway and by consumers. In the default (version 2)
+ * format all multi-byte fields are in network byte order; the compact
+ * version 3 format further down is little-endian after magic/version.
+ *
+ * Datagram layout:
+ *   UdpMarketHeader | symbol (symbol_len bytes) |
+ *   UdpPriceLevel x bid_count | UdpPriceLevel x ask_count
+ *
+ * Every datagram carries a per-channel sequence number that increases by
+ * exactly one, so a consumer detects loss as a jump in seq_num and can ask
+ * the retransmission service (TCP) for the missing range.
+ *
+ * No datagram exceeds the publisher's max payload (1472 bytes by default),
+ * so the feed never relies on IP fragmentation. A book that does not fit is
+ * split by depth into chunks sent on consecutive sequence numbers, flagged
+ * FEED_FLAG_CHUNKED. Chunk 0 carries the best levels of both sides and the
+ * book's message type; later chunks are FEED_MSG_DELTA and only add deeper
+ * levels, so each chunk can be applied on its own when another is lost.
+ * aero/feed_chunk.h reassembles chunks for consumers that want whole books.
+ */
+
+#ifndef AERO_FEED_PROTOCOL_H
+#define AERO_FEED_PROTOCOL_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace aero {
+
+// Binary Protocol Constants
+constexpr uint32_t UDP_FEED_MAGIC = 0x48465444; // "HFTD"
+constexpr uint16_t UDP_FEED_VERSION = 2; // Full format; see also UDP_FEED_VERSION_COMPACT
+
+constexpr uint8_t FEED_MSG_SNAPSHOT = 1;
+constexpr uint8_t FEED_MSG_DELTA = 2;
+
+// UdpMarketHeader::flags
+constexpr uint16_t FEED_FLAG_RETRANSMIT = 0x0001; // Sent by the gap-fill service
+constexpr uint16_t FEED_FLAG_CHUNKED = 0x0002;    // Part of a split book
+
+// Packet Header Structure (packed)
+struct __attribute__((packed)) UdpMarketHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint8_t msg_type;    // 1=Snapshot, 2=Delta (3=Symbol def, compact only)
+  uint8_t exchange_id; // See ExchangeId
+  uint64_t timestamp_ns;
+  uint32_t symbol_len;
+  uint16_t bid_count;
+  uint16_t ask_count;
+  // Version 2
+  uint16_t channel_id;  // Multicast group / channel the datagram was sent on
+  uint16_t flags;       // FEED_FLAG_*
+  uint16_t chunk_index; // FEED_FLAG_CHUNKED only: 0 .. chunk_count - 1
+  uint16_t chunk_count; // FEED_FLAG_CHUNKED only
+  uint64_t seq_num; // Per-channel, starts at 1, +1 per datagram
+};
+static_assert(sizeof(UdpMarketHeader) == 40, "UdpMarketHeader layout");
+
+// Price Level Structure (packed)
+struct __attribute__((packed)) UdpPriceLevel {
+  uint64_t price_int; // Scaled by 1e8
+  double quantity;    // Floating point size
+};
+
+/**
+ * @brief Channel of a symbol in per-symbol-hash mode (FNV-1a 32)
+ *
+ * Consumers use this to find the group that carries the symbols they want.
+ */
+inline uint16_t feed_symbol_channel(const char *symbol, size_t len,
+                                    uint16_t channel_count) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    h ^= static_cast<uint8_t>(symbol[i]);
+    h *= 16777619u;
+  }
+  return channel_count ? static_cast<uint16_t>(h % channel_count) : 0;
+}
+
+/**
+ * @brief Consumer-side key of a full-format book (FNV-1a 64 over exchange
+ *        id and symbol)
+ *
+ * Compact-format books are keyed by (exchange_id << 32) | symbol_id instead.
+ */
+inline uint64_t feed_symbol_key(uint8_t exchange_id, const uint8_t *symbol,
+                                size_t len) {
+  uint64_t key = 14695981039346656037ULL ^ exchange_id;
+  key *= 1099511628211ULL;
+  for (size_t i = 0; i < len; i++) {
+    key ^= symbol[i];
+    key *= 1099511628211ULL;
+  }
+  return key;
+}
+
+// ---------------------------------------------------------------------------
+// Compact format (version 3)
+//
+// Selected with UDP_FEED_FORMAT=compact. magic and version stay in network
+// order so a consumer can dispatch on them; everything after is
+// little-endian. Books are identified by a symbol id announced with a
+// FEED_MSG_SYMBOL_DEF message on the same channel (re-sent with every
+// periodic refresh, so late joiners pick it up).
+//
+// Book body (FEED_MSG_SNAPSHOT / FEED_MSG_DELTA):
+//   [varint chunk_index, varint chunk_count]  (only with FEED_FLAG_CHUNKED)
+//   varint bid_count, varint ask_count,
+//   varint base_ticks                       (price of the first level / tick)
+//   per level, bids (best first) then asks (best first):
+//     zigzag varint delta_ticks             (vs. previous level; 0 for first)
+//     varint qty                            (quantity * FEED_QTY_SCALE,
+//                                            0 = level removed)
+//
+// A DELTA carries only the levels that changed since the previous message
+// for that symbol; a SNAPSHOT carries the whole published book and replaces
+// the consumer's state.
+// ---------------------------------------------------------------------------
+
+constexpr uint16_t UDP_FEED_VERSION_COMPACT = 3;
+constexpr uint8_t FEED_MSG_SYMBOL_DEF = 3;
+constexpr uint64_t FEED_QTY_SCALE = 100000000ULL; // 1e8, like PRICE_SCALE
+
+// Exchange size to FEED_QTY_SCALE fixed point (non-positive and NaN -> 0)
+inline uint64_t feed_fixed_qty(double qty) {
+  if (!(qty > 0.0))
+    return 0;
+  return static_cast<uint64_t>(
+      std::llround(qty * static_cast<double>(FEED_QTY_SCALE)));
+}
+
+struct __attribute__((packed)) CompactHeader {
+  uint32_t magic;   // Network order
+  uint16_t version; // Network order (3)
+  uint8_t msg_type;
+  uint8_t exchange_id;
+  uint16_t channel_id; // Little-endian from here on
+  uint16_t flags;
+  uint32_t symbol_id;
+  uint64_t seq_num;
+  uint64_t timestamp_ns;
+};
+static_assert(sizeof(CompactHeader) == 32, "CompactHeader layout");
+
+// Body of FEED_MSG_SYMBOL_DEF
+struct __attribute__((packed)) CompactSymbolDef {
+  uint64_t tick;   // Price tick in PRICE_SCALE (1e8) units
+  uint8_t name_len;
+  // char name[name_len] follows
+};
+
+inline size_t feed_put_varint(uint8_t *out, uint64_t v) {
+  size_t n = 0;
+  while (v >= 0x80) {
+    out[n++] = static_cast<uint8_t>(v) | 0x80;
+    v >>= 7;
+  }
+  out[n++] = static_cast<uint8_t>(v);
+  return n;
+}
+
+/**
+ * @brief Decode a varint; returns bytes consumed or 0 on truncation
+ */
+inline size_t feed_get_varint(const uint8_t *in, size_t avail, uint64_t &v) {
+  v = 0;
+  for (size_t i = 0; i < avail && i < 10; i++) {
+    v |= static_cast<uint64_t>(in[i] & 0x7F) << (7 * i);
+    if (!(in[i] & 0x80))
+      return i + 1;
+  }
+  return 0;
+}
+
+inline uint64_t feed_zigzag(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t feed_unzigzag(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+// ---------------------------------------------------------------------------
+// Top-of-book channel (UDP_FEED_BBO_PORT)
+//
+// Every datagram is exactly one 64-byte, little-endian record: receive into
+// a 64-byte aligned buffer and read it as FeedBboRecord (or FeedBboSymbol,
+// by msg_type). An update is sent only when the best bid/ask price or size
+// of a symbol changes. seq_num counts all records on the channel; there is
+// no gap fill, since the next update for a symbol supersedes a lost one.
+//
+// With BOOK_ANALYTICS_ENABLED, a FeedBboAnalytics record follows each update
+// and is also sent alone when only deeper levels changed. Its depth windows
+// and VWAP size are the gateway's BOOK_ANALYTICS_LEVELS / _VWAP_QTY.
+//
+// With TRADES_ENABLED, every public trade goes out as a FeedBboTrade, and
+// each trades message is followed by one FeedBboTradeFlow per symbol with
+// the rolling aggregates as of its last trade. The flow windows are the
+// gateway's TRADE_FLOW_WINDOWS_MS.
+// ---------------------------------------------------------------------------
+
+constexpr uint16_t FEED_BBO_MAGIC = 0x4242; // "BB"
+constexpr uint8_t FEED_BBO_UPDATE = 1;
+constexpr uint8_t FEED_BBO_SYMBOL = 2; // symbol_id -> name, repeated every second
+constexpr uint8_t FEED_BBO_ANALYTICS = 3; // Derived book signals of a symbol
+constexpr size_t FEED_BBO_DEPTHS = 3;     // Depth windows per side
+constexpr uint8_t FEED_BBO_TRADE = 4;     // One public trade
+constexpr uint8_t FEED_BBO_TRADE_FLOW = 5; // Rolling trade aggregates
+constexpr size_t FEED_BBO_FLOW_WINDOWS = 3; // Time windows per flow record
+
+struct alignas(64) FeedBboRecord {
+  uint16_t magic;
+  uint8_t msg_type; // FEED_BBO_UPDATE
+  uint8_t exchange_id;
+  uint32_t symbol_id; // Same ids as the compact format
+  uint64_t seq_num;
+  uint64_t bid_price; // PRICE_SCALE (1e8) units
+  uint64_t bid_qty;   // FEED_QTY_SCALE (1e8) units
+  uint64_t ask_price;
+  uint64_t ask_qty;
+  uint64_t exchange_ts_ns; // Exchange event time
+  uint64_t gateway_tsc;    // Gateway TSC at frame receive
+};
+static_assert(sizeof(FeedBboRecord) == 64, "FeedBboRecord layout");
+
+struct alignas(64) FeedBboSymbol {
+  uint16_t magic;
+  uint8_t msg_type; // FEED_BBO_SYMBOL
+  uint8_t exchange_id;
+  uint32_t symbol_id;
+  uint64_t seq_num;
+  char name[48]; // NUL-padded
+};
+static_assert(sizeof(FeedBboSymbol) == 64, "FeedBboSymbol layout");
+
+struct alignas(64) FeedBboAnalytics {
+  uint16_t magic;
+  uint8_t msg_type; // FEED_BBO_ANALYTICS
+  uint8_t exchange_id;
+  uint32_t symbol_id;
+  uint64_t seq_num;
+  uint64_t microprice; // PRICE_SCALE units, BBO weighted by opposite size
+  uint64_t bid_vwap;   // PRICE_SCALE units to sell the VWAP size, 0 if thin
+  uint64_t ask_vwap;   // Same, to buy
+  float bid_depth[FEED_BBO_DEPTHS]; // Quantity in the best N levels
+  float ask_depth[FEED_BBO_DEPTHS];
+};
+static_assert(sizeof(FeedBboAnalytics) == 64, "FeedBboAnalytics layout");
+
+// (bid - ask) / (bid + ask) over depth window i
+inline double feed_bbo_imbalance(const FeedBboAnalytics &a, size_t i) {
+  double bid = a.bid_depth[i];
+  double ask = a.ask_depth[i];
+  return bid + ask > 0.0 ? (bid - ask) / (bid + ask) : 0.0;
+}
+
+struct alignas(64) FeedBboTrade {
+  uint16_t magic;
+  uint8_t msg_type; // FEED_BBO_TRADE
+  uint8_t exchange_id;
+  uint32_t symbol_id;
+  uint64_t seq_num;
+  uint64_t price;          // PRICE_SCALE units
+  uint64_t qty;            // FEED_QTY_SCALE units
+  uint64_t exchange_ts_ns; // Exchange trade time
+  uint64_t gateway_tsc;    // Gateway TSC at frame receive
+  uint8_t side;            // Aggressor: 0 buy, 1 sell
+  uint8_t reserved[15];
+};
+static_assert(sizeof(FeedBboTrade) == 64, "FeedBboTrade layout");
+
+struct alignas(64) FeedBboTradeFlow {
+  uint16_t magic;
+  uint8_t msg_type; // FEED_BBO_TRADE_FLOW
+  uint8_t exchange_id;
+  uint32_t symbol_id;
+  uint64_t seq_num;
+  uint64_t vwap[FEED_BBO_FLOW_WINDOWS]; // PRICE_SCALE units, 0 if no trades
+  float buy_qty[FEED_BBO_FLOW_WINDOWS]; // Aggressor buy volume per window
+  float sell_qty[FEED_BBO_FLOW_WINDOWS];
+};
+static_assert(sizeof(FeedBboTradeFlow) == 64, "FeedBboTradeFlow layout");
+
+// (buy - sell) / (buy + sell) aggressor volume over flow window i
+inline double feed_bbo_flow_imbalance(const FeedBboTradeFlow &f, size_t i) {
+  double buy = f.buy_qty[i];
+  double sell = f.sell_qty[i];
+  return buy + sell > 0.0 ? (buy - sell) / (buy + sell) : 0.0;
+}
+
+// ---------------------------------------------------------------------------
+// Forward error correction (UDP_FEED_FEC_K / UDP_FEED_FEC_M)
+//
+// Each channel's datagrams are grouped into blocks of up to k consecutive
+// sequence numbers; after a block the publisher sends m parity datagrams on
+// the same channel. Parity datagrams have their own magic and do not take a
+// feed sequence number, so consumers that do not decode FEC just drop them.
+//
+// The protected symbol of a data datagram is [uint16_t len (network order)]
+// [datagram] zero-padded to symbol_len. m = 1 uses plain XOR; m > 1 uses a
+// Reed-Solomon (Cauchy) code over GF(2^8), so any `data_count` of the
+// block's data + parity datagrams rebuild the rest. The codec is in
+// aero/feed_fec.h. Header fields are in network byte order.
+// ---------------------------------------------------------------------------
+
+constexpr uint32_t FEED_FEC_MAGIC = 0x48465446; // "HFTF"
+constexpr uint16_t FEED_FEC_VERSION = 1;
+constexpr uint8_t FEED_FEC_XOR = 1;
+constexpr uint8_t FEED_FEC_RS = 2;
+constexpr uint8_t FEED_FEC_MAX_K = 64;
+constexpr uint8_t FEED_FEC_MAX_M = 16;
+constexpr size_t FEED_FEC_MAX_SYMBOL = 9000; // Larger datagrams are unprotected
+
+struct __attribute__((packed)) FeedFecHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t channel_id;
+  uint64_t block_seq;    // Seq of the first data datagram in the block
+  uint8_t data_count;    // Data datagrams in the block (a block may be cut
+                         // short by the publisher's max delay)
+  uint8_t parity_count;  // Parity datagrams sent for the block (m)
+  uint8_t parity_index;  // 0 .. parity_count - 1
+  uint8_t scheme;        // FEED_FEC_XOR / FEED_FEC_RS
+  uint16_t symbol_len;   // Parity bytes that follow this header
+  uint16_t reserved;
+};
+static_assert(sizeof(FeedFecHeader) == 24, "FeedFecHeader layout");
+
+// ---------------------------------------------------------------------------
+// Retransmission (gap-fill) service, TCP
+//
+// Client sends RetransRequest; the server answers with one RetransResponse
+// followed by `count` frames of [uint16_t len][datagram bytes], starting at
+// first_seq. Retransmitted datagrams are byte-identical to the originals
+// except that FEED_FLAG_RETRANSMIT is set. Several requests may be sent on
+// one connection.
+// ---------------------------------------------------------------------------
+
+constexpr uint32_t RETRANS_MAGIC = 0x48465452; // "HFTR"
+constexpr uint32_t RETRANS_MAX_COUNT = 1024;   // Datagrams per request
+
+enum RetransStatus : uint16_t {
+  RETRANS_OK = 0,
+  RETRANS_PARTIAL = 1, // Part of the range is no longer (or not yet) held
+  RETRANS_UNKNOWN_CHANNEL = 2,
+  RETRANS_BAD_REQUEST = 3,
+};
+
+struct __attribute__((packed)) RetransRequest {
+  uint32_t magic;
+  uint16_t channel_id;
+  uint16_t reserved;
+  uint64_t begin_seq;
+  uint32_t count;
+};
+
+struct __attribute__((packed)) RetransResponse {
+  uint32_t magic;
+  uint16_t status;
+  uint16_t channel_id;
+  uint64_t first_seq; // Seq of the first frame that follows
+  uint32_t count;     // Number of frames that follow
+  uint32_t reserved;
+  uint64_t next_seq; // Next seq the channel will publish
+};
+
+// ---------------------------------------------------------------------------
+// Snapshot-on-demand service, TCP
+//
+// Client sends SnapshotRequest for a symbol id (the ids carried by the
+// compact format, the BBO channel and the shared-memory bus) or, with
+// symbol_id = SNAPSHOT_BY_NAME, for exchange_id + the name_len bytes of
+// instrument name that follow the request. The server answers with one
+// SnapshotResponse followed by bid_count + ask_count SnapshotLevel (bids
+// best first, then asks best first) and name_len bytes of instrument name.
+//
+// seq_num is the sequence number, on channel_id, of the last datagram for
+// this symbol that is already reflected in the snapshot (0 = none sent yet).
+// To join late: buffer the channel, request the snapshot, drop buffered
+// datagrams with seq <= seq_num for this symbol and apply the rest.
+// SNAPSHOT_FLAG_DEGRADED means levels were skipped under load: the book is
+// exact near the top but deeper levels may be missing or stale until the
+// gateway's resync snapshot for the symbol arrives.
+// All fields are in network byte order.
+// ---------------------------------------------------------------------------
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x48465453; // "HFTS"
+constexpr uint32_t SNAPSHOT_BY_NAME = 0xFFFFFFFF;
+constexpr uint16_t SNAPSHOT_MAX_LEVELS = 5000; // Per side
+constexpr uint16_t SNAPSHOT_FLAG_DEGRADED = 0x0001;
+
+enum SnapshotStatus : uint16_t {
+  SNAPSHOT_OK = 0,
+  SNAPSHOT_UNKNOWN_SYMBOL = 1, // Not (yet) seen by the gateway
+  SNAPSHOT_BUSY = 2,           // Book kept changing, retry
+  SNAPSHOT_BAD_REQUEST = 3,
+};
+
+struct __attribute__((packed)) SnapshotRequest {
+  uint32_t magic;
+  uint32_t symbol_id;  // Or SNAPSHOT_BY_NAME
+  uint16_t max_levels; // Per side, 0 = all (up to SNAPSHOT_MAX_LEVELS)
+  uint8_t exchange_id; // SNAPSHOT_BY_NAME only
+  uint8_t name_len;    // SNAPSHOT_BY_NAME only: name bytes that follow
+};
+
+struct __attribute__((packed)) SnapshotResponse {
+  uint32_t magic;
+  uint16_t status;
+  uint16_t channel_id; // Channel the symbol is published on
+  uint32_t symbol_id;
+  uint8_t exchange_id;
+  uint8_t name_len;
+  uint16_t flags;          // SNAPSHOT_FLAG_*
+  uint64_t seq_num;        // Last datagram reflected in the snapshot
+  uint64_t exchange_ts_ns; // Exchange time of the last applied update
+  uint16_t bid_count;
+  uint16_t ask_count;
+  uint32_t reserved2;
+};
+
+struct __attribute__((packed)) SnapshotLevel {
+  uint64_t price_int;
+  uint64_t quantity; // Fixed-point, FEED_QTY_SCALE
+};
+
+} // namespace aero
+
+#endif /* AERO_FEED_PROTOCOL_H */
@@ -0,0 +1,827 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 Project AERO.
+ */
+
+/**
+ * @file feed_receiver.h
+ * @brief UDP feed consumer: decoder, local books and latency (header-only)
+ *
+ * The reference way to consume the feed described in aero/feed_protocol.h,
+ * both the full (v2) and the compact (v3) format:
+ *
+ *   - FeedReceiver reads up to BATCH datagrams per recvmmsg() call into
+ *     fixed buffers, with kernel receive timestamps when available
+ *   - feed_decode() parses headers in place; levels are decoded from the
+ *     receive buffer straight into the book, with no intermediate copies
+ *   - one FeedBook per symbol, kept as flat arrays sorted best first
+ *   - per-channel sequence tracking: datagrams that arrive ahead of a gap
+ *     are held for a short window (set_reorder_window()) and applied in
+ *     seq order once the gap is filled by a late datagram, a retransmit or
+ *     FEC; a gap still open when the window runs out is skipped, and the
+ *     channel's books are flagged stale until their next snapshot (or fill
+ *     them from the gap-fill / snapshot services)
+ *   - FEC parity datagrams (aero/feed_fec.h) go to a FeedFecDecoder per
+ *     channel, and the datagrams it rebuilds fill gaps like late arrivals
+ *   - gateway-to-consumer latency: kernel receive time minus the gateway
+ *     send time in the header, both CLOCK_REALTIME, so across hosts it is
+ *     only as good as their clock sync (PTP)
+ *
+ * Chunks of a split book (FEED_FLAG_CHUNKED) are applied as they arrive,
+ * which is valid for every chunk on its own; use FeedChunkAssembler
+ * (aero/feed_chunk.h) instead for whole-book semantics.
+ *
+ * Minimal consumer:
+ *
+ *   aero::FeedReceiver rx;
+ *   if (!rx.open("239.10.0.1", 13988)) { perror(rx.last_error()); ... }
+ *   for (;;)
+ *     rx.poll([](const aero::FeedBook &book, const aero::FeedDatagram &d) {
+ *       if (!book.stale() && !book.bids().empty()) use(book.bids()[0]);
+ *     });
+ *
+ * Not thread-safe; use one receiver per thread.
+ */
+
+#ifndef AERO_FEED_RECEIVER_H
+#define AERO_FEED_RECEIVER_H
+
+#include "aero/feed_fec.h"
+#include "aero/feed_protocol.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <netinet/in.h>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief One feed datagram, decoded in place
+ *
+ * Pointers and views refer to the receive buffer and are only valid until
+ * the next poll().
+ */
+struct FeedDatagram {
+  uint16_t version = 0; // UDP_FEED_VERSION or UDP_FEED_VERSION_COMPACT
+  uint8_t msg_type = 0; // FEED_MSG_*
+  uint8_t exchange_id = 0;
+  uint16_t channel = 0;
+  uint16_t flags = 0; // FEED_FLAG_*
+  uint64_t seq = 0;
+  uint64_t timestamp_ns = 0; // Gateway send time (CLOCK_REALTIME)
+  uint64_t symbol_key = 0;   // See feed_symbol_key()
+  uint32_t symbol_id = 0;    // Compact only
+  std::string_view symbol;   // Full format, or compact symbol definition
+  uint16_t chunk_index = 0;
+  uint16_t chunk_count = 0; // 0 = not chunked
+  uint32_t bid_count = 0;
+  uint32_t ask_count = 0;
+  uint64_t tick = 0; // Compact symbol definition only
+
+  // Levels: UdpPriceLevel array (full) or varints after the base price
+  // (compact)
+  const uint8_t *levels = nullptr;
+  size_t levels_len = 0;
+  uint64_t base_ticks = 0; // Compact only
+};
+
+/**
+ * @brief Parse a feed data datagram without copying it
+ * @return false if it is not one (FEC parity, other traffic) or truncated
+ */
+inline bool feed_decode(const uint8_t *data, size_t len, FeedDatagram &d) {
+  if (len < sizeof(CompactHeader))
+    return false;
+  uint32_t magic;
+  uint16_t version;
+  std::memcpy(&magic, data, sizeof(magic));
+  std::memcpy(&version, data + offsetof(UdpMarketHeader, version),
+              sizeof(version));
+  if (ntohl(magic) != UDP_FEED_MAGIC)
+    return false;
+  d.version = ntohs(version);
+
+  if (d.version == UDP_FEED_VERSION) {
+    if (len < sizeof(UdpMarketHeader))
+      return false;
+    UdpMarketHeader h;
+    std::memcpy(&h, data, sizeof(h));
+    uint32_t symbol_len = ntohl(h.symbol_len);
+    d.msg_type = h.msg_type;
+    d.exchange_id = h.exchange_id;
+    d.channel = ntohs(h.channel_id);
+    d.flags = ntohs(h.flags);
+    d.seq = __builtin_bswap64(h.seq_num);
+    d.timestamp_ns = __builtin_bswap64(h.timestamp_ns);
+    d.bid_count = ntohs(h.bid_count);
+    d.ask_count = ntohs(h.ask_count);
+    bool chunked = d.flags & FEED_FLAG_CHUNKED;
+    d.chunk_index = chunked ? ntohs(h.chunk_index) : 0;
+    d.chunk_count = chunked ? ntohs(h.chunk_count) : 0;
+    d.symbol_id = 0;
+    d.tick = 0;
+    d.base_ticks = 0;
+
+    size_t body = len - sizeof(h);
+    size_t levels =
+        (size_t(d.bid_count) + d.ask_count) * sizeof(UdpPriceLevel);
+    if (symbol_len > body || levels > body - symbol_len)
+      return false;
+    const uint8_t *sym = data + sizeof(h);
+    d.symbol = std::string_view(reinterpret_cast<const char *>(sym),
+                                symbol_len);
+    d.symbol_key = feed_symbol_key(h.exchange_id, sym, symbol_len);
+    d.levels = sym + symbol_len;
+    d.levels_len = levels;
+    return true;
+  }
+
+  if (d.version != UDP_FEED_VERSION_COMPACT)
+    return false;
+  CompactHeader h;
+  std::memcpy(&h, data, sizeof(h)); // Little-endian fields, x86 host
+  d.msg_type = h.msg_type;
+  d.exchange_id = h.exchange_id;
+  d.channel = h.channel_id;
+  d.flags = h.flags;
+  d.symbol_id = h.symbol_id;
+  d.seq = h.seq_num;
+  d.timestamp_ns = h.timestamp_ns;
+  d.symbol_key = (uint64_t(h.exchange_id) << 32) | h.symbol_id;
+  d.symbol = {};
+  d.chunk_index = d.chunk_count = 0;
+  d.bid_count = d.ask_count = 0;
+  d.tick = 0;
+
+  const uint8_t *p = data + sizeof(h);
+  size_t avail = len - sizeof(h);
+
+  if (d.msg_type == FEED_MSG_SYMBOL_DEF) {
+    CompactSymbolDef def;
+    if (avail < sizeof(def))
+      return false;
+    std::memcpy(&def, p, sizeof(def));
+    if (def.name_len > avail - sizeof(def))
+      return false;
+    d.tick = def.tick;
+    d.symbol = std::string_view(
+        reinterpret_cast<const char *>(p + sizeof(def)), def.name_len);
+    d.levels = nullptr;
+    d.levels_len = 0;
+    return true;
+  }
+
+  auto next = [&](uint64_t &v) {
+    size_t n = feed_get_varint(p, avail, v);
+    p += n;
+    avail -= n;
+    return n != 0;
+  };
+  uint64_t v;
+  if (d.flags & FEED_FLAG_CHUNKED) {
+    uint64_t count;
+    if (!next(v) || !next(count) || count == 0 || v >= count ||
+        count > UINT16_MAX)
+      return false;
+    d.chunk_index = static_cast<uint16_t>(v);
+    d.chunk_count = static_cast<uint16_t>(count);
+  }
+  uint64_t bids, asks;
+  if (!next(bids) || !next(asks) || !next(d.base_ticks))
+    return false;
+  if (bids + asks > avail / 2) // At least two bytes per level
+    return false;
+  d.bid_count = static_cast<uint32_t>(bids);
+  d.ask_count = static_cast<uint32_t>(asks);
+  d.levels = p;
+  d.levels_len = avail;
+  return true;
+}
+
+/**
+ * @brief Call `f(is_bid, price_int, qty)` for every level of a datagram,
+ *        bids then asks, best first
+ *
+ * @param tick Price tick of the symbol (compact only, from its definition)
+ * @return false if the level data is truncated
+ */
+template <typename F>
+inline bool feed_for_each_level(const FeedDatagram &d, uint64_t tick, F &&f) {
+  uint32_t total = d.bid_count + d.ask_count;
+  if (d.version == UDP_FEED_VERSION) {
+    const uint8_t *p = d.levels;
+    for (uint32_t i = 0; i < total; i++, p += sizeof(UdpPriceLevel)) {
+      uint64_t price, qty_bits;
+      std::memcpy(&price, p, sizeof(price));
+      std::memcpy(&qty_bits, p + sizeof(price), sizeof(qty_bits));
+      qty_bits = __builtin_bswap64(qty_bits);
+      double qty;
+      std::memcpy(&qty, &qty_bits, sizeof(qty));
+      f(i < d.bid_count, __builtin_bswap64(price), qty);
+    }
+    return true;
+  }
+
+  const uint8_t *p = d.levels;
+  size_t avail = d.levels_len;
+  int64_t ticks = static_cast<int64_t>(d.base_ticks);
+  for (uint32_t i = 0; i < total; i++) {
+    uint64_t delta, qty;
+    size_t n = feed_get_varint(p, avail, delta);
+    size_t m = n ? feed_get_varint(p + n, avail - n, qty) : 0;
+    if (m == 0)
+      return false;
+    p += n + m;
+    avail -= n + m;
+    ticks += feed_unzigzag(delta);
+    f(i < d.bid_count, static_cast<uint64_t>(ticks) * tick,
+      static_cast<double>(qty) / FEED_QTY_SCALE);
+  }
+  return true;
+}
+
+/**
+ * @brief Consumer-side book of one symbol
+ */
+class FeedBook {
+public:
+  struct Level {
+    uint64_t price_int; // 1e8 units
+    double qty;
+  };
+
+  std::span<const Level> bids() const { return bids_; } // Best first
+  std::span<const Level> asks() const { return asks_; } // Best first
+
+  const std::string &symbol() const { return symbol_; }
+  uint8_t exchange_id() const { return exchange_id_; }
+  uint16_t channel() const { return channel_; }
+  uint64_t last_seq() const { return last_seq_; }
+  uint64_t timestamp_ns() const { return timestamp_ns_; } // Gateway time
+
+  /**
+   * @brief No snapshot since start, or a gap since the last one
+   *
+   * Deltas are still applied to a stale book; levels that changed in the
+   * lost datagrams may be wrong until the next snapshot.
+   */
+  bool stale() const { return stale_; }
+
+  void clear() {
+    bids_.clear();
+    asks_.clear();
+  }
+
+  /**
+   * @brief Set a level's quantity; qty <= 0 removes it
+   */
+  void set(bool is_bid, uint64_t price_int, double qty) {
+    std::vector<Level> &side = is_bid ? bids_ : asks_;
+    auto it = std::lower_bound(side.begin(), side.end(), price_int,
+                               [is_bid](const Level &l, uint64_t price) {
+                                 return is_bid ? l.price_int > price
+                                               : l.price_int < price;
+                               });
+    bool found = it != side.end() && it->price_int == price_int;
+    if (qty <= 0) {
+      if (found)
+        side.erase(it);
+    } else if (found) {
+      it->qty = qty;
+    } else {
+      side.insert(it, Level{price_int, qty});
+    }
+  }
+
+private:
+  friend class FeedReceiver;
+
+  std::vector<Level> bids_;
+  std::vector<Level> asks_;
+  std::string symbol_;
+  uint8_t exchange_id_ = 0;
+  uint16_t channel_ = 0;
+  uint64_t last_seq_ = 0;
+  uint64_t timestamp_ns_ = 0;
+  bool stale_ = true;
+};
+
+/**
+ * @brief Log-linear latency histogram (ns)
+ *
+ * 8 sub-buckets per power of two (~12% resolution). Negative samples
+ * (clock skew between hosts) are counted apart and not recorded.
+ */
+class FeedLatencyStats {
+public:
+  static constexpr int SUB_BITS = 3;
+  static constexpr int SUB = 1 << SUB_BITS;
+  static constexpr int BUCKETS = (64 - SUB_BITS + 1) * SUB;
+
+  void record(int64_t ns) {
+    if (ns < 0) {
+      negative_++;
+      return;
+    }
+    uint64_t v = static_cast<uint64_t>(ns);
+    buckets_[bucket(v)]++;
+    count_++;
+    sum_ += v;
+    max_ = std::max(max_, v);
+    min_ = std::min(min_, v);
+  }
+
+  uint64_t count() const { return count_; }
+  uint64_t negative() const { return negative_; }
+  uint64_t min_ns() const { return count_ ? min_ : 0; }
+  uint64_t max_ns() const { return max_; }
+  uint64_t mean_ns() const { return count_ ? sum_ / count_ : 0; }
+
+  /**
+   * @brief Lower bound of the bucket holding quantile q (0..1)
+   */
+  uint64_t percentile_ns(double q) const {
+    if (count_ == 0)
+      return 0;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count_));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+      seen += buckets_[i];
+      if (seen > rank)
+        return lower_bound(i);
+    }
+    return max_;
+  }
+
+  void reset() { *this = FeedLatencyStats(); }
+
+private:
+  static int bucket(uint64_t v) {
+    if (v < SUB)
+      return static_cast<int>(v);
+    int msb = 63 - __builtin_clzll(v);
+    int shift = msb - SUB_BITS;
+    return (shift + 1) * SUB + static_cast<int>((v >> shift) & (SUB - 1));
+  }
+  static uint64_t lower_bound(int i) {
+    if (i < SUB)
+      return static_cast<uint64_t>(i);
+    int shift = i / SUB - 1;
+    return (uint64_t(SUB) | uint64_t(i % SUB)) << shift;
+  }
+
+  std::array<uint64_t, BUCKETS> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t negative_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = UINT64_MAX;
+  uint64_t max_ = 0;
+};
+
+/**
+ * @brief Receiver counters
+ */
+struct FeedReceiverStats {
+  uint64_t datagrams = 0;  // Feed data datagrams accepted
+  uint64_t syscalls = 0;   // recvmmsg() calls that returned data
+  uint64_t gaps = 0;       // Sequence breaks skipped
+  uint64_t lost = 0;       // Datagrams missing in those breaks
+  uint64_t duplicates = 0; // Old or repeated seq, skipped
+  uint64_t reordered = 0;  // Held behind a gap, then applied in order
+  uint64_t parity = 0;     // FEC parity datagrams received
+  uint64_t recovered = 0;  // Data datagrams rebuilt from parity
+  uint64_t malformed = 0;  // Not decodable
+  uint64_t truncated = 0;  // Larger than MAX_DATAGRAM
+  uint64_t undefined = 0;  // Compact book before its symbol definition
+};
+
+/**
+ * @brief recvmmsg()-based feed consumer maintaining per-symbol books
+ */
+class FeedReceiver {
+public:
+  static constexpr size_t BATCH = 64;           // Datagrams per recvmmsg()
+  static constexpr size_t MAX_DATAGRAM = 9216; // Receive buffer per datagram
+  // Default gap window: one full FEC block with its parity, and the
+  // publisher's parity delay for a partial block
+  static constexpr size_t REORDER_DATAGRAMS = 128;
+  static constexpr uint64_t REORDER_NS = 2000000;
+
+  FeedReceiver() : buffers_(BATCH * MAX_DATAGRAM) {}
+  ~FeedReceiver() { close(); }
+
+  FeedReceiver(const FeedReceiver &) = delete;
+  FeedReceiver &operator=(const FeedReceiver &) = delete;
+
+  /**
+   * @brief Bind to the feed port and, for a multicast address, join it
+   *
+   * @param address Unicast address to bind, or multicast group to join
+   * @param port Feed port (channel i of a unicast feed is port + i)
+   * @param iface Local interface IP for multicast ("" = default)
+   * @return false on failure, see last_error()
+   */
+  bool open(const std::string &address, uint16_t port,
+            const std::string &iface = "") {
+    close();
+    in_addr addr{};
+    if (inet_pton(AF_INET, address.c_str(), &addr) != 1)
+      return fail("invalid address", false);
+    iface_.s_addr = htonl(INADDR_ANY);
+    if (!iface.empty() && inet_pton(AF_INET, iface.c_str(), &iface_) != 1)
+      return fail("invalid interface address", false);
+
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0)
+      return fail("socket");
+    int one = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    int rcvbuf = 32 << 20; // Capped by net.core.rmem_max
+    setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    kernel_ts_ =
+        setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) == 0;
+
+    bool mcast = IN_MULTICAST(ntohl(addr.s_addr));
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(port);
+    local.sin_addr = addr; // A group binds to itself: only its traffic
+    if (::bind(fd_, reinterpret_cast<sockaddr *>(&local), sizeof(local)) < 0)
+      return fail("bind");
+    if (mcast && !join(address))
+      return false;
+
+    for (size_t i = 0; i < BATCH; i++) {
+      iovs_[i].iov_base = buffers_.data() + i * MAX_DATAGRAM;
+      iovs_[i].iov_len = MAX_DATAGRAM;
+      msgs_[i].msg_hdr.msg_iov = &iovs_[i];
+      msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Also receive another multicast group on the same port
+   */
+  bool join(const std::string &group) {
+    ip_mreq mreq{};
+    if (inet_pton(AF_INET, group.c_str(), &mreq.imr_multiaddr) != 1)
+      return fail("invalid group", false);
+    mreq.imr_interface = iface_;
+    if (setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) <
+        0)
+      return fail("IP_ADD_MEMBERSHIP");
+    return true;
+  }
+
+  void close() {
+    if (fd_ >= 0)
+      ::close(fd_);
+    fd_ = -1;
+  }
+
+  int fd() const { return fd_; }
+  const char *last_error() const { return error_.c_str(); }
+
+  /**
+   * @brief How long a gap may wait to be filled before it is skipped
+   *
+   * Datagrams behind the gap are held meanwhile, so this bounds the delay
+   * a loss adds. The gap is skipped once more than `max_datagrams` seqs lie
+   * beyond it or it has been open for `max_ns`. (0, 0) skips every gap at
+   * once, applying datagrams in arrival order.
+   */
+  void set_reorder_window(size_t max_datagrams, uint64_t max_ns) {
+    reorder_datagrams_ = max_datagrams;
+    reorder_ns_ = max_ns;
+  }
+
+  /**
+   * @brief Receive and apply one batch of datagrams (non-blocking)
+   *
+   * Calls `on_update(const FeedBook &, const FeedDatagram &)` after each
+   * book datagram has been applied.
+   *
+   * @return Datagrams received (0 if none were pending, -1 on error)
+   */
+  template <typename F> int poll(F &&on_update) {
+    for (size_t i = 0; i < BATCH; i++) {
+      msgs_[i].msg_hdr.msg_control = ctrl_[i].data();
+      msgs_[i].msg_hdr.msg_controllen = kernel_ts_ ? ctrl_[i].size() : 0;
+      msgs_[i].msg_hdr.msg_flags = 0;
+    }
+    int n = recvmmsg(fd_, msgs_.data(), BATCH, MSG_DONTWAIT, nullptr);
+    if (n <= 0) {
+      if (held_ > 0)
+        expire(now_ns(), on_update); // Gaps nothing more will fill
+      return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : n;
+    }
+    stats_.syscalls++;
+
+    uint64_t batch_ns = now_ns();
+    for (int i = 0; i < n; i++) {
+      const msghdr &h = msgs_[i].msg_hdr;
+      if (h.msg_flags & MSG_TRUNC) {
+        stats_.truncated++;
+        continue;
+      }
+      uint64_t rx_ns = kernel_ts_ ? rx_timestamp(h) : 0;
+      on_datagram(static_cast<const uint8_t *>(iovs_[i].iov_base),
+                  msgs_[i].msg_len, rx_ns ? rx_ns : batch_ns, on_update);
+    }
+    if (held_ > 0)
+      expire(batch_ns, on_update);
+    return n;
+  }
+
+  /**
+   * @brief Decode and apply one datagram received by other means (a
+   *        gap-fill response, a capture file)
+   *
+   * @param rx_ns Receive time (CLOCK_REALTIME ns), for latency and the
+   *        reorder window
+   */
+  template <typename F>
+  void on_datagram(const uint8_t *data, size_t len, uint64_t rx_ns,
+                   F &&on_update) {
+    FeedDatagram &d = datagram_;
+    if (!feed_decode(data, len, d)) {
+      if (len >= sizeof(FeedFecHeader) && load_be32(data) == FEED_FEC_MAGIC) {
+        stats_.parity++;
+        on_parity(data, len, rx_ns, on_update);
+      } else {
+        stats_.malformed++;
+      }
+      return;
+    }
+
+    // Rebuilt datagrams are sequenced from their own decode, leaving d
+    // intact for this one
+    if (FeedFecDecoder *fec = channel(d.channel).fec.get())
+      fec->on_datagram(data, len, [&](const uint8_t *r, size_t r_len) {
+        on_recovered(r, r_len, rx_ns, on_update);
+      });
+    sequence(d, data, len, rx_ns, on_update);
+  }
+
+  /**
+   * @brief Skip every open gap and apply the datagrams held behind it
+   *
+   * For a consumer feeding on_datagram() itself that has nothing more to
+   * give (end of a capture file).
+   */
+  template <typename F> void flush(F &&on_update) {
+    for (uint16_t c = 0; c < channels_.size(); c++)
+      while (!channels_[c].held.empty())
+        skip_gap(c, on_update);
+  }
+
+  /**
+   * @brief Book by key (see FeedDatagram::symbol_key), or nullptr
+   */
+  const FeedBook *book(uint64_t symbol_key) const {
+    auto it = books_.find(symbol_key);
+    return it == books_.end() ? nullptr : &it->second;
+  }
+
+  /**
+   * @brief Call `f(const FeedBook &)` for every book
+   */
+  template <typename F> void for_each_book(F &&f) const {
+    for (const auto &[key, book] : books_)
+      f(book);
+  }
+
+  const FeedReceiverStats &stats() const { return stats_; }
+  FeedLatencyStats &latency() { return latency_; }
+
+private:
+  struct SymbolDef {
+    uint64_t tick = 0;
+    std::string name;
+  };
+
+  bool fail(const char *what, bool sys = true) {
+    error_ = what;
+    if (sys)
+      error_ += std::string(": ") + std::strerror(errno);
+    close();
+    return false;
+  }
+
+  static uint64_t now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+  }
+
+  static uint64_t rx_timestamp(const msghdr &h) {
+    for (cmsghdr *c = CMSG_FIRSTHDR(&h); c != nullptr;
+         c = CMSG_NXTHDR(const_cast<msghdr *>(&h), c)) {
+      if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS) {
+        timespec ts;
+        std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+        return uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+      }
+    }
+    return 0;
+  }
+
+  struct Held {
+    std::vector<uint8_t> bytes;
+    uint64_t rx_ns;
+  };
+
+  struct ChannelState {
+    uint64_t next_seq = 0;               // 0 = unseen
+    std::map<uint64_t, Held> held;       // Arrived beyond a gap, by seq
+    std::unique_ptr<FeedFecDecoder> fec; // From the first parity datagram
+  };
+
+  ChannelState &channel(uint16_t c) {
+    if (c >= channels_.size())
+      channels_.resize(c + 1);
+    return channels_[c];
+  }
+
+  static uint32_t load_be32(const uint8_t *p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+           (uint32_t(p[2]) << 8) | p[3];
+  }
+
+  template <typename F>
+  void on_parity(const uint8_t *data, size_t len, uint64_t rx_ns,
+                 F &&on_update) {
+    const uint8_t *c = data + offsetof(FeedFecHeader, channel_id);
+    ChannelState &ch = channel(static_cast<uint16_t>((c[0] << 8) | c[1]));
+    if (!ch.fec)
+      ch.fec = std::make_unique<FeedFecDecoder>();
+    ch.fec->on_datagram(data, len, [&](const uint8_t *r, size_t r_len) {
+      on_recovered(r, r_len, rx_ns, on_update);
+    });
+  }
+
+  template <typename F>
+  void on_recovered(const uint8_t *data, size_t len, uint64_t rx_ns,
+                    F &&on_update) {
+    FeedDatagram d;
+    if (!feed_decode(data, len, d)) {
+      stats_.malformed++;
+      return;
+    }
+    stats_.recovered++;
+    sequence(d, data, len, rx_ns, on_update);
+  }
+
+  // Apply in seq order: a datagram beyond a gap waits until the gap is
+  // filled or the reorder window runs out
+  template <typename F>
+  void sequence(const FeedDatagram &d, const uint8_t *data, size_t len,
+                uint64_t rx_ns, F &&on_update) {
+    uint16_t c = d.channel;
+    ChannelState &ch = channel(c);
+    if (ch.next_seq != 0 && d.seq < ch.next_seq) {
+      stats_.duplicates++;
+      return;
+    }
+    if (ch.next_seq == 0 || d.seq == ch.next_seq) {
+      ch.next_seq = d.seq + 1;
+      apply(d, rx_ns, on_update);
+      release(c, on_update);
+      return;
+    }
+
+    if (!ch.held.try_emplace(d.seq, Held{{data, data + len}, rx_ns}).second) {
+      stats_.duplicates++;
+      return;
+    }
+    held_++;
+    while (!channels_[c].held.empty() &&
+           (channels_[c].held.rbegin()->first - channels_[c].next_seq >=
+                reorder_datagrams_ ||
+            gap_expired(channels_[c], rx_ns)))
+      skip_gap(c, on_update);
+  }
+
+  bool gap_expired(const ChannelState &ch, uint64_t now) const {
+    uint64_t since = ch.held.begin()->second.rx_ns;
+    return now >= since && now - since >= reorder_ns_;
+  }
+
+  template <typename F> void expire(uint64_t now, F &&on_update) {
+    for (uint16_t c = 0; c < channels_.size(); c++)
+      while (!channels_[c].held.empty() && gap_expired(channels_[c], now))
+        skip_gap(c, on_update);
+  }
+
+  // Give up on the lowest gap of a channel
+  template <typename F> void skip_gap(uint16_t c, F &&on_update) {
+    ChannelState &ch = channels_[c];
+    uint64_t first = ch.held.begin()->first;
+    stats_.gaps++;
+    stats_.lost += first - ch.next_seq;
+    // Which books the lost datagrams touched is unknown
+    for (auto &[key, book] : books_)
+      if (book.channel_ == c)
+        book.stale_ = true;
+    ch.next_seq = first;
+    release(c, on_update);
+  }
+
+  // Apply the held datagrams that continue the channel's sequence
+  template <typename F> void release(uint16_t c, F &&on_update) {
+    std::map<uint64_t, Held> &held = channels_[c].held;
+    while (!held.empty() && held.begin()->first == channels_[c].next_seq) {
+      auto node = held.extract(held.begin());
+      held_--;
+      channels_[c].next_seq++;
+      const std::vector<uint8_t> &bytes = node.mapped().bytes;
+      FeedDatagram d;
+      if (!feed_decode(bytes.data(), bytes.size(), d))
+        continue;
+      stats_.reordered++;
+      apply(d, node.mapped().rx_ns, on_update);
+    }
+  }
+
+  template <typename F>
+  void apply(const FeedDatagram &d, uint64_t rx_ns, F &&on_update) {
+    stats_.datagrams++;
+    latency_.record(static_cast<int64_t>(rx_ns - d.timestamp_ns));
+
+    if (d.msg_type == FEED_MSG_SYMBOL_DEF) {
+      SymbolDef &def = defs_[d.symbol_key];
+      def.tick = d.tick;
+      def.name.assign(d.symbol);
+      return;
+    }
+
+    uint64_t tick = 0;
+    if (d.version == UDP_FEED_VERSION_COMPACT) {
+      auto it = defs_.find(d.symbol_key);
+      if (it == defs_.end() || it->second.tick == 0) {
+        stats_.undefined++;
+        return;
+      }
+      tick = it->second.tick;
+    }
+
+    FeedBook &book = books_[d.symbol_key];
+    if (book.symbol_.empty()) {
+      book.symbol_ = d.version == UDP_FEED_VERSION_COMPACT
+                         ? defs_[d.symbol_key].name
+                         : std::string(d.symbol);
+      book.exchange_id_ = d.exchange_id;
+    }
+    book.channel_ = d.channel;
+    if (d.msg_type == FEED_MSG_SNAPSHOT) {
+      book.clear();
+      book.stale_ = false;
+    }
+    if (!feed_for_each_level(d, tick,
+                             [&book](bool is_bid, uint64_t price, double qty) {
+                               book.set(is_bid, price, qty);
+                             }))
+      stats_.malformed++;
+    book.last_seq_ = d.seq;
+    book.timestamp_ns_ = d.timestamp_ns;
+    on_update(static_cast<const FeedBook &>(book), d);
+  }
+
+  int fd_ = -1;
+  in_addr iface_{};
+  bool kernel_ts_ = false;
+  std::string error_;
+
+  std::vector<uint8_t> buffers_; // BATCH x MAX_DATAGRAM
+  std::array<mmsghdr, BATCH> msgs_{};
+  std::array<iovec, BATCH> iovs_{};
+  std::array<std::array<char, CMSG_SPACE(sizeof(timespec))>, BATCH> ctrl_{};
+
+  FeedDatagram datagram_;
+  std::unordered_map<uint64_t, FeedBook> books_;
+  std::unordered_map<uint64_t, SymbolDef> defs_; // Compact symbol ids
+  std::vector<ChannelState> channels_;           // By channel id
+  size_t held_ = 0;                              // Over all channels
+  size_t reorder_datagrams_ = REORDER_DATAGRAMS;
+  uint64_t reorder_ns_ = REORDER_NS;
+  FeedReceiverStats stats_;
+  FeedLatencyStats latency_;
+};
+
+} // namespace aero
+
+#endif // AERO_FEED_RECEIVER_H
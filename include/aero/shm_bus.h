@@ -0,0 +1,296 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 Project AERO.
+ */
+
+/**
+ * @file shm_bus.h
+ * @brief Shared-memory market data bus: layout and reader (C and C++)
+ *
+ * One producer (the gateway feed handler) writes normalized book, BBO and
+ * trade events into a ring of fixed-size slots in a file under /dev/shm (or
+ * a hugetlbfs mount). Any number of readers map the file read-only and follow
+ * the ring with their own cursor. The producer never waits for readers: a
+ * reader that falls more than one ring behind is told it overran and is
+ * moved to the live head.
+ *
+ * Each slot starts with its sequence number, written last by the producer
+ * (release) and checked before and after the copy by readers, so a slot
+ * that was overwritten during the copy is detected.
+ *
+ * File layout:
+ *   aero_shm_bus_header                 (4096 bytes)
+ *   aero_shm_symbol x symbol_capacity   (index = symbol id)
+ *   slot x slot_count                   (slot_size bytes each)
+ *
+ * All prices are in 1e8 units and all quantities are fixed-point 1e8.
+ *
+ * Minimal reader:
+ *
+ *   aero_shm_reader r;
+ *   if (aero_shm_reader_open(&r, "/dev/shm/aero_md_bus") == 0) {
+ *     uint8_t buf[4096];
+ *     for (;;) {
+ *       int n = aero_shm_reader_poll(&r, buf, sizeof(buf));
+ *       if (n > 0) handle((const aero_shm_event *)buf);
+ *     }
+ *   }
+ */
+
+#ifndef AERO_SHM_BUS_H
+#define AERO_SHM_BUS_H
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AERO_SHM_BUS_MAGIC 0x314D48534F524541ULL /* "AEROSHM1" */
+#define AERO_SHM_BUS_VERSION 1
+#define AERO_SHM_BUS_HEADER_SIZE 4096
+
+/* Largest slot: its event length still fits aero_shm_event::len */
+#define AERO_SHM_MAX_SLOT_SIZE 65536
+
+/* Marker stored in a slot's seq while the producer rewrites it */
+#define AERO_SHM_SLOT_WRITING UINT64_MAX
+
+/* aero_shm_event::type */
+#define AERO_SHM_EV_BOOK 1 /* Followed by aero_shm_level x (bids + asks) */
+#define AERO_SHM_EV_BBO 2  /* Followed by one aero_shm_bbo */
+#define AERO_SHM_EV_TRADE 3 /* Followed by one aero_shm_trade */
+#define AERO_SHM_EV_TRADE_FLOW 4 /* Followed by one aero_shm_trade_flow */
+
+/* Time windows per aero_shm_trade_flow */
+#define AERO_SHM_FLOW_WINDOWS 3
+
+/* aero_shm_event::flags */
+#define AERO_SHM_FLAG_SNAPSHOT 0x01  /* Book replaces the previous state */
+#define AERO_SHM_FLAG_TRUNCATED 0x02 /* Levels did not fit in one slot */
+
+typedef struct {
+  uint64_t magic; /* Written last when the producer finishes setup */
+  uint32_t version;
+  uint32_t slot_size; /* Bytes per slot, multiple of 64, at most
+                         AERO_SHM_MAX_SLOT_SIZE */
+  uint64_t slot_count; /* Power of two */
+  uint32_t symbol_capacity;
+  uint32_t producer_pid;
+  uint64_t session_ns; /* Producer start time (CLOCK_REALTIME) */
+  uint64_t symbols_offset;
+  uint64_t slots_offset;
+  uint8_t pad0[64 - 56];
+
+  /* Own cache line: next sequence the producer will write (release) */
+  uint64_t write_seq;
+  uint8_t pad1[64 - 8];
+} aero_shm_bus_header;
+
+typedef struct {
+  uint32_t valid; /* Set to 1 (release) once the entry is filled */
+  uint8_t exchange_id;
+  uint8_t reserved[3];
+  char name[56]; /* NUL-terminated */
+} aero_shm_symbol;
+
+typedef struct {
+  uint16_t type; /* AERO_SHM_EV_* */
+  uint16_t len;  /* Bytes of this event including the header */
+  uint32_t symbol_id;
+  uint8_t exchange_id;
+  uint8_t flags; /* AERO_SHM_FLAG_* */
+  uint16_t bid_count;
+  uint16_t ask_count;
+  uint16_t reserved;
+  uint64_t exchange_ts_ns; /* Exchange event time */
+  uint64_t rx_tsc;         /* Gateway TSC at frame receive */
+  uint64_t publish_tsc;    /* Gateway TSC when written to the bus */
+} aero_shm_event;
+
+typedef struct {
+  uint64_t price;
+  uint64_t qty; /* 0 = level removed (deltas) */
+} aero_shm_level;
+
+typedef struct {
+  uint64_t bid_price;
+  uint64_t bid_qty;
+  uint64_t ask_price;
+  uint64_t ask_qty;
+} aero_shm_bbo;
+
+typedef struct {
+  uint64_t price;
+  uint64_t qty;
+  uint8_t side; /* Aggressor: 0 buy, 1 sell */
+  uint8_t reserved[7];
+} aero_shm_trade;
+
+/* Rolling aggregates of a symbol's trades as of its last one, per time
+ * window; entries from `windows` on are zero */
+typedef struct {
+  uint32_t windows;
+  uint32_t window_ms[AERO_SHM_FLOW_WINDOWS];
+  uint32_t trades[AERO_SHM_FLOW_WINDOWS];
+  uint32_t reserved;
+  uint64_t vwap[AERO_SHM_FLOW_WINDOWS]; /* 0 without trades */
+  uint64_t buy_qty[AERO_SHM_FLOW_WINDOWS]; /* Aggressor buys */
+  uint64_t sell_qty[AERO_SHM_FLOW_WINDOWS];
+} aero_shm_trade_flow;
+
+/* Offset of the event inside a slot (after the slot's seq) */
+#define AERO_SHM_SLOT_HDR 8
+
+static inline const aero_shm_level *
+aero_shm_event_levels(const aero_shm_event *ev) {
+  return (const aero_shm_level *)(ev + 1);
+}
+
+static inline const aero_shm_bbo *aero_shm_event_bbo(const aero_shm_event *ev) {
+  return (const aero_shm_bbo *)(ev + 1);
+}
+
+static inline const aero_shm_trade *
+aero_shm_event_trade(const aero_shm_event *ev) {
+  return (const aero_shm_trade *)(ev + 1);
+}
+
+static inline const aero_shm_trade_flow *
+aero_shm_event_trade_flow(const aero_shm_event *ev) {
+  return (const aero_shm_trade_flow *)(ev + 1);
+}
+
+/* ------------------------------------------------------------------------ */
+/* Reader                                                                   */
+/* ------------------------------------------------------------------------ */
+
+typedef struct {
+  const uint8_t *base;
+  size_t map_size;
+  const aero_shm_bus_header *hdr;
+  const aero_shm_symbol *symbols;
+  const uint8_t *slots;
+  uint64_t mask;
+  uint64_t cursor;   /* Next sequence to read */
+  uint64_t overruns; /* Times the reader was lapped and resynced */
+  uint64_t dropped;  /* Events skipped: larger than buf_len or the slot */
+  ino_t inode;
+} aero_shm_reader;
+
+/**
+ * Map the bus and position the cursor at the live head.
+ * Returns 0 on success, -1 if the file is missing or not (yet) a valid bus.
+ */
+static inline int aero_shm_reader_open(aero_shm_reader *r, const char *path) {
+  memset(r, 0, sizeof(*r));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || (size_t)st.st_size < AERO_SHM_BUS_HEADER_SIZE) {
+    close(fd);
+    return -1;
+  }
+  void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED)
+    return -1;
+
+  r->base = (const uint8_t *)p;
+  r->map_size = (size_t)st.st_size;
+  r->hdr = (const aero_shm_bus_header *)p;
+  r->inode = st.st_ino;
+
+  if (__atomic_load_n(&r->hdr->magic, __ATOMIC_ACQUIRE) != AERO_SHM_BUS_MAGIC ||
+      r->hdr->version != AERO_SHM_BUS_VERSION ||
+      r->hdr->slots_offset + r->hdr->slot_count * r->hdr->slot_size >
+          r->map_size) {
+    munmap(p, r->map_size);
+    memset(r, 0, sizeof(*r));
+    return -1;
+  }
+
+  r->symbols = (const aero_shm_symbol *)(r->base + r->hdr->symbols_offset);
+  r->slots = r->base + r->hdr->slots_offset;
+  r->mask = r->hdr->slot_count - 1;
+  r->cursor = __atomic_load_n(&r->hdr->write_seq, __ATOMIC_ACQUIRE);
+  return 0;
+}
+
+static inline void aero_shm_reader_close(aero_shm_reader *r) {
+  if (r->base)
+    munmap((void *)r->base, r->map_size);
+  memset(r, 0, sizeof(*r));
+}
+
+/**
+ * Copy the next event into buf (size it to hdr->slot_size).
+ * Returns its length, 0 if nothing new, or -1 if the reader was lapped (the
+ * cursor is moved to the live head; book state must be rebuilt). An event
+ * that does not fit buf is skipped and counted in r->dropped.
+ */
+static inline int aero_shm_reader_poll(aero_shm_reader *r, void *buf,
+                                       size_t buf_len) {
+  const uint64_t c = r->cursor;
+  const uint8_t *slot = r->slots + (c & r->mask) * r->hdr->slot_size;
+  const uint64_t *slot_seq = (const uint64_t *)slot;
+
+  uint64_t s1 = __atomic_load_n(slot_seq, __ATOMIC_ACQUIRE);
+  if (s1 == c) {
+    const aero_shm_event *ev = (const aero_shm_event *)(slot + AERO_SHM_SLOT_HDR);
+    size_t len = ev->len;
+    if (len > buf_len || len > r->hdr->slot_size - AERO_SHM_SLOT_HDR)
+      len = 0;
+    if (len)
+      memcpy(buf, ev, len);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(slot_seq, __ATOMIC_RELAXED) == c) {
+      r->cursor = c + 1;
+      if (!len)
+        r->dropped++;
+      return len ? (int)len : 0;
+    }
+  } else if (s1 == AERO_SHM_SLOT_WRITING || s1 < c) {
+    /* Not written yet, unless the producer is a whole ring ahead */
+    uint64_t head = __atomic_load_n(&r->hdr->write_seq, __ATOMIC_ACQUIRE);
+    if (head <= c + r->hdr->slot_count)
+      return 0;
+  }
+
+  r->cursor = __atomic_load_n(&r->hdr->write_seq, __ATOMIC_ACQUIRE);
+  r->overruns++;
+  return -1;
+}
+
+/**
+ * Symbol behind an id, or NULL if the producer has not published it yet.
+ */
+static inline const aero_shm_symbol *
+aero_shm_reader_symbol(const aero_shm_reader *r, uint32_t id) {
+  if (id >= r->hdr->symbol_capacity)
+    return NULL;
+  const aero_shm_symbol *s = &r->symbols[id];
+  return __atomic_load_n(&s->valid, __ATOMIC_ACQUIRE) ? s : NULL;
+}
+
+/**
+ * Non-zero if the producer restarted and replaced the file; reopen then.
+ */
+static inline int aero_shm_reader_stale(const aero_shm_reader *r,
+                                        const char *path) {
+  struct stat st;
+  return stat(path, &st) < 0 || st.st_ino != r->inode;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AERO_SHM_BUS_H */
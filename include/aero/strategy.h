@@ -0,0 +1,161 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 Project AERO.
+ */
+
+/**
+ * @file strategy.h
+ * @brief In-process strategy plugin ABI (C and C++)
+ *
+ * A strategy is a shared object loaded by the gateway at startup
+ * (STRATEGY_PLUGIN=path). It runs on its own lcore, next to the books, and
+ * gets market data as callbacks instead of over the network:
+ *
+ *   on_book    every book update applied to the gateway's local book
+ *   on_bbo     after on_book, when the update changed the top of book;
+ *              alone, for a new quote on the venue's top-of-book channel
+ *   on_trade   every trade print
+ *   on_idle    when no event is pending (timers, housekeeping)
+ *
+ * The feed handler only copies each event into a lock-free ring; all
+ * callbacks run on the strategy lcore, one at a time, in feed order. A
+ * strategy that falls a full ring behind loses events (counted by the
+ * host), it never slows the feed.
+ *
+ * Depth beyond the top of book is read from the gateway's book mirror
+ * (BOOK_MIRROR_ENABLED), handed over as host->book_mirror: an in-process
+ * view of aero/book_mirror.h, already updated when the event arrives.
+ *
+ * Orders go out through host->send_order() on the exchange's WebSocket
+ * connection, and only when the gateway runs with ENABLE_EXECUTION.
+ *
+ * The plugin exports one function, found with dlsym():
+ *
+ *   int aero_strategy_init(const aero_strategy_host *host,
+ *                          aero_strategy_plugin *plugin)
+ *   {
+ *     if (host->abi_version != AERO_STRATEGY_ABI_VERSION)
+ *       return -1;
+ *     plugin->abi_version = AERO_STRATEGY_ABI_VERSION;
+ *     plugin->name = "my_strategy";
+ *     plugin->on_bbo = my_on_bbo;
+ *     return 0;
+ *   }
+ *
+ * Unused callbacks stay NULL. `host` stays valid until on_stop returns.
+ *
+ * Symbol ids match the other feeds (aero/shm_bus.h, aero/book_mirror.h,
+ * compact UDP). Prices are in 1e8 units, quantities fixed-point 1e8.
+ */
+
+#ifndef AERO_STRATEGY_H
+#define AERO_STRATEGY_H
+
+#include "book_mirror.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AERO_STRATEGY_ABI_VERSION 1
+#define AERO_STRATEGY_INIT_SYMBOL "aero_strategy_init"
+
+/* aero_strategy_book::flags */
+#define AERO_STRATEGY_FLAG_SNAPSHOT 0x01    /* Update replaced the book */
+#define AERO_STRATEGY_FLAG_BBO_CHANGED 0x02 /* on_bbo follows */
+
+/* aero_strategy_bbo::flags */
+#define AERO_STRATEGY_FLAG_BBO_CHANNEL 0x04 /* From the top-of-book channel,
+                                              * newer than the local book */
+
+typedef struct {
+  uint64_t bid_price; /* 0 when the side is empty */
+  uint64_t bid_qty;
+  uint64_t ask_price;
+  uint64_t ask_qty;
+} aero_strategy_quote;
+
+typedef struct {
+  uint32_t symbol_id;
+  uint8_t exchange_id;
+  uint8_t flags;   /* AERO_STRATEGY_FLAG_* */
+  uint16_t levels; /* Price levels in the update (saturates) */
+  uint64_t exchange_ts_ms;
+  uint64_t rx_tsc; /* Gateway receive TSC of the frame */
+  aero_strategy_quote top; /* Top of book after the update */
+} aero_strategy_book;
+
+typedef struct {
+  uint32_t symbol_id;
+  uint8_t exchange_id;
+  uint8_t flags; /* AERO_STRATEGY_FLAG_BBO_CHANNEL */
+  uint8_t reserved[2];
+  uint64_t exchange_ts_ms;
+  uint64_t rx_tsc;
+  aero_strategy_quote quote;
+  aero_strategy_quote prev; /* Zero for the first quote of a symbol */
+} aero_strategy_bbo;
+
+typedef struct {
+  uint32_t symbol_id;
+  uint8_t exchange_id;
+  uint8_t side; /* Aggressor: 0 buy, 1 sell */
+  uint8_t reserved[2];
+  uint64_t exchange_ts_ms;
+  uint64_t rx_tsc;
+  uint64_t price;
+  uint64_t qty;
+} aero_strategy_trade;
+
+/* Services of the gateway, valid from init until on_stop returns */
+typedef struct aero_strategy_host {
+  uint32_t abi_version;
+  uint32_t lcore_id; /* Lcore the callbacks run on */
+  uint64_t tsc_hz;   /* For rx_tsc and on_idle's now_tsc */
+  const char *args;  /* STRATEGY_ARGS, "" if unset */
+
+  /* In-process book mirror, or NULL without BOOK_MIRROR_ENABLED. Read with
+   * aero_book_mirror_read(); do not close it. */
+  const aero_book_mirror_reader *book_mirror;
+
+  void *ctx; /* First argument of the functions below */
+
+  /* Queue a raw order message on an exchange's connection. Returns 0, or
+   * -1 if execution is disabled or the exchange is not connected. */
+  int (*send_order)(void *ctx, uint8_t exchange_id, const char *msg,
+                    size_t len);
+
+  /* Id of (exchange_id, name); assigned if the gateway has not seen it */
+  uint32_t (*symbol_id)(void *ctx, uint8_t exchange_id, const char *name);
+
+  /* Name of an id, NUL-terminated into buf. Returns 0, or -1 if unknown */
+  int (*symbol_name)(void *ctx, uint32_t symbol_id, uint8_t *exchange_id,
+                     char *buf, size_t buf_len);
+
+  /* One line into the gateway's system log */
+  void (*log)(void *ctx, const char *msg);
+} aero_strategy_host;
+
+/* Filled in by aero_strategy_init(); `state` is passed to every callback */
+typedef struct aero_strategy_plugin {
+  uint32_t abi_version;
+  const char *name;
+  void *state;
+
+  void (*on_book)(void *state, const aero_strategy_book *ev);
+  void (*on_bbo)(void *state, const aero_strategy_bbo *ev);
+  void (*on_trade)(void *state, const aero_strategy_trade *ev);
+  void (*on_idle)(void *state, uint64_t now_tsc);
+  void (*on_stop)(void *state); /* Last call; free `state` here */
+} aero_strategy_plugin;
+
+/* Returns 0 to start, anything else to refuse loading */
+typedef int (*aero_strategy_init_fn)(const aero_strategy_host *host,
+                                     aero_strategy_plugin *plugin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AERO_STRATEGY_H */
@@ -0,0 +1,320 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2025 Project AERO.
+ */
+
+/**
+ * @file tick_history.h
+ * @brief Columnar BBO/trade history files: layout, reader and decoder
+ *        (C and C++)
+ *
+ * The gateway appends top-of-book changes and trades to one file per UTC
+ * day (aero_ticks_YYYYMMDD.atk). A file is a 64-byte header followed by
+ * self-contained blocks, each holding up to a few thousand rows of one
+ * table, column by column:
+ *
+ *   aero_tck_header
+ *   aero_tck_block + stored bytes      (table SYMBOLS, BBO or TRADE)
+ *   aero_tck_block + stored bytes
+ *   ...
+ *
+ * Files only roll forward: rows are placed by receive time, but one that
+ * reaches the writer after the first row of a new day (or after a clock
+ * step back) is kept in the newer file, so ts is not monotonic across
+ * rows and readers of a day boundary should look at both files.
+ *
+ * A SYMBOLS block defining every symbol id precedes the first data block
+ * that uses it. Ids are only stable within one gateway run: when a
+ * restarted gateway appends to the same day's file, later SYMBOLS blocks
+ * redefine them for the blocks that follow. Stored bytes are the raw
+ * column data, compressed with zstd when the block's codec says so.
+ *
+ * Raw BBO/TRADE data:
+ *   varint nsyms, varint symbol id x nsyms     (block-local slot -> id)
+ *   columns, each as varint byte length + bytes:
+ *     ts        receive time ns: first absolute, then zigzag deltas
+ *     exch_ts   exchange time ms: zigzag delta to the previous row
+ *     slot      varint index into the block's symbol list
+ *     BBO:   bid_px, bid_qty, ask_px, ask_qty
+ *     TRADE: price, qty, side (one byte per row: 0 buy, 1 sell)
+ *   Prices (1e8 units) are zigzag deltas to the previous value of the same
+ *   slot in the block; quantities are plain varints (fixed-point 1e8).
+ *
+ * Raw SYMBOLS data: per row varint id, u8 exchange id, u8 length, name.
+ *
+ * Blocks are appended with a single write each; a reader that maps a live
+ * file may see a partial last block, which aero_tck_reader_next() skips.
+ *
+ * Minimal reader:
+ *
+ *   aero_tck_reader r;
+ *   if (aero_tck_reader_open(&r, path) == 0) {
+ *     const aero_tck_block *blk;
+ *     const uint8_t *stored;
+ *     while ((blk = aero_tck_reader_next(&r, &stored)) != NULL) {
+ *       // raw = stored, or ZSTD_decompress(buf, blk->raw_size, stored,
+ *       //                                  blk->stored_size)
+ *       // then aero_tck_decode_rows() / aero_tck_next_symbol()
+ *     }
+ *     aero_tck_reader_close(&r);
+ *   }
+ */
+
+#ifndef AERO_TICK_HISTORY_H
+#define AERO_TICK_HISTORY_H
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AERO_TCK_MAGIC 0x314B43544F524541ULL /* "AEROTCK1" */
+#define AERO_TCK_VERSION 1
+#define AERO_TCK_BLOCK_MAGIC 0x314B4C42U /* "BLK1" */
+
+/* aero_tck_block::table */
+#define AERO_TCK_SYMBOLS 1
+#define AERO_TCK_BBO 2
+#define AERO_TCK_TRADE 3
+
+/* aero_tck_block::codec */
+#define AERO_TCK_CODEC_NONE 0
+#define AERO_TCK_CODEC_ZSTD 1
+
+typedef struct {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t day; /* YYYYMMDD, UTC */
+  uint64_t created_ns;
+  uint8_t pad[64 - 24];
+} aero_tck_header;
+
+typedef struct {
+  uint32_t magic; /* AERO_TCK_BLOCK_MAGIC */
+  uint8_t table;  /* AERO_TCK_SYMBOLS / BBO / TRADE */
+  uint8_t codec;  /* AERO_TCK_CODEC_* */
+  uint16_t reserved;
+  uint32_t rows;
+  uint32_t raw_size;    /* Column bytes before compression */
+  uint32_t stored_size; /* Bytes following this header */
+  uint32_t reserved2;
+  uint64_t first_ts_ns; /* Receive time range of the rows */
+  uint64_t last_ts_ns;
+} aero_tck_block;
+
+/* One decoded BBO or trade row */
+typedef struct {
+  uint64_t ts_ns;          /* Gateway receive time (CLOCK_REALTIME) */
+  uint64_t exchange_ts_ms; /* Exchange event time */
+  uint32_t symbol_id;
+  uint8_t side; /* Trades: 0 buy, 1 sell */
+  uint8_t pad[3];
+  uint64_t price[2]; /* BBO: bid, ask; trade: price */
+  uint64_t qty[2];   /* BBO: bid, ask; trade: qty */
+} aero_tck_row;
+
+typedef struct {
+  uint32_t id;
+  uint8_t exchange_id;
+  uint8_t name_len;
+  const char *name; /* Not NUL-terminated */
+} aero_tck_symbol;
+
+/* ------------------------------------------------------------------------ */
+/* Varints                                                                  */
+/* ------------------------------------------------------------------------ */
+
+static inline int aero_tck_get_varint(const uint8_t **p, const uint8_t *end,
+                                      uint64_t *out) {
+  uint64_t v = 0;
+  for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+    uint8_t b = *(*p)++;
+    v |= (uint64_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) {
+      *out = v;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+static inline int64_t aero_tck_unzigzag(uint64_t v) {
+  return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+/* ------------------------------------------------------------------------ */
+/* Reader                                                                   */
+/* ------------------------------------------------------------------------ */
+
+typedef struct {
+  const uint8_t *base;
+  size_t map_size;
+  const aero_tck_header *hdr;
+  size_t offset; /* Next block */
+} aero_tck_reader;
+
+/**
+ * Map a history file. Returns 0 on success, -1 if it is missing or not a
+ * tick history file.
+ */
+static inline int aero_tck_reader_open(aero_tck_reader *r, const char *path) {
+  memset(r, 0, sizeof(*r));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(aero_tck_header)) {
+    close(fd);
+    return -1;
+  }
+  void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED)
+    return -1;
+
+  r->base = (const uint8_t *)p;
+  r->map_size = (size_t)st.st_size;
+  r->hdr = (const aero_tck_header *)p;
+  if (r->hdr->magic != AERO_TCK_MAGIC || r->hdr->version != AERO_TCK_VERSION) {
+    munmap(p, r->map_size);
+    memset(r, 0, sizeof(*r));
+    return -1;
+  }
+  madvise(p, r->map_size, MADV_SEQUENTIAL);
+  r->offset = sizeof(aero_tck_header);
+  return 0;
+}
+
+static inline void aero_tck_reader_close(aero_tck_reader *r) {
+  if (r->base)
+    munmap((void *)r->base, r->map_size);
+  memset(r, 0, sizeof(*r));
+}
+
+/**
+ * Next complete block and its stored bytes, or NULL at the end.
+ */
+static inline const aero_tck_block *
+aero_tck_reader_next(aero_tck_reader *r, const uint8_t **stored) {
+  if (r->offset + sizeof(aero_tck_block) > r->map_size)
+    return NULL;
+  const aero_tck_block *blk = (const aero_tck_block *)(r->base + r->offset);
+  if (blk->magic != AERO_TCK_BLOCK_MAGIC ||
+      r->offset + sizeof(aero_tck_block) + blk->stored_size > r->map_size)
+    return NULL;
+  *stored = (const uint8_t *)(blk + 1);
+  r->offset += sizeof(aero_tck_block) + blk->stored_size;
+  return blk;
+}
+
+/**
+ * Next entry of a SYMBOLS block's raw data. Returns 0, or -1 at the end.
+ */
+static inline int aero_tck_next_symbol(const uint8_t **p, const uint8_t *end,
+                                       aero_tck_symbol *out) {
+  uint64_t id;
+  if (aero_tck_get_varint(p, end, &id) < 0 || end - *p < 2)
+    return -1;
+  out->id = (uint32_t)id;
+  out->exchange_id = *(*p)++;
+  out->name_len = *(*p)++;
+  if (end - *p < out->name_len)
+    return -1;
+  out->name = (const char *)*p;
+  *p += out->name_len;
+  return 0;
+}
+
+/**
+ * Decode the raw data of a BBO or TRADE block into blk->rows rows.
+ * Returns 0, or -1 if the data is malformed.
+ */
+static inline int aero_tck_decode_rows(const aero_tck_block *blk,
+                                       const uint8_t *raw, size_t raw_len,
+                                       aero_tck_row *rows) {
+  const uint8_t *p = raw, *end = raw + raw_len;
+  const int bbo = blk->table == AERO_TCK_BBO;
+  const int ncols = bbo ? 7 : 6;
+  const uint8_t *col[7], *col_end[7];
+  uint64_t nsyms, v;
+  uint32_t *ids;
+  uint64_t *last;
+  uint32_t i, s;
+  int c, err = -1;
+
+  if (blk->table != AERO_TCK_BBO && blk->table != AERO_TCK_TRADE)
+    return -1;
+  if (aero_tck_get_varint(&p, end, &nsyms) < 0 || nsyms > blk->rows)
+    return -1;
+  ids = (uint32_t *)malloc((nsyms + 1) * sizeof(uint32_t));
+  last = (uint64_t *)calloc((nsyms + 1) * 2, sizeof(uint64_t));
+  if (!ids || !last)
+    goto out;
+  for (s = 0; s < nsyms; s++) {
+    if (aero_tck_get_varint(&p, end, &v) < 0)
+      goto out;
+    ids[s] = (uint32_t)v;
+  }
+  for (c = 0; c < ncols; c++) {
+    if (aero_tck_get_varint(&p, end, &v) < 0 || v > (uint64_t)(end - p))
+      goto out;
+    col[c] = p;
+    col_end[c] = p + v;
+    p += v;
+  }
+
+  {
+    uint64_t ts = 0, exch_ts = 0;
+    for (i = 0; i < blk->rows; i++) {
+      aero_tck_row *row = &rows[i];
+      uint64_t slot;
+      memset(row, 0, sizeof(*row));
+      if (aero_tck_get_varint(&col[0], col_end[0], &v) < 0)
+        goto out;
+      ts = i == 0 ? v : ts + (uint64_t)aero_tck_unzigzag(v);
+      if (aero_tck_get_varint(&col[1], col_end[1], &v) < 0)
+        goto out;
+      exch_ts += (uint64_t)aero_tck_unzigzag(v);
+      if (aero_tck_get_varint(&col[2], col_end[2], &slot) < 0 || slot >= nsyms)
+        goto out;
+      row->ts_ns = ts;
+      row->exchange_ts_ms = exch_ts;
+      row->symbol_id = ids[slot];
+
+      /* BBO: px, qty, px, qty in columns 3..6; trade: px, qty, side */
+      for (s = 0; s < (uint32_t)(bbo ? 2 : 1); s++) {
+        uint64_t px, qty;
+        if (aero_tck_get_varint(&col[3 + 2 * s], col_end[3 + 2 * s], &px) < 0 ||
+            aero_tck_get_varint(&col[4 + 2 * s], col_end[4 + 2 * s], &qty) < 0)
+          goto out;
+        last[slot * 2 + s] += (uint64_t)aero_tck_unzigzag(px);
+        row->price[s] = last[slot * 2 + s];
+        row->qty[s] = qty;
+      }
+      if (!bbo) {
+        if (col[5] >= col_end[5])
+          goto out;
+        row->side = *col[5]++;
+      }
+    }
+  }
+  err = 0;
+out:
+  free(ids);
+  free(last);
+  return err;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AERO_TICK_HISTORY_H */
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+Read the gateway's shared-memory order book mirror (include/aero/book_mirror.h).
+
+The file is mapped read-only with numpy; nothing is sent to the gateway.
+
+  python3 scripts/tools/book_mirror.py                 # List books with BBO
+  python3 scripts/tools/book_mirror.py BTC-USDT -n 5   # Top 5 levels
+"""
+import argparse
+import sys
+import time
+
+import numpy as np
+
+MAGIC = 0x314D4B424F524541  # "AEROBKM1"
+VERSION = 1
+PRICE_SCALE = 1e8
+QTY_SCALE = 1e8
+
+EXCHANGES = {0: "OKX", 1: "BYBIT", 2: "BINANCE", 3: "GATE", 4: "BITGET", 5: "MEXC"}
+
+HEADER_DTYPE = np.dtype([
+    ("magic", "<u8"),
+    ("version", "<u4"),
+    ("depth", "<u4"),
+    ("symbol_capacity", "<u4"),
+    ("slot_size", "<u4"),
+    ("directory_offset", "<u8"),
+    ("books_offset", "<u8"),
+    ("session_ns", "<u8"),
+    ("symbol_count", "<u4"),
+    ("producer_pid", "<u4"),
+])
+
+SYMBOL_DTYPE = np.dtype([
+    ("valid", "<u4"),
+    ("exchange_id", "u1"),
+    ("reserved", "u1", 3),
+    ("name", "S56"),
+])
+
+LEVEL_DTYPE = np.dtype([("price", "<u8"), ("qty", "<u8")])
+
+
+def book_dtype(depth, slot_size):
+    return np.dtype({
+        "names": ["seq", "update_count", "exchange_ts_ns", "rx_tsc",
+                  "update_ns", "bid_count", "ask_count", "flags", "bids",
+                  "asks"],
+        "formats": ["<u8", "<u8", "<u8", "<u8", "<u8", "<u4", "<u4", "<u4",
+                    (LEVEL_DTYPE, depth), (LEVEL_DTYPE, depth)],
+        "offsets": [0, 8, 16, 24, 32, 40, 44, 48, 64, 64 + 16 * depth],
+        "itemsize": slot_size,
+    })
+
+
+class BookMirror:
+    def __init__(self, path):
+        raw = np.memmap(path, dtype="u1", mode="r")
+        hdr = raw[:HEADER_DTYPE.itemsize].view(HEADER_DTYPE)[0]
+        if int(hdr["magic"]) != MAGIC or int(hdr["version"]) != VERSION:
+            raise ValueError(f"{path} is not a book mirror (yet)")
+
+        self.raw = raw
+        self.header = hdr
+        self.depth = int(hdr["depth"])
+        cap = int(hdr["symbol_capacity"])
+        slot_size = int(hdr["slot_size"])
+        d = int(hdr["directory_offset"])
+        b = int(hdr["books_offset"])
+        self.directory = raw[d:d + cap * SYMBOL_DTYPE.itemsize].view(SYMBOL_DTYPE)
+        self.books = raw[b:b + cap * slot_size].view(book_dtype(self.depth, slot_size))
+
+    def symbols(self):
+        """[(id, exchange, name)] for every published directory entry."""
+        n = int(self.raw[:HEADER_DTYPE.itemsize].view(HEADER_DTYPE)[0]["symbol_count"])
+        out = []
+        for i in range(min(n, len(self.directory))):
+            s = self.directory[i]
+            if s["valid"]:
+                out.append((i, EXCHANGES.get(int(s["exchange_id"]), "?"),
+                            s["name"].decode()))
+        return out
+
+    def find(self, name, exchange=None):
+        for i, ex, n in self.symbols():
+            if n == name and (exchange is None or ex == exchange):
+                return i
+        return None
+
+    def read(self, symbol_id, max_tries=1000):
+        """Consistent copy of one book, or None if it kept changing."""
+        slot = self.books[symbol_id:symbol_id + 1]
+        for _ in range(max_tries):
+            s1 = int(slot["seq"][0])
+            if s1 & 1:
+                continue
+            copy = slot.copy()[0]
+            if int(slot["seq"][0]) == s1:
+                return copy
+        return None
+
+
+def fmt_level(level):
+    return f"{level['qty'] / QTY_SCALE:>14.6f} @ {level['price'] / PRICE_SCALE:<16.8f}"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Read the order book mirror")
+    parser.add_argument("symbol", nargs="?", help="Instrument to print")
+    parser.add_argument("--path", default="/dev/shm/aero_book_mirror")
+    parser.add_argument("--exchange", help="Exchange name (OKX, BYBIT, ...)")
+    parser.add_argument("-n", "--levels", type=int, default=10)
+    parser.add_argument("--watch", type=float, default=0.0,
+                        help="Refresh period in seconds (0 = print once)")
+    args = parser.parse_args()
+
+    try:
+        mirror = BookMirror(args.path)
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+
+    while True:
+        if args.symbol is None:
+            print(f"{'ID':>5} {'EXCHANGE':<8} {'SYMBOL':<24} {'BID':>16} {'ASK':>16} {'UPDATES':>10}")
+            for i, ex, name in mirror.symbols():
+                b = mirror.read(i)
+                if b is None:
+                    continue
+                bid = b["bids"][0]["price"] / PRICE_SCALE if b["bid_count"] else float("nan")
+                ask = b["asks"][0]["price"] / PRICE_SCALE if b["ask_count"] else float("nan")
+                print(f"{i:>5} {ex:<8} {name:<24} {bid:>16.8f} {ask:>16.8f} {int(b['update_count']):>10}")
+        else:
+            sid = mirror.find(args.symbol, args.exchange)
+            if sid is None:
+                print(f"Error: {args.symbol} not in mirror", file=sys.stderr)
+                return 1
+            b = mirror.read(sid)
+            if b is None:
+                print("Error: book kept changing, try again", file=sys.stderr)
+                return 1
+            age_ms = (time.time_ns() - int(b["update_ns"])) / 1e6
+            print(f"{args.symbol}  updates={int(b['update_count'])}  age={age_ms:.1f}ms")
+            n = min(args.levels, mirror.depth)
+            for i in range(min(n, int(b["ask_count"])) - 1, -1, -1):
+                print(f"  ASK {fmt_level(b['asks'][i])}")
+            for i in range(min(n, int(b["bid_count"]))):
+                print(f"  BID {fmt_level(b['bids'][i])}")
+
+        if args.watch <= 0:
+            return 0
+        time.sleep(args.watch)
+        print()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
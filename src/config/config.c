@@ -166,6 +166,284 @@ int config_load(void) {
           sizeof(app_config.udp_feed_address) - 1);
   app_config.udp_feed_address[sizeof(app_config.udp_feed_address) - 1] = '\0';
 
+  const char *udp_flush_str = get_optional_env("UDP_FEED_FLUSH_US", "20");
+  app_config.udp_feed_flush_us = atoi(udp_flush_str);
+
+  const char *udp_gso_str = get_optional_env("UDP_FEED_GSO_ENABLED", "true");
+  app_config.udp_feed_gso_enabled = (strcasecmp(udp_gso_str, "true") == 0 ||
+                                     strcmp(udp_gso_str, "1") == 0);
+
+  const char *udp_dpdk_str = get_optional_env("UDP_FEED_DPDK_TX", "false");
+  app_config.udp_feed_dpdk_tx = (strcasecmp(udp_dpdk_str, "true") == 0 ||
+                                 strcmp(udp_dpdk_str, "1") == 0);
+
+  const char *udp_mode_str = get_optional_env("UDP_FEED_CHANNEL_MODE", "single");
+  if (strcasecmp(udp_mode_str, "exchange") == 0) {
+    app_config.udp_feed_channel_mode = FEED_CHANNELS_EXCHANGE;
+  } else if (strcasecmp(udp_mode_str, "symbol") == 0) {
+    app_config.udp_feed_channel_mode = FEED_CHANNELS_SYMBOL;
+  } else {
+    app_config.udp_feed_channel_mode = FEED_CHANNELS_SINGLE;
+  }
+
+  const char *udp_channels_str = get_optional_env("UDP_FEED_CHANNELS", "8");
+  app_config.udp_feed_channels = atoi(udp_channels_str);
+
+  const char *udp_ttl_str = get_optional_env("UDP_FEED_MCAST_TTL", "1");
+  app_config.udp_feed_mcast_ttl = atoi(udp_ttl_str);
+
+  app_config.udp_feed_mcast_iface = get_optional_env("UDP_FEED_MCAST_IFACE", "");
+
+  const char *retrans_port_str =
+      get_optional_env("UDP_FEED_RETRANS_PORT", "13989");
+  app_config.udp_feed_retrans_port = atoi(retrans_port_str);
+
+  app_config.udp_feed_retrans_bind =
+      get_optional_env("UDP_FEED_RETRANS_BIND", "127.0.0.1");
+
+  const char *retrans_depth_str =
+      get_optional_env("UDP_FEED_RETRANS_DEPTH", "4096");
+  app_config.udp_feed_retrans_depth = atoi(retrans_depth_str);
+
+  const char *snapshot_port_str =
+      get_optional_env("UDP_FEED_SNAPSHOT_PORT", "13991");
+  app_config.udp_feed_snapshot_port = atoi(snapshot_port_str);
+
+  app_config.udp_feed_snapshot_bind =
+      get_optional_env("UDP_FEED_SNAPSHOT_BIND", "127.0.0.1");
+
+  const char *snapshot_capacity_str =
+      get_optional_env("UDP_FEED_SNAPSHOT_CAPACITY", "4096");
+  app_config.udp_feed_snapshot_capacity = atoi(snapshot_capacity_str);
+
+  const char *fec_k_str = get_optional_env("UDP_FEED_FEC_K", "0");
+  app_config.udp_feed_fec_k = atoi(fec_k_str);
+
+  const char *fec_m_str = get_optional_env("UDP_FEED_FEC_M", "1");
+  app_config.udp_feed_fec_m = atoi(fec_m_str);
+
+  const char *fec_delay_str =
+      get_optional_env("UDP_FEED_FEC_MAX_DELAY_US", "1000");
+  app_config.udp_feed_fec_max_delay_us = atoi(fec_delay_str);
+
+  const char *max_payload_str =
+      get_optional_env("UDP_FEED_MAX_PAYLOAD", "1472");
+  app_config.udp_feed_max_payload = atoi(max_payload_str);
+
+  const char *async_str = get_optional_env("UDP_FEED_ASYNC", "false");
+  app_config.udp_feed_async =
+      (strcasecmp(async_str, "true") == 0 || strcmp(async_str, "1") == 0);
+
+  const char *async_ring_str =
+      get_optional_env("UDP_FEED_ASYNC_RING_KB", "4096");
+  app_config.udp_feed_async_ring_kb = atoi(async_ring_str);
+
+  const char *udp_format_str = get_optional_env("UDP_FEED_FORMAT", "full");
+  app_config.udp_feed_format = strcasecmp(udp_format_str, "compact") == 0
+                                   ? FEED_FORMAT_COMPACT
+                                   : FEED_FORMAT_FULL;
+
+  const char *compact_refresh_str =
+      get_optional_env("UDP_FEED_COMPACT_REFRESH_MS", "1000");
+  app_config.udp_feed_compact_refresh_ms = atoi(compact_refresh_str);
+
+  const char *bbo_enabled_str = get_optional_env("UDP_FEED_BBO_ENABLED", "false");
+  app_config.udp_feed_bbo_enabled = (strcasecmp(bbo_enabled_str, "true") == 0 ||
+                                     strcmp(bbo_enabled_str, "1") == 0);
+
+  app_config.udp_feed_bbo_address = get_optional_env("UDP_FEED_BBO_ADDRESS", "");
+
+  const char *bbo_port_str = get_optional_env("UDP_FEED_BBO_PORT", "13990");
+  app_config.udp_feed_bbo_port = atoi(bbo_port_str);
+
+  // Shared-Memory Bus Configuration
+  const char *shm_enabled_str = get_optional_env("SHM_BUS_ENABLED", "false");
+  app_config.shm_bus_enabled = (strcasecmp(shm_enabled_str, "true") == 0 ||
+                                strcmp(shm_enabled_str, "1") == 0);
+
+  app_config.shm_bus_path =
+      get_optional_env("SHM_BUS_PATH", "/dev/shm/aero_md_bus");
+
+  const char *shm_slots_str = get_optional_env("SHM_BUS_SLOTS", "16384");
+  app_config.shm_bus_slots = atoi(shm_slots_str);
+
+  const char *shm_slot_size_str = get_optional_env("SHM_BUS_SLOT_SIZE", "2048");
+  app_config.shm_bus_slot_size = atoi(shm_slot_size_str);
+
+  // Order Book Mirror Configuration
+  const char *mirror_enabled_str =
+      get_optional_env("BOOK_MIRROR_ENABLED", "false");
+  app_config.book_mirror_enabled =
+      (strcasecmp(mirror_enabled_str, "true") == 0 ||
+       strcmp(mirror_enabled_str, "1") == 0);
+
+  app_config.book_mirror_path =
+      get_optional_env("BOOK_MIRROR_PATH", "/dev/shm/aero_book_mirror");
+
+  const char *mirror_depth_str = get_optional_env("BOOK_MIRROR_DEPTH", "20");
+  app_config.book_mirror_depth = atoi(mirror_depth_str);
+
+  const char *mirror_cap_str = get_optional_env("BOOK_MIRROR_CAPACITY", "1024");
+  app_config.book_mirror_capacity = atoi(mirror_cap_str);
+
+  // Feed Latency Monitor Configuration
+  const char *latency_mon_str =
+      get_optional_env("LATENCY_MONITOR_ENABLED", "true");
+  app_config.latency_monitor_enabled =
+      (strcasecmp(latency_mon_str, "true") == 0 ||
+       strcmp(latency_mon_str, "1") == 0);
+
+  const char *latency_report_str =
+      get_optional_env("LATENCY_REPORT_INTERVAL_S", "10");
+  app_config.latency_report_interval_s = atoi(latency_report_str);
+
+  const char *heartbeat_str =
+      get_optional_env("FEED_HEARTBEAT_INTERVAL_MS", "5000");
+  app_config.feed_heartbeat_interval_ms = atoi(heartbeat_str);
+
+  const char *conflate_str = get_optional_env("FEED_CONFLATE_BACKLOG", "1000");
+  app_config.feed_conflate_backlog = atoi(conflate_str);
+
+  const char *flush_frames_str =
+      get_optional_env("FEED_CONFLATE_FLUSH_FRAMES", "256");
+  app_config.feed_conflate_flush_frames = atoi(flush_frames_str);
+
+  const char *flush_us_str = get_optional_env("FEED_CONFLATE_FLUSH_US", "1000");
+  app_config.feed_conflate_flush_us = atoi(flush_us_str);
+
+  // Load Shedding
+  const char *shed_str = get_optional_env("LOAD_SHED_ENABLED", "false");
+  app_config.load_shed_enabled =
+      (strcasecmp(shed_str, "true") == 0 || strcmp(shed_str, "1") == 0);
+
+  const char *shed_enter_backlog_str =
+      get_optional_env("LOAD_SHED_ENTER_BACKLOG", "2000");
+  app_config.load_shed_enter_backlog = atoi(shed_enter_backlog_str);
+
+  const char *shed_exit_backlog_str =
+      get_optional_env("LOAD_SHED_EXIT_BACKLOG", "200");
+  app_config.load_shed_exit_backlog = atoi(shed_exit_backlog_str);
+
+  const char *shed_enter_loop_str =
+      get_optional_env("LOAD_SHED_ENTER_LOOP_US", "1000");
+  app_config.load_shed_enter_loop_us = atoi(shed_enter_loop_str);
+
+  const char *shed_exit_loop_str =
+      get_optional_env("LOAD_SHED_EXIT_LOOP_US", "200");
+  app_config.load_shed_exit_loop_us = atoi(shed_exit_loop_str);
+
+  const char *shed_hold_str = get_optional_env("LOAD_SHED_EXIT_HOLD_MS", "1000");
+  app_config.load_shed_exit_hold_ms = atoi(shed_hold_str);
+
+  const char *shed_top_str = get_optional_env("LOAD_SHED_TOP_LEVELS", "10");
+  app_config.load_shed_top_levels = atoi(shed_top_str);
+
+  const char *shed_priority_env =
+      get_optional_env("LOAD_SHED_PRIORITY_SYMBOLS", NULL);
+  app_config.load_shed_priority_symbols = NULL;
+  app_config.load_shed_priority_count = 0;
+  parse_csv_symbols(shed_priority_env, &app_config.load_shed_priority_symbols,
+                    &app_config.load_shed_priority_count);
+
+  // Raw Frame Capture
+  const char *capture_str = get_optional_env("CAPTURE_ENABLED", "false");
+  app_config.capture_enabled =
+      (strcasecmp(capture_str, "true") == 0 || strcmp(capture_str, "1") == 0);
+
+  app_config.capture_dir = get_optional_env("CAPTURE_DIR", "capture");
+
+  const char *capture_mb_str = get_optional_env("CAPTURE_SEGMENT_MB", "256");
+  app_config.capture_segment_mb = atoi(capture_mb_str);
+
+  const char *capture_roll_str = get_optional_env("CAPTURE_ROLL_S", "3600");
+  app_config.capture_roll_s = atoi(capture_roll_str);
+
+  // Tick History
+  const char *history_str = get_optional_env("TICK_HISTORY_ENABLED", "false");
+  app_config.tick_history_enabled =
+      (strcasecmp(history_str, "true") == 0 || strcmp(history_str, "1") == 0);
+
+  app_config.tick_history_dir = get_optional_env("TICK_HISTORY_DIR", "history");
+
+  const char *history_rows_str =
+      get_optional_env("TICK_HISTORY_BLOCK_ROWS", "8192");
+  app_config.tick_history_block_rows = atoi(history_rows_str);
+
+  const char *history_flush_str =
+      get_optional_env("TICK_HISTORY_FLUSH_MS", "1000");
+  app_config.tick_history_flush_ms = atoi(history_flush_str);
+
+  const char *history_cpu_str = get_optional_env("TICK_HISTORY_CPU", "-1");
+  app_config.tick_history_cpu = atoi(history_cpu_str);
+
+  // Strategy Plugin
+  app_config.strategy_plugin = get_optional_env("STRATEGY_PLUGIN", "");
+  app_config.strategy_args = get_optional_env("STRATEGY_ARGS", "");
+
+  const char *strategy_queue_str =
+      get_optional_env("STRATEGY_QUEUE_EVENTS", "16384");
+  app_config.strategy_queue_events = atoi(strategy_queue_str);
+
+  // Arbitrage Engine
+  const char *arb_enabled_str = get_optional_env("ARB_ENABLED", "false");
+  app_config.arb_enabled = (strcasecmp(arb_enabled_str, "true") == 0 ||
+                            strcmp(arb_enabled_str, "1") == 0);
+
+  const char *arb_okx_fee_str = get_optional_env("ARB_OKX_FEE_BPS", "5.0");
+  app_config.arb_okx_fee_bps = strtod(arb_okx_fee_str, NULL);
+
+  const char *arb_bybit_fee_str = get_optional_env("ARB_BYBIT_FEE_BPS", "5.5");
+  app_config.arb_bybit_fee_bps = strtod(arb_bybit_fee_str, NULL);
+
+  const char *arb_edge_str = get_optional_env("ARB_MIN_EDGE_BPS", "2.0");
+  app_config.arb_min_edge_bps = strtod(arb_edge_str, NULL);
+
+  const char *arb_qty_str = get_optional_env("ARB_MIN_QTY", "0");
+  app_config.arb_min_qty = strtod(arb_qty_str, NULL);
+
+  const char *arb_age_str = get_optional_env("ARB_MAX_LEG_AGE_MS", "500");
+  app_config.arb_max_leg_age_ms = atoi(arb_age_str);
+
+  // Consolidated Book
+  const char *consolidated_str =
+      get_optional_env("CONSOLIDATED_BOOK_ENABLED", "false");
+  app_config.consolidated_book_enabled =
+      (strcasecmp(consolidated_str, "true") == 0 ||
+       strcmp(consolidated_str, "1") == 0);
+
+  // Book Analytics
+  const char *analytics_str = get_optional_env("BOOK_ANALYTICS_ENABLED", "false");
+  app_config.book_analytics_enabled = (strcasecmp(analytics_str, "true") == 0 ||
+                                       strcmp(analytics_str, "1") == 0);
+
+  app_config.book_analytics_levels =
+      get_optional_env("BOOK_ANALYTICS_LEVELS", "5,10,20");
+
+  const char *analytics_vwap_str =
+      get_optional_env("BOOK_ANALYTICS_VWAP_QTY", "0");
+  app_config.book_analytics_vwap_qty = strtod(analytics_vwap_str, NULL);
+
+  // Top-of-book Channels
+  const char *bbo_channels_str =
+      get_optional_env("BBO_CHANNELS_ENABLED", "false");
+  app_config.bbo_channels_enabled =
+      (strcasecmp(bbo_channels_str, "true") == 0 ||
+       strcmp(bbo_channels_str, "1") == 0);
+
+  // Public Trades
+  const char *trades_str = get_optional_env("TRADES_ENABLED", "false");
+  app_config.trades_enabled = (strcasecmp(trades_str, "true") == 0 ||
+                               strcmp(trades_str, "1") == 0);
+
+  app_config.trade_flow_windows_ms =
+      get_optional_env("TRADE_FLOW_WINDOWS_MS", "100,1000,5000");
+
+  const char *trade_flow_ring_str = get_optional_env("TRADE_FLOW_RING", "4096");
+  app_config.trade_flow_ring = atoi(trade_flow_ring_str);
+
+  app_config.contract_sizes =
+      get_optional_env("CONTRACT_SIZES", "OKX:ETH-USDT-SWAP=0.1");
+
   // Log File Paths (default: logs/ directory)
   app_config.log_price_file =
       get_optional_env("LOG_PRICE_FILE", "logs/price.log");
@@ -7,6 +7,19 @@
 extern "C" {
 #endif
 
+/* UDP feed channel mapping (UDP_FEED_CHANNEL_MODE) */
+typedef enum {
+  FEED_CHANNELS_SINGLE = 0, /* "single": one channel */
+  FEED_CHANNELS_EXCHANGE,   /* "exchange": one channel per exchange */
+  FEED_CHANNELS_SYMBOL,     /* "symbol": hash of symbol over N channels */
+} feed_channel_mode_t;
+
+/* UDP feed wire format (UDP_FEED_FORMAT) */
+typedef enum {
+  FEED_FORMAT_FULL = 0, /* "full": version 2, every level, symbol string */
+  FEED_FORMAT_COMPACT,  /* "compact": version 3, changed levels, symbol ids */
+} feed_wire_format_t;
+
 typedef struct {
   const char *okx_api_key;
   const char *okx_api_secret;
@@ -44,6 +57,110 @@ typedef struct {
   bool udp_feed_enabled;
   int udp_feed_port;
   char udp_feed_address[64];
+  int udp_feed_flush_us; // Max batching delay before sendmmsg (0 = off)
+  bool udp_feed_gso_enabled; // Coalesce equal-sized datagrams (UDP_SEGMENT)
+  bool udp_feed_dpdk_tx; // Publish via DPDK TX on the phy port (kernel bypass)
+  feed_channel_mode_t udp_feed_channel_mode;
+  int udp_feed_channels;            // Channel count in symbol mode
+  int udp_feed_mcast_ttl;
+  const char *udp_feed_mcast_iface; // Local IP for multicast egress ("" = default)
+  int udp_feed_retrans_port;        // Gap-fill TCP service (0 = disabled)
+  const char *udp_feed_retrans_bind;
+  int udp_feed_retrans_depth;       // Datagrams kept per channel
+  int udp_feed_snapshot_port;       // Snapshot-on-demand service (0 = disabled)
+  const char *udp_feed_snapshot_bind;
+  int udp_feed_snapshot_capacity;   // Symbols the snapshot service can serve
+  int udp_feed_fec_k;               // Data datagrams per FEC block (0 = off)
+  int udp_feed_fec_m;               // Parity datagrams per FEC block
+  int udp_feed_fec_max_delay_us;    // Partial block closed after this long
+  int udp_feed_max_payload;         // Largest datagram; bigger books chunked
+  bool udp_feed_async;              // Publish on a separate lcore
+  int udp_feed_async_ring_kb;       // Feed -> publisher queue size
+  feed_wire_format_t udp_feed_format;
+  int udp_feed_compact_refresh_ms;  // Full snapshot period per symbol (compact)
+  bool udp_feed_bbo_enabled;        // 64-byte top-of-book channel
+  const char *udp_feed_bbo_address; // "" = same as udp_feed_address
+  int udp_feed_bbo_port;
+
+  /* Shared-Memory Market Data Bus */
+  bool shm_bus_enabled;
+  const char *shm_bus_path; // /dev/shm or hugetlbfs file
+  int shm_bus_slots;        // Ring size (power of two)
+  int shm_bus_slot_size;    // Bytes per event slot
+
+  /* Shared-Memory Order Book Mirror */
+  bool book_mirror_enabled;
+  const char *book_mirror_path; // /dev/shm or hugetlbfs file
+  int book_mirror_depth;        // Levels per side
+  int book_mirror_capacity;     // Maximum number of books
+
+  /* Feed Latency Monitor */
+  bool latency_monitor_enabled;
+  int latency_report_interval_s; // Period of per-symbol latency reports
+  int feed_heartbeat_interval_ms; // Ping period (also drives RTT sampling)
+  int feed_conflate_backlog;      // Receive backlog that enables conflation
+  int feed_conflate_flush_frames; // Frames between flushes while behind
+  int feed_conflate_flush_us;     // Time between flushes while behind
+
+  /* Load Shedding (see LoadGovernor) */
+  bool load_shed_enabled;
+  int load_shed_enter_backlog; // Receive backlog (frames) that starts shedding
+  int load_shed_exit_backlog;
+  int load_shed_enter_loop_us; // Smoothed feed cycle time that starts it
+  int load_shed_exit_loop_us;
+  int load_shed_exit_hold_ms;  // Calm period before shedding ends
+  int load_shed_top_levels;    // Depth kept for non-priority symbols
+  char **load_shed_priority_symbols; // Full fidelity under overload
+  int load_shed_priority_count;
+
+  /* Raw Frame Capture (see FrameCapture) */
+  bool capture_enabled;
+  const char *capture_dir; // Segment files, created if missing
+  int capture_segment_mb;  // Preallocated size per segment
+  int capture_roll_s;      // Max segment age (0 = roll by size only)
+
+  /* Tick History (see TickHistoryWriter) */
+  bool tick_history_enabled;
+  const char *tick_history_dir; // Per-day files, created if missing
+  int tick_history_block_rows;  // Rows per compressed block
+  int tick_history_flush_ms;    // Max age of an unwritten row
+  int tick_history_cpu;         // Writer thread CPU (-1 = unpinned)
+
+  /* Strategy Plugin (see StrategyHost, aero/strategy.h) */
+  const char *strategy_plugin; // Shared object path, "" = none
+  const char *strategy_args;   // Passed to the plugin as-is
+  int strategy_queue_events;   // Event ring size
+
+  /* Arbitrage Engine (see ArbitrageEngine) */
+  bool arb_enabled;
+  double arb_okx_fee_bps;          // Taker fees
+  double arb_bybit_fee_bps;
+  double arb_min_edge_bps;         // After fees
+  double arb_min_qty;              // Base units
+  int arb_max_leg_age_ms;          // Other leg must be this fresh
+
+  /* Consolidated Book (see ConsolidatedBook) */
+  bool consolidated_book_enabled;
+
+  /* Book Analytics (see BookAnalytics), published on the BBO channel */
+  bool book_analytics_enabled;
+  const char *book_analytics_levels; // Depth windows, e.g. "5,10,20" (max 3)
+  double book_analytics_vwap_qty;    // VWAP-to-size, venue units (0 = off)
+
+  /* Top-of-book channels (OKX bbo-tbt, Bybit orderbook.1) next to the depth
+   * feed, arbitrated by exchange time (see BboArbiter) */
+  bool bbo_channels_enabled;
+
+  /* Public trades (OKX trades, Bybit publicTrade) and their rolling
+   * aggregates (see TradeFlowAggregator) */
+  bool trades_enabled;
+  const char *trade_flow_windows_ms; // e.g. "100,1000,5000" (max 3)
+  int trade_flow_ring;               // Trades kept per symbol
+
+  /* Base units per contract, for venues quoting contracts
+   * ("OKX:ETH-USDT-SWAP=0.1,..."); used by the arbitrage engine and the
+   * consolidated book */
+  const char *contract_sizes;
 
   /* Log File Paths (Optional) */
   const char *log_price_file;
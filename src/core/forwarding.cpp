@@ -1,10 +1,10 @@
 #include "forwarding.h"
 #include "../modules/classifier/classifier.h"
 #include "init.h"
+#include "tsc_clock.h"
 #include "types.h"
 #include <iostream>
 #include <rte_branch_prediction.h>
-#include <rte_cycles.h> // Added for timestamping
 #include <rte_ethdev.h>
 #include <rte_lcore.h> // Added for rte_lcore_id
 #include <rte_mbuf.h>
@@ -31,7 +31,7 @@ void lcore_forward_loop(HftClassifier &classifier) {
   static uint64_t tx_phy_total = 0;
   static uint64_t last_stats_time = 0;
   static const uint64_t STATS_INTERVAL_CYCLES =
-      5 * rte_get_timer_hz(); // 5 seconds
+      aero::TscClock::instance().ns_to_tsc(5000000000ULL); // 5 seconds
 
   printf("HFT Forwarding Engine Running on Core %u\n", rte_lcore_id());
   fflush(stdout);
@@ -67,7 +67,7 @@ void lcore_forward_loop(HftClassifier &classifier) {
 
     if (likely(nb_rx > 0)) {
       uint64_t rx_timestamp =
-          rte_get_timer_cycles(); // Capture timestamp batch-wise or per-packet?
+          aero::TscClock::now_tsc(); // Capture timestamp batch-wise or per-packet?
       // Batch ts is slightly less accurate but much faster.
       // For high precision, better strictly per packet or just once for the
       // burst? Since it's a burst, the arrival times are close. Assigning same
@@ -148,12 +148,15 @@ void lcore_forward_loop(HftClassifier &classifier) {
     }
 
     // Periodic stats output
-    uint64_t now = rte_get_timer_cycles();
+    uint64_t now = aero::TscClock::now_tsc();
     if (now - last_stats_time > STATS_INTERVAL_CYCLES) {
       printf("[Forwarding Stats] RX_PHY: %lu, TX_VIRT: %lu, RX_VIRT: %lu, "
              "TX_PHY: %lu\n",
              rx_phy_total, tx_virt_total, rx_virt_total, tx_phy_total);
       last_stats_time = now;
+
+      // Shared clock service: refine TSC rate and follow wall-clock slews
+      aero::TscClock::instance().recalibrate();
     }
   }
 }
@@ -1,4 +1,5 @@
 #include "init.h"
+#include "config.h"
 #include <rte_common.h>
 #include <rte_ethdev.h>
 #include <rte_string_fns.h>
@@ -8,6 +9,8 @@
 
 uint16_t phy_port_id = RTE_MAX_ETHPORTS;
 uint16_t virt_port_id = RTE_MAX_ETHPORTS;
+uint64_t phy_tx_offloads = 0;
+bool feed_tx_queue_ready = false;
 
 void init_port_mapping(void) {
   uint16_t pid;
@@ -49,10 +52,31 @@ void configure_ports(struct rte_mempool *mbuf_pool) {
   struct rte_eth_conf port_conf = {0};
   uint16_t nb_rxd = 1024;
   uint16_t nb_txd = 1024;
+  uint16_t nb_phy_txq = 1;
+
+  /* The DPDK UDP feed gets its own TX queue and checksum offloads */
+  if (app_config.udp_feed_enabled && app_config.udp_feed_dpdk_tx) {
+    struct rte_eth_dev_info dev_info;
+    uint64_t wanted =
+        RTE_ETH_TX_OFFLOAD_IPV4_CKSUM | RTE_ETH_TX_OFFLOAD_UDP_CKSUM;
+
+    ret = rte_eth_dev_info_get(phy_port_id, &dev_info);
+    if (ret == 0) {
+      phy_tx_offloads = dev_info.tx_offload_capa & wanted;
+      if (dev_info.max_tx_queues > FEED_TX_QUEUE_ID)
+        nb_phy_txq = FEED_TX_QUEUE_ID + 1;
+    }
+    feed_tx_queue_ready = nb_phy_txq > FEED_TX_QUEUE_ID;
+    if (!feed_tx_queue_ready)
+      printf("WARNING: Port %u has a single TX queue, DPDK UDP feed "
+             "disabled\n",
+             phy_port_id);
+    port_conf.txmode.offloads = phy_tx_offloads;
+  }
 
   /* Configure Physical Port */
   printf("Configuring Physical Port %u...\n", phy_port_id);
-  ret = rte_eth_dev_configure(phy_port_id, 1, 1, &port_conf);
+  ret = rte_eth_dev_configure(phy_port_id, 1, nb_phy_txq, &port_conf);
   if (ret < 0)
     rte_exit(EXIT_FAILURE, "Cannot configure physical port\n");
 
@@ -67,15 +91,18 @@ void configure_ports(struct rte_mempool *mbuf_pool) {
     rte_exit(EXIT_FAILURE, "rte_eth_rx_queue_setup: err=%d, port=%u\n", ret,
              phy_port_id);
 
-  ret = rte_eth_tx_queue_setup(phy_port_id, 0, nb_txd,
-                               rte_eth_dev_socket_id(phy_port_id), NULL);
-  if (ret < 0)
-    rte_exit(EXIT_FAILURE, "rte_eth_tx_queue_setup: err=%d, port=%u\n", ret,
-             phy_port_id);
+  for (uint16_t q = 0; q < nb_phy_txq; q++) {
+    ret = rte_eth_tx_queue_setup(phy_port_id, q, nb_txd,
+                                 rte_eth_dev_socket_id(phy_port_id), NULL);
+    if (ret < 0)
+      rte_exit(EXIT_FAILURE, "rte_eth_tx_queue_setup: err=%d, port=%u\n",
+               ret, phy_port_id);
+  }
 
   /* Configure Virtual Port */
   if (virt_port_id != RTE_MAX_ETHPORTS) {
     printf("Configuring Virtio-User Port %u...\n", virt_port_id);
+    port_conf.txmode.offloads = 0;
     ret = rte_eth_dev_configure(virt_port_id, 1, 1, &port_conf);
     if (ret < 0)
       rte_exit(EXIT_FAILURE, "Cannot configure virtio port\n");
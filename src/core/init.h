@@ -10,8 +10,14 @@
 extern "C" {
 #endif
 
+/* Physical port TX queue reserved for the DPDK UDP feed publisher; queue 0
+ * belongs to the forwarding lcore and TX queues are not thread-safe. */
+#define FEED_TX_QUEUE_ID 1
+
 extern uint16_t phy_port_id;
 extern uint16_t virt_port_id;
+extern uint64_t phy_tx_offloads; /* TX offloads enabled on the phy port */
+extern bool feed_tx_queue_ready;  /* FEED_TX_QUEUE_ID was set up */
 extern struct rte_ring *hft_ring;
 extern volatile bool force_quit;
 
@@ -1,6 +1,7 @@
 #include "logging.h"
-#include <chrono>
-#include <iomanip>
+#include "tsc_clock.h"
+#include <atomic>
+#include <ctime>
 
 #include <fstream>
 #include <iostream>
@@ -15,6 +16,9 @@ static std::mutex price_log_mutex;
 static std::mutex system_log_mutex;
 static std::mutex trade_log_mutex;
 
+static std::atomic<bool> log_shed{false};
+static std::atomic<uint64_t> log_shed_count{0};
+
 static void create_log_dir_if_needed(const char *path) {
   if (!path)
     return;
@@ -53,6 +57,21 @@ void logging_shutdown(void) {
     trade_log_file.close();
 }
 
+void logging_set_shed(bool on) {
+  log_shed.store(on, std::memory_order_relaxed);
+}
+
+bool logging_shed_skip() {
+  if (!log_shed.load(std::memory_order_relaxed))
+    return false;
+  log_shed_count.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+uint64_t logging_shed_count() {
+  return log_shed_count.load(std::memory_order_relaxed);
+}
+
 std::ostream &get_price_log_stream() {
   if (price_log_file.is_open())
     return price_log_file;
@@ -72,9 +91,18 @@ std::ostream &get_trade_log_stream() {
 }
 
 std::ostream &log_timestamp(std::ostream &os) {
-  auto now = std::chrono::system_clock::now();
-  auto time_t_now = std::chrono::system_clock::to_time_t(now);
-  struct tm tm_now;
-  localtime_r(&time_t_now, &tm_now);
-  return os << "[" << std::put_time(&tm_now, "%Y-%m-%d %H:%M:%S") << "]";
+  // The prefix only changes once per second: format it per thread on the
+  // second boundary and reuse it, so a log line costs one TSC read.
+  thread_local time_t cached_sec = -1;
+  thread_local char cached[32];
+
+  time_t sec = static_cast<time_t>(aero::TscClock::instance().now_wall_ns() /
+                                   1000000000ULL);
+  if (sec != cached_sec) {
+    struct tm tm_now;
+    localtime_r(&sec, &tm_now);
+    strftime(cached, sizeof(cached), "[%Y-%m-%d %H:%M:%S]", &tm_now);
+    cached_sec = sec;
+  }
+  return os << cached;
 }
@@ -2,6 +2,7 @@
 #define AERO_CORE_LOGGING_H
 
 #include "../config/config.h"
+#include <cstdint>
 #include <iostream>
 #include <string>
 
@@ -19,9 +20,15 @@ std::ostream &get_price_log_stream();
 std::ostream &get_system_log_stream();
 std::ostream &get_trade_log_stream();
 
+// Load shedding (LoadGovernor): while set, hot-path logging is skipped.
+// logging_shed_skip() returns true (and counts the line) when shedding.
+void logging_set_shed(bool on);
+bool logging_shed_skip();
+uint64_t logging_shed_count();
+
 #define LOG_PRICE(msg)                                                         \
   do {                                                                         \
-    if (app_config.log_price_enabled) {                                        \
+    if (app_config.log_price_enabled && !logging_shed_skip()) {                \
       log_timestamp(get_price_log_stream())                                    \
           << " [PRICE] " << msg << std::endl;                                  \
     }                                                                          \
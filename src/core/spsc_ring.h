@@ -0,0 +1,129 @@
+#ifndef AERO_CORE_SPSC_RING_H
+#define AERO_CORE_SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <type_traits>
+
+namespace aero {
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring of fixed-size slots
+ *
+ * Hands events from the feed-handler lcore to a consumer on another core.
+ * The producer never blocks: push() on a full ring drops the event and
+ * counts it. Head and tail are free-running counters on their own cache
+ * lines; the producer keeps a cached copy of the tail so it only touches
+ * the consumer's line when the ring looks full.
+ */
+template <typename T> class SpscRing {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "slots are copied with plain assignment");
+
+public:
+  SpscRing() = default;
+  ~SpscRing() { release(); }
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  /**
+   * @brief Allocate at least `min_slots` slots (rounded up to a power of two)
+   * @return false if the allocation failed
+   */
+  bool init(size_t min_slots) {
+    release();
+    size_t pow2 = 1;
+    while (pow2 < min_slots)
+      pow2 <<= 1;
+    slots_ = static_cast<T *>(std::aligned_alloc(64, pow2 * sizeof(T)));
+    if (!slots_)
+      return false;
+    mask_ = pow2 - 1;
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    cached_tail_ = 0;
+    return true;
+  }
+
+  void release() {
+    std::free(slots_);
+    slots_ = nullptr;
+  }
+
+  bool is_open() const { return slots_ != nullptr; }
+  size_t capacity() const { return slots_ ? mask_ + 1 : 0; }
+
+  // Producer
+
+  bool push(const T &item) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - cached_tail_ > mask_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head - cached_tail_ > mask_) {
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+        return false;
+      }
+    }
+    slots_[head & mask_] = item;
+    head_.store(head + 1, std::memory_order_release);
+    pushed_.store(pushed_.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+    return true;
+  }
+
+  // Consumer
+
+  /**
+   * @brief Pass every published slot to `fn`, oldest first
+   *
+   * Slots go back to the producer every `release_every` items (1: as soon
+   * as each is handled, for consumers whose callback may be slow).
+   * @return Number of items handled
+   */
+  template <typename Fn> size_t drain(Fn &&fn, uint64_t release_every = 1) {
+    uint64_t start = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t tail = start;
+    uint64_t until_release = release_every;
+    while (tail != head) {
+      fn(slots_[tail & mask_]);
+      tail++;
+      if (--until_release == 0) {
+        tail_.store(tail, std::memory_order_release);
+        until_release = release_every;
+      }
+    }
+    tail_.store(tail, std::memory_order_release);
+    return static_cast<size_t>(tail - start);
+  }
+
+  bool empty() const {
+    return tail_.load(std::memory_order_relaxed) ==
+           head_.load(std::memory_order_acquire);
+  }
+
+  // Counters
+  uint64_t pushed() const { return pushed_.load(std::memory_order_relaxed); }
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  T *slots_ = nullptr;
+  size_t mask_ = 0;
+
+  // Producer
+  alignas(64) std::atomic<uint64_t> head_{0};
+  uint64_t cached_tail_ = 0;
+
+  // Consumer
+  alignas(64) std::atomic<uint64_t> tail_{0};
+
+  alignas(64) std::atomic<uint64_t> pushed_{0};
+  std::atomic<uint64_t> dropped_{0}; // Ring full
+};
+
+} // namespace aero
+
+#endif // AERO_CORE_SPSC_RING_H
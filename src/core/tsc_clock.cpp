@@ -0,0 +1,99 @@
+#include "tsc_clock.h"
+#include <time.h>
+
+namespace aero {
+
+static inline uint64_t timespec_to_ns(const struct timespec &ts) {
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+TscClock::Sample TscClock::take_sample() {
+  // Bracket both clock reads between two TSC reads and keep the tightest
+  // pair, so an interrupt or slow vDSO call does not skew the anchor.
+  Sample best{};
+  uint64_t best_width = UINT64_MAX;
+  for (int i = 0; i < 8; ++i) {
+    struct timespec mono, wall;
+    uint64_t t0 = rte_rdtsc();
+    clock_gettime(CLOCK_MONOTONIC, &mono);
+    clock_gettime(CLOCK_REALTIME, &wall);
+    uint64_t t1 = rte_rdtsc();
+
+    if (t1 - t0 < best_width) {
+      best_width = t1 - t0;
+      best.tsc = t0 + (t1 - t0) / 2;
+      best.mono_ns = timespec_to_ns(mono);
+      best.wall_ns = timespec_to_ns(wall);
+    }
+  }
+  return best;
+}
+
+uint64_t TscClock::mult_for_hz(uint64_t hz) {
+  return static_cast<uint64_t>(
+      (static_cast<unsigned __int128>(1000000000ULL) << SHIFT) / hz);
+}
+
+TscClock::TscClock() {
+  // The clock may be used (e.g. by logging) before rte_eal_init(), when
+  // DPDK does not know the TSC rate yet. Measure it ourselves in that case.
+  uint64_t hz = rte_get_tsc_hz();
+  origin_ = take_sample();
+  if (hz == 0) {
+    Sample end;
+    do {
+      end = take_sample();
+    } while (end.mono_ns - origin_.mono_ns < 10000000ULL); // 10ms
+    hz = static_cast<uint64_t>(
+        static_cast<unsigned __int128>(end.tsc - origin_.tsc) * 1000000000ULL /
+        (end.mono_ns - origin_.mono_ns));
+  }
+
+  hz_.store(hz, std::memory_order_relaxed);
+  store_anchor(
+      {origin_.tsc, origin_.wall_ns, origin_.mono_ns, mult_for_hz(hz)});
+}
+
+uint64_t TscClock::ns_to_tsc(uint64_t ns) const {
+  return static_cast<uint64_t>(static_cast<unsigned __int128>(ns) * tsc_hz() /
+                               1000000000ULL);
+}
+
+void TscClock::store_anchor(const Anchor &a) {
+  uint32_t seq = seq_.load(std::memory_order_relaxed);
+  seq_.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  anchor_tsc_.store(a.tsc, std::memory_order_relaxed);
+  anchor_wall_ns_.store(a.wall_ns, std::memory_order_relaxed);
+  anchor_mono_ns_.store(a.mono_ns, std::memory_order_relaxed);
+  mult_.store(a.mult, std::memory_order_relaxed);
+
+  seq_.store(seq + 2, std::memory_order_release);
+}
+
+void TscClock::recalibrate() {
+  Sample now = take_sample();
+  Anchor prev = load_anchor();
+
+  // Refine the rate against CLOCK_MONOTONIC over the whole run; the long
+  // baseline makes the TSC/clock_gettime read jitter negligible.
+  uint64_t hz = tsc_hz();
+  uint64_t mono_elapsed = now.mono_ns - origin_.mono_ns;
+  if (mono_elapsed >= 1000000000ULL && now.tsc > origin_.tsc) {
+    hz = static_cast<uint64_t>(
+        static_cast<unsigned __int128>(now.tsc - origin_.tsc) * 1000000000ULL /
+        mono_elapsed);
+  }
+
+  // Monotonic stays continuous (only the slope changes); wall time is
+  // re-anchored so NTP/PTP steps and slews are picked up.
+  Anchor next{now.tsc, now.wall_ns,
+              convert(now.tsc, prev.tsc, prev.mono_ns, prev.mult),
+              mult_for_hz(hz)};
+  hz_.store(hz, std::memory_order_relaxed);
+  store_anchor(next);
+}
+
+} // namespace aero
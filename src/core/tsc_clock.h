@@ -0,0 +1,142 @@
+#ifndef AERO_CORE_TSC_CLOCK_H
+#define AERO_CORE_TSC_CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <rte_cycles.h>
+
+namespace aero {
+
+/**
+ * @brief Calibrated TSC clock shared by all modules
+ *
+ * now_tsc() is a bare rdtsc. Conversions use a fixed-point multiply-shift
+ * (ns = tsc * mult >> 32) so no hot path ever divides. The TSC is anchored
+ * against CLOCK_REALTIME and CLOCK_MONOTONIC at startup, and recalibrate()
+ * (called periodically from the main lcore) refines the TSC rate against
+ * CLOCK_MONOTONIC and re-anchors the wall clock so NTP/PTP adjustments are
+ * followed. Anchors are published through a seqlock; readers never block.
+ */
+class TscClock {
+public:
+  static constexpr unsigned SHIFT = 32;
+
+  static TscClock &instance() {
+    static TscClock clock;
+    return clock;
+  }
+
+  /**
+   * @brief Current TSC value
+   */
+  static inline uint64_t now_tsc() { return rte_rdtsc(); }
+
+  /**
+   * @brief Convert a TSC interval to nanoseconds (multiply-shift)
+   */
+  inline uint64_t tsc_to_ns(uint64_t tsc_delta) const {
+    uint64_t mult = mult_.load(std::memory_order_relaxed);
+    return static_cast<uint64_t>(
+        (static_cast<unsigned __int128>(tsc_delta) * mult) >> SHIFT);
+  }
+
+  /**
+   * @brief Convert a nanosecond interval to TSC ticks (for deadlines)
+   */
+  uint64_t ns_to_tsc(uint64_t ns) const;
+
+  /**
+   * @brief Convert an absolute TSC value to CLOCK_REALTIME nanoseconds
+   */
+  inline uint64_t tsc_to_wall(uint64_t tsc) const {
+    Anchor a = load_anchor();
+    return convert(tsc, a.tsc, a.wall_ns, a.mult);
+  }
+
+  /**
+   * @brief Convert an absolute TSC value to CLOCK_MONOTONIC nanoseconds
+   */
+  inline uint64_t tsc_to_mono(uint64_t tsc) const {
+    Anchor a = load_anchor();
+    return convert(tsc, a.tsc, a.mono_ns, a.mult);
+  }
+
+  uint64_t now_wall_ns() const { return tsc_to_wall(now_tsc()); }
+  uint64_t now_mono_ns() const { return tsc_to_mono(now_tsc()); }
+
+  /**
+   * @brief Measured TSC frequency in Hz
+   */
+  uint64_t tsc_hz() const { return hz_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Refine the TSC rate and re-anchor the wall clock
+   *
+   * Must be called from a single thread (the main lcore stats tick).
+   */
+  void recalibrate();
+
+private:
+  TscClock();
+  TscClock(const TscClock &) = delete;
+  TscClock &operator=(const TscClock &) = delete;
+
+  struct Anchor {
+    uint64_t tsc;
+    uint64_t wall_ns;
+    uint64_t mono_ns;
+    uint64_t mult;
+  };
+
+  struct Sample {
+    uint64_t tsc;
+    uint64_t wall_ns;
+    uint64_t mono_ns;
+  };
+
+  static inline uint64_t convert(uint64_t tsc, uint64_t base_tsc,
+                                 uint64_t base_ns, uint64_t mult) {
+    if (tsc >= base_tsc)
+      return base_ns + static_cast<uint64_t>(
+                           (static_cast<unsigned __int128>(tsc - base_tsc) *
+                            mult) >>
+                           SHIFT);
+    return base_ns - static_cast<uint64_t>(
+                         (static_cast<unsigned __int128>(base_tsc - tsc) *
+                          mult) >>
+                         SHIFT);
+  }
+
+  inline Anchor load_anchor() const {
+    Anchor a;
+    uint32_t seq;
+    do {
+      seq = seq_.load(std::memory_order_acquire);
+      a.tsc = anchor_tsc_.load(std::memory_order_relaxed);
+      a.wall_ns = anchor_wall_ns_.load(std::memory_order_relaxed);
+      a.mono_ns = anchor_mono_ns_.load(std::memory_order_relaxed);
+      a.mult = mult_.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) || seq != seq_.load(std::memory_order_relaxed));
+    return a;
+  }
+
+  void store_anchor(const Anchor &a);
+  static Sample take_sample();
+  static uint64_t mult_for_hz(uint64_t hz);
+
+  // Seqlock-protected anchor
+  std::atomic<uint32_t> seq_{0};
+  std::atomic<uint64_t> anchor_tsc_{0};
+  std::atomic<uint64_t> anchor_wall_ns_{0};
+  std::atomic<uint64_t> anchor_mono_ns_{0};
+  std::atomic<uint64_t> mult_{0};
+  std::atomic<uint64_t> hz_{0};
+
+  // Startup sample: long baseline for rate refinement
+  Sample origin_{};
+};
+
+} // namespace aero
+
+#endif // AERO_CORE_TSC_CLOCK_H
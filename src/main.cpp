@@ -4,6 +4,7 @@
 
 #include "core/logging.h"
 #include "modules/network/network_utils.h"
+#include <algorithm>
 #include <iostream>
 #include <rte_byteorder.h>
 #include <rte_common.h>
@@ -18,16 +19,32 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <strings.h>
 
 #include "classifier/classifier.h"
 #include "config.h"
 #include "forwarding.h"
 #include "init.h"
+#include "tsc_clock.h"
 #include "modules/exchange/bybit_connection.h"
+#include "modules/exchange/feed_publish_stage.h"
 #include "modules/exchange/okx_connection.h"
 
+#include "modules/market_data/bbo_arbiter.h"
+#include "modules/market_data/book_conflator.h"
+#include "modules/market_data/book_snapshot_server.h"
+#include "modules/market_data/consolidated_book.h"
 #include "modules/market_data/order_book.h"
+#include "modules/market_data/tick_history_writer.h"
+#include "modules/market_data/trade_flow.h"
+#include "modules/network/bbo_publisher.h"
+#include "modules/network/frame_capture.h"
+#include "modules/network/shm_bus_publisher.h"
 #include "modules/network/udp_publisher.h"
+#include "modules/strategy/arbitrage_engine.h"
+#include "modules/strategy/strategy_host.h"
+#include "modules/telemetry/feed_latency_monitor.h"
+#include "modules/telemetry/load_governor.h"
 #include <arpa/inet.h>
 
 #define NUM_MBUFS 8191
@@ -48,16 +65,240 @@ static void signal_handler(int signum) {
   }
 }
 
-// Simple dummy strategy placeholder or just a logger if needed.
-// For the source repo, we might just run the forwarding loop and logging.
-static int run_logger(void *arg) {
-  (void)arg;
-  LOG_SYSTEM("Reference Logger running on core " << rte_lcore_id());
+// Connections driven by the feed-handler lcore
+struct FeedContext {
+  aero::OkxConnection *okx;
+  aero::BybitConnection *bybit;
+  aero::UdpPublisher *udp;
+  aero::BboPublisher *bbo;
+  aero::ShmBusPublisher *shm_bus;
+  aero::FeedPublishStage *udp_stage; // Owns `udp` when set
+  aero::TickHistoryWriter *history;
+  aero::StrategyHost *strategy;
+  aero::ArbitrageEngine *arbitrage;
+  aero::ConsolidatedBook *consolidated; // Null unless enabled
+  aero::BboArbiter *bbo_arbiter;        // Null unless BBO channels are on
+  aero::TradeFlowAggregator *trade_flow;
+};
+
+// Called from whichever lcore owns the publisher
+static void log_udp_stats(const aero::UdpPublisher &udp) {
+  LOG_SYSTEM("[UdpFeed] sent=" << udp.datagrams_sent()
+                               << " dropped=" << udp.datagrams_dropped()
+                               << " syscalls=" << udp.syscalls()
+                               << " fec_parity=" << udp.fec_parity_sent()
+                               << " chunked=" << udp.books_chunked());
+  if (const auto *enc = udp.compact_encoder()) {
+    LOG_SYSTEM("[UdpFeed] compact snapshots=" << enc->snapshots()
+                                              << " deltas=" << enc->deltas()
+                                              << " unchanged="
+                                              << enc->unchanged());
+  }
+}
+
+// UDP publishing lcore (UDP_FEED_ASYNC): drains the stage the feed handler
+// fills, so serialization and sends stay off the parse/apply path.
+static int run_feed_publisher(void *arg) {
+  auto *stage = static_cast<aero::FeedPublishStage *>(arg);
+  LOG_SYSTEM("Feed publisher running on core " << rte_lcore_id());
+
+  aero::TscClock &clock = aero::TscClock::instance();
+  const uint64_t report_cycles =
+      clock.ns_to_tsc(app_config.latency_report_interval_s * 1000000000ULL);
+  uint64_t next_report = aero::TscClock::now_tsc() + report_cycles;
+
+  while (!force_quit) {
+    stage->poll();
+
+    uint64_t now = aero::TscClock::now_tsc();
+    if (report_cycles > 0 && now >= next_report) {
+      log_udp_stats(stage->publisher());
+      LOG_SYSTEM("[UdpStage] published=" << stage->published() << " dropped="
+                                         << stage->dropped() << " conflated="
+                                         << stage->conflated() << " max_delay="
+                                         << clock.tsc_to_ns(
+                                                stage->take_max_delay_tsc())
+                                         << "ns");
+      next_report = now + report_cycles;
+    }
+  }
+
+  // Whatever the feed handler queued before shutdown
+  while (stage->poll() > 0) {
+  }
+  return 0;
+}
+
+// Strategy lcore (STRATEGY_PLUGIN): the plugin's callbacks run here
+static int run_strategy(void *arg) {
+  static_cast<aero::StrategyHost *>(arg)->run(force_quit);
+  return 0;
+}
+
+// Comma-separated positive integers ("5,10,20"), at most `max`; returns
+// how many were stored
+static uint32_t parse_uint_list(const char *list, uint32_t *out,
+                                uint32_t max) {
+  uint32_t count = 0;
+  while (*list && count < max) {
+    char *end;
+    unsigned long n = strtoul(list, &end, 10);
+    if (end == list)
+      break;
+    if (n > 0)
+      out[count++] = static_cast<uint32_t>(n);
+    list = *end == ',' ? end + 1 : end;
+  }
+  return count;
+}
+
+// CONTRACT_SIZES: base units per contract ("OKX:ETH-USDT-SWAP=0.1,...")
+struct ContractSize {
+  aero::ExchangeId exchange;
+  std::string instrument;
+  double base_per_unit;
+};
+
+static std::vector<ContractSize> parse_contract_sizes() {
+  std::vector<ContractSize> out;
+  std::string sizes = app_config.contract_sizes;
+  size_t pos = 0;
+  while (pos < sizes.size()) {
+    size_t end = sizes.find(',', pos);
+    if (end == std::string::npos)
+      end = sizes.size();
+    std::string entry = sizes.substr(pos, end - pos);
+    pos = end + 1;
+    if (entry.empty())
+      continue;
+
+    size_t colon = entry.find(':');
+    size_t eq = entry.find('=');
+    aero::ExchangeId ex = aero::ExchangeId::UNKNOWN;
+    if (colon != std::string::npos) {
+      for (size_t i = 0; i < aero::MAX_EXCHANGES; i++) {
+        auto id = static_cast<aero::ExchangeId>(i);
+        if (strcasecmp(entry.substr(0, colon).c_str(),
+                       aero::exchange_name(id)) == 0)
+          ex = id;
+      }
+    }
+    double size = eq != std::string::npos
+                      ? strtod(entry.c_str() + eq + 1, nullptr)
+                      : 0.0;
+    if (ex == aero::ExchangeId::UNKNOWN || eq < colon || !(size > 0.0)) {
+      LOG_SYSTEM("Warning: Ignoring CONTRACT_SIZES entry '" << entry << "'");
+      continue;
+    }
+    out.push_back({ex, entry.substr(colon + 1, eq - colon - 1), size});
+  }
+  return out;
+}
+
+// ARB_*: fees and thresholds. Opportunities are logged to the trade log as
+// they open and close.
+static void setup_arbitrage(aero::ArbitrageEngine &arb,
+                            const std::vector<ContractSize> &sizes) {
+  aero::ArbitrageEngine::Config cfg;
+  cfg.fee_bps[static_cast<size_t>(aero::ExchangeId::OKX)] =
+      app_config.arb_okx_fee_bps;
+  cfg.fee_bps[static_cast<size_t>(aero::ExchangeId::BYBIT)] =
+      app_config.arb_bybit_fee_bps;
+  cfg.min_edge_bps = app_config.arb_min_edge_bps;
+  cfg.min_qty = app_config.arb_min_qty;
+  cfg.max_leg_age_ms =
+      static_cast<uint32_t>(std::max(app_config.arb_max_leg_age_ms, 1));
+  arb.configure(cfg);
+  for (const ContractSize &c : sizes)
+    arb.set_contract_size(c.exchange, c.instrument, c.base_per_unit);
+
+  arb.set_handler([&arb](const aero::ArbOpportunity &opp) {
+    if (opp.state == aero::ArbOpportunity::UPDATE)
+      return;
+    LOG_TRADE("[Arb] "
+              << (opp.state == aero::ArbOpportunity::OPEN ? "OPEN " : "CLOSE ")
+              << arb.instrument_name(opp.instrument) << " buy "
+              << aero::exchange_name(opp.buy_exchange) << "@"
+              << opp.buy_price / 1e8 << " sell "
+              << aero::exchange_name(opp.sell_exchange) << "@"
+              << opp.sell_price / 1e8 << " qty=" << opp.qty
+              << " edge_bps=" << opp.edge_bps);
+  });
+}
+
+// Feed handler: drains both exchange connections, keeps the heartbeats
+// going (which also samples RTT for the latency monitor) and periodically
+// reports exchange-to-gateway latency.
+static int run_feed_handler(void *arg) {
+  auto *ctx = static_cast<FeedContext *>(arg);
+  LOG_SYSTEM("Feed handler running on core " << rte_lcore_id());
+
+  aero::TscClock &clock = aero::TscClock::instance();
+  const uint64_t heartbeat_cycles =
+      clock.ns_to_tsc(app_config.feed_heartbeat_interval_ms * 1000000ULL);
+  const uint64_t report_cycles =
+      clock.ns_to_tsc(app_config.latency_report_interval_s * 1000000000ULL);
+  uint64_t next_heartbeat = aero::TscClock::now_tsc() + heartbeat_cycles;
+  uint64_t next_report = aero::TscClock::now_tsc() + report_cycles;
+
+  aero::LoadGovernor &governor = aero::LoadGovernor::instance();
+  uint64_t cycle_start = aero::TscClock::now_tsc();
+
   while (!force_quit) {
-    // In a real source-only app, you might consume market data here
-    // or just let the main loop handle the network stuff.
-    // For now, we just sleep/yield.
-    rte_delay_us_sleep(1000 * 1000);
+    size_t backlog = std::max(ctx->okx->backlog(), ctx->bybit->backlog());
+    ctx->okx->poll(nullptr);
+    ctx->bybit->poll(nullptr);
+
+    // Send whatever this poll cycle batched up (or, with the publisher
+    // lcore, move conflated updates into its ring as it frees up)
+    if (ctx->udp_stage)
+      ctx->udp_stage->pump();
+    else if (ctx->udp->is_initialized())
+      ctx->udp->flush();
+
+    uint64_t now = aero::TscClock::now_tsc();
+    governor.on_cycle(backlog, now - cycle_start, now);
+    cycle_start = now;
+    ctx->arbitrage->expire(now);
+
+    if (heartbeat_cycles > 0 && now >= next_heartbeat) {
+      ctx->okx->send_heartbeat();
+      ctx->bybit->send_heartbeat();
+      next_heartbeat = now + heartbeat_cycles;
+    }
+    if (report_cycles > 0 && now >= next_report) {
+      if (app_config.latency_monitor_enabled)
+        aero::FeedLatencyMonitor::instance().print_stats();
+      governor.print_stats();
+      if (aero::FrameCapture::instance().active())
+        aero::FrameCapture::instance().print_stats();
+      if (ctx->history->is_running())
+        ctx->history->print_stats();
+      if (ctx->strategy->is_loaded())
+        ctx->strategy->print_stats();
+      if (ctx->arbitrage->enabled())
+        ctx->arbitrage->print_stats();
+      if (ctx->consolidated)
+        ctx->consolidated->print_stats();
+      if (ctx->bbo_arbiter)
+        ctx->bbo_arbiter->print_stats();
+      if (ctx->trade_flow->enabled())
+        ctx->trade_flow->print_stats();
+      if (!ctx->udp_stage && ctx->udp->is_initialized())
+        log_udp_stats(*ctx->udp);
+      if (ctx->bbo->is_initialized()) {
+        LOG_SYSTEM("[BboFeed] sent=" << ctx->bbo->records_sent()
+                                     << " dropped="
+                                     << ctx->bbo->records_dropped()
+                                     << " unchanged=" << ctx->bbo->unchanged());
+      }
+      if (ctx->shm_bus->is_initialized()) {
+        LOG_SYSTEM("[ShmBus] events=" << ctx->shm_bus->events()
+                                      << " truncated="
+                                      << ctx->shm_bus->truncated());
+      }
+      next_report = now + report_cycles;
+    }
   }
   return 0;
 }
@@ -84,6 +325,11 @@ int main(int argc, char *argv[]) {
     rte_exit(EXIT_FAILURE, "Error with EAL initialization\n");
   }
 
+  /* Anchor the shared TSC clock now that DPDK knows the TSC rate */
+  aero::TscClock::instance().recalibrate();
+  LOG_SYSTEM("TSC clock calibrated: " << aero::TscClock::instance().tsc_hz()
+                                      << " Hz");
+
   /* Register Signal Handler */
   signal(SIGINT, signal_handler);
   signal(SIGTERM, signal_handler);
@@ -136,10 +382,71 @@ int main(int argc, char *argv[]) {
   aero::OrderBookManager order_book_manager;
 
   // UDP Market Data Publisher
+  aero::UdpFeedOptions feed_opts;
+  feed_opts.flush_us = app_config.udp_feed_flush_us;
+  feed_opts.use_gso = app_config.udp_feed_gso_enabled;
+  switch (app_config.udp_feed_channel_mode) {
+  case FEED_CHANNELS_EXCHANGE:
+    feed_opts.channel_mode = aero::FeedChannelMode::EXCHANGE;
+    feed_opts.channel_count = 6; // One per ExchangeId (OKX..MEXC)
+    break;
+  case FEED_CHANNELS_SYMBOL:
+    feed_opts.channel_mode = aero::FeedChannelMode::SYMBOL;
+    feed_opts.channel_count =
+        static_cast<uint16_t>(std::max(app_config.udp_feed_channels, 1));
+    break;
+  default:
+    feed_opts.channel_mode = aero::FeedChannelMode::SINGLE;
+    feed_opts.channel_count = 1;
+    break;
+  }
+  feed_opts.mcast_ttl = app_config.udp_feed_mcast_ttl;
+  feed_opts.mcast_iface = app_config.udp_feed_mcast_iface;
+  if (app_config.udp_feed_retrans_port > 0 &&
+      app_config.udp_feed_retrans_depth > 0)
+    feed_opts.retrans_depth =
+        static_cast<size_t>(app_config.udp_feed_retrans_depth);
+  if (app_config.udp_feed_format == FEED_FORMAT_COMPACT)
+    feed_opts.wire_format = aero::FeedWireFormat::COMPACT;
+  feed_opts.compact_refresh_ms = app_config.udp_feed_compact_refresh_ms;
+  feed_opts.fec_k = app_config.udp_feed_fec_k;
+  feed_opts.fec_m = app_config.udp_feed_fec_m;
+  feed_opts.fec_max_delay_us = app_config.udp_feed_fec_max_delay_us;
+  if (app_config.udp_feed_max_payload > 0)
+    feed_opts.max_payload =
+        static_cast<size_t>(app_config.udp_feed_max_payload);
+
   auto udp_publisher = std::make_unique<aero::UdpPublisher>();
-  if (app_config.udp_feed_enabled) {
+  if (app_config.udp_feed_enabled && app_config.udp_feed_dpdk_tx &&
+      feed_tx_queue_ready) {
+    // Kernel bypass: frames go out on the phy port's feed TX queue
+    aero::DpdkUdpTx::Config tx_cfg{};
+    tx_cfg.port_id = phy_port_id;
+    tx_cfg.queue_id = FEED_TX_QUEUE_ID;
+    tx_cfg.mbuf_pool = mbuf_pool;
+    tx_cfg.tx_offloads = phy_tx_offloads;
+    tx_cfg.src_port = static_cast<uint16_t>(app_config.udp_feed_port);
+    tx_cfg.dst_port = static_cast<uint16_t>(app_config.udp_feed_port);
+
+    auto src_ip = aero::NetworkUtils::get_source_ip();
+    auto dst_ip =
+        aero::NetworkUtils::resolve_hostname(app_config.udp_feed_address);
+    if (src_ip && dst_ip &&
+        aero::NetworkUtils::get_nic_mac(phy_port_id, tx_cfg.src_mac) &&
+        aero::DpdkUdpTx::resolve_dst_mac(*dst_ip, tx_cfg.dst_mac)) {
+      tx_cfg.src_ip = *src_ip;
+      tx_cfg.dst_ip = *dst_ip;
+      if (!udp_publisher->init_dpdk(tx_cfg, feed_opts))
+        LOG_SYSTEM("Failed to initialize DPDK UDP Publisher");
+    } else {
+      LOG_SYSTEM("DPDK UDP Publisher: cannot resolve source/destination "
+                 "addressing, falling back to kernel socket");
+    }
+  }
+
+  if (app_config.udp_feed_enabled && !udp_publisher->is_initialized()) {
     if (udp_publisher->init(app_config.udp_feed_address,
-                            app_config.udp_feed_port)) {
+                            app_config.udp_feed_port, feed_opts)) {
       LOG_SYSTEM("UDP Publisher initialized on " << app_config.udp_feed_address
                                                  << ":"
                                                  << app_config.udp_feed_port);
@@ -148,17 +455,250 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  // Gap-fill service for UDP consumers, answered from the publisher's ring
+  std::unique_ptr<aero::FeedRetransmitServer> retrans_server;
+  if (udp_publisher->retransmit_store()) {
+    retrans_server = std::make_unique<aero::FeedRetransmitServer>(
+        *udp_publisher->retransmit_store());
+    if (!retrans_server->start(app_config.udp_feed_retrans_bind,
+                               app_config.udp_feed_retrans_port)) {
+      LOG_SYSTEM("Failed to start UDP feed retransmission service");
+      retrans_server.reset();
+    }
+  }
+
+  // Snapshot-on-demand for consumers that join mid-session
+  std::unique_ptr<aero::BookSnapshotServer> snapshot_server;
+  if (app_config.udp_feed_snapshot_port > 0) {
+    uint32_t capacity = static_cast<uint32_t>(
+        std::max(app_config.udp_feed_snapshot_capacity, 1));
+    snapshot_server = std::make_unique<aero::BookSnapshotServer>(capacity);
+    if (!snapshot_server->start(app_config.udp_feed_snapshot_bind,
+                                app_config.udp_feed_snapshot_port)) {
+      LOG_SYSTEM("Failed to start book snapshot service");
+      snapshot_server.reset();
+    }
+  }
+
+  // Top-of-book fast channel, fed from the local books
+  auto bbo_publisher = std::make_unique<aero::BboPublisher>();
+  if (app_config.udp_feed_bbo_enabled) {
+    const char *bbo_addr = app_config.udp_feed_bbo_address[0]
+                               ? app_config.udp_feed_bbo_address
+                               : app_config.udp_feed_address;
+    if (!bbo_publisher->init(bbo_addr, app_config.udp_feed_bbo_port,
+                             app_config.udp_feed_mcast_ttl,
+                             app_config.udp_feed_mcast_iface)) {
+      LOG_SYSTEM("Failed to initialize BBO Publisher");
+    }
+  }
+
+  // Same-host consumers: shared-memory event bus
+  auto shm_bus = std::make_unique<aero::ShmBusPublisher>();
+  if (app_config.shm_bus_enabled) {
+    size_t slots = static_cast<size_t>(std::max(app_config.shm_bus_slots, 1));
+    size_t slot_size =
+        static_cast<size_t>(std::max(app_config.shm_bus_slot_size, 0));
+    if (!shm_bus->init(app_config.shm_bus_path, slots, slot_size)) {
+      LOG_SYSTEM("Failed to initialize shared-memory bus");
+    }
+  }
+
+  // Random-access view of the local books for other processes
+  if (app_config.book_mirror_enabled) {
+    uint32_t depth =
+        static_cast<uint32_t>(std::max(app_config.book_mirror_depth, 1));
+    uint32_t capacity =
+        static_cast<uint32_t>(std::max(app_config.book_mirror_capacity, 1));
+    if (!order_book_manager.enable_mirror(app_config.book_mirror_path, depth,
+                                          capacity)) {
+      LOG_SYSTEM("Failed to initialize order book mirror");
+    }
+  }
+
+  // Depth, imbalance and VWAP kept up to date in every book
+  if (app_config.book_analytics_enabled) {
+    aero::BookAnalyticsConfig analytics_cfg;
+    analytics_cfg.level_count =
+        parse_uint_list(app_config.book_analytics_levels,
+                        analytics_cfg.depth_levels,
+                        aero::BookAnalytics::MAX_LEVELS);
+    analytics_cfg.vwap_qty = std::max(app_config.book_analytics_vwap_qty, 0.0);
+    order_book_manager.enable_analytics(analytics_cfg);
+    LOG_SYSTEM("Book analytics: " << analytics_cfg.level_count
+                                  << " depth windows, VWAP size "
+                                  << analytics_cfg.vwap_qty);
+  }
+
+  // One book per instrument across venues, in base units
+  std::vector<ContractSize> contract_sizes = parse_contract_sizes();
+  if (app_config.consolidated_book_enabled) {
+    order_book_manager.enable_consolidated();
+    for (const ContractSize &c : contract_sizes)
+      order_book_manager.consolidated()->set_contract_size(
+          c.exchange, c.instrument, c.base_per_unit);
+  }
+
+  // Worker lcores: feed handler first, then the optional UDP publisher
+  unsigned int worker_core_id = rte_get_next_lcore(rte_lcore_id(), 1, 0);
+  unsigned int publisher_core_id = RTE_MAX_LCORE;
+
+  std::unique_ptr<aero::FeedPublishStage> udp_stage;
+  if (app_config.udp_feed_async && udp_publisher->is_initialized()) {
+    if (worker_core_id != RTE_MAX_LCORE)
+      publisher_core_id = rte_get_next_lcore(worker_core_id, 1, 0);
+    if (publisher_core_id == RTE_MAX_LCORE) {
+      LOG_SYSTEM("Warning: No spare lcore for the UDP publisher, publishing "
+                 "inline on the feed handler");
+    } else {
+      size_t ring_bytes =
+          static_cast<size_t>(std::max(app_config.udp_feed_async_ring_kb, 64)) *
+          1024;
+      udp_stage = std::make_unique<aero::FeedPublishStage>(
+          *udp_publisher, snapshot_server.get(), ring_bytes);
+      if (!udp_stage->is_initialized()) {
+        LOG_SYSTEM("Warning: UDP publisher stage unavailable, publishing "
+                   "inline on the feed handler");
+        udp_stage.reset();
+        publisher_core_id = RTE_MAX_LCORE;
+      }
+    }
+  }
+
+  // Strategy plugin: on the next free lcore, after the feed lcores
+  unsigned int strategy_core_id = RTE_MAX_LCORE;
+  if (app_config.strategy_plugin[0] != '\0') {
+    unsigned int last_core =
+        publisher_core_id != RTE_MAX_LCORE ? publisher_core_id : worker_core_id;
+    if (last_core != RTE_MAX_LCORE)
+      strategy_core_id = rte_get_next_lcore(last_core, 1, 0);
+    if (strategy_core_id == RTE_MAX_LCORE)
+      LOG_SYSTEM("Warning: No spare lcore for the strategy plugin, not "
+                 "loading " << app_config.strategy_plugin);
+  }
+
+  // Overload shedding: decides when the feed handler may skip work
+  aero::LoadGovernor::Config shed_cfg;
+  shed_cfg.enabled = app_config.load_shed_enabled;
+  shed_cfg.enter_backlog =
+      static_cast<size_t>(std::max(app_config.load_shed_enter_backlog, 1));
+  shed_cfg.exit_backlog =
+      static_cast<size_t>(std::max(app_config.load_shed_exit_backlog, 0));
+  shed_cfg.enter_loop_us =
+      static_cast<uint32_t>(std::max(app_config.load_shed_enter_loop_us, 1));
+  shed_cfg.exit_loop_us =
+      static_cast<uint32_t>(std::max(app_config.load_shed_exit_loop_us, 0));
+  shed_cfg.exit_hold_ms =
+      static_cast<uint32_t>(std::max(app_config.load_shed_exit_hold_ms, 0));
+  shed_cfg.top_levels =
+      static_cast<size_t>(std::max(app_config.load_shed_top_levels, 1));
+  aero::LoadGovernor::instance().configure(shed_cfg);
+  for (int i = 0; i < app_config.load_shed_priority_count; i++)
+    aero::LoadGovernor::instance().add_priority(
+        app_config.load_shed_priority_symbols[i]);
+
+  // Raw input recording for offline reproduction (replayed in order)
+  if (app_config.capture_enabled) {
+    aero::FrameCapture::Config cap_cfg;
+    cap_cfg.dir = app_config.capture_dir;
+    cap_cfg.segment_bytes =
+        static_cast<size_t>(std::max(app_config.capture_segment_mb, 1)) << 20;
+    cap_cfg.roll_s =
+        static_cast<uint32_t>(std::max(app_config.capture_roll_s, 0));
+    if (!aero::FrameCapture::instance().start(cap_cfg))
+      LOG_SYSTEM("Failed to start frame capture");
+  }
+
+  // Columnar BBO/trade history, written off the feed-handler lcore
+  aero::TickHistoryWriter tick_history;
+  if (app_config.tick_history_enabled) {
+    aero::TickHistoryWriter::Config hist_cfg;
+    hist_cfg.dir = app_config.tick_history_dir;
+    hist_cfg.block_rows =
+        static_cast<size_t>(std::max(app_config.tick_history_block_rows, 1));
+    hist_cfg.flush_ms =
+        static_cast<uint32_t>(std::max(app_config.tick_history_flush_ms, 1));
+    hist_cfg.cpu = app_config.tick_history_cpu;
+    if (!tick_history.start(hist_cfg))
+      LOG_SYSTEM("Failed to start tick history writer");
+  }
+
+  // Holds back outputs while the feed handler works off a receive backlog
+  // or sheds load
+  aero::BookConflator feed_conflator;
+
+  aero::FeedSinks sinks;
+  sinks.udp = udp_publisher.get();
+  sinks.books = &order_book_manager;
+  sinks.bbo = bbo_publisher.get();
+  sinks.shm_bus = shm_bus.get();
+  sinks.snapshots = snapshot_server.get();
+  sinks.udp_stage = udp_stage.get();
+  sinks.history = &tick_history;
+  aero::StrategyHost strategy;
+  sinks.strategy = &strategy; // Inert until load()
+  aero::ArbitrageEngine arbitrage;
+  if (app_config.arb_enabled)
+    setup_arbitrage(arbitrage, contract_sizes);
+  sinks.arbitrage = &arbitrage; // Inert unless configured
+  if (app_config.feed_conflate_backlog > 0 || app_config.load_shed_enabled)
+    sinks.conflator = &feed_conflator;
+  // Top of book arrives twice per symbol; publish whichever is newest
+  aero::BboArbiter bbo_arbiter;
+  if (app_config.bbo_channels_enabled)
+    sinks.bbo_arbiter = &bbo_arbiter;
+  // Public trades: volume, VWAP and aggressor imbalance per window
+  aero::TradeFlowAggregator trade_flow;
+  if (app_config.trades_enabled) {
+    aero::TradeFlowConfig flow_cfg;
+    flow_cfg.window_count =
+        parse_uint_list(app_config.trade_flow_windows_ms, flow_cfg.window_ms,
+                        aero::TradeFlow::MAX_WINDOWS);
+    flow_cfg.ring_trades =
+        static_cast<uint32_t>(std::max(app_config.trade_flow_ring, 2));
+    trade_flow.configure(flow_cfg);
+  }
+  sinks.trade_flow = &trade_flow; // Inert unless configured
+
   // Connections
   LOG_SYSTEM("Instantiating OkxConnection");
-  aero::OkxConnection okx_conn(udp_publisher.get());
+  aero::OkxConnection okx_conn(sinks);
   LOG_SYSTEM("Instantiating BybitConnection");
-  aero::BybitConnection bybit_conn(udp_publisher.get());
+  aero::BybitConnection bybit_conn(sinks);
 
   // Restore HftClassifier
   LOG_SYSTEM("Instantiating HftClassifier");
   HftClassifier classifier(0);
 
-  // Strategy Engine REMOVED for Source Only Release
+  // Strategy plugin: orders go out on the market data connections
+  if (strategy_core_id != RTE_MAX_LCORE) {
+    strategy.set_order_route(aero::ExchangeId::OKX,
+                             [&okx_conn](const std::string &msg) {
+                               if (!okx_conn.is_connected())
+                                 return false;
+                               okx_conn.send_order(msg);
+                               return true;
+                             });
+    strategy.set_order_route(aero::ExchangeId::BYBIT,
+                             [&bybit_conn](const std::string &msg) {
+                               if (!bybit_conn.is_connected())
+                                 return false;
+                               bybit_conn.send_order(msg);
+                               return true;
+                             });
+    strategy.set_book_mirror(order_book_manager.mirror());
+
+    aero::StrategyHost::Config strat_cfg;
+    strat_cfg.path = app_config.strategy_plugin;
+    strat_cfg.args = app_config.strategy_args;
+    strat_cfg.queue_events =
+        static_cast<size_t>(std::max(app_config.strategy_queue_events, 64));
+    strat_cfg.execution = app_config.enable_execution;
+    if (!strategy.load(strat_cfg, strategy_core_id)) {
+      LOG_SYSTEM("Failed to load strategy plugin");
+      strategy_core_id = RTE_MAX_LCORE;
+    }
+  }
 
   // Register subscriptions
   // OKX Subscriptions
@@ -170,6 +710,10 @@ int main(int argc, char *argv[]) {
     }
   }
   okx_conn.subscribe(okx_instruments, "books5");
+  if (app_config.bbo_channels_enabled)
+    okx_conn.subscribe(okx_instruments, "bbo-tbt");
+  if (app_config.trades_enabled)
+    okx_conn.subscribe(okx_instruments, "trades");
 
   // Bybit Subscriptions
   std::vector<std::string> bybit_instruments;
@@ -180,6 +724,10 @@ int main(int argc, char *argv[]) {
     }
   }
   bybit_conn.subscribe(bybit_instruments, "orderbook.50");
+  if (app_config.bbo_channels_enabled)
+    bybit_conn.subscribe(bybit_instruments, "orderbook.1");
+  if (app_config.trades_enabled)
+    bybit_conn.subscribe(bybit_instruments, "publicTrade");
 
   // Initiate connections
   if (okx_conn.connect()) {
@@ -192,14 +740,27 @@ int main(int argc, char *argv[]) {
     LOG_SYSTEM("Initiated Bybit connection.");
   }
 
-  /* Launch Dummy/Logger on a worker core */
-  unsigned int worker_core_id = rte_get_next_lcore(rte_lcore_id(), 1, 0);
+  /* Launch Feed Handler on a worker core */
+  FeedContext feed_ctx{&okx_conn, &bybit_conn, udp_publisher.get(),
+                       bbo_publisher.get(), shm_bus.get(), udp_stage.get(),
+                       &tick_history, &strategy, &arbitrage,
+                       order_book_manager.consolidated(),
+                       sinks.bbo_arbiter, &trade_flow};
   if (worker_core_id == RTE_MAX_LCORE) {
-    LOG_SYSTEM("Warning: No worker core available for logger. Running purely "
-               "in forwarding loop.");
+    LOG_SYSTEM("Warning: No worker core available for feed handler. Running "
+               "purely in forwarding loop.");
   } else {
-    LOG_SYSTEM("Launching Reference Logger on core " << worker_core_id);
-    rte_eal_remote_launch(run_logger, NULL, worker_core_id);
+    LOG_SYSTEM("Launching Feed Handler on core " << worker_core_id);
+    rte_eal_remote_launch(run_feed_handler, &feed_ctx, worker_core_id);
+  }
+  if (udp_stage) {
+    LOG_SYSTEM("Launching Feed Publisher on core " << publisher_core_id);
+    rte_eal_remote_launch(run_feed_publisher, udp_stage.get(),
+                          publisher_core_id);
+  }
+  if (strategy_core_id != RTE_MAX_LCORE) {
+    LOG_SYSTEM("Launching Strategy on core " << strategy_core_id);
+    rte_eal_remote_launch(run_strategy, &strategy, strategy_core_id);
   }
 
   /* Start Forwarding Loop on Main Core (NIC <-> TAP Bridge) */
@@ -210,6 +771,13 @@ int main(int argc, char *argv[]) {
   if (worker_core_id != RTE_MAX_LCORE) {
     rte_eal_wait_lcore(worker_core_id);
   }
+  if (udp_stage)
+    rte_eal_wait_lcore(publisher_core_id);
+  if (strategy_core_id != RTE_MAX_LCORE)
+    rte_eal_wait_lcore(strategy_core_id);
+  strategy.unload();
+  aero::FrameCapture::instance().stop();
+  tick_history.stop();
 
   /* Clean up ports */
   close_ports();
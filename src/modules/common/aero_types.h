@@ -1,6 +1,7 @@
 #ifndef _AERO_TYPES_H_
 #define _AERO_TYPES_H_
 
+#include <cstddef>
 #include <cstdint>
 
 namespace aero {
@@ -18,6 +19,36 @@ enum class ExchangeId : uint8_t {
   UNKNOWN = 255
 };
 
+// Number of known venues (ExchangeId::OKX .. MEXC), for per-venue arrays
+inline constexpr size_t MAX_EXCHANGES = 6;
+
+/**
+ * @brief Human readable exchange name (for logging)
+ */
+inline const char *exchange_name(ExchangeId id) {
+  switch (id) {
+  case ExchangeId::OKX:
+    return "OKX";
+  case ExchangeId::BYBIT:
+    return "Bybit";
+  case ExchangeId::BINANCE:
+    return "Binance";
+  case ExchangeId::GATE:
+    return "Gate";
+  case ExchangeId::BITGET:
+    return "Bitget";
+  case ExchangeId::MEXC:
+    return "MEXC";
+  default:
+    return "Unknown";
+  }
+}
+
+// v rounded up to a multiple of align (sizes, offsets)
+inline constexpr size_t round_up(size_t v, size_t align) {
+  return (v + align - 1) / align * align;
+}
+
 } // namespace aero
 
 #endif // _AERO_TYPES_H_
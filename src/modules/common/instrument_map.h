@@ -0,0 +1,115 @@
+#ifndef _AERO_INSTRUMENT_MAP_H_
+#define _AERO_INSTRUMENT_MAP_H_
+
+#include "aero_types.h"
+#include "symbol_registry.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Venue-independent name of an instrument
+ *
+ * "BASE-QUOTE" for spot, "BASE-QUOTE-PERP" for linear perpetuals:
+ *   OKX   ETH-USDT-SWAP -> ETH-USDT-PERP, ETH-USDT -> ETH-USDT
+ *   Bybit ETHUSDT       -> ETH-USDT-PERP (the gateway reads /v5/public/linear)
+ *
+ * Names of other venues are split at '-', '_' or '/', or before a known
+ * quote currency. Anything not recognized is returned unchanged, so it
+ * never pairs with another venue by accident.
+ */
+inline std::string canonical_instrument(ExchangeId exchange,
+                                        std::string_view name) {
+  static constexpr std::string_view QUOTES[] = {"USDT", "USDC", "USD"};
+  std::string out;
+
+  if (exchange == ExchangeId::OKX) {
+    constexpr std::string_view SWAP = "-SWAP";
+    if (name.size() > SWAP.size() && name.ends_with(SWAP)) {
+      out.assign(name.substr(0, name.size() - SWAP.size()));
+      out += "-PERP";
+      return out;
+    }
+    return std::string(name);
+  }
+
+  size_t sep = name.find_first_of("-_/");
+  if (sep != std::string_view::npos && sep > 0 && sep + 1 < name.size()) {
+    out.assign(name.substr(0, sep));
+    out += '-';
+    out.append(name.substr(sep + 1));
+  } else {
+    for (std::string_view quote : QUOTES) {
+      if (name.size() > quote.size() && name.ends_with(quote)) {
+        out.assign(name.substr(0, name.size() - quote.size()));
+        out += '-';
+        out.append(quote);
+        break;
+      }
+    }
+    if (out.empty())
+      return std::string(name);
+  }
+  if (exchange == ExchangeId::BYBIT)
+    out += "-PERP";
+  return out;
+}
+
+/**
+ * @brief Dense canonical instrument indexes for SymbolRegistry ids
+ *
+ * resolve() caches per symbol id, so after the first sighting of a symbol
+ * it is one array read. Not thread-safe: each owner (e.g. the feed-handler
+ * lcore) keeps its own map.
+ */
+class InstrumentMap {
+public:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  /**
+   * @brief Canonical index of a symbol id, assigned on first sight
+   */
+  uint32_t resolve(uint32_t symbol_id) {
+    if (symbol_id < by_symbol_.size() && by_symbol_[symbol_id] != NONE)
+      return by_symbol_[symbol_id];
+
+    SymbolRegistry::Entry entry;
+    if (!SymbolRegistry::instance().lookup(symbol_id, entry))
+      return NONE;
+    std::string name = canonical_instrument(entry.exchange, entry.instrument);
+    auto [it, inserted] =
+        index_.try_emplace(name, static_cast<uint32_t>(names_.size()));
+    if (inserted)
+      names_.push_back(std::move(name));
+
+    if (symbol_id >= by_symbol_.size())
+      by_symbol_.resize(symbol_id + 1, NONE);
+    by_symbol_[symbol_id] = it->second;
+    return it->second;
+  }
+
+  /**
+   * @brief Index of a canonical name, or NONE if no symbol mapped to it yet
+   */
+  uint32_t find(std::string_view canonical) const {
+    auto it = index_.find(std::string(canonical));
+    return it == index_.end() ? NONE : it->second;
+  }
+
+  const std::string &name(uint32_t index) const { return names_[index]; }
+
+  size_t size() const { return names_.size(); }
+
+private:
+  std::vector<uint32_t> by_symbol_; // Symbol id -> canonical index
+  std::unordered_map<std::string, uint32_t> index_;
+  std::vector<std::string> names_;
+};
+
+} // namespace aero
+
+#endif // _AERO_INSTRUMENT_MAP_H_
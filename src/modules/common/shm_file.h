@@ -0,0 +1,63 @@
+#ifndef _AERO_SHM_FILE_H_
+#define _AERO_SHM_FILE_H_
+
+#include "aero_types.h"
+#include "core/logging.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace aero {
+
+inline constexpr size_t SHM_MAP_ALIGN = 2 * 1024 * 1024; // Hugepage friendly
+
+/**
+ * @brief Create a fresh file at path and map size bytes of it shared
+ *
+ * Replaces rather than truncates: readers still mapping the old file keep a
+ * valid (if frozen) mapping and notice the new inode. The mapping is
+ * prefaulted and locked when the limits allow (mlock failure only logs).
+ *
+ * @param owner Log prefix (e.g. "BookMirror")
+ * @return The zero-filled mapping (munmap when done), nullptr on failure
+ */
+inline uint8_t *shm_create_mapped(const char *owner, const std::string &path,
+                                  size_t size) {
+  unlink(path.c_str());
+  int fd = open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    LOG_SYSTEM(owner << ": Failed to create " << path << ": "
+                     << strerror(errno));
+    return nullptr;
+  }
+  if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+    LOG_SYSTEM(owner << ": Failed to size " << path << ": "
+                     << strerror(errno));
+    ::close(fd);
+    unlink(path.c_str());
+    return nullptr;
+  }
+
+  void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    LOG_SYSTEM(owner << ": Failed to map " << path << ": " << strerror(errno));
+    unlink(path.c_str());
+    return nullptr;
+  }
+  if (mlock(p, size) < 0) {
+    LOG_SYSTEM(owner << ": mlock failed (" << strerror(errno)
+                     << "), continuing unlocked");
+  }
+  return static_cast<uint8_t *>(p);
+}
+
+} // namespace aero
+
+#endif // _AERO_SHM_FILE_H_
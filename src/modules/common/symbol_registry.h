@@ -0,0 +1,140 @@
+#ifndef _AERO_SYMBOL_REGISTRY_H_
+#define _AERO_SYMBOL_REGISTRY_H_
+
+#include "aero_types.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace aero {
+
+/**
+ * @brief Process-wide dense ids for (exchange, instrument) pairs
+ *
+ * Ids are assigned on first sight, starting at 0, and never reused, so they
+ * can index per-symbol arrays and stand in for the instrument string on the
+ * wire. Lookups take a shared lock; only the first sighting of a symbol
+ * takes the exclusive one.
+ */
+class SymbolRegistry {
+public:
+  static constexpr uint32_t INVALID_ID = UINT32_MAX;
+
+  struct Entry {
+    ExchangeId exchange;
+    std::string instrument;
+  };
+
+  static SymbolRegistry &instance() {
+    static SymbolRegistry registry;
+    return registry;
+  }
+
+  /**
+   * @brief Id of the symbol, assigning the next free one if it is new
+   */
+  uint32_t get_or_assign(ExchangeId exchange, std::string_view instrument) {
+    thread_local std::string key;
+    make_key(key, exchange, instrument);
+
+    {
+      std::shared_lock lock(mutex_);
+      auto it = ids_.find(key);
+      if (it != ids_.end())
+        return it->second;
+    }
+
+    std::unique_lock lock(mutex_);
+    auto [it, inserted] =
+        ids_.try_emplace(key, static_cast<uint32_t>(entries_.size()));
+    if (inserted)
+      entries_.push_back(Entry{exchange, std::string(instrument)});
+    return it->second;
+  }
+
+  /**
+   * @brief Id of a known symbol, or INVALID_ID
+   */
+  uint32_t find(ExchangeId exchange, std::string_view instrument) const {
+    thread_local std::string key;
+    make_key(key, exchange, instrument);
+
+    std::shared_lock lock(mutex_);
+    auto it = ids_.find(key);
+    return it != ids_.end() ? it->second : INVALID_ID;
+  }
+
+  /**
+   * @brief Copy out the symbol behind an id
+   * @return false if the id was never assigned
+   */
+  bool lookup(uint32_t id, Entry &out) const {
+    std::shared_lock lock(mutex_);
+    if (id >= entries_.size())
+      return false;
+    out = entries_[id];
+    return true;
+  }
+
+  size_t size() const {
+    std::shared_lock lock(mutex_);
+    return entries_.size();
+  }
+
+private:
+  SymbolRegistry() = default;
+
+  static void make_key(std::string &key, ExchangeId exchange,
+                       std::string_view instrument) {
+    key.clear();
+    key.push_back(static_cast<char>(exchange));
+    key.append(instrument);
+  }
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, uint32_t> ids_;
+  std::deque<Entry> entries_; // Indexed by id
+};
+
+/**
+ * @brief Lock-free front for SymbolRegistry::get_or_assign()
+ *
+ * Ids never change once assigned, so after the first sighting a symbol is
+ * one hash lookup in the owner's map, without the registry lock. Not
+ * thread-safe: each owner (e.g. the feed-handler lcore) keeps its own.
+ */
+class SymbolIdCache {
+public:
+  uint32_t get_or_assign(ExchangeId exchange, std::string_view instrument) {
+    size_t v = static_cast<size_t>(exchange);
+    if (v >= MAX_EXCHANGES)
+      return SymbolRegistry::instance().get_or_assign(exchange, instrument);
+    auto it = ids_[v].find(instrument);
+    if (it != ids_[v].end())
+      return it->second;
+    uint32_t id =
+        SymbolRegistry::instance().get_or_assign(exchange, instrument);
+    ids_[v].emplace(std::string(instrument), id);
+    return id;
+  }
+
+private:
+  struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const {
+      return std::hash<std::string_view>{}(s);
+    }
+  };
+
+  std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>>
+      ids_[MAX_EXCHANGES];
+};
+
+} // namespace aero
+
+#endif // _AERO_SYMBOL_REGISTRY_H_
@@ -0,0 +1,44 @@
+/**
+ * @file adapter_json.h
+ * @brief Field readers shared by the exchange adapters' simdjson parsers
+ */
+
+#ifndef AERO_MODULES_EXCHANGE_ADAPTER_JSON_H
+#define AERO_MODULES_EXCHANGE_ADAPTER_JSON_H
+
+#include <charconv>
+#include <simdjson.h>
+#include <string_view>
+#include <system_error>
+
+namespace aero {
+
+// Decimal string to double, converted in place (no temporary std::string)
+inline bool json_to_double(std::string_view str, double &out) {
+  return std::from_chars(str.data(), str.data() + str.size(), out).ec ==
+         std::errc();
+}
+
+// Best [price, size, ...] entry of a side; an empty side leaves price 0
+inline bool
+json_top_level(simdjson::simdjson_result<simdjson::dom::element> side,
+               double &price, double &size) {
+  simdjson::dom::array levels;
+  if (side.get(levels) != simdjson::SUCCESS)
+    return false;
+  price = 0.0;
+  size = 0.0;
+  for (simdjson::dom::element level : levels) {
+    std::string_view price_str, size_str;
+    if (level.at(0).get(price_str) != simdjson::SUCCESS ||
+        level.at(1).get(size_str) != simdjson::SUCCESS)
+      return false;
+    return json_to_double(price_str, price) &&
+           json_to_double(size_str, size);
+  }
+  return true;
+}
+
+} // namespace aero
+
+#endif // AERO_MODULES_EXCHANGE_ADAPTER_JSON_H
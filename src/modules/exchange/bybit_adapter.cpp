@@ -4,13 +4,29 @@
  */
 
 #include "bybit_adapter.h"
+#include "adapter_json.h"
 #include "config/config.h"
 #include "core/logging.h"
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 
 namespace aero {
 
+static constexpr std::string_view BBO_TOPIC = "orderbook.1.";
+static constexpr std::string_view TRADE_TOPIC = "publicTrade.";
+
+// Control frames (ping, pong, subscribe replies) are short and carry an "op"
+// member; market data frames carry "topic" instead. Checked before paying
+// for a parse on every frame.
+static constexpr size_t MAX_CONTROL_FRAME = 512;
+
+static bool is_control_frame(const char *json_data, size_t len) {
+  return len <= MAX_CONTROL_FRAME &&
+         std::string_view(json_data, len).find(R"("op")") !=
+             std::string_view::npos;
+}
+
 bool BybitAdapter::parse_orderbook_message(const char *json_data, size_t len,
                                            ParsedOrderBook &out_book) {
   try {
@@ -26,6 +42,12 @@ bool BybitAdapter::parse_orderbook_message(const char *json_data, size_t len,
       return false;
     }
 
+    // Top-of-book frames belong to parse_bbo_message(): read as one-level
+    // snapshots they would wipe the depth book
+    if (topic.starts_with(BBO_TOPIC)) {
+      return false;
+    }
+
     // Extract instrument from topic (e.g., "orderbook.50.BTCUSDT")
     size_t last_dot = topic.rfind('.');
     if (last_dot == std::string_view::npos) {
@@ -80,9 +102,9 @@ bool BybitAdapter::parse_orderbook_message(const char *json_data, size_t len,
       }
     }
 
-    // Parse timestamp
+    // Parse timestamp (top-level "ts", the time the exchange sent the update)
     uint64_t ts;
-    if (data["ts"].get(ts) == simdjson::SUCCESS) {
+    if (doc["ts"].get(ts) == simdjson::SUCCESS) {
       out_book.timestamp_ms = ts;
     }
 
@@ -92,6 +114,121 @@ bool BybitAdapter::parse_orderbook_message(const char *json_data, size_t len,
   }
 }
 
+bool BybitAdapter::parse_bbo_message(const char *json_data, size_t len,
+                                     ParsedBbo &out_bbo) {
+  // "topic" leads every push, so depth frames are turned away before parsing
+  std::string_view head(json_data, std::min<size_t>(len, 64));
+  if (head.find(BBO_TOPIC) == std::string_view::npos) {
+    return false;
+  }
+
+  simdjson::dom::element doc;
+  if (parser_.parse(json_data, len).get(doc) != simdjson::SUCCESS) {
+    return false;
+  }
+
+  std::string_view topic;
+  if (doc["topic"].get(topic) != simdjson::SUCCESS ||
+      !topic.starts_with(BBO_TOPIC) || topic.size() == BBO_TOPIC.size()) {
+    return false;
+  }
+
+  // A snapshot replaces the quote; a delta only carries the sides that
+  // changed (the other array is empty) and is merged into the last quote
+  std::string_view type;
+  if (doc["type"].get(type) != simdjson::SUCCESS) {
+    return false;
+  }
+  bool snapshot = type == "snapshot";
+  auto data = doc["data"];
+  simdjson::dom::array bids, asks;
+  if (data["b"].get(bids) != simdjson::SUCCESS ||
+      data["a"].get(asks) != simdjson::SUCCESS) {
+    return false;
+  }
+
+  std::string_view instrument = topic.substr(BBO_TOPIC.size());
+  auto it = channel_quotes_.find(instrument);
+  if (it == channel_quotes_.end())
+    it = channel_quotes_.emplace(std::string(instrument), ChannelQuote{})
+             .first;
+  ChannelQuote q = it->second;
+
+  double price, size;
+  if (snapshot || bids.size() > 0) {
+    if (!json_top_level(data["b"], price, size))
+      return false;
+    q.bid_price = static_cast<uint64_t>(std::round(price * PRICE_SCALE));
+    q.bid_qty = size;
+  }
+  if (snapshot || asks.size() > 0) {
+    if (!json_top_level(data["a"], price, size))
+      return false;
+    q.ask_price = static_cast<uint64_t>(std::round(price * PRICE_SCALE));
+    q.ask_qty = size;
+  }
+  // A zero size removes the level: that side is empty
+  if (q.bid_qty <= 0.0)
+    q.bid_price = 0;
+  if (q.ask_qty <= 0.0)
+    q.ask_price = 0;
+  it->second = q;
+
+  out_bbo.instrument.assign(instrument);
+  out_bbo.bid_price = q.bid_price;
+  out_bbo.bid_qty = q.bid_qty;
+  out_bbo.ask_price = q.ask_price;
+  out_bbo.ask_qty = q.ask_qty;
+
+  uint64_t ts;
+  out_bbo.timestamp_ms = doc["ts"].get(ts) == simdjson::SUCCESS ? ts : 0;
+  return true;
+}
+
+bool BybitAdapter::parse_trades_message(const char *json_data, size_t len,
+                                        ParsedTrades &out_trades) {
+  std::string_view head(json_data, std::min<size_t>(len, 64));
+  if (head.find(TRADE_TOPIC) == std::string_view::npos) {
+    return false;
+  }
+
+  simdjson::dom::element doc;
+  if (parser_.parse(json_data, len).get(doc) != simdjson::SUCCESS) {
+    return false;
+  }
+
+  std::string_view topic;
+  if (doc["topic"].get(topic) != simdjson::SUCCESS ||
+      !topic.starts_with(TRADE_TOPIC) || topic.size() == TRADE_TOPIC.size()) {
+    return false;
+  }
+
+  simdjson::dom::array data;
+  if (doc["data"].get(data) != simdjson::SUCCESS) {
+    return false;
+  }
+
+  out_trades.instrument.assign(topic.substr(TRADE_TOPIC.size()));
+  out_trades.trades.clear();
+  for (simdjson::dom::element item : data) {
+    std::string_view p, v, side;
+    double price, size;
+    if (item["p"].get(p) != simdjson::SUCCESS ||
+        item["v"].get(v) != simdjson::SUCCESS ||
+        item["S"].get(side) != simdjson::SUCCESS ||
+        !json_to_double(p, price) || !json_to_double(v, size)) {
+      return false;
+    }
+    TradePrint &t = out_trades.trades.emplace_back();
+    t.price_int = static_cast<uint64_t>(std::round(price * PRICE_SCALE));
+    t.qty = size;
+    t.is_sell = side == "Sell"; // Taker side
+    uint64_t ts;
+    t.timestamp_ms = item["T"].get(ts) == simdjson::SUCCESS ? ts : 0;
+  }
+  return true;
+}
+
 std::string
 BybitAdapter::generate_subscribe_message(const std::string &instrument,
                                          const std::string &channel) const {
@@ -114,7 +251,15 @@ std::string BybitAdapter::generate_pong_message(const std::string &) const {
   return R"({"op":"pong"})";
 }
 
+bool BybitAdapter::is_depth_channel(const std::string &channel) const {
+  // "orderbook.50", "orderbook.200", ...; "orderbook.1" is the BBO channel
+  return channel.compare(0, 10, "orderbook.") == 0 &&
+         channel != "orderbook.1";
+}
+
 bool BybitAdapter::is_ping_message(const char *json_data, size_t len) const {
+  if (!is_control_frame(json_data, len))
+    return false;
   try {
     simdjson::dom::parser temp_parser;
     simdjson::dom::element doc = temp_parser.parse(json_data, len);
@@ -131,8 +276,32 @@ bool BybitAdapter::is_ping_message(const char *json_data, size_t len) const {
   }
 }
 
+bool BybitAdapter::is_pong_message(const char *json_data, size_t len) const {
+  if (!is_control_frame(json_data, len))
+    return false;
+  try {
+    simdjson::dom::parser temp_parser;
+    simdjson::dom::element doc = temp_parser.parse(json_data, len);
+
+    // Reply to our {"op":"ping"}:
+    // linear: {"success":true,"ret_msg":"pong","conn_id":"...","op":"ping"}
+    // spot:   {"op":"pong","args":["1675418560633"],"conn_id":"..."}
+    std::string_view op;
+    if (doc["op"].get(op) != simdjson::SUCCESS) {
+      return false;
+    }
+    bool success;
+    return op == "pong" ||
+           (op == "ping" && doc["success"].get(success) == simdjson::SUCCESS);
+  } catch (...) {
+    return false;
+  }
+}
+
 bool BybitAdapter::is_subscription_response(const char *json_data,
                                             size_t len) const {
+  if (!is_control_frame(json_data, len))
+    return false;
   try {
     simdjson::dom::parser temp_parser;
     simdjson::dom::element doc = temp_parser.parse(json_data, len);
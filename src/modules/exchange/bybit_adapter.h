@@ -7,7 +7,11 @@
 #define _BYBIT_ADAPTER_H_
 
 #include "exchange_adapter.h"
+#include <functional>
 #include <simdjson.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace aero {
 
@@ -16,6 +20,8 @@ namespace aero {
  *
  * Handles:
  * - orderbook.50 order book parsing
+ * - orderbook.1 top-of-book parsing
+ * - publicTrade parsing
  * - Subscription message generation
  * - Ping/pong heartbeat
  */
@@ -35,6 +41,12 @@ public:
   bool parse_orderbook_message(const char *json_data, size_t len,
                                ParsedOrderBook &out_book) override;
 
+  bool parse_bbo_message(const char *json_data, size_t len,
+                         ParsedBbo &out_bbo) override;
+
+  bool parse_trades_message(const char *json_data, size_t len,
+                            ParsedTrades &out_trades) override;
+
   std::string
   generate_subscribe_message(const std::string &instrument,
                              const std::string &channel) const override;
@@ -48,11 +60,31 @@ public:
 
   bool is_ping_message(const char *json_data, size_t len) const override;
 
+  bool is_pong_message(const char *json_data, size_t len) const override;
+
   bool is_subscription_response(const char *json_data,
                                 size_t len) const override;
 
+  bool is_depth_channel(const std::string &channel) const override;
+
 private:
+  // Last orderbook.1 quote per instrument: deltas only carry changed sides
+  struct ChannelQuote {
+    uint64_t bid_price = 0;
+    double bid_qty = 0.0;
+    uint64_t ask_price = 0;
+    double ask_qty = 0.0;
+  };
+  struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const {
+      return std::hash<std::string_view>{}(s);
+    }
+  };
+
   simdjson::dom::parser parser_;
+  std::unordered_map<std::string, ChannelQuote, NameHash, std::equal_to<>>
+      channel_quotes_;
   static constexpr uint64_t PRICE_SCALE = 100000000ULL; // 10^8
 };
 
@@ -1,14 +1,19 @@
 #include "bybit_connection.h"
 #include "config/config.h"
 #include "core/logging.h"
+#include "core/tsc_clock.h"
+#include "modules/network/frame_capture.h"
+#include "modules/telemetry/feed_latency_monitor.h"
+#include "modules/telemetry/load_governor.h"
+#include <algorithm>
 #include <iostream>
+#include <unordered_set>
 
 namespace aero {
 
-BybitConnection::BybitConnection(UdpPublisher *udp_publisher)
+BybitConnection::BybitConnection(const FeedSinks &sinks)
     : ws_client_(std::make_unique<BoostWebSocketClient>()),
-      adapter_(std::make_unique<BybitAdapter>()),
-      udp_publisher_(udp_publisher) {}
+      adapter_(std::make_unique<BybitAdapter>()), sinks_(sinks) {}
 
 BybitConnection::~BybitConnection() {}
 
@@ -24,6 +29,13 @@ bool BybitConnection::connect() {
   std::string port = "443";
   std::string path = "/v5/public/linear";
 
+  flush_tsc_ = TscClock::instance().ns_to_tsc(
+      static_cast<uint64_t>(app_config.feed_conflate_flush_us) * 1000ULL);
+
+  if (capture_id_ < 0)
+    capture_id_ = FrameCapture::instance().add_connection(
+        ExchangeId::BYBIT, host + ":" + port + path);
+
   LOG_SYSTEM("BybitConnection: Connecting to " << host << ":" << port << path
                                                << "...");
 
@@ -72,22 +84,101 @@ void BybitConnection::resubscribe() {
   }
 }
 
+void BybitConnection::resync(bool only_trimmed) {
+  // Re-subscribing makes the exchange start over with a snapshot, which
+  // supersedes books built from a stream that lost messages (or levels
+  // skipped while shedding load). Only depth channels are resubscribed:
+  // trades and top of book hold no state, and a resubscribe would just
+  // lose whatever arrives meanwhile.
+  LoadGovernor &gov = LoadGovernor::instance();
+  std::unordered_set<std::string> trimmed; // Flag taken once per instrument
+  for (const auto &sub : active_subscriptions_) {
+    if (!adapter_->is_depth_channel(sub.channel))
+      continue;
+    for (const auto &inst : sub.instruments) {
+      if (gov.take_trimmed(ExchangeId::BYBIT, inst))
+        trimmed.insert(inst);
+    }
+  }
+
+  size_t count = 0;
+  for (const auto &sub : active_subscriptions_) {
+    if (!adapter_->is_depth_channel(sub.channel))
+      continue;
+    for (const auto &inst : sub.instruments) {
+      if (only_trimmed && trimmed.count(inst) == 0)
+        continue;
+      ws_client_->send(
+          adapter_->generate_unsubscribe_message(inst, sub.channel));
+      ws_client_->send(adapter_->generate_subscribe_message(inst, sub.channel));
+      count++;
+    }
+  }
+  if (count > 0)
+    LOG_SYSTEM("BybitConnection: Resubscribed " << count << " channel(s) "
+               << (only_trimmed ? "trimmed while shedding load"
+                                : "after receive queue overflow"));
+}
+
 void BybitConnection::poll(
     std::function<void(const ParsedOrderBook &)> on_orderbook_callback) {
+  // While behind, conflated outputs still go out every few frames or
+  // microseconds rather than only once the queue is empty
+  LoadGovernor &gov = LoadGovernor::instance();
+  uint32_t flush_frames =
+      static_cast<uint32_t>(std::max(app_config.feed_conflate_flush_frames, 1));
+  uint64_t deferred_since = 0;
+  uint32_t frames = 0; // Processed since outputs were first held back
+
   while (true) {
     auto msg_opt = ws_client_->get_next_message();
     if (!msg_opt) {
       break;
     }
-    process_message(*msg_opt, on_orderbook_callback);
+    FrameCapture::instance().record(static_cast<uint16_t>(capture_id_),
+                                    ExchangeId::BYBIT, msg_opt->data,
+                                    msg_opt->rx_tsc);
+
+    size_t backlog = static_cast<size_t>(app_config.feed_conflate_backlog);
+    behind_ = backlog > 0 && ws_client_->backlog() >= backlog;
+    process_message(msg_opt->data, msg_opt->rx_tsc, on_orderbook_callback);
+
+    // Dropped frames leave books wrong: ask for fresh snapshots now, not
+    // after the backlog behind the drop is worked off
+    if (ws_client_->take_overflow())
+      resync(false);
+
+    if (!sinks_.conflator || sinks_.conflator->empty() || gov.shedding()) {
+      frames = 0;
+      continue;
+    }
+    uint64_t now = TscClock::now_tsc();
+    if (frames++ == 0) {
+      deferred_since = now;
+    } else if (frames >= flush_frames || now - deferred_since >= flush_tsc_) {
+      flush_deferred(sinks_);
+      frames = 0;
+    }
+  }
+
+  // Caught up: send what was conflated while behind (held back further
+  // while shedding load)
+  behind_ = false;
+  if (!gov.shedding()) {
+    flush_deferred(sinks_);
+    if (gov.has_trimmed())
+      resync(true);
   }
+
+  if (ws_client_->take_overflow())
+    resync(false);
 }
 
 void BybitConnection::process_message(
-    const std::string &msg,
+    const std::string &msg, uint64_t rx_tsc,
     std::function<void(const ParsedOrderBook &)> &callback) {
   // DEBUG: Log all incoming messages (controlled by DEBUG_LOG_ENABLED)
-  if (app_config.debug_log_enabled) {
+  if (app_config.debug_log_enabled && !logging_shed_skip()) {
     LOG_SYSTEM("DEBUG Bybit Message: " << msg);
   }
 
@@ -104,20 +195,49 @@ void BybitConnection::process_message(
     return;
   }
 
-  // 2. Check for Subscription Response
+  // 2. Check for Pong (reply to our heartbeat, used for RTT sampling)
+  if (adapter_->is_pong_message(msg.c_str(), msg.length())) {
+    FeedLatencyMonitor::instance().on_pong_received(ExchangeId::BYBIT, rx_tsc);
+    return;
+  }
+
+  // 3. Check for Subscription Response
   if (adapter_->is_subscription_response(msg.c_str(), msg.length())) {
     LOG_SYSTEM("BybitConnection: Subscription response: " << msg);
     return;
   }
 
-  // 3. Try parsing OrderBook
+  // 4. Top-of-book channel: straight to the BBO outputs
+  ParsedBbo bbo;
+  if (adapter_->parse_bbo_message(msg.c_str(), msg.length(), bbo)) {
+    bbo.rx_tsc = rx_tsc;
+    if (app_config.latency_monitor_enabled) {
+      FeedLatencyMonitor::instance().record(ExchangeId::BYBIT, bbo.instrument,
+                                            bbo.timestamp_ms, rx_tsc);
+    }
+    route_bbo(sinks_, ExchangeId::BYBIT, bbo);
+    return;
+  }
+
+  // 5. Public trades: never conflated
+  if (adapter_->parse_trades_message(msg.c_str(), msg.length(), trades_)) {
+    trades_.rx_tsc = rx_tsc;
+    route_trades(sinks_, ExchangeId::BYBIT, trades_);
+    return;
+  }
+
+  // 6. Try parsing OrderBook
   ParsedOrderBook book;
   if (adapter_->parse_orderbook_message(msg.c_str(), msg.length(), book)) {
-    // Broadcast via UDP if enabled
-    if (udp_publisher_ && udp_publisher_->is_initialized()) {
-      udp_publisher_->publish(book, ExchangeId::BYBIT);
+    book.rx_tsc = rx_tsc;
+    if (app_config.latency_monitor_enabled) {
+      FeedLatencyMonitor::instance().record(ExchangeId::BYBIT, book.instrument,
+                                            book.timestamp_ms, rx_tsc);
     }
 
+    // Local books, shm bus, UDP feeds
+    route_book(sinks_, ExchangeId::BYBIT, book, behind_);
+
     if (callback) {
       callback(book);
     }
@@ -126,6 +246,8 @@ void BybitConnection::process_message(
 
 void BybitConnection::send_heartbeat() {
   if (ws_client_ && ws_client_->is_connected()) {
+    FeedLatencyMonitor::instance().on_ping_sent(ExchangeId::BYBIT,
+                                                TscClock::now_tsc());
     ws_client_->send(R"({"op":"ping"})");
   }
 }
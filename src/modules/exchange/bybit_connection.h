@@ -1,8 +1,8 @@
 #pragma once
 
 #include "../network/boost_websocket_client.h"
-#include "../network/udp_publisher.h"
 #include "bybit_adapter.h"
+#include "feed_sinks.h"
 #include <functional>
 #include <memory>
 #include <string>
@@ -12,7 +12,10 @@ namespace aero {
 
 class BybitConnection {
 public:
-  BybitConnection(UdpPublisher *udp_publisher = nullptr);
+  /**
+   * @param sinks Consumers of the parsed books (UDP feed, local books, ...)
+   */
+  explicit BybitConnection(const FeedSinks &sinks = {});
   ~BybitConnection();
 
   // Delete copy constructors
@@ -50,6 +53,11 @@ public:
    */
   bool is_connected() const;
 
+  /**
+   * @brief Received messages not yet processed.
+   */
+  size_t backlog() const { return ws_client_ ? ws_client_->backlog() : 0; }
+
   /**
    * @brief Sends an order message to the exchange.
    * @param json_msg The JSON string of the order.
@@ -59,10 +67,10 @@ public:
 private:
   std::unique_ptr<BoostWebSocketClient> ws_client_;
   std::unique_ptr<BybitAdapter> adapter_;
-  UdpPublisher *udp_publisher_; // Non-owning pointer
+  FeedSinks sinks_;
 
   // Internal helper to process a single message string
-  void process_message(const std::string &msg,
+  void process_message(const std::string &msg, uint64_t rx_tsc,
                        std::function<void(const ParsedOrderBook &)> &callback);
 
   struct Subscription {
@@ -71,6 +79,18 @@ private:
   };
   std::vector<Subscription> active_subscriptions_;
   void resubscribe();
+  void resync(bool only_trimmed);
+
+  // Receive queue past FEED_CONFLATE_BACKLOG: outputs are conflated
+  bool behind_ = false;
+  // feed_conflate_flush_us in TSC ticks, set by connect()
+  uint64_t flush_tsc_ = 0;
+
+  // Reused for every trades message, so parsing them does not allocate
+  ParsedTrades trades_;
+
+  // FrameCapture id, assigned on the first connect()
+  int capture_id_ = -1;
 
   // For testing only
 public:
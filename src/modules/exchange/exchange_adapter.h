@@ -29,20 +29,78 @@ struct PriceLevel {
 
 /**
  * @brief Parsed order book data from any exchange
+ *
+ * Parsing appends levels; clear() before reusing one, which keeps the
+ * vectors' capacity.
  */
 struct ParsedOrderBook {
   std::string instrument;
   std::vector<PriceLevel> bids;
   std::vector<PriceLevel> asks;
-  bool is_snapshot;
-  uint64_t timestamp_ms;
+  bool is_snapshot = false;
+  uint64_t timestamp_ms = 0; // Exchange event time (Unix ms)
+  uint64_t rx_tsc = 0;       // Local TSC when the frame was received
+
+  void clear() {
+    instrument.clear();
+    bids.clear();
+    asks.clear();
+    is_snapshot = false;
+    timestamp_ms = 0;
+    rx_tsc = 0;
+  }
+};
+
+/**
+ * @brief Top of book from a venue's dedicated BBO channel
+ *
+ * A price of 0 means that side is empty.
+ */
+struct ParsedBbo {
+  std::string instrument;
+  uint64_t bid_price = 0; // Scaled by PRICE_SCALE (10^8)
+  double bid_qty = 0.0;
+  uint64_t ask_price = 0;
+  double ask_qty = 0.0;
+  uint64_t timestamp_ms = 0; // Exchange event time (Unix ms)
+  uint64_t rx_tsc = 0;       // Local TSC when the frame was received
+
+  void clear() {
+    instrument.clear();
+    bid_price = ask_price = 0;
+    bid_qty = ask_qty = 0.0;
+    timestamp_ms = 0;
+    rx_tsc = 0;
+  }
+};
+
+/**
+ * @brief One public trade print
+ */
+struct TradePrint {
+  uint64_t price_int;    // Price scaled by PRICE_SCALE (10^8)
+  double qty;
+  uint64_t timestamp_ms; // Exchange trade time (Unix ms)
+  bool is_sell;          // Aggressor (taker) side
+};
+
+/**
+ * @brief Trades of one public trades message (one instrument)
+ *
+ * Meant to be reused: parsing clears `trades` without releasing its
+ * capacity, so steady-state parsing does not allocate.
+ */
+struct ParsedTrades {
+  std::string instrument;
+  std::vector<TradePrint> trades;
+  uint64_t rx_tsc = 0; // Local TSC when the frame was received
 };
 
 /**
  * @brief Abstract interface for exchange-specific logic
  *
  * Each exchange adapter implements this interface to handle:
- * - Order book message parsing
+ * - Order book, top-of-book and trades message parsing
  * - Subscription message generation
  * - Heartbeat (ping/pong) handling
  */
@@ -74,6 +132,33 @@ public:
   virtual bool parse_orderbook_message(const char *json_data, size_t len,
                                        ParsedOrderBook &out_book) = 0;
 
+  /**
+   * @brief Parse a top-of-book channel message (e.g. OKX "bbo-tbt")
+   *
+   * Tried before parse_orderbook_message(), so it must reject anything else
+   * cheaply. Exchanges without such a channel keep the default.
+   *
+   * @return true if this was a BBO channel update
+   */
+  virtual bool parse_bbo_message(const char * /*json_data*/, size_t /*len*/,
+                                 ParsedBbo & /*out_bbo*/) {
+    return false;
+  }
+
+  /**
+   * @brief Parse a public trades message (e.g. OKX "trades")
+   *
+   * Same contract as parse_bbo_message(): anything else is rejected before
+   * it is parsed.
+   *
+   * @return true if this was a trades update
+   */
+  virtual bool parse_trades_message(const char * /*json_data*/,
+                                    size_t /*len*/,
+                                    ParsedTrades & /*out_trades*/) {
+    return false;
+  }
+
   /**
    * @brief Generate subscription message for a channel
    * @param instrument Instrument ID (exchange-specific format)
@@ -91,6 +176,14 @@ public:
   generate_unsubscribe_message(const std::string &instrument,
                                const std::string &channel) const = 0;
 
+  /**
+   * @brief Check if a channel carries an incremental depth book
+   *
+   * Only these channels need a fresh snapshot when the local book is lost
+   * (trades and top-of-book channels hold no state to repair).
+   */
+  virtual bool is_depth_channel(const std::string &channel) const = 0;
+
   /**
    * @brief Generate pong response for heartbeat
    * @param ping_data Original ping data (if needed for echo)
@@ -106,6 +199,13 @@ public:
    */
   virtual bool is_ping_message(const char *json_data, size_t len) const = 0;
 
+  /**
+   * @brief Check if a message is the reply to our own heartbeat ping
+   * @param json_data Message to check
+   * @return true if this is a pong message
+   */
+  virtual bool is_pong_message(const char *json_data, size_t len) const = 0;
+
   /**
    * @brief Check if a message is a subscription confirmation
    */
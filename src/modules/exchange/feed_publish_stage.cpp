@@ -0,0 +1,187 @@
+#include "feed_publish_stage.h"
+#include "../common/symbol_registry.h"
+#include "core/logging.h"
+#include "core/tsc_clock.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace aero {
+
+static_assert(sizeof(PriceLevel) == 16,
+              "Levels are copied as {price_int, size} pairs");
+static_assert((FeedPublishStage::RECORD_ALIGN &
+               (FeedPublishStage::RECORD_ALIGN - 1)) == 0,
+              "RECORD_ALIGN divides every larger power of two");
+
+FeedPublishStage::FeedPublishStage(UdpPublisher &udp,
+                                   BookSnapshotServer *snapshots,
+                                   size_t ring_bytes)
+    : udp_(udp), snapshots_(snapshots) {
+  // A power of two from RECORD_ALIGN * 64 up is a multiple of RECORD_ALIGN,
+  // as aligned_alloc requires
+  size_t pow2 = RECORD_ALIGN * 64;
+  while (pow2 < ring_bytes)
+    pow2 <<= 1;
+  ring_ = static_cast<uint8_t *>(std::aligned_alloc(RECORD_ALIGN, pow2));
+  if (!ring_) {
+    LOG_SYSTEM("FeedPublishStage: Failed to allocate a " << pow2 / 1024
+                                                         << " KB ring");
+    return;
+  }
+  capacity_ = pow2;
+  mask_ = pow2 - 1;
+  LOG_SYSTEM("FeedPublishStage: " << capacity_ / 1024 << " KB ring");
+}
+
+FeedPublishStage::~FeedPublishStage() { std::free(ring_); }
+
+size_t FeedPublishStage::record_size(const ParsedOrderBook &book) const {
+  return round_up(sizeof(Event) + (book.bids.size() + book.asks.size()) * 16,
+                  RECORD_ALIGN);
+}
+
+bool FeedPublishStage::write(uint32_t id, ExchangeId exchange_id,
+                             const ParsedOrderBook &book) {
+  size_t len = record_size(book);
+
+  // Records are contiguous; one that would cross the end of the ring is
+  // preceded by a padding record up to the end
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  size_t off = head & mask_;
+  size_t pad = off + len > capacity_ ? capacity_ - off : 0;
+  if (head + pad + len - cached_tail_ > capacity_) {
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    if (head + pad + len - cached_tail_ > capacity_)
+      return false;
+  }
+
+  if (pad) {
+    Event filler{};
+    filler.len = static_cast<uint32_t>(pad);
+    filler.symbol_id = PAD_ID;
+    std::memcpy(ring_ + off, &filler, sizeof(filler));
+    off = 0;
+  }
+
+  Event ev{};
+  ev.len = static_cast<uint32_t>(len);
+  ev.symbol_id = id;
+  ev.exchange_id = static_cast<uint8_t>(exchange_id);
+  ev.is_snapshot = book.is_snapshot;
+  ev.bid_count = static_cast<uint32_t>(book.bids.size());
+  ev.ask_count = static_cast<uint32_t>(book.asks.size());
+  ev.timestamp_ms = book.timestamp_ms;
+  ev.rx_tsc = book.rx_tsc;
+  ev.enqueue_tsc = TscClock::now_tsc();
+
+  uint8_t *p = ring_ + off;
+  std::memcpy(p, &ev, sizeof(ev));
+  p += sizeof(ev);
+  std::memcpy(p, book.bids.data(), book.bids.size() * 16);
+  std::memcpy(p + book.bids.size() * 16, book.asks.data(),
+              book.asks.size() * 16);
+
+  head_.store(head + pad + len, std::memory_order_release);
+  return true;
+}
+
+bool FeedPublishStage::push(ExchangeId exchange_id, uint32_t id,
+                            const ParsedOrderBook &book) {
+  if (record_size(book) > capacity_ / 2) {
+    // Could never fit alongside anything else
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    LOG_SYSTEM("FeedPublishStage: dropped " << book.instrument << " update of "
+                                            << book.bids.size() +
+                                                   book.asks.size()
+                                            << " levels, ring too small");
+    return false;
+  }
+
+  // Older conflated updates go first; this one only bypasses them if its
+  // symbol has none pending
+  if (!conflator_.empty())
+    pump();
+  if (!conflator_.pending(id) && write(id, exchange_id, book))
+    return true;
+
+  conflator_.add(id, exchange_id, book);
+  conflated_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void FeedPublishStage::pump() {
+  conflator_.drain(
+      [this](uint32_t id, ExchangeId exchange_id, const ParsedOrderBook &book) {
+        if (record_size(book) > capacity_ / 2) {
+          // Merged past what the ring can take: lost, like an oversized push
+          dropped_.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+        return write(id, exchange_id, book);
+      });
+}
+
+const std::string &FeedPublishStage::instrument(uint32_t id) {
+  if (id >= names_.size())
+    names_.resize(id + 1);
+  if (names_[id].empty()) {
+    SymbolRegistry::Entry entry;
+    if (SymbolRegistry::instance().lookup(id, entry))
+      names_[id] = std::move(entry.instrument);
+  }
+  return names_[id];
+}
+
+void FeedPublishStage::publish_event(const Event &ev, const uint8_t *levels) {
+  book_.instrument = instrument(ev.symbol_id);
+  book_.is_snapshot = ev.is_snapshot != 0;
+  book_.timestamp_ms = ev.timestamp_ms;
+  book_.rx_tsc = ev.rx_tsc;
+  book_.bids.resize(ev.bid_count);
+  book_.asks.resize(ev.ask_count);
+  std::memcpy(book_.bids.data(), levels, ev.bid_count * 16);
+  std::memcpy(book_.asks.data(), levels + ev.bid_count * 16,
+              ev.ask_count * 16);
+
+  udp_.publish(book_, static_cast<ExchangeId>(ev.exchange_id), ev.symbol_id);
+
+  // The local book may already be ahead of this position; see
+  // BookSnapshotServer::set_position()
+  const FeedPosition &pos = udp_.last_position();
+  if (snapshots_ && pos.seq != 0)
+    snapshots_->set_position(ev.symbol_id, pos.channel, pos.seq);
+}
+
+size_t FeedPublishStage::poll(size_t max_events) {
+  uint64_t tail = tail_.load(std::memory_order_relaxed);
+  size_t n = 0;
+
+  while (n < max_events) {
+    if (tail == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail == cached_head_)
+        break;
+    }
+
+    const uint8_t *p = ring_ + (tail & mask_);
+    Event ev;
+    std::memcpy(&ev, p, sizeof(ev));
+    if (ev.symbol_id != PAD_ID) {
+      max_delay_tsc_ =
+          std::max(max_delay_tsc_, TscClock::now_tsc() - ev.enqueue_tsc);
+      publish_event(ev, p + sizeof(ev));
+      n++;
+    }
+    tail += ev.len;
+    tail_.store(tail, std::memory_order_release);
+  }
+
+  if (n > 0)
+    published_.fetch_add(n, std::memory_order_relaxed);
+  if (tail == cached_head_)
+    udp_.flush(); // Drained: send what this round batched up
+  return n;
+}
+
+} // namespace aero
@@ -0,0 +1,162 @@
+/**
+ * @file feed_publish_stage.h
+ * @brief Hands book updates from the feed-handler lcore to a UDP publishing
+ *        lcore
+ */
+
+#ifndef AERO_MODULES_EXCHANGE_FEED_PUBLISH_STAGE_H
+#define AERO_MODULES_EXCHANGE_FEED_PUBLISH_STAGE_H
+
+#include "../market_data/book_snapshot_server.h"
+#include "../market_data/book_conflator.h"
+#include "../network/udp_publisher.h"
+#include "exchange_adapter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Lock-free SPSC queue of book updates in front of a UdpPublisher
+ *
+ * With the stage in place the feed-handler lcore only copies each update
+ * (symbol id and raw levels) into a byte ring and returns to parse -> apply
+ * -> strategy callback; serialization, FEC and sendmmsg() run on the
+ * publishing lcore, which owns the UdpPublisher from then on.
+ *
+ * Records are variable-length and 64-byte aligned; producer and consumer
+ * indices live on separate cache lines and each side caches the other's
+ * index, so neither touches a shared line per event unless the ring looks
+ * full or empty.
+ *
+ * A full ring never blocks the feed thread. Updates that do not fit go to
+ * a BookConflator instead, where further updates of the same symbol merge
+ * into one; pump() moves them into the ring as space frees up. The
+ * publisher thus falls behind by at most one merged update per symbol
+ * rather than losing updates, and per-symbol order is kept because a
+ * symbol with a conflated update pending never bypasses it.
+ */
+class FeedPublishStage {
+public:
+  static constexpr size_t RECORD_ALIGN = 64;
+
+  /**
+   * @param udp Publisher driven by poll(); must not be used elsewhere
+   * @param snapshots Snapshot service to report feed positions to, or null
+   * @param ring_bytes Ring size (rounded up to a power of two)
+   */
+  FeedPublishStage(UdpPublisher &udp, BookSnapshotServer *snapshots,
+                   size_t ring_bytes);
+  ~FeedPublishStage();
+
+  FeedPublishStage(const FeedPublishStage &) = delete;
+  FeedPublishStage &operator=(const FeedPublishStage &) = delete;
+
+  /**
+   * @brief False if the ring could not be allocated; the stage must then
+   *        not be used
+   */
+  bool is_initialized() const { return ring_ != nullptr; }
+
+  /**
+   * @brief Queue an update (feed-handler lcore)
+   * @return false if the update was conflated rather than queued
+   */
+  bool push(ExchangeId exchange_id, uint32_t symbol_id,
+            const ParsedOrderBook &book);
+
+  /**
+   * @brief Move conflated updates into the ring while there is room
+   *        (feed-handler lcore, once per poll cycle)
+   */
+  void pump();
+
+  /**
+   * @brief Symbols with a conflated update waiting (feed-handler lcore)
+   */
+  size_t backlog() const { return conflator_.size(); }
+
+  /**
+   * @brief Publish up to max_events queued updates (publishing lcore)
+   *
+   * Flushes the UdpPublisher once the ring has been drained, like the feed
+   * loop does at the end of each poll cycle.
+   *
+   * @return Updates published
+   */
+  size_t poll(size_t max_events = 64);
+
+  UdpPublisher &publisher() { return udp_; }
+
+  /**
+   * @brief Largest enqueue-to-publish delay since the last call, in TSC
+   *        cycles (publishing lcore)
+   */
+  uint64_t take_max_delay_tsc() {
+    uint64_t v = max_delay_tsc_;
+    max_delay_tsc_ = 0;
+    return v;
+  }
+
+  // Counters (any thread)
+  uint64_t published() const {
+    return published_.load(std::memory_order_relaxed);
+  }
+  uint64_t conflated() const {
+    return conflated_.load(std::memory_order_relaxed);
+  }
+  // Updates too large for the ring at all
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr uint32_t PAD_ID = UINT32_MAX; // Fills the end of the ring
+
+  struct Event {
+    uint32_t len;       // Bytes including this header, RECORD_ALIGN multiple
+    uint32_t symbol_id; // SymbolRegistry id, or PAD_ID
+    uint8_t exchange_id;
+    uint8_t is_snapshot;
+    uint16_t reserved;
+    uint32_t bid_count;
+    uint32_t ask_count;
+    uint32_t reserved2;
+    uint64_t timestamp_ms;
+    uint64_t rx_tsc;
+    uint64_t enqueue_tsc;
+    // PriceLevel bids[bid_count], asks[ask_count] follow
+  };
+
+  size_t record_size(const ParsedOrderBook &book) const;
+  bool write(uint32_t id, ExchangeId exchange_id, const ParsedOrderBook &book);
+  void publish_event(const Event &ev, const uint8_t *levels);
+  const std::string &instrument(uint32_t id);
+
+  UdpPublisher &udp_;
+  BookSnapshotServer *snapshots_;
+  uint8_t *ring_ = nullptr; // RECORD_ALIGN aligned
+  size_t capacity_ = 0;
+  size_t mask_ = 0;
+
+  // Producer (feed-handler lcore)
+  alignas(64) std::atomic<uint64_t> head_{0};
+  uint64_t cached_tail_ = 0;
+  BookConflator conflator_; // Updates waiting for ring space
+
+  // Consumer (publishing lcore)
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  uint64_t cached_head_ = 0;
+  ParsedOrderBook book_;           // Rebuilt for each event
+  std::vector<std::string> names_; // Per symbol id, from SymbolRegistry
+  uint64_t max_delay_tsc_ = 0;
+
+  alignas(64) std::atomic<uint64_t> published_{0};
+  std::atomic<uint64_t> conflated_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_EXCHANGE_FEED_PUBLISH_STAGE_H
@@ -0,0 +1,390 @@
+#include "feed_sinks.h"
+#include "../common/symbol_registry.h"
+#include "../telemetry/load_governor.h"
+#include "feed_publish_stage.h"
+#include <algorithm>
+
+namespace aero {
+
+// Every route resolves ids here, on the feed-handler lcore: after the
+// first sighting of a symbol without the registry lock
+static uint32_t symbol_id(ExchangeId exchange_id,
+                          const std::string &instrument) {
+  thread_local SymbolIdCache ids;
+  return ids.get_or_assign(exchange_id, instrument);
+}
+
+static inline bool applied_consumers(const FeedSinks &sinks) {
+  return (sinks.strategy && sinks.strategy->is_loaded()) ||
+         (sinks.arbitrage && sinks.arbitrage->enabled());
+}
+
+// Newest-wins against the symbol's BBO channel; always true without one.
+// A depth update goes to the arbiter once, when it is applied; the outputs
+// of a deferred one only check later that it is still the newest.
+static bool depth_bbo_fresh(const FeedSinks &sinks, uint32_t id,
+                            const ParsedOrderBook &book, bool admitted) {
+  if (!sinks.bbo_arbiter)
+    return true;
+  return admitted
+             ? sinks.bbo_arbiter->fresh(id, book.timestamp_ms)
+             : sinks.bbo_arbiter->accept(id, book.timestamp_ms,
+                                         BboArbiter::DEPTH);
+}
+
+// Consumers of every update as it is applied to the local book, deferred or
+// not. The strategy goes first: it is what the gateway trades on. `bbo` is
+// null while a side of the book is empty; `fresh` is false when the BBO
+// channel already delivered a newer top of book, which the strategy's
+// on_bbo and the arbitrage engine then keep.
+static void on_applied(const FeedSinks &sinks, ExchangeId exchange_id,
+                       uint32_t id, const ParsedOrderBook &book,
+                       const BestBidOffer *bbo, bool fresh) {
+  if (!applied_consumers(sinks))
+    return;
+  if (sinks.strategy && sinks.strategy->is_loaded())
+    sinks.strategy->on_book(exchange_id, id, book, bbo, fresh);
+  if (fresh && sinks.arbitrage && sinks.arbitrage->enabled())
+    sinks.arbitrage->on_bbo(exchange_id, id, bbo, book.rx_tsc);
+}
+
+static_assert(BookAnalytics::MAX_LEVELS == FEED_BBO_DEPTHS,
+              "every analytics depth window fits the BBO channel record");
+
+static BboAnalytics to_bbo_analytics(const BookAnalytics &a) {
+  BboAnalytics out{};
+  out.microprice = a.microprice;
+  out.bid_vwap = a.bid_vwap;
+  out.ask_vwap = a.ask_vwap;
+  for (uint32_t i = 0; i < a.levels; i++) {
+    out.bid_depth[i] = a.bid_depth[i];
+    out.ask_depth[i] = a.ask_depth[i];
+  }
+  return out;
+}
+
+// `id` is the symbol's SymbolRegistry id, resolved once per update for
+// every sink. `apply` is false for updates already applied to the local
+// books when defer_book() held them back.
+static void dispatch(const FeedSinks &sinks, ExchangeId exchange_id,
+                     uint32_t id, const ParsedOrderBook &book, bool apply) {
+  ShmBusPublisher *shm =
+      sinks.shm_bus && sinks.shm_bus->is_initialized() ? sinks.shm_bus
+                                                       : nullptr;
+  BboPublisher *bbo_pub =
+      sinks.bbo && sinks.bbo->is_initialized() ? sinks.bbo : nullptr;
+  // Deferred updates were recorded when defer_book() applied them
+  TickHistoryWriter *history =
+      apply && sinks.history && sinks.history->is_running() ? sinks.history
+                                                            : nullptr;
+
+  FeedPublishStage *stage = sinks.udp_stage;
+  bool udp = !stage && sinks.udp && sinks.udp->is_initialized();
+
+  // Book apply and UDP publish form one step for the snapshot service, so a
+  // snapshot always comes with the seq of the last datagram it reflects
+  // (with the stage, the publishing lcore reports positions instead)
+  uint32_t snap_id = SymbolRegistry::INVALID_ID;
+  if (sinks.snapshots && sinks.books)
+    snap_id = sinks.snapshots->begin_update(exchange_id, id, book.instrument);
+
+  BestBidOffer bbo;
+  BookAnalytics analytics;
+  bool have_bbo = false;
+  bool with_analytics = false;
+  OrderBook *ob = nullptr;
+  if (sinks.books) {
+    ob = apply ? &sinks.books->apply_book(exchange_id, id, book)
+               : &sinks.books->get_book(exchange_id, book.instrument);
+    // Analytics ride the BBO channel, read under the same lock as the BBO
+    with_analytics = bbo_pub && sinks.books->analytics_enabled();
+    have_bbo = (shm || bbo_pub || history ||
+                (apply && applied_consumers(sinks))) &&
+               (with_analytics ? ob->get_bbo(bbo, analytics)
+                               : ob->get_bbo(bbo));
+    bool fresh = depth_bbo_fresh(sinks, id, book, !apply);
+    if (apply)
+      on_applied(sinks, exchange_id, id, book, have_bbo ? &bbo : nullptr,
+                 fresh);
+    // Older than what the BBO channel published: must not take it back
+    have_bbo = have_bbo && fresh;
+  }
+  BboQuote quote{bbo.bid_price, bbo.bid_qty, bbo.ask_price, bbo.ask_qty};
+
+  if (shm) {
+    shm->publish_book(exchange_id, id, book);
+    if (have_bbo)
+      shm->publish_bbo(exchange_id, id, book.instrument, quote,
+                       book.timestamp_ms, book.rx_tsc);
+  }
+
+  if (stage)
+    stage->push(exchange_id, id, book);
+  else if (udp)
+    sinks.udp->publish(book, exchange_id, id);
+
+  if (snap_id != SymbolRegistry::INVALID_ID) {
+    FeedPosition pos = udp ? sinks.udp->last_position() : FeedPosition{};
+    sinks.snapshots->end_update(snap_id, *ob, pos.channel, pos.seq,
+                                book.timestamp_ms);
+  }
+
+  if (bbo_pub && have_bbo) {
+    BboAnalytics bbo_analytics;
+    if (with_analytics)
+      bbo_analytics = to_bbo_analytics(analytics);
+    bbo_pub->update(exchange_id, id, book.instrument, quote,
+                    book.timestamp_ms, book.rx_tsc,
+                    with_analytics ? &bbo_analytics : nullptr);
+  }
+
+  // Off the publish path: recording must not delay any output
+  if (history && have_bbo)
+    history->on_bbo(id, bbo, book.timestamp_ms, book.rx_tsc);
+}
+
+static void dispatch_symbol(const FeedSinks &sinks, ExchangeId exchange_id,
+                            uint32_t id, const ParsedOrderBook &book) {
+  if (sinks.conflator && !sinks.conflator->empty() &&
+      sinks.conflator->pending(id))
+    flush_deferred(sinks);
+  dispatch(sinks, exchange_id, id, book, true);
+}
+
+static void defer_symbol(const FeedSinks &sinks, ExchangeId exchange_id,
+                         uint32_t id, const ParsedOrderBook &book) {
+  if (!sinks.conflator) {
+    dispatch_symbol(sinks, exchange_id, id, book);
+    return;
+  }
+
+  if (sinks.books) {
+    // Still bracketed for the snapshot service, but with no new feed
+    // position: the one recorded trails the book until the flush
+    uint32_t snap_id = sinks.snapshots ? sinks.snapshots->begin_update(
+                                             exchange_id, id, book.instrument)
+                                       : SymbolRegistry::INVALID_ID;
+    OrderBook &ob = sinks.books->apply_book(exchange_id, id, book);
+    bool history = sinks.history && sinks.history->is_running();
+    BestBidOffer bbo;
+    bool have_bbo =
+        (history || applied_consumers(sinks)) && ob.get_bbo(bbo);
+    bool fresh = depth_bbo_fresh(sinks, id, book, false);
+    on_applied(sinks, exchange_id, id, book, have_bbo ? &bbo : nullptr,
+               fresh);
+    have_bbo = have_bbo && fresh;
+    if (snap_id != SymbolRegistry::INVALID_ID)
+      sinks.snapshots->end_update(snap_id, ob, 0, 0, book.timestamp_ms);
+
+    if (history && have_bbo)
+      sinks.history->on_bbo(id, bbo, book.timestamp_ms, book.rx_tsc);
+  }
+
+  sinks.conflator->add(id, exchange_id, book);
+}
+
+void dispatch_book(const FeedSinks &sinks, ExchangeId exchange_id,
+                   const ParsedOrderBook &book) {
+  dispatch_symbol(sinks, exchange_id, symbol_id(exchange_id, book.instrument),
+                  book);
+}
+
+void defer_book(const FeedSinks &sinks, ExchangeId exchange_id,
+                const ParsedOrderBook &book) {
+  defer_symbol(sinks, exchange_id, symbol_id(exchange_id, book.instrument),
+               book);
+}
+
+void flush_deferred(const FeedSinks &sinks) {
+  if (!sinks.conflator)
+    return;
+  sinks.conflator->drain(
+      [&sinks](uint32_t id, ExchangeId exchange_id,
+               const ParsedOrderBook &book) {
+        dispatch(sinks, exchange_id, id, book, false);
+        return true;
+      });
+}
+
+void route_bbo(const FeedSinks &sinks, ExchangeId exchange_id,
+               const ParsedBbo &bbo) {
+  // Same rule as the depth path: a one-sided quote is not published. It is
+  // dropped before the arbiter, so it neither becomes the newest top of
+  // book nor clears the consumers' quote; the depth feed still reports an
+  // emptied side.
+  if (bbo.bid_price == 0 || bbo.ask_price == 0)
+    return;
+
+  uint32_t id = symbol_id(exchange_id, bbo.instrument);
+  if (sinks.bbo_arbiter &&
+      !sinks.bbo_arbiter->accept(id, bbo.timestamp_ms, BboArbiter::CHANNEL))
+    return;
+
+  BestBidOffer top{bbo.bid_price, bbo.bid_qty, bbo.ask_price, bbo.ask_qty};
+  if (sinks.strategy && sinks.strategy->is_loaded())
+    sinks.strategy->on_bbo(exchange_id, id, &top, bbo.timestamp_ms,
+                           bbo.rx_tsc);
+  if (sinks.arbitrage && sinks.arbitrage->enabled())
+    sinks.arbitrage->on_bbo(exchange_id, id, &top, bbo.rx_tsc);
+
+  if (sinks.books)
+    sinks.books->mirror_bbo(exchange_id, id, bbo.instrument, top,
+                            bbo.timestamp_ms, bbo.rx_tsc);
+
+  BboQuote quote{bbo.bid_price, bbo.bid_qty, bbo.ask_price, bbo.ask_qty};
+  if (sinks.shm_bus && sinks.shm_bus->is_initialized())
+    sinks.shm_bus->publish_bbo(exchange_id, id, bbo.instrument, quote,
+                               bbo.timestamp_ms, bbo.rx_tsc);
+  if (sinks.bbo && sinks.bbo->is_initialized())
+    sinks.bbo->update(exchange_id, id, bbo.instrument, quote,
+                      bbo.timestamp_ms, bbo.rx_tsc);
+  if (sinks.history && sinks.history->is_running())
+    sinks.history->on_bbo(id, top, bbo.timestamp_ms, bbo.rx_tsc);
+}
+
+static_assert(TradeFlow::MAX_WINDOWS == FEED_BBO_FLOW_WINDOWS,
+              "every trade flow window fits the BBO channel record");
+
+static BboTradeFlow to_bbo_trade_flow(const TradeFlow &f) {
+  BboTradeFlow out{};
+  out.windows = f.windows;
+  for (uint32_t i = 0; i < f.windows; i++) {
+    out.window_ms[i] = f.window_ms[i];
+    out.trades[i] = f.window[i].trades;
+    out.vwap[i] = f.window[i].vwap;
+    out.buy_qty[i] = f.window[i].buy_qty;
+    out.sell_qty[i] = f.window[i].sell_qty;
+  }
+  return out;
+}
+
+void route_trades(const FeedSinks &sinks, ExchangeId exchange_id,
+                  const ParsedTrades &trades) {
+  if (trades.trades.empty())
+    return;
+  const std::string &instrument = trades.instrument;
+  uint32_t id = symbol_id(exchange_id, instrument);
+
+  if (sinks.strategy && sinks.strategy->is_loaded())
+    for (const TradePrint &t : trades.trades)
+      sinks.strategy->on_trade(exchange_id, id, t.price_int, t.qty, t.is_sell,
+                               t.timestamp_ms, trades.rx_tsc);
+
+  ShmBusPublisher *shm =
+      sinks.shm_bus && sinks.shm_bus->is_initialized() ? sinks.shm_bus
+                                                       : nullptr;
+  BboPublisher *bbo_pub =
+      sinks.bbo && sinks.bbo->is_initialized() ? sinks.bbo : nullptr;
+
+  bool with_flow = false;
+  BboTradeFlow flow;
+  if (sinks.trade_flow && sinks.trade_flow->enabled()) {
+    TradeFlow f;
+    sinks.trade_flow->add(id, trades.trades, f);
+    flow = to_bbo_trade_flow(f);
+    with_flow = true;
+  }
+  uint64_t last_ts = trades.trades.back().timestamp_ms;
+
+  if (shm) {
+    for (const TradePrint &t : trades.trades)
+      shm->publish_trade(exchange_id, id, instrument, t.price_int, t.qty,
+                         t.is_sell, t.timestamp_ms, trades.rx_tsc);
+    if (with_flow)
+      shm->publish_trade_flow(exchange_id, id, instrument, flow, last_ts,
+                              trades.rx_tsc);
+  }
+
+  if (bbo_pub) {
+    for (const TradePrint &t : trades.trades)
+      bbo_pub->trade(exchange_id, id, instrument, t.price_int, t.qty,
+                     t.is_sell, t.timestamp_ms, trades.rx_tsc);
+    if (with_flow)
+      bbo_pub->trade_flow(exchange_id, id, instrument, flow);
+  }
+
+  // Off the publish path: recording must not delay any output
+  if (sinks.history && sinks.history->is_running())
+    for (const TradePrint &t : trades.trades)
+      sinks.history->on_trade(id, t.price_int, t.qty, t.is_sell,
+                              t.timestamp_ms, trades.rx_tsc);
+}
+
+// Keep the levels within the top `n` of the local book (`top`, best first).
+// Removals always stay, but size changes below the top are dropped: a deep
+// level can keep a stale size and surface once the book moves toward it,
+// which is why a trimmed book is flagged degraded until its resync.
+// Returns the number of levels dropped.
+template <bool IS_BID>
+static size_t trim_side(std::vector<PriceLevel> &side,
+                        const std::vector<OrderBookLevel> &top, size_t n,
+                        bool is_snapshot) {
+  size_t before = side.size();
+  if (is_snapshot) {
+    if (side.size() > n) {
+      std::partial_sort(side.begin(), side.begin() + n, side.end(),
+                        [](const PriceLevel &a, const PriceLevel &b) {
+                          return IS_BID ? a.price_int > b.price_int
+                                        : a.price_int < b.price_int;
+                        });
+      side.resize(n);
+    }
+  } else if (top.size() >= n) {
+    uint64_t limit = top[n - 1].price_int;
+    std::erase_if(side, [limit](const PriceLevel &l) {
+      return l.size > 0 &&
+             (IS_BID ? l.price_int < limit : l.price_int > limit);
+    });
+  }
+  return before - side.size();
+}
+
+// A complete snapshot ends what trimming left degraded (before the apply,
+// so the mirror write already carries the cleared flag)
+static void mark_complete(const FeedSinks &sinks, ExchangeId exchange_id,
+                          const ParsedOrderBook &book) {
+  if (book.is_snapshot && sinks.books)
+    sinks.books->get_book(exchange_id, book.instrument).set_degraded(false);
+}
+
+void route_book(const FeedSinks &sinks, ExchangeId exchange_id,
+                ParsedOrderBook &book, bool behind) {
+  LoadGovernor &gov = LoadGovernor::instance();
+  uint32_t id = symbol_id(exchange_id, book.instrument);
+  if (!gov.shedding() || !sinks.conflator) {
+    mark_complete(sinks, exchange_id, book);
+    if (behind)
+      defer_symbol(sinks, exchange_id, id, book);
+    else
+      dispatch_symbol(sinks, exchange_id, id, book);
+    return;
+  }
+
+  if (gov.is_priority(id)) {
+    mark_complete(sinks, exchange_id, book);
+    dispatch_symbol(sinks, exchange_id, id, book); // Full fidelity
+    return;
+  }
+
+  static thread_local std::vector<OrderBookLevel> top_bids, top_asks;
+  size_t n = gov.top_levels();
+  top_bids.clear();
+  top_asks.clear();
+  OrderBook *ob = sinks.books
+                      ? &sinks.books->get_book(exchange_id, book.instrument)
+                      : nullptr;
+  if (!book.is_snapshot && ob)
+    ob->get_depth(n, top_bids, top_asks);
+  size_t dropped = trim_side<true>(book.bids, top_bids, n, book.is_snapshot) +
+                   trim_side<false>(book.asks, top_asks, n, book.is_snapshot);
+  if (dropped > 0)
+    gov.on_trimmed(id, dropped);
+  // Degraded from the first skipped level until a complete snapshot
+  if (ob && (dropped > 0 || book.is_snapshot))
+    ob->set_degraded(dropped > 0);
+
+  defer_symbol(sinks, exchange_id, id, book);
+  gov.on_deferred();
+}
+
+} // namespace aero
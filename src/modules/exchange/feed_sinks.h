@@ -0,0 +1,120 @@
+/**
+ * @file feed_sinks.h
+ * @brief Where the exchange connections deliver parsed books
+ */
+
+#ifndef AERO_MODULES_EXCHANGE_FEED_SINKS_H
+#define AERO_MODULES_EXCHANGE_FEED_SINKS_H
+
+#include "../market_data/bbo_arbiter.h"
+#include "../market_data/book_conflator.h"
+#include "../market_data/book_snapshot_server.h"
+#include "../market_data/order_book.h"
+#include "../market_data/tick_history_writer.h"
+#include "../market_data/trade_flow.h"
+#include "../network/bbo_publisher.h"
+#include "../network/shm_bus_publisher.h"
+#include "../network/udp_publisher.h"
+#include "../strategy/arbitrage_engine.h"
+#include "../strategy/strategy_host.h"
+#include "exchange_adapter.h"
+
+namespace aero {
+
+class FeedPublishStage;
+
+/**
+ * @brief Non-owning set of consumers for parsed order books
+ *
+ * Any member may be null. The BBO outputs and the snapshot service need
+ * `books`, since the state of a delta feed only exists in the maintained
+ * book. With `udp_stage` set, UDP publishing is handed to that stage and
+ * `udp` is not touched from the feed thread. `conflator` enables
+ * defer_book(). `history`, `strategy` and `arbitrage` see each update as it
+ * is applied to the local book, deferred or not. `bbo_arbiter` is set when
+ * symbols also come from a top-of-book channel (route_bbo()): the top of
+ * book then reaches the BBO outputs, history, the book mirror, `arbitrage`
+ * and the strategy's on_bbo only from whichever source is newest.
+ */
+struct FeedSinks {
+  UdpPublisher *udp = nullptr;             // Full-depth UDP feed
+  OrderBookManager *books = nullptr;       // Local books
+  BboPublisher *bbo = nullptr;             // Top-of-book UDP channel
+  ShmBusPublisher *shm_bus = nullptr;      // Same-host shared-memory bus
+  BookSnapshotServer *snapshots = nullptr; // Late-joiner snapshot service
+  FeedPublishStage *udp_stage = nullptr;   // Publishes `udp` on its own lcore
+  BookConflator *conflator = nullptr;      // Outputs held back by defer_book()
+  TickHistoryWriter *history = nullptr;    // On-disk BBO/trade history
+  StrategyHost *strategy = nullptr;        // In-process strategy plugin
+  ArbitrageEngine *arbitrage = nullptr;    // Cross-exchange spreads
+  BboArbiter *bbo_arbiter = nullptr;       // BBO channel vs depth feed
+  TradeFlowAggregator *trade_flow = nullptr; // Rolling trade aggregates
+};
+
+/**
+ * @brief Hand one parsed book to every configured sink
+ *
+ * Same-host outputs (book apply, shm bus) go first; network sends follow.
+ * Called on the feed-handler lcore.
+ */
+void dispatch_book(const FeedSinks &sinks, ExchangeId exchange_id,
+                   const ParsedOrderBook &book);
+
+/**
+ * @brief Apply a book locally but hold back its outputs
+ *
+ * For a feed thread that is behind the exchange: the local books stay
+ * exact, while the shm bus, UDP feeds and BBO channel later get one merged
+ * update per symbol from flush_deferred() instead of every intermediate
+ * one. Falls back to dispatch_book() without a conflator.
+ */
+void defer_book(const FeedSinks &sinks, ExchangeId exchange_id,
+                const ParsedOrderBook &book);
+
+/**
+ * @brief Send the outputs held back by defer_book()
+ *
+ * dispatch_book() does this first as well when its symbol has a deferred
+ * update, so an output never sees a symbol's updates out of order.
+ */
+void flush_deferred(const FeedSinks &sinks);
+
+/**
+ * @brief Dispatch, defer or shed a book depending on load
+ *
+ * While the LoadGovernor sheds load, priority symbols are dispatched in
+ * full and the others are cut to the top levels of their local book and
+ * deferred. Otherwise the book is deferred while the connection is
+ * `behind` and dispatched when it is not.
+ */
+void route_book(const FeedSinks &sinks, ExchangeId exchange_id,
+                ParsedOrderBook &book, bool behind);
+
+/**
+ * @brief Hand a BBO channel update to the top-of-book consumers
+ *
+ * Goes straight to the strategy, the arbitrage engine, the book mirror,
+ * the shm bus, the BBO channel and the tick history, never through the
+ * conflator (one quote is already the latest state). The local books are
+ * not touched: they stay exactly what the depth feed built, and the mirror
+ * only shows the quote on top of them. Dropped when a side is empty or
+ * `bbo_arbiter` has seen a newer quote of the symbol. Called on the
+ * feed-handler lcore.
+ */
+void route_bbo(const FeedSinks &sinks, ExchangeId exchange_id,
+               const ParsedBbo &bbo);
+
+/**
+ * @brief Hand the trades of one message to every trade consumer
+ *
+ * The strategy gets each trade first. Then `trade_flow` adds them to the
+ * symbol's rolling aggregates, and every trade followed by the aggregates
+ * goes to the shm bus and the BBO channel. The history records the trades
+ * last. Trades are never conflated. Called on the feed-handler lcore.
+ */
+void route_trades(const FeedSinks &sinks, ExchangeId exchange_id,
+                  const ParsedTrades &trades);
+
+} // namespace aero
+
+#endif // AERO_MODULES_EXCHANGE_FEED_SINKS_H
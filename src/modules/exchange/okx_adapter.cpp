@@ -4,8 +4,11 @@
  */
 
 #include "okx_adapter.h"
+#include "adapter_json.h"
 #include "config/config.h"
 #include "core/logging.h"
+#include <algorithm>
+#include <charconv>
 #include <cmath>
 #include <sstream>
 
@@ -103,6 +106,107 @@ bool OkxAdapter::parse_orderbook_message(const char *json_data, size_t len,
   }
 }
 
+bool OkxAdapter::parse_bbo_message(const char *json_data, size_t len,
+                                   ParsedBbo &out_bbo) {
+  // "arg" leads every push, so depth frames are turned away before parsing
+  std::string_view head(json_data, std::min<size_t>(len, 64));
+  if (head.find("\"bbo-tbt\"") == std::string_view::npos) {
+    return false;
+  }
+
+  simdjson::dom::element doc;
+  if (parser_.parse(json_data, len).get(doc) != simdjson::SUCCESS) {
+    return false;
+  }
+
+  std::string_view channel, inst_id;
+  auto arg = doc["arg"];
+  if (arg["channel"].get(channel) != simdjson::SUCCESS ||
+      channel != "bbo-tbt" ||
+      arg["instId"].get(inst_id) != simdjson::SUCCESS) {
+    return false;
+  }
+
+  // Subscription events carry the same "arg" but no data
+  simdjson::dom::array data;
+  simdjson::dom::element item;
+  if (doc["data"].get(data) != simdjson::SUCCESS ||
+      data.at(0).get(item) != simdjson::SUCCESS) {
+    return false;
+  }
+
+  double bid_price, bid_size, ask_price, ask_size;
+  if (!json_top_level(item["bids"], bid_price, bid_size) ||
+      !json_top_level(item["asks"], ask_price, ask_size)) {
+    return false;
+  }
+  out_bbo.instrument.assign(inst_id);
+  out_bbo.bid_price =
+      static_cast<uint64_t>(std::round(bid_price * PRICE_SCALE));
+  out_bbo.bid_qty = bid_size;
+  out_bbo.ask_price =
+      static_cast<uint64_t>(std::round(ask_price * PRICE_SCALE));
+  out_bbo.ask_qty = ask_size;
+
+  std::string_view ts_str;
+  uint64_t ts = 0;
+  if (item["ts"].get(ts_str) == simdjson::SUCCESS) {
+    std::from_chars(ts_str.data(), ts_str.data() + ts_str.size(), ts);
+  }
+  out_bbo.timestamp_ms = ts;
+  return true;
+}
+
+bool OkxAdapter::parse_trades_message(const char *json_data, size_t len,
+                                      ParsedTrades &out_trades) {
+  // "trades" only: "trades-all" is served on /ws/v5/business, not on the
+  // public connection
+  std::string_view head(json_data, std::min<size_t>(len, 64));
+  if (head.find("\"trades\"") == std::string_view::npos) {
+    return false;
+  }
+
+  simdjson::dom::element doc;
+  if (parser_.parse(json_data, len).get(doc) != simdjson::SUCCESS) {
+    return false;
+  }
+
+  std::string_view channel, inst_id;
+  auto arg = doc["arg"];
+  if (arg["channel"].get(channel) != simdjson::SUCCESS ||
+      channel != "trades" ||
+      arg["instId"].get(inst_id) != simdjson::SUCCESS) {
+    return false;
+  }
+
+  simdjson::dom::array data;
+  if (doc["data"].get(data) != simdjson::SUCCESS) {
+    return false;
+  }
+
+  out_trades.instrument.assign(inst_id);
+  out_trades.trades.clear();
+  for (simdjson::dom::element item : data) {
+    std::string_view px, sz, side, ts;
+    double price, size;
+    if (item["px"].get(px) != simdjson::SUCCESS ||
+        item["sz"].get(sz) != simdjson::SUCCESS ||
+        item["side"].get(side) != simdjson::SUCCESS ||
+        !json_to_double(px, price) || !json_to_double(sz, size)) {
+      return false;
+    }
+    TradePrint &t = out_trades.trades.emplace_back();
+    t.price_int = static_cast<uint64_t>(std::round(price * PRICE_SCALE));
+    t.qty = size;
+    t.is_sell = side == "sell"; // Taker side
+    t.timestamp_ms = 0;
+    if (item["ts"].get(ts) == simdjson::SUCCESS) {
+      std::from_chars(ts.data(), ts.data() + ts.size(), t.timestamp_ms);
+    }
+  }
+  return true;
+}
+
 std::string
 OkxAdapter::generate_subscribe_message(const std::string &instrument,
                                        const std::string &channel) const {
@@ -125,11 +229,21 @@ std::string OkxAdapter::generate_pong_message(const std::string &) const {
   return "pong";
 }
 
+bool OkxAdapter::is_depth_channel(const std::string &channel) const {
+  // "books", "books5", "books-l2-tbt", "books50-l2-tbt"
+  return channel.compare(0, 5, "books") == 0;
+}
+
 bool OkxAdapter::is_ping_message(const char *json_data, size_t len) const {
   // OKX sends "ping" as plain text
   return len == 4 && std::string_view(json_data, len) == "ping";
 }
 
+bool OkxAdapter::is_pong_message(const char *json_data, size_t len) const {
+  // OKX answers our plain-text "ping" with plain-text "pong"
+  return len == 4 && std::string_view(json_data, len) == "pong";
+}
+
 bool OkxAdapter::is_subscription_response(const char *json_data,
                                           size_t len) const {
   try {
@@ -16,6 +16,8 @@ namespace aero {
  *
  * Handles:
  * - books-l2-tbt order book parsing
+ * - bbo-tbt top-of-book parsing
+ * - trades parsing (public connection; trades-all is business-only)
  * - Subscription message generation
  * - Ping/pong heartbeat
  */
@@ -35,6 +37,12 @@ public:
   bool parse_orderbook_message(const char *json_data, size_t len,
                                ParsedOrderBook &out_book) override;
 
+  bool parse_bbo_message(const char *json_data, size_t len,
+                         ParsedBbo &out_bbo) override;
+
+  bool parse_trades_message(const char *json_data, size_t len,
+                            ParsedTrades &out_trades) override;
+
   std::string
   generate_subscribe_message(const std::string &instrument,
                              const std::string &channel) const override;
@@ -48,9 +56,13 @@ public:
 
   bool is_ping_message(const char *json_data, size_t len) const override;
 
+  bool is_pong_message(const char *json_data, size_t len) const override;
+
   bool is_subscription_response(const char *json_data,
                                 size_t len) const override;
 
+  bool is_depth_channel(const std::string &channel) const override;
+
 private:
   simdjson::dom::parser parser_;
   static constexpr uint64_t PRICE_SCALE = 100000000ULL; // 10^8
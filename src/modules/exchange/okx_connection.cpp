@@ -1,13 +1,19 @@
 #include "okx_connection.h"
 #include "config/config.h"
 #include "core/logging.h"
+#include "core/tsc_clock.h"
+#include "modules/network/frame_capture.h"
+#include "modules/telemetry/feed_latency_monitor.h"
+#include "modules/telemetry/load_governor.h"
+#include <algorithm>
 #include <iostream>
+#include <unordered_set>
 
 namespace aero {
 
-OkxConnection::OkxConnection(UdpPublisher *udp_publisher)
+OkxConnection::OkxConnection(const FeedSinks &sinks)
     : ws_client_(std::make_unique<BoostWebSocketClient>()),
-      adapter_(std::make_unique<OkxAdapter>()), udp_publisher_(udp_publisher) {}
+      adapter_(std::make_unique<OkxAdapter>()), sinks_(sinks) {}
 
 OkxConnection::~OkxConnection() {
   // Unique pointers auto-clean
@@ -23,6 +29,13 @@ bool OkxConnection::connect() {
   std::string port = "8443";
   std::string path = "/ws/v5/public";
 
+  flush_tsc_ = TscClock::instance().ns_to_tsc(
+      static_cast<uint64_t>(app_config.feed_conflate_flush_us) * 1000ULL);
+
+  if (capture_id_ < 0)
+    capture_id_ = FrameCapture::instance().add_connection(
+        ExchangeId::OKX, host + ":" + port + path);
+
   LOG_SYSTEM("OkxConnection: Connecting to " << host << ":" << port << path
                                              << "...");
 
@@ -71,23 +84,102 @@ void OkxConnection::resubscribe() {
   }
 }
 
+void OkxConnection::resync(bool only_trimmed) {
+  // Re-subscribing makes the exchange start over with a snapshot, which
+  // supersedes books built from a stream that lost messages (or levels
+  // skipped while shedding load). Only depth channels are resubscribed:
+  // trades and top of book hold no state, and a resubscribe would just
+  // lose whatever arrives meanwhile.
+  LoadGovernor &gov = LoadGovernor::instance();
+  std::unordered_set<std::string> trimmed; // Flag taken once per instrument
+  for (const auto &sub : active_subscriptions_) {
+    if (!adapter_->is_depth_channel(sub.channel))
+      continue;
+    for (const auto &inst : sub.instruments) {
+      if (gov.take_trimmed(ExchangeId::OKX, inst))
+        trimmed.insert(inst);
+    }
+  }
+
+  size_t count = 0;
+  for (const auto &sub : active_subscriptions_) {
+    if (!adapter_->is_depth_channel(sub.channel))
+      continue;
+    for (const auto &inst : sub.instruments) {
+      if (only_trimmed && trimmed.count(inst) == 0)
+        continue;
+      ws_client_->send(
+          adapter_->generate_unsubscribe_message(inst, sub.channel));
+      ws_client_->send(adapter_->generate_subscribe_message(inst, sub.channel));
+      count++;
+    }
+  }
+  if (count > 0)
+    LOG_SYSTEM("OkxConnection: Resubscribed " << count << " channel(s) "
+               << (only_trimmed ? "trimmed while shedding load"
+                                : "after receive queue overflow"));
+}
+
 void OkxConnection::poll(
     std::function<void(const ParsedOrderBook &)> on_orderbook_callback) {
+  // While behind, conflated outputs still go out every few frames or
+  // microseconds rather than only once the queue is empty
+  LoadGovernor &gov = LoadGovernor::instance();
+  uint32_t flush_frames =
+      static_cast<uint32_t>(std::max(app_config.feed_conflate_flush_frames, 1));
+  uint64_t deferred_since = 0;
+  uint32_t frames = 0; // Processed since outputs were first held back
+
   while (true) {
     auto msg_opt = ws_client_->get_next_message();
     if (!msg_opt) {
       break; // Queue empty
     }
 
-    process_message(*msg_opt, on_orderbook_callback);
+    FrameCapture::instance().record(static_cast<uint16_t>(capture_id_),
+                                    ExchangeId::OKX, msg_opt->data,
+                                    msg_opt->rx_tsc);
+
+    size_t backlog = static_cast<size_t>(app_config.feed_conflate_backlog);
+    behind_ = backlog > 0 && ws_client_->backlog() >= backlog;
+    process_message(msg_opt->data, msg_opt->rx_tsc, on_orderbook_callback);
+
+    // Dropped frames leave books wrong: ask for fresh snapshots now, not
+    // after the backlog behind the drop is worked off
+    if (ws_client_->take_overflow())
+      resync(false);
+
+    if (!sinks_.conflator || sinks_.conflator->empty() || gov.shedding()) {
+      frames = 0;
+      continue;
+    }
+    uint64_t now = TscClock::now_tsc();
+    if (frames++ == 0) {
+      deferred_since = now;
+    } else if (frames >= flush_frames || now - deferred_since >= flush_tsc_) {
+      flush_deferred(sinks_);
+      frames = 0;
+    }
+  }
+
+  // Caught up: send what was conflated while behind (held back further
+  // while shedding load)
+  behind_ = false;
+  if (!gov.shedding()) {
+    flush_deferred(sinks_);
+    if (gov.has_trimmed())
+      resync(true);
   }
+
+  if (ws_client_->take_overflow())
+    resync(false);
 }
 
 void OkxConnection::process_message(
-    const std::string &msg,
+    const std::string &msg, uint64_t rx_tsc,
     std::function<void(const ParsedOrderBook &)> &callback) {
   // DEBUG: Log all incoming messages (controlled by DEBUG_LOG_ENABLED)
-  if (app_config.debug_log_enabled) {
+  if (app_config.debug_log_enabled && !logging_shed_skip()) {
     LOG_SYSTEM("DEBUG OKX Message: " << msg);
   }
 
@@ -98,25 +190,54 @@ void OkxConnection::process_message(
     return;
   }
 
-  // 2. Check for Subscription Response
+  // 2. Check for Pong (reply to our heartbeat, used for RTT sampling)
+  if (adapter_->is_pong_message(msg.c_str(), msg.length())) {
+    FeedLatencyMonitor::instance().on_pong_received(ExchangeId::OKX, rx_tsc);
+    return;
+  }
+
+  // 3. Check for Subscription Response
   if (adapter_->is_subscription_response(msg.c_str(), msg.length())) {
     // Log subscription success/fail
     LOG_SYSTEM("OkxConnection: Subscription response: " << msg);
     return;
   }
 
-  // 3. Try to parse as OrderBook
+  // 4. Top-of-book channel: straight to the BBO outputs
+  ParsedBbo bbo;
+  if (adapter_->parse_bbo_message(msg.c_str(), msg.length(), bbo)) {
+    bbo.rx_tsc = rx_tsc;
+    if (app_config.latency_monitor_enabled) {
+      FeedLatencyMonitor::instance().record(ExchangeId::OKX, bbo.instrument,
+                                            bbo.timestamp_ms, rx_tsc);
+    }
+    route_bbo(sinks_, ExchangeId::OKX, bbo);
+    return;
+  }
+
+  // 5. Public trades: never conflated
+  if (adapter_->parse_trades_message(msg.c_str(), msg.length(), trades_)) {
+    trades_.rx_tsc = rx_tsc;
+    route_trades(sinks_, ExchangeId::OKX, trades_);
+    return;
+  }
+
+  // 6. Try to parse as OrderBook
   ParsedOrderBook book;
   if (adapter_->parse_orderbook_message(msg.c_str(), msg.length(), book)) {
-    // Broadcast via UDP if enabled
-    if (udp_publisher_ && udp_publisher_->is_initialized()) {
-      udp_publisher_->publish(book, ExchangeId::OKX);
+    book.rx_tsc = rx_tsc;
+    if (app_config.latency_monitor_enabled) {
+      FeedLatencyMonitor::instance().record(ExchangeId::OKX, book.instrument,
+                                            book.timestamp_ms, rx_tsc);
     }
 
+    // Local books, shm bus, UDP feeds
+    route_book(sinks_, ExchangeId::OKX, book, behind_);
+
     if (callback) {
       callback(book);
     }
-  } else {
+  } else if (!logging_shed_skip()) {
     // Unknown message or parsing failure
     LOG_SYSTEM(
         "OkxConnection: Failed to parse message or unknown type: " << msg);
@@ -125,6 +246,8 @@ void OkxConnection::process_message(
 
 void OkxConnection::send_heartbeat() {
   if (ws_client_ && ws_client_->is_connected()) {
+    FeedLatencyMonitor::instance().on_ping_sent(ExchangeId::OKX,
+                                                TscClock::now_tsc());
     ws_client_->send("ping");
   }
 }
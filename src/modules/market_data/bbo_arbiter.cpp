@@ -0,0 +1,14 @@
+#include "modules/market_data/bbo_arbiter.h"
+#include "core/logging.h"
+
+namespace aero {
+
+void BboArbiter::print_stats() const {
+  LOG_SYSTEM("[BboArb] channel accepted=" << accepted(CHANNEL)
+                                          << " stale=" << stale(CHANNEL)
+                                          << " depth accepted="
+                                          << accepted(DEPTH)
+                                          << " stale=" << stale(DEPTH));
+}
+
+} // namespace aero
@@ -0,0 +1,95 @@
+/**
+ * @file bbo_arbiter.h
+ * @brief Newest-wins choice between a venue's BBO channel and its depth feed
+ */
+
+#ifndef AERO_MODULES_MARKET_DATA_BBO_ARBITER_H
+#define AERO_MODULES_MARKET_DATA_BBO_ARBITER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Decides, per symbol, whether a top of book is newer than the last
+ *        one published
+ *
+ * A symbol subscribed to both a top-of-book channel (OKX bbo-tbt, Bybit
+ * orderbook.1) and a depth channel gets two streams of the same quote that
+ * arrive in either order. Each candidate is checked against the exchange
+ * timestamp of the last accepted one: anything as new or newer is accepted
+ * and becomes the reference, anything older is stale and must not
+ * overwrite what the BBO outputs already show. Candidates without a
+ * timestamp are accepted and leave the reference alone.
+ *
+ * Not thread-safe: called from the feed-handler lcore, except the counters
+ * and print_stats().
+ */
+class BboArbiter {
+public:
+  enum Source : uint8_t {
+    DEPTH = 0,   // Derived from the maintained depth book
+    CHANNEL = 1, // The venue's top-of-book channel
+  };
+
+  /**
+   * @brief Whether a top of book of `symbol_id` should be published
+   *
+   * @param exchange_ts_ms Exchange time of the update it comes from
+   */
+  bool accept(uint32_t symbol_id, uint64_t exchange_ts_ms, Source source) {
+    if (exchange_ts_ms != 0) {
+      if (symbol_id >= last_ts_ms_.size())
+        last_ts_ms_.resize(symbol_id + 1, 0);
+      uint64_t &last = last_ts_ms_[symbol_id];
+      if (exchange_ts_ms < last) {
+        bump(stale_[source]);
+        return false;
+      }
+      last = exchange_ts_ms;
+    }
+    bump(accepted_[source]);
+    return true;
+  }
+
+  /**
+   * @brief Whether a top of book as of `exchange_ts_ms` is still the newest
+   *
+   * For an update accept() already admitted: changes nothing and counts
+   * nothing.
+   */
+  bool fresh(uint32_t symbol_id, uint64_t exchange_ts_ms) const {
+    return exchange_ts_ms == 0 || symbol_id >= last_ts_ms_.size() ||
+           exchange_ts_ms >= last_ts_ms_[symbol_id];
+  }
+
+  // Counters (any thread)
+  uint64_t accepted(Source source) const {
+    return accepted_[source].load(std::memory_order_relaxed);
+  }
+  uint64_t stale(Source source) const {
+    return stale_[source].load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Log accepted and stale counts per source
+   */
+  void print_stats() const;
+
+private:
+  static void bump(std::atomic<uint64_t> &counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  }
+
+  std::vector<uint64_t> last_ts_ms_; // By symbol id
+  std::atomic<uint64_t> accepted_[2] = {};
+  std::atomic<uint64_t> stale_[2] = {};
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_MARKET_DATA_BBO_ARBITER_H
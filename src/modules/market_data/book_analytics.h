@@ -0,0 +1,227 @@
+/**
+ * @file book_analytics.h
+ * @brief Derived book signals maintained incrementally by OrderBook
+ */
+
+#ifndef AERO_MODULES_MARKET_DATA_BOOK_ANALYTICS_H
+#define AERO_MODULES_MARKET_DATA_BOOK_ANALYTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace aero {
+
+/**
+ * @brief Signals derived from one book, read with the BBO
+ *
+ * Prices are in PRICE_SCALE units, quantities in the venue's units.
+ */
+struct BookAnalytics {
+  static constexpr size_t MAX_LEVELS = 3;
+
+  double microprice;            // Size-weighted mid of the BBO; 0 if one-sided
+  uint32_t levels;              // Depth levels configured (0 = disabled)
+  uint32_t depth_levels[MAX_LEVELS];
+  double bid_depth[MAX_LEVELS]; // Quantity in the best depth_levels[i] levels
+  double ask_depth[MAX_LEVELS];
+  double vwap_qty;              // Size the VWAPs are for (0 = disabled)
+  double bid_vwap;              // Price to sell vwap_qty; 0 if too thin
+  double ask_vwap;              // Price to buy vwap_qty; 0 if too thin
+
+  /**
+   * @brief (bid - ask) / (bid + ask) over the best depth_levels[i] levels
+   */
+  double imbalance(size_t i) const {
+    double sum = bid_depth[i] + ask_depth[i];
+    return sum > 0.0 ? (bid_depth[i] - ask_depth[i]) / sum : 0.0;
+  }
+};
+
+struct BookAnalyticsConfig {
+  uint32_t depth_levels[BookAnalytics::MAX_LEVELS] = {5, 10, 20};
+  uint32_t level_count = 3;
+  double vwap_qty = 0.0; // 0 = no VWAP
+};
+
+/**
+ * @brief Cumulative depth and VWAP-to-size of one side of a book
+ *
+ * `Ladder` is the side's std::map (price -> qty, best first). set() applies
+ * a level change to the map and adjusts the sums by the change: a depth
+ * window keeps an iterator to its worst level, so a level entering or
+ * leaving the window swaps one level in or out; the VWAP keeps an iterator
+ * to the level where the cumulative size reaches vwap_qty plus the size and
+ * cost in front of it, and moves it only across the levels that changed
+ * sides. The cost of a change is O(log depth) plus the levels the VWAP edge
+ * moves, instead of a walk of the side.
+ *
+ * Sums drift with floating-point rounding, so reset() recomputes them from
+ * the map (on snapshots and every RESYNC_CHANGES changes).
+ */
+template <typename Ladder> class LadderAnalytics {
+public:
+  static constexpr uint32_t RESYNC_CHANGES = 65536;
+
+  void configure(const BookAnalyticsConfig &cfg) {
+    cfg_ = cfg;
+    if (cfg_.level_count > BookAnalytics::MAX_LEVELS)
+      cfg_.level_count = BookAnalytics::MAX_LEVELS;
+    for (uint32_t w = 0; w < cfg_.level_count; w++)
+      if (cfg_.depth_levels[w] == 0)
+        cfg_.depth_levels[w] = 1;
+  }
+
+  const BookAnalyticsConfig &config() const { return cfg_; }
+
+  /**
+   * @brief Recompute everything from the map
+   */
+  void reset(Ladder &ladder) {
+    changes_ = 0;
+    for (uint32_t w = 0; w < cfg_.level_count; w++) {
+      windows_[w].qty = 0.0;
+      windows_[w].last = ladder.end();
+      uint32_t n = 0;
+      for (auto it = ladder.begin();
+           it != ladder.end() && n < cfg_.depth_levels[w]; ++it, ++n) {
+        windows_[w].qty += it->second;
+        windows_[w].last = it;
+      }
+    }
+    before_qty_ = 0.0;
+    before_cost_ = 0.0;
+    edge_ = ladder.begin();
+    edge_valid_ = false;
+    if (vwap())
+      advance(ladder);
+  }
+
+  /**
+   * @brief Set a level (qty <= 0 removes it) and update the sums
+   */
+  void set(Ladder &ladder, uint64_t price, double qty) {
+    auto better = ladder.key_comp();
+    auto it = ladder.find(price);
+
+    if (qty > 0.0 && it != ladder.end()) {
+      double delta = qty - it->second;
+      it->second = qty;
+      for (uint32_t w = 0; w < cfg_.level_count; w++)
+        if (!better(windows_[w].last->first, price))
+          windows_[w].qty += delta;
+      if (vwap() && before_edge(ladder, price))
+        add_before(price, delta);
+    } else if (qty > 0.0) {
+      bool was_empty = ladder.empty();
+      size_t prior = ladder.size();
+      it = ladder.emplace(price, qty).first;
+      for (uint32_t w = 0; w < cfg_.level_count; w++) {
+        Window &win = windows_[w];
+        if (prior < cfg_.depth_levels[w]) {
+          win.qty += qty;
+          if (was_empty || better(win.last->first, price))
+            win.last = it;
+        } else if (better(price, win.last->first)) {
+          win.qty += qty - win.last->second;
+          win.last = std::prev(win.last);
+        }
+      }
+      if (vwap() && before_edge(ladder, price))
+        add_before(price, qty);
+    } else if (it != ladder.end()) {
+      for (uint32_t w = 0; w < cfg_.level_count; w++) {
+        Window &win = windows_[w];
+        if (better(win.last->first, price))
+          continue;
+        win.qty -= it->second;
+        auto next = std::next(win.last);
+        if (next != ladder.end()) {
+          win.qty += next->second; // The next level moves into the window
+          win.last = next;
+        } else if (win.last == it) {
+          win.last = it == ladder.begin() ? ladder.end() : std::prev(it);
+        }
+      }
+      if (vwap()) {
+        if (it == edge_)
+          edge_ = std::next(it);
+        else if (before_edge(ladder, price))
+          add_before(price, -it->second);
+      }
+      ladder.erase(it);
+    } else {
+      return;
+    }
+
+    if (vwap()) {
+      retreat(ladder);
+      advance(ladder);
+    }
+    if (++changes_ >= RESYNC_CHANGES)
+      reset(ladder);
+  }
+
+  /**
+   * @brief Copy the sums of this side (`bid` selects the output fields)
+   */
+  void read(BookAnalytics &out, bool bid) const {
+    double *depth = bid ? out.bid_depth : out.ask_depth;
+    for (uint32_t w = 0; w < cfg_.level_count; w++)
+      depth[w] = windows_[w].qty;
+    double price = 0.0;
+    if (vwap() && edge_valid_) {
+      double rest = cfg_.vwap_qty - before_qty_;
+      price = (before_cost_ + static_cast<double>(edge_->first) * rest) /
+              cfg_.vwap_qty;
+    }
+    (bid ? out.bid_vwap : out.ask_vwap) = price;
+  }
+
+private:
+  bool vwap() const { return cfg_.vwap_qty > 0.0; }
+
+  struct Window {
+    typename Ladder::iterator last{}; // Worst level inside (end if empty)
+    double qty = 0.0;
+  };
+
+  bool before_edge(const Ladder &ladder, uint64_t price) const {
+    return edge_ == ladder.end() || ladder.key_comp()(price, edge_->first);
+  }
+
+  void add_before(uint64_t price, double qty) {
+    before_qty_ += qty;
+    before_cost_ += static_cast<double>(price) * qty;
+  }
+
+  // The edge is too deep: levels in front of it already cover the size
+  void retreat(const Ladder &ladder) {
+    while (before_qty_ >= cfg_.vwap_qty && edge_ != ladder.begin()) {
+      edge_ = std::prev(edge_);
+      add_before(edge_->first, -edge_->second);
+    }
+  }
+
+  // The edge does not reach the size yet
+  void advance(const Ladder &ladder) {
+    while (edge_ != ladder.end() &&
+           before_qty_ + edge_->second < cfg_.vwap_qty) {
+      add_before(edge_->first, edge_->second);
+      ++edge_;
+    }
+    edge_valid_ = edge_ != ladder.end();
+  }
+
+  BookAnalyticsConfig cfg_;
+  Window windows_[BookAnalytics::MAX_LEVELS];
+  typename Ladder::iterator edge_{}; // First level reaching vwap_qty
+  bool edge_valid_ = false;
+  double before_qty_ = 0.0;  // Levels in front of the edge
+  double before_cost_ = 0.0; // Sum of price * qty of the same
+  uint32_t changes_ = 0;
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_MARKET_DATA_BOOK_ANALYTICS_H
@@ -0,0 +1,61 @@
+#include "book_conflator.h"
+#include <algorithm>
+
+namespace aero {
+
+void BookConflator::merge_side(std::vector<PriceLevel> &side,
+                               const std::vector<PriceLevel> &update,
+                               bool is_bid, bool keep_removals) {
+  auto better = [is_bid](const PriceLevel &a, uint64_t price) {
+    return is_bid ? a.price_int > price : a.price_int < price;
+  };
+  for (const PriceLevel &lvl : update) {
+    auto it = std::lower_bound(side.begin(), side.end(), lvl.price_int,
+                               better);
+    bool found = it != side.end() && it->price_int == lvl.price_int;
+    if (lvl.size <= 0 && !keep_removals) {
+      if (found)
+        side.erase(it);
+    } else if (found) {
+      it->size = lvl.size;
+    } else {
+      side.insert(it, lvl);
+    }
+  }
+}
+
+void BookConflator::add(uint32_t id, ExchangeId exchange_id,
+                        const ParsedOrderBook &book) {
+  if (id >= entries_.size())
+    entries_.resize(id + 1);
+  Entry &e = entries_[id];
+
+  if (!e.queued || book.is_snapshot) {
+    // Start over from this update; a pending one is superseded by a snapshot
+    if (e.queued)
+      merged_++;
+    else
+      e.book.rx_tsc = book.rx_tsc;
+    e.book.instrument = book.instrument;
+    e.book.is_snapshot = book.is_snapshot;
+    e.book.bids.clear();
+    e.book.asks.clear();
+    // Through merge_side so both sides come out sorted and deduplicated
+    merge_side(e.book.bids, book.bids, true, !book.is_snapshot);
+    merge_side(e.book.asks, book.asks, false, !book.is_snapshot);
+  } else {
+    // Removals only matter to the consumer if the pending update is a delta
+    merged_++;
+    merge_side(e.book.bids, book.bids, true, !e.book.is_snapshot);
+    merge_side(e.book.asks, book.asks, false, !e.book.is_snapshot);
+  }
+  e.book.timestamp_ms = book.timestamp_ms;
+  e.exchange_id = exchange_id;
+
+  if (!e.queued) {
+    e.queued = true;
+    order_.push_back(id);
+  }
+}
+
+} // namespace aero
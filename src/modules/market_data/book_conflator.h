@@ -0,0 +1,90 @@
+/**
+ * @file book_conflator.h
+ * @brief Per-symbol merging of book updates a consumer could not keep up with
+ */
+
+#ifndef AERO_MODULES_MARKET_DATA_BOOK_CONFLATOR_H
+#define AERO_MODULES_MARKET_DATA_BOOK_CONFLATOR_H
+
+#include "modules/common/aero_types.h"
+#include "modules/exchange/exchange_adapter.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Latest-state queue of book updates, keyed by SymbolRegistry id
+ *
+ * Each symbol holds at most one pending update. A delta arriving while one
+ * is pending is folded into it level by level (the latest size of a price
+ * wins, removals included); a snapshot replaces whatever was pending, and a
+ * delta on top of a pending snapshot is applied to it, so the merged update
+ * is still a snapshot. Draining the queue therefore yields, per symbol, one
+ * update that moves a consumer from its last seen state straight to the
+ * current one, in the order symbols first became pending.
+ *
+ * Merged updates carry the newest exchange timestamp and the oldest rx_tsc,
+ * so latency measured downstream covers the time spent waiting here.
+ *
+ * Not thread-safe.
+ */
+class BookConflator {
+public:
+  /**
+   * @brief Queue an update, merging it into the symbol's pending one
+   */
+  void add(uint32_t id, ExchangeId exchange_id, const ParsedOrderBook &book);
+
+  /**
+   * @brief Hand pending updates to `emit(id, exchange_id, book)` in FIFO
+   *        order
+   *
+   * Stops without consuming the update when emit returns false (e.g. the
+   * destination is full), leaving it at the front.
+   *
+   * @return Updates consumed
+   */
+  template <typename F> size_t drain(F &&emit) {
+    size_t n = 0;
+    while (!order_.empty()) {
+      uint32_t id = order_.front();
+      Entry &e = entries_[id];
+      if (!emit(id, e.exchange_id, e.book))
+        break;
+      e.queued = false;
+      order_.pop_front();
+      n++;
+    }
+    return n;
+  }
+
+  bool empty() const { return order_.empty(); }
+  size_t size() const { return order_.size(); } // Symbols pending
+  bool pending(uint32_t id) const {
+    return id < entries_.size() && entries_[id].queued;
+  }
+
+  uint64_t merged() const { return merged_; } // Updates folded into another
+
+private:
+  struct Entry {
+    bool queued = false;
+    ExchangeId exchange_id = ExchangeId::UNKNOWN;
+    ParsedOrderBook book; // Sides sorted best first
+  };
+
+  static void merge_side(std::vector<PriceLevel> &side,
+                         const std::vector<PriceLevel> &update, bool is_bid,
+                         bool keep_removals);
+
+  std::vector<Entry> entries_; // By symbol id; books reused across updates
+  std::deque<uint32_t> order_; // Pending ids, each at most once
+  uint64_t merged_ = 0;
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_MARKET_DATA_BOOK_CONFLATOR_H
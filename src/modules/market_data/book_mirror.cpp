@@ -0,0 +1,206 @@
+#include "modules/market_data/book_mirror.h"
+#include "aero/feed_protocol.h"
+#include "core/logging.h"
+#include "core/tsc_clock.h"
+#include "modules/common/shm_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace aero {
+
+static_assert(sizeof(aero_book_mirror_header) <= AERO_BOOK_MIRROR_HEADER_SIZE,
+              "aero_book_mirror_header layout");
+static_assert(sizeof(aero_book_mirror_symbol) == 64,
+              "aero_book_mirror_symbol layout");
+static_assert(sizeof(aero_book_mirror_book) == 64,
+              "aero_book_mirror_book layout");
+static_assert(sizeof(aero_book_mirror_level) == 16,
+              "aero_book_mirror_level layout");
+
+BookMirror::~BookMirror() { close(); }
+
+bool BookMirror::init(const std::string &path, uint32_t depth,
+                      uint32_t symbol_capacity) {
+  depth = std::max(depth, 1u);
+  symbol_capacity = std::max(symbol_capacity, 1u);
+  size_t slot_size = round_up(sizeof(aero_book_mirror_book) +
+                                  2 * depth * sizeof(aero_book_mirror_level),
+                              64);
+
+  size_t directory_offset = AERO_BOOK_MIRROR_HEADER_SIZE;
+  size_t books_offset = round_up(
+      directory_offset + symbol_capacity * sizeof(aero_book_mirror_symbol),
+      4096);
+  size_t size =
+      round_up(books_offset + symbol_capacity * slot_size, SHM_MAP_ALIGN);
+
+  uint8_t *base = shm_create_mapped("BookMirror", path, size);
+  if (!base)
+    return false;
+
+  path_ = path;
+  base_ = base;
+  map_size_ = size;
+  hdr_ = reinterpret_cast<aero_book_mirror_header *>(base_);
+  directory_ =
+      reinterpret_cast<aero_book_mirror_symbol *>(base_ + directory_offset);
+  books_ = base_ + books_offset;
+  slot_size_ = slot_size;
+  depth_ = depth;
+  announced_.clear();
+  bids_.reserve(depth);
+  asks_.reserve(depth);
+
+  hdr_->version = AERO_BOOK_MIRROR_VERSION;
+  hdr_->depth = depth;
+  hdr_->symbol_capacity = symbol_capacity;
+  hdr_->slot_size = static_cast<uint32_t>(slot_size);
+  hdr_->directory_offset = directory_offset;
+  hdr_->books_offset = books_offset;
+  hdr_->session_ns = TscClock::instance().now_wall_ns();
+  hdr_->producer_pid = static_cast<uint32_t>(getpid());
+  __atomic_store_n(&hdr_->magic, AERO_BOOK_MIRROR_MAGIC, __ATOMIC_RELEASE);
+
+  LOG_SYSTEM("BookMirror: " << path << " (" << symbol_capacity
+                            << " symbols x " << depth << " levels, "
+                            << size / (1024 * 1024) << " MiB)");
+  return true;
+}
+
+void BookMirror::close() {
+  if (base_) {
+    munmap(base_, map_size_);
+    base_ = nullptr;
+    hdr_ = nullptr;
+  }
+}
+
+bool BookMirror::local_reader(aero_book_mirror_reader &r) const {
+  if (!base_)
+    return false;
+  r.base = base_;
+  r.map_size = map_size_;
+  r.hdr = hdr_;
+  r.directory = directory_;
+  r.books = books_;
+  r.inode = 0;
+  return true;
+}
+
+// False when the id is beyond the directory
+bool BookMirror::announce(uint32_t id, ExchangeId exchange_id,
+                          const std::string &instrument) {
+  if (id >= hdr_->symbol_capacity) {
+    if (!capacity_logged_) {
+      LOG_SYSTEM("BookMirror: Directory full (" << hdr_->symbol_capacity
+                                                << "), dropping " << instrument);
+      capacity_logged_ = true;
+    }
+    return false;
+  }
+
+  if (id >= announced_.size())
+    announced_.resize(id + 1, 0);
+  if (!announced_[id]) {
+    aero_book_mirror_symbol &s = directory_[id];
+    s.exchange_id = static_cast<uint8_t>(exchange_id);
+    size_t n = std::min(instrument.size(), sizeof(s.name) - 1);
+    memcpy(s.name, instrument.data(), n);
+    s.name[n] = '\0';
+    __atomic_store_n(&s.valid, 1u, __ATOMIC_RELEASE);
+    // Ids come from the shared registry, so they may arrive out of order
+    if (id + 1 > hdr_->symbol_count)
+      __atomic_store_n(&hdr_->symbol_count, id + 1, __ATOMIC_RELEASE);
+    announced_[id] = 1;
+  }
+  return true;
+}
+
+void BookMirror::write(ExchangeId exchange_id, uint32_t id,
+                       const std::string &instrument, const OrderBook &book,
+                       uint64_t exchange_ts_ms, uint64_t rx_tsc) {
+  if (!hdr_ || !announce(id, exchange_id, instrument))
+    return;
+
+  // A depth update older than the last channel quote keeps it on top,
+  // as the BBO outputs do; anything else ends the overlay
+  if (id < overlays_.size() && overlays_[id].exchange_ts_ms != 0 &&
+      (exchange_ts_ms == 0 || exchange_ts_ms >= overlays_[id].exchange_ts_ms))
+    overlays_[id].exchange_ts_ms = 0;
+  write_slot(id, book, exchange_ts_ms, rx_tsc);
+}
+
+// Put `top` first and drop the levels it crosses (price at or through it)
+template <bool IS_BID>
+static void overlay_top(std::vector<OrderBookLevel> &side, uint64_t price,
+                        double qty, size_t depth) {
+  std::erase_if(side, [price](const OrderBookLevel &l) {
+    return IS_BID ? l.price_int >= price : l.price_int <= price;
+  });
+  side.insert(side.begin(), OrderBookLevel{price, qty});
+  if (side.size() > depth)
+    side.resize(depth);
+}
+
+void BookMirror::write_bbo(ExchangeId exchange_id, uint32_t id,
+                           const std::string &instrument,
+                           const OrderBook &book, const BestBidOffer &bbo,
+                           uint64_t exchange_ts_ms, uint64_t rx_tsc) {
+  if (!hdr_ || !announce(id, exchange_id, instrument))
+    return;
+
+  if (id >= overlays_.size())
+    overlays_.resize(id + 1);
+  // Without a timestamp the quote cannot be ordered against later depth
+  overlays_[id] = {bbo, exchange_ts_ms ? exchange_ts_ms : 1};
+  write_slot(id, book, exchange_ts_ms, rx_tsc);
+}
+
+void BookMirror::write_slot(uint32_t id, const OrderBook &book,
+                            uint64_t exchange_ts_ms, uint64_t rx_tsc) {
+  // Read the book before entering the write section to keep it short
+  book.get_depth(depth_, bids_, asks_);
+  uint32_t flags = book.degraded() ? AERO_BOOK_MIRROR_DEGRADED : 0;
+  if (id < overlays_.size() && overlays_[id].exchange_ts_ms != 0) {
+    const BestBidOffer &top = overlays_[id].bbo;
+    overlay_top<true>(bids_, top.bid_price, top.bid_qty, depth_);
+    overlay_top<false>(asks_, top.ask_price, top.ask_qty, depth_);
+    flags |= AERO_BOOK_MIRROR_BBO;
+  }
+
+  auto *b = reinterpret_cast<aero_book_mirror_book *>(books_ + id * slot_size_);
+  uint64_t seq = b->seq;
+  __atomic_store_n(&b->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  b->update_count++;
+  b->exchange_ts_ns = exchange_ts_ms * 1000000ULL;
+  b->rx_tsc = rx_tsc;
+  b->update_ns = TscClock::instance().now_wall_ns();
+  b->bid_count = static_cast<uint32_t>(bids_.size());
+  b->ask_count = static_cast<uint32_t>(asks_.size());
+  b->flags = flags;
+
+  // Unused levels are zeroed so readers can also ignore the counts
+  auto *bids = reinterpret_cast<aero_book_mirror_level *>(b + 1);
+  auto *asks = bids + depth_;
+  for (uint32_t i = 0; i < depth_; i++) {
+    bids[i] = i < bids_.size()
+                  ? aero_book_mirror_level{bids_[i].price_int,
+                                           feed_fixed_qty(bids_[i].size)}
+                  : aero_book_mirror_level{0, 0};
+    asks[i] = i < asks_.size()
+                  ? aero_book_mirror_level{asks_[i].price_int,
+                                           feed_fixed_qty(asks_[i].size)}
+                  : aero_book_mirror_level{0, 0};
+  }
+
+  __atomic_store_n(&b->seq, seq + 2, __ATOMIC_RELEASE);
+  writes_++;
+}
+
+} // namespace aero
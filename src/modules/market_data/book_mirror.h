@@ -0,0 +1,123 @@
+/**
+ * @file book_mirror.h
+ * @brief Writer side of the shared-memory order book mirror
+ *
+ * Keeps the top levels of every local book in the fixed layout described in
+ * aero/book_mirror.h, so other processes can sample current state without
+ * following an event stream.
+ */
+
+#ifndef AERO_MODULES_MARKET_DATA_BOOK_MIRROR_H
+#define AERO_MODULES_MARKET_DATA_BOOK_MIRROR_H
+
+#include "aero/book_mirror.h"
+#include "modules/common/aero_types.h"
+#include "modules/market_data/order_book.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Seqlock-protected per-symbol snapshot slots in a shared file
+ *
+ * Slots are indexed by SymbolRegistry id. Each write bumps the slot's seq
+ * to odd, rewrites header and levels, then bumps it back to even.
+ *
+ * Not thread-safe: write() must be called from the thread that applies
+ * book updates (the feed-handler lcore).
+ */
+class BookMirror {
+public:
+  BookMirror() = default;
+  ~BookMirror();
+
+  BookMirror(const BookMirror &) = delete;
+  BookMirror &operator=(const BookMirror &) = delete;
+
+  /**
+   * @brief Create (replace) and map the mirror file
+   *
+   * @param path File under /dev/shm or a hugetlbfs mount
+   * @param depth Levels kept per side
+   * @param symbol_capacity Directory entries and book slots
+   */
+  bool init(const std::string &path, uint32_t depth, uint32_t symbol_capacity);
+
+  /**
+   * @brief Copy the current top of a book into its slot
+   *
+   * @param symbol_id SymbolRegistry id of (exchange_id, instrument), the
+   *        slot index
+   * @param exchange_ts_ms Exchange time of the update just applied
+   * @param rx_tsc Gateway TSC of the update just applied
+   */
+  void write(ExchangeId exchange_id, uint32_t symbol_id,
+             const std::string &instrument, const OrderBook &book,
+             uint64_t exchange_ts_ms, uint64_t rx_tsc);
+
+  /**
+   * @brief Rewrite a book's slot with a top-of-book channel quote on top
+   *
+   * The quote replaces the best level of each side and the levels it
+   * crosses; the rest of the slot is the local book as write() copies it.
+   * For quotes newer than the book (see BboArbiter). write() keeps the
+   * quote on top while the depth updates it gets are older than it.
+   *
+   * @param bbo Both sides set
+   */
+  void write_bbo(ExchangeId exchange_id, uint32_t symbol_id,
+                 const std::string &instrument, const OrderBook &book,
+                 const BestBidOffer &bbo, uint64_t exchange_ts_ms,
+                 uint64_t rx_tsc);
+
+  void close();
+
+  bool is_initialized() const { return hdr_ != nullptr; }
+
+  /**
+   * @brief Reader over this process's own mapping
+   *
+   * For consumers on other lcores (strategy plugins). Valid until close();
+   * must not be passed to aero_book_mirror_close().
+   *
+   * @return false if the mirror is not initialized
+   */
+  bool local_reader(aero_book_mirror_reader &r) const;
+
+  // Counters (owner thread only)
+  uint64_t writes() const { return writes_; }
+
+private:
+  bool announce(uint32_t id, ExchangeId exchange_id,
+                const std::string &instrument);
+  void write_slot(uint32_t id, const OrderBook &book, uint64_t exchange_ts_ms,
+                  uint64_t rx_tsc);
+
+  std::string path_;
+  uint8_t *base_ = nullptr;
+  size_t map_size_ = 0;
+  aero_book_mirror_header *hdr_ = nullptr;
+  aero_book_mirror_symbol *directory_ = nullptr;
+  uint8_t *books_ = nullptr;
+  size_t slot_size_ = 0;
+  uint32_t depth_ = 0;
+
+  struct Overlay {
+    BestBidOffer bbo;
+    uint64_t exchange_ts_ms = 0; // 0 = none
+  };
+
+  std::vector<uint8_t> announced_; // Per symbol id: in the directory
+  std::vector<Overlay> overlays_;  // Per symbol id: last channel quote
+  std::vector<OrderBookLevel> bids_;
+  std::vector<OrderBookLevel> asks_;
+  uint64_t writes_ = 0;
+  bool capacity_logged_ = false;
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_MARKET_DATA_BOOK_MIRROR_H
@@ -0,0 +1,199 @@
+#include "modules/market_data/book_snapshot_server.h"
+#include "core/logging.h"
+#include "modules/common/symbol_registry.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstring>
+#include <rte_byteorder.h>
+#include <rte_pause.h>
+#include <thread>
+
+namespace aero {
+
+// A reader that keeps colliding with updates gives up with SNAPSHOT_BUSY
+static constexpr int MAX_READ_ATTEMPTS = 1000;
+
+BookSnapshotServer::BookSnapshotServer(uint32_t symbol_capacity)
+    : capacity_(symbol_capacity),
+      entries_(std::make_unique<Entry[]>(symbol_capacity)),
+      server_("BookSnapshotServer",
+              [this](const uint8_t *in, size_t len, std::vector<uint8_t> &out) {
+                return on_request(in, len, out);
+              }) {}
+
+BookSnapshotServer::~BookSnapshotServer() { stop(); }
+
+bool BookSnapshotServer::start(const std::string &bind_addr, int port) {
+  return server_.start(bind_addr, port);
+}
+
+void BookSnapshotServer::stop() { server_.stop(); }
+
+void BookSnapshotServer::begin_write(Entry &e) {
+  // Two writers (feed thread, publishing thread): enter on an even version
+  uint64_t v = e.version.load(std::memory_order_relaxed);
+  while ((v & 1) || !e.version.compare_exchange_weak(
+                        v, v + 1, std::memory_order_relaxed)) {
+    rte_pause();
+    v = e.version.load(std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void BookSnapshotServer::end_write(Entry &e) {
+  e.version.store(e.version.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_release);
+}
+
+uint32_t BookSnapshotServer::begin_update(ExchangeId exchange_id, uint32_t id,
+                                          const std::string &instrument) {
+  if (id >= capacity_) {
+    if (!capacity_logged_) {
+      LOG_SYSTEM("BookSnapshotServer: Symbol capacity (" << capacity_
+                                                         << ") reached, "
+                                                         << instrument
+                                                         << " not served");
+      capacity_logged_ = true;
+    }
+    return SymbolRegistry::INVALID_ID;
+  }
+
+  Entry &e = entries_[id];
+  begin_write(e);
+  e.exchange_id = static_cast<uint8_t>(exchange_id);
+  return id;
+}
+
+void BookSnapshotServer::end_update(uint32_t id, const OrderBook &book,
+                                    uint16_t channel, uint64_t seq,
+                                    uint64_t exchange_ts_ms) {
+  Entry &e = entries_[id];
+  e.book.store(&book, std::memory_order_relaxed);
+  if (seq != 0) {
+    e.channel.store(channel, std::memory_order_relaxed);
+    e.seq.store(seq, std::memory_order_relaxed);
+  }
+  e.exchange_ts_ns = exchange_ts_ms * 1000000ULL;
+  end_write(e);
+}
+
+void BookSnapshotServer::set_position(uint32_t id, uint16_t channel,
+                                      uint64_t seq) {
+  if (id >= capacity_)
+    return;
+  Entry &e = entries_[id];
+  begin_write(e);
+  e.channel.store(channel, std::memory_order_relaxed);
+  e.seq.store(seq, std::memory_order_relaxed);
+  end_write(e);
+}
+
+size_t BookSnapshotServer::on_request(const uint8_t *in, size_t len,
+                                      std::vector<uint8_t> &out) {
+  if (len < sizeof(SnapshotRequest))
+    return 0;
+  SnapshotRequest req;
+  std::memcpy(&req, in, sizeof(req));
+  size_t name_len = ntohl(req.symbol_id) == SNAPSHOT_BY_NAME ? req.name_len : 0;
+  size_t total = sizeof(req) + name_len;
+  if (len < total)
+    return 0;
+
+  std::string name(reinterpret_cast<const char *>(in) + sizeof(req),
+                   name_len);
+  answer(req, name, out);
+  return total;
+}
+
+void BookSnapshotServer::answer(const SnapshotRequest &req,
+                                const std::string &name,
+                                std::vector<uint8_t> &out) {
+  SnapshotResponse resp;
+  memset(&resp, 0, sizeof(resp));
+  resp.magic = htonl(SNAPSHOT_MAGIC);
+  resp.symbol_id = req.symbol_id;
+
+  uint16_t status = SNAPSHOT_OK;
+  uint32_t id = ntohl(req.symbol_id);
+  if (ntohl(req.magic) != SNAPSHOT_MAGIC) {
+    status = SNAPSHOT_BAD_REQUEST;
+  } else if (id == SNAPSHOT_BY_NAME) {
+    id = SymbolRegistry::instance().find(
+        static_cast<ExchangeId>(req.exchange_id), name);
+    resp.symbol_id = htonl(id);
+  }
+
+  size_t max_levels = ntohs(req.max_levels);
+  if (max_levels == 0 || max_levels > SNAPSHOT_MAX_LEVELS)
+    max_levels = SNAPSHOT_MAX_LEVELS;
+
+  SymbolRegistry::Entry symbol;
+  if (status == SNAPSHOT_OK &&
+      (id >= capacity_ || !SymbolRegistry::instance().lookup(id, symbol))) {
+    status = SNAPSHOT_UNKNOWN_SYMBOL;
+  }
+
+  if (status == SNAPSHOT_OK) {
+    const Entry &e = entries_[id];
+    status = SNAPSHOT_BUSY;
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++) {
+      uint64_t v1 = e.version.load(std::memory_order_acquire);
+      if (v1 & 1) {
+        std::this_thread::yield(); // Feed thread is mid-update
+        continue;
+      }
+      const OrderBook *book = e.book.load(std::memory_order_relaxed);
+      if (book == nullptr) {
+        status = SNAPSHOT_UNKNOWN_SYMBOL; // Registered by another sink only
+        break;
+      }
+      book->get_depth(max_levels, bids_, asks_);
+      uint16_t channel = e.channel.load(std::memory_order_relaxed);
+      uint64_t seq = e.seq.load(std::memory_order_relaxed);
+      uint64_t ts_ns = e.exchange_ts_ns;
+      uint8_t exchange_id = e.exchange_id;
+      bool degraded = book->degraded();
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (e.version.load(std::memory_order_relaxed) != v1)
+        continue;
+
+      resp.channel_id = htons(channel);
+      resp.exchange_id = exchange_id;
+      resp.seq_num = rte_cpu_to_be_64(seq);
+      resp.exchange_ts_ns = rte_cpu_to_be_64(ts_ns);
+      resp.flags = htons(degraded ? SNAPSHOT_FLAG_DEGRADED : 0);
+      status = SNAPSHOT_OK;
+      break;
+    }
+  }
+
+  size_t base = out.size();
+  out.resize(base + sizeof(resp));
+  if (status == SNAPSHOT_OK) {
+    size_t name_len = std::min<size_t>(symbol.instrument.size(), 255);
+    resp.name_len = static_cast<uint8_t>(name_len);
+    resp.bid_count = htons(static_cast<uint16_t>(bids_.size()));
+    resp.ask_count = htons(static_cast<uint16_t>(asks_.size()));
+
+    out.reserve(out.size() +
+                (bids_.size() + asks_.size()) * sizeof(SnapshotLevel) +
+                name_len);
+    for (const auto *side : {&bids_, &asks_}) {
+      for (const auto &level : *side) {
+        SnapshotLevel l;
+        l.price_int = rte_cpu_to_be_64(level.price_int);
+        l.quantity = rte_cpu_to_be_64(feed_fixed_qty(level.size));
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(&l);
+        out.insert(out.end(), p, p + sizeof(l));
+      }
+    }
+    out.insert(out.end(), symbol.instrument.begin(),
+                symbol.instrument.begin() + name_len);
+    served_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  resp.status = htons(status);
+  std::memcpy(out.data() + base, &resp, sizeof(resp));
+}
+
+} // namespace aero
@@ -0,0 +1,127 @@
+/**
+ * @file book_snapshot_server.h
+ * @brief Snapshot-on-demand TCP service for late-joining feed consumers
+ *
+ * A consumer that starts mid-session asks for the current book of a symbol
+ * instead of waiting for an exchange snapshot (OKX books-l2-tbt only sends
+ * one per subscription). Each response carries the feed sequence number it
+ * corresponds to, so it can be spliced onto the live UDP stream. Protocol
+ * in aero/feed_protocol.h. Many consumers are served at once.
+ */
+
+#ifndef AERO_MODULES_MARKET_DATA_BOOK_SNAPSHOT_SERVER_H
+#define AERO_MODULES_MARKET_DATA_BOOK_SNAPSHOT_SERVER_H
+
+#include "aero/feed_protocol.h"
+#include "modules/common/aero_types.h"
+#include "modules/market_data/order_book.h"
+#include "modules/network/tcp_request_server.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Serves OrderBook state together with its feed position
+ *
+ * The feed-handler lcore brackets every book update with begin_update() /
+ * end_update(). That pair is a per-symbol seqlock around "apply to the
+ * local book, publish on UDP", so the service thread can read a book and
+ * the seq of the last datagram it reflects as one consistent pair.
+ * set_position() takes the same write section from the publishing thread,
+ * so a symbol's writer section is entered by CAS rather than a plain store.
+ *
+ * Books are only reached through the pointers registered in end_update();
+ * the service never touches OrderBookManager's maps, which the feed thread
+ * may be growing.
+ */
+class BookSnapshotServer {
+public:
+  /**
+   * @param symbol_capacity Symbols that can be served (by registry id)
+   */
+  explicit BookSnapshotServer(uint32_t symbol_capacity);
+  ~BookSnapshotServer();
+
+  BookSnapshotServer(const BookSnapshotServer &) = delete;
+  BookSnapshotServer &operator=(const BookSnapshotServer &) = delete;
+
+  /**
+   * @brief Listen on bind_addr:port and start the service thread
+   */
+  bool start(const std::string &bind_addr, int port);
+
+  void stop();
+
+  /**
+   * @brief Mark a symbol's book as changing (feed thread)
+   *
+   * @param symbol_id SymbolRegistry id of (exchange_id, instrument)
+   * @return Symbol id to pass to end_update(), or SymbolRegistry::INVALID_ID
+   *         beyond the capacity
+   */
+  uint32_t begin_update(ExchangeId exchange_id, uint32_t symbol_id,
+                        const std::string &instrument);
+
+  /**
+   * @brief Book updated and published (feed thread)
+   *
+   * @param book The book just updated
+   * @param channel Feed channel of the symbol
+   * @param seq Last datagram published for this update, 0 if none (the
+   *        previous position is kept)
+   */
+  void end_update(uint32_t id, const OrderBook &book, uint16_t channel,
+                  uint64_t seq, uint64_t exchange_ts_ms);
+
+  /**
+   * @brief Record the feed position of a symbol from the publishing thread
+   *
+   * Used when UDP publishing runs on its own lcore (FeedPublishStage) and
+   * end_update() gets no seq. The position may then trail the book by the
+   * updates still queued; consumers replay those on top of the snapshot,
+   * which is harmless because every level carries its absolute size.
+   * Waits for an update of the symbol in progress on the feed thread.
+   */
+  void set_position(uint32_t id, uint16_t channel, uint64_t seq);
+
+  // Counters
+  uint64_t served() const { return served_.load(std::memory_order_relaxed); }
+
+private:
+  struct Entry {
+    std::atomic<uint64_t> version{0}; // Odd while a writer is inside
+    std::atomic<const OrderBook *> book{nullptr};
+    uint8_t exchange_id = 0;
+    std::atomic<uint16_t> channel{0};
+    std::atomic<uint64_t> seq{0};
+    uint64_t exchange_ts_ns = 0;
+  };
+
+  static void begin_write(Entry &e);
+  static void end_write(Entry &e);
+
+  size_t on_request(const uint8_t *in, size_t len,
+                    std::vector<uint8_t> &out);
+  void answer(const SnapshotRequest &req, const std::string &name,
+              std::vector<uint8_t> &out);
+
+  uint32_t capacity_;
+  std::unique_ptr<Entry[]> entries_;
+  std::atomic<uint64_t> served_{0};
+  bool capacity_logged_ = false; // Feed thread only
+
+  // Service thread only
+  std::vector<OrderBookLevel> bids_;
+  std::vector<OrderBookLevel> asks_;
+
+  TcpRequestServer server_;
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_MARKET_DATA_BOOK_SNAPSHOT_SERVER_H
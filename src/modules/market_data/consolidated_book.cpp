@@ -0,0 +1,222 @@
+#include "modules/market_data/consolidated_book.h"
+#include "core/logging.h"
+#include "modules/common/symbol_registry.h"
+#include <algorithm>
+#include <mutex>
+
+namespace aero {
+
+// Set one venue's quantity at a price; qty <= 0 removes the venue from the
+// level, and the level goes once no venue is left
+template <typename Ladder>
+static void set_level(Ladder &ladder, size_t venue, uint64_t price,
+                      double qty) {
+  uint8_t bit = static_cast<uint8_t>(1u << venue);
+  typename Ladder::iterator it;
+  if (qty > 0.0) {
+    it = ladder.try_emplace(price).first;
+    it->second.venue_qty[venue] = qty;
+    it->second.venues |= bit;
+  } else {
+    it = ladder.find(price);
+    if (it == ladder.end() || !(it->second.venues & bit))
+      return;
+    it->second.venue_qty[venue] = 0.0;
+    it->second.venues &= static_cast<uint8_t>(~bit);
+    if (it->second.venues == 0) {
+      ladder.erase(it);
+      return;
+    }
+  }
+  // Summed rather than adjusted by deltas, so rounding never accumulates
+  double total = 0.0;
+  for (double q : it->second.venue_qty)
+    total += q;
+  it->second.qty = total;
+}
+
+// Snapshot: drop the venue's previous levels that the new one no longer has
+template <typename Ladder>
+static void remove_missing(Ladder &ladder, size_t venue,
+                           const std::vector<OrderBookLevel> &old_levels,
+                           const std::vector<PriceLevel> &new_levels) {
+  if (old_levels.empty())
+    return;
+  thread_local std::vector<uint64_t> keep;
+  keep.clear();
+  for (const PriceLevel &l : new_levels)
+    if (l.size > 0.0)
+      keep.push_back(l.price_int);
+  std::sort(keep.begin(), keep.end());
+  for (const OrderBookLevel &l : old_levels)
+    if (!std::binary_search(keep.begin(), keep.end(), l.price_int))
+      set_level(ladder, venue, l.price_int, 0.0);
+}
+
+template <typename Level>
+static void copy_level(uint64_t price, const Level &level,
+                       ConsolidatedLevel &out) {
+  out.price = price;
+  out.qty = level.qty;
+  out.venues = level.venues;
+  std::copy(std::begin(level.venue_qty), std::end(level.venue_qty),
+            out.venue_qty);
+}
+
+template <typename Ladder>
+static bool walk(const Ladder &ladder, double qty, SweepResult &result) {
+  result = SweepResult{};
+  if (ladder.empty())
+    return false;
+  for (const auto &[price, level] : ladder) {
+    if (result.filled >= qty)
+      break;
+    double take = std::min(level.qty, qty - result.filled);
+    double share = take / level.qty;
+    for (size_t v = 0; v < MAX_EXCHANGES; v++)
+      result.venue_qty[v] += level.venue_qty[v] * share;
+    result.filled += take;
+    result.cost += static_cast<double>(price) / PRICE_SCALE * take;
+    result.worst_price = price;
+    result.levels++;
+  }
+  return true;
+}
+
+void ConsolidatedBook::set_contract_size(ExchangeId exchange,
+                                         std::string_view instrument,
+                                         double base_per_unit) {
+  uint32_t id = SymbolRegistry::instance().get_or_assign(exchange, instrument);
+  std::unique_lock lock(table_mutex_);
+  if (id >= contract_size_.size())
+    contract_size_.resize(id + 1, 0.0);
+  contract_size_[id] = base_per_unit;
+}
+
+void ConsolidatedBook::apply(ExchangeId exchange, uint32_t symbol_id,
+                             const ParsedOrderBook &book,
+                             const OrderBook &venue_book) {
+  size_t v = static_cast<size_t>(exchange);
+  if (v >= MAX_EXCHANGES)
+    return;
+  uint32_t index = symbol_id < by_symbol_.size() ? by_symbol_[symbol_id]
+                                                 : InstrumentMap::NONE;
+  if (index == InstrumentMap::NONE) {
+    std::unique_lock lock(table_mutex_);
+    index = map_.resolve(symbol_id);
+    if (index == InstrumentMap::NONE)
+      return;
+    while (instruments_.size() <= index)
+      instruments_.push_back(std::make_unique<Instrument>());
+    if (symbol_id >= by_symbol_.size()) {
+      by_symbol_.resize(symbol_id + 1, InstrumentMap::NONE);
+      scale_.resize(symbol_id + 1, 1.0);
+    }
+    by_symbol_[symbol_id] = index;
+    if (symbol_id < contract_size_.size() && contract_size_[symbol_id] > 0.0)
+      scale_[symbol_id] = contract_size_[symbol_id];
+  }
+  // Only this thread adds instruments, so no table lock is needed to read
+  Instrument &ins = *instruments_[index];
+  double scale = scale_[symbol_id];
+
+  thread_local std::vector<OrderBookLevel> old_bids, old_asks;
+  if (book.is_snapshot)
+    venue_book.get_depth(SIZE_MAX, old_bids, old_asks);
+
+  std::unique_lock lock(ins.mutex);
+  if (book.is_snapshot) {
+    remove_missing(ins.bids, v, old_bids, book.bids);
+    remove_missing(ins.asks, v, old_asks, book.asks);
+  }
+  for (const PriceLevel &l : book.bids)
+    set_level(ins.bids, v, l.price_int, l.size * scale);
+  for (const PriceLevel &l : book.asks)
+    set_level(ins.asks, v, l.price_int, l.size * scale);
+  lock.unlock();
+
+  updates_.store(updates_.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+}
+
+ConsolidatedBook::Instrument *
+ConsolidatedBook::instrument(uint32_t index) const {
+  std::shared_lock lock(table_mutex_);
+  return index < instruments_.size() ? instruments_[index].get() : nullptr;
+}
+
+uint32_t ConsolidatedBook::find(std::string_view canonical) const {
+  std::shared_lock lock(table_mutex_);
+  return map_.find(canonical);
+}
+
+std::vector<std::string> ConsolidatedBook::instruments() const {
+  std::shared_lock lock(table_mutex_);
+  std::vector<std::string> names;
+  names.reserve(map_.size());
+  for (uint32_t i = 0; i < map_.size(); i++)
+    names.push_back(map_.name(i));
+  return names;
+}
+
+bool ConsolidatedBook::best(uint32_t index, ConsolidatedQuote &quote) const {
+  Instrument *ins = instrument(index);
+  if (!ins)
+    return false;
+  std::shared_lock lock(ins->mutex);
+  if (ins->bids.empty() || ins->asks.empty())
+    return false;
+  copy_level(ins->bids.begin()->first, ins->bids.begin()->second, quote.bid);
+  copy_level(ins->asks.begin()->first, ins->asks.begin()->second, quote.ask);
+  return true;
+}
+
+bool ConsolidatedBook::sweep(uint32_t index, Side side, double qty,
+                             SweepResult &result) const {
+  Instrument *ins = instrument(index);
+  if (!ins) {
+    result = SweepResult{};
+    return false;
+  }
+  std::shared_lock lock(ins->mutex);
+  return side == Side::ASK ? walk(ins->asks, qty, result)
+                           : walk(ins->bids, qty, result);
+}
+
+void ConsolidatedBook::get_depth(uint32_t index, size_t max_levels,
+                                 std::vector<ConsolidatedLevel> &bids,
+                                 std::vector<ConsolidatedLevel> &asks) const {
+  bids.clear();
+  asks.clear();
+  Instrument *ins = instrument(index);
+  if (!ins)
+    return;
+  std::shared_lock lock(ins->mutex);
+  for (auto it = ins->bids.begin();
+       it != ins->bids.end() && bids.size() < max_levels; ++it)
+    copy_level(it->first, it->second, bids.emplace_back());
+  for (auto it = ins->asks.begin();
+       it != ins->asks.end() && asks.size() < max_levels; ++it)
+    copy_level(it->first, it->second, asks.emplace_back());
+}
+
+void ConsolidatedBook::print_stats() const {
+  std::vector<std::string> names = instruments();
+  for (uint32_t i = 0; i < names.size(); i++) {
+    ConsolidatedQuote q;
+    if (!best(i, q))
+      continue;
+    LOG_SYSTEM("[Consolidated] " << names[i] << " bid "
+                                 << q.bid.price / 1e8 << " x " << q.bid.qty
+                                 << " (venues 0x" << std::hex
+                                 << static_cast<int>(q.bid.venues) << std::dec
+                                 << ") ask " << q.ask.price / 1e8 << " x "
+                                 << q.ask.qty << " (venues 0x" << std::hex
+                                 << static_cast<int>(q.ask.venues) << std::dec
+                                 << ")");
+  }
+  LOG_SYSTEM("[Consolidated] instruments=" << names.size()
+                                           << " updates=" << updates());
+}
+
+} // namespace aero
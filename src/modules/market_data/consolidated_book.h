@@ -0,0 +1,177 @@
+/**
+ * @file consolidated_book.h
+ * @brief Multi-venue order book per canonical instrument
+ *
+ * Merges the levels of every venue's book for the same instrument (see
+ * canonical_instrument()) into one price ladder, keeping each venue's
+ * quantity at every price.
+ */
+
+#ifndef AERO_MODULES_MARKET_DATA_CONSOLIDATED_BOOK_H
+#define AERO_MODULES_MARKET_DATA_CONSOLIDATED_BOOK_H
+
+#include "modules/common/aero_types.h"
+#include "modules/common/instrument_map.h"
+#include "modules/market_data/order_book.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief One consolidated price level
+ */
+struct ConsolidatedLevel {
+  uint64_t price;                  // 1e8 units
+  double qty;                      // Base units, all venues
+  double venue_qty[MAX_EXCHANGES]; // Base units, by ExchangeId
+  uint8_t venues;                  // Bit per ExchangeId with quantity here
+};
+
+/**
+ * @brief Best consolidated bid and ask ("NBBO")
+ */
+struct ConsolidatedQuote {
+  ConsolidatedLevel bid;
+  ConsolidatedLevel ask;
+};
+
+/**
+ * @brief Result of walking one side of the consolidated book
+ */
+struct SweepResult {
+  double filled;                   // Base units, <= the requested size
+  double cost;                     // Sum of price * qty, in quote units
+  uint64_t worst_price;            // Last level touched, 1e8 units
+  double venue_qty[MAX_EXCHANGES]; // Filled per venue
+  uint32_t levels;                 // Levels touched
+
+  double vwap() const { return filled > 0.0 ? cost / filled : 0.0; }
+};
+
+/**
+ * @brief Consolidated books of every canonical instrument
+ *
+ * Maintained incrementally by OrderBookManager::apply_book(): each level of
+ * a venue update sets that venue's quantity at the price, and a venue
+ * snapshot removes only the venue's levels that are not in the new
+ * snapshot, so the cost of an update is O(changed levels * log depth).
+ * Quantities are converted to base units with per-symbol contract sizes,
+ * so venues quoting contracts and venues quoting coins merge correctly.
+ *
+ * apply() runs on the thread that applies book updates (the feed-handler
+ * lcore); the queries can be made from any thread. Each instrument has its
+ * own lock, so a query waits at most for one venue update of the same
+ * instrument.
+ */
+class ConsolidatedBook {
+public:
+  ConsolidatedBook() = default;
+
+  ConsolidatedBook(const ConsolidatedBook &) = delete;
+  ConsolidatedBook &operator=(const ConsolidatedBook &) = delete;
+
+  /**
+   * @brief Base units per quantity unit of a symbol (default 1)
+   *
+   * Call before the first update of the symbol, e.g. OKX ETH-USDT-SWAP =
+   * 0.1 ETH.
+   */
+  void set_contract_size(ExchangeId exchange, std::string_view instrument,
+                         double base_per_unit);
+
+  /**
+   * @brief Merge a venue update (feed-handler lcore)
+   *
+   * Must be called before the update is applied to the venue's own book:
+   * for snapshots, `venue_book` still holds the levels being replaced.
+   *
+   * @param symbol_id SymbolRegistry id of the venue symbol
+   */
+  void apply(ExchangeId exchange, uint32_t symbol_id,
+             const ParsedOrderBook &book, const OrderBook &venue_book);
+
+  /**
+   * @brief Index of a canonical instrument name (e.g. "ETH-USDT-PERP")
+   *
+   * @return InstrumentMap::NONE until a venue has sent an update for it
+   */
+  uint32_t find(std::string_view canonical) const;
+
+  /**
+   * @brief Canonical instrument names, by index
+   */
+  std::vector<std::string> instruments() const;
+
+  /**
+   * @brief Best consolidated bid and ask with venue attribution
+   *
+   * @return false if either side is empty
+   */
+  bool best(uint32_t instrument, ConsolidatedQuote &quote) const;
+
+  /**
+   * @brief Walk the best levels of one side
+   *
+   * Side::ASK prices a buy, Side::BID a sell. At a price quoted by several
+   * venues the fill is split pro rata to their quantities.
+   *
+   * @param qty Base units to fill
+   * @return false if the side is empty
+   */
+  bool sweep(uint32_t instrument, Side side, double qty,
+             SweepResult &result) const;
+
+  /**
+   * @brief Copy the best levels of both sides (best first)
+   */
+  void get_depth(uint32_t instrument, size_t max_levels,
+                 std::vector<ConsolidatedLevel> &bids,
+                 std::vector<ConsolidatedLevel> &asks) const;
+
+  uint64_t updates() const { return updates_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Log the best consolidated quote of every instrument
+   */
+  void print_stats() const;
+
+private:
+  struct Level {
+    double venue_qty[MAX_EXCHANGES] = {};
+    double qty = 0.0; // Sum over venues, recomputed on every change
+    uint8_t venues = 0;
+  };
+
+  struct Instrument {
+    mutable std::shared_mutex mutex;
+    std::map<uint64_t, Level, std::greater<uint64_t>> bids;
+    std::map<uint64_t, Level, std::less<uint64_t>> asks;
+  };
+
+  Instrument *instrument(uint32_t index) const;
+
+  // Feed-handler lcore only
+  std::vector<uint32_t> by_symbol_; // Symbol id -> instrument index
+  std::vector<double> scale_;       // Symbol id -> contract size
+
+  // Guards the table below; taken exclusively only to add an instrument
+  mutable std::shared_mutex table_mutex_;
+  InstrumentMap map_;
+  std::vector<std::unique_ptr<Instrument>> instruments_;
+  std::vector<double> contract_size_; // By symbol id (0 = unset, 1)
+
+  std::atomic<uint64_t> updates_{0};
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_MARKET_DATA_CONSOLIDATED_BOOK_H
@@ -4,6 +4,8 @@
  */
 
 #include "modules/market_data/order_book.h"
+#include "modules/market_data/book_mirror.h"
+#include "modules/market_data/consolidated_book.h"
 #include <mutex>
 
 namespace aero {
@@ -16,12 +18,29 @@ void OrderBook::clear() {
   std::unique_lock lock(mutex_);
   bids_.clear();
   asks_.clear();
+  if (analytics_) {
+    analytics_->bids.reset(bids_);
+    analytics_->asks.reset(asks_);
+  }
+}
+
+void OrderBook::enable_analytics(const BookAnalyticsConfig &cfg) {
+  std::unique_lock lock(mutex_);
+  analytics_ = std::make_unique<Analytics>();
+  analytics_->bids.configure(cfg);
+  analytics_->asks.configure(cfg);
+  analytics_->bids.reset(bids_);
+  analytics_->asks.reset(asks_);
 }
 
 void OrderBook::apply_snapshot(const std::vector<OrderBookUpdate> &updates) {
   std::unique_lock lock(mutex_);
   bids_.clear();
   asks_.clear();
+  if (analytics_) {
+    analytics_->bids.reset(bids_);
+    analytics_->asks.reset(asks_);
+  }
   for (const auto &update : updates) {
     apply_update_internal(update);
   }
@@ -43,6 +62,16 @@ void OrderBook::apply_update_internal(const OrderBookUpdate &update) {
   // If quantity is 0 or is_delete flag is set, remove the level
   bool is_delete = update.is_delete || (update.quantity <= 0.0);
 
+  if (analytics_) {
+    double qty = is_delete ? 0.0 : update.quantity;
+    if (update.side == Side::BID) {
+      analytics_->bids.set(bids_, update.price_int, qty);
+    } else {
+      analytics_->asks.set(asks_, update.price_int, qty);
+    }
+    return;
+  }
+
   if (update.side == Side::BID) {
     if (is_delete) {
       bids_.erase(update.price_int);
@@ -75,11 +104,81 @@ bool OrderBook::get_bbo(BestBidOffer &bbo) const {
   return true;
 }
 
+bool OrderBook::get_bbo(BestBidOffer &bbo, BookAnalytics &analytics) const {
+  std::shared_lock lock(mutex_);
+  if (bids_.empty() || asks_.empty()) {
+    return false;
+  }
+
+  auto best_bid = bids_.begin();
+  auto best_ask = asks_.begin();
+
+  bbo.bid_price = best_bid->first;
+  bbo.bid_qty = best_bid->second;
+  bbo.ask_price = best_ask->first;
+  bbo.ask_qty = best_ask->second;
+
+  // The bid weighted by the ask size and vice versa: leans toward the side
+  // more likely to trade through
+  double size = bbo.bid_qty + bbo.ask_qty;
+  analytics.microprice =
+      size > 0.0 ? (static_cast<double>(bbo.bid_price) * bbo.ask_qty +
+                    static_cast<double>(bbo.ask_price) * bbo.bid_qty) /
+                       size
+                 : 0.0;
+  if (!analytics_) {
+    analytics.levels = 0;
+    analytics.vwap_qty = 0.0;
+    analytics.bid_vwap = analytics.ask_vwap = 0.0;
+    return true;
+  }
+  const BookAnalyticsConfig &cfg = analytics_->bids.config();
+  analytics.levels = cfg.level_count;
+  for (uint32_t i = 0; i < analytics.levels; i++) {
+    analytics.depth_levels[i] = cfg.depth_levels[i];
+  }
+  analytics.vwap_qty = cfg.vwap_qty;
+  analytics_->bids.read(analytics, true);
+  analytics_->asks.read(analytics, false);
+  return true;
+}
+
+void OrderBook::get_depth(size_t max_levels, std::vector<OrderBookLevel> &bids,
+                          std::vector<OrderBookLevel> &asks) const {
+  std::shared_lock lock(mutex_);
+  bids.clear();
+  asks.clear();
+  for (auto it = bids_.begin(); it != bids_.end() && bids.size() < max_levels;
+       ++it) {
+    bids.push_back({it->first, it->second});
+  }
+  for (auto it = asks_.begin(); it != asks_.end() && asks.size() < max_levels;
+       ++it) {
+    asks.push_back({it->first, it->second});
+  }
+}
+
 // --- OrderBookManager Implementation ---
 
+OrderBookManager::OrderBookManager() = default;
+OrderBookManager::~OrderBookManager() = default;
+
 OrderBook &OrderBookManager::get_book(ExchangeId exchange,
                                       const std::string &instrument) {
-  return books_[exchange][instrument];
+  auto [it, inserted] = books_[exchange].try_emplace(instrument);
+  if (inserted && analytics_) {
+    it->second.enable_analytics(*analytics_);
+  }
+  return it->second;
+}
+
+void OrderBookManager::enable_analytics(const BookAnalyticsConfig &cfg) {
+  analytics_ = cfg;
+  for (auto &[exchange, books] : books_) {
+    for (auto &[instrument, book] : books) {
+      book.enable_analytics(cfg);
+    }
+  }
 }
 
 void OrderBookManager::apply_update(ExchangeId exchange,
@@ -126,6 +225,71 @@ void OrderBookManager::apply_updates(
   }
 }
 
+OrderBook &OrderBookManager::apply_book(ExchangeId exchange,
+                                        uint32_t symbol_id,
+                                        const ParsedOrderBook &book) {
+  thread_local std::vector<OrderBookUpdate> updates;
+  updates.clear();
+  updates.reserve(book.bids.size() + book.asks.size());
+
+  for (const auto &bid : book.bids) {
+    updates.push_back({.price_int = bid.price_int,
+                       .quantity = bid.size,
+                       .side = Side::BID,
+                       .is_delete = (bid.size <= 0.0)});
+  }
+  for (const auto &ask : book.asks) {
+    updates.push_back({.price_int = ask.price_int,
+                       .quantity = ask.size,
+                       .side = Side::ASK,
+                       .is_delete = (ask.size <= 0.0)});
+  }
+
+  OrderBook &ob = get_book(exchange, book.instrument);
+  // Before the venue book changes: a snapshot is merged against the levels
+  // it replaces
+  if (consolidated_) {
+    consolidated_->apply(exchange, symbol_id, book, ob);
+  }
+  if (book.is_snapshot) {
+    ob.apply_snapshot(updates);
+  } else {
+    ob.apply_updates(updates);
+  }
+  if (mirror_) {
+    mirror_->write(exchange, symbol_id, book.instrument, ob,
+                   book.timestamp_ms, book.rx_tsc);
+  }
+  return ob;
+}
+
+void OrderBookManager::mirror_bbo(ExchangeId exchange, uint32_t symbol_id,
+                                  const std::string &instrument,
+                                  const BestBidOffer &bbo,
+                                  uint64_t exchange_ts_ms, uint64_t rx_tsc) {
+  if (mirror_) {
+    mirror_->write_bbo(exchange, symbol_id, instrument,
+                       get_book(exchange, instrument), bbo, exchange_ts_ms,
+                       rx_tsc);
+  }
+}
+
+bool OrderBookManager::enable_mirror(const std::string &path, uint32_t depth,
+                                     uint32_t symbol_capacity) {
+  auto mirror = std::make_unique<BookMirror>();
+  if (!mirror->init(path, depth, symbol_capacity)) {
+    return false;
+  }
+  mirror_ = std::move(mirror);
+  return true;
+}
+
+void OrderBookManager::enable_consolidated() {
+  if (!consolidated_) {
+    consolidated_ = std::make_unique<ConsolidatedBook>();
+  }
+}
+
 bool OrderBookManager::get_best_prices(ExchangeId exchange,
                                        const std::string &instrument,
                                        double &bid_price, double &bid_qty,
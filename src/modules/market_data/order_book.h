@@ -6,15 +6,23 @@
 #ifndef _ORDER_BOOK_H_
 #define _ORDER_BOOK_H_
 
+#include "modules/exchange/exchange_adapter.h" // For ParsedOrderBook
+#include "modules/market_data/book_analytics.h"
 #include "modules/parser/json_parser.h" // For ExchangeId, OrderBookUpdate
+#include <atomic>
 #include <cstdint>
 #include <map>
+#include <memory>
+#include <optional>
 #include <shared_mutex>
 #include <string>
 #include <vector>
 
 namespace aero {
 
+class BookMirror;
+class ConsolidatedBook;
+
 /**
  * @brief Structure for accessing Best Bid and Offer efficiently
  */
@@ -75,22 +83,75 @@ public:
    */
   bool get_bbo(BestBidOffer &bbo) const;
 
+  /**
+   * @brief Get the BBO and the book analytics under one lock
+   *
+   * analytics.levels and vwap_qty are 0 unless enable_analytics() was
+   * called.
+   *
+   * @return true if both Bid and Ask exist, false otherwise
+   */
+  bool get_bbo(BestBidOffer &bbo, BookAnalytics &analytics) const;
+
+  /**
+   * @brief Maintain cumulative depth and VWAP-to-size on every update
+   *
+   * The sums are adjusted by each level change (see LadderAnalytics), so
+   * reading them costs the same at any depth.
+   */
+  void enable_analytics(const BookAnalyticsConfig &cfg);
+
+  /**
+   * @brief Copy the best levels of both sides (best first)
+   *
+   * Both sides are read under one lock, so they belong to the same state.
+   *
+   * @param max_levels Levels per side
+   * @param bids Output bids (cleared first)
+   * @param asks Output asks (cleared first)
+   */
+  void get_depth(size_t max_levels, std::vector<OrderBookLevel> &bids,
+                 std::vector<OrderBookLevel> &asks) const;
+
   /**
    * @brief Clear the order book
    */
   void clear();
 
+  /**
+   * @brief Mark the book as missing depth that load shedding skipped
+   *
+   * Set while trimmed updates are applied and cleared by the next complete
+   * snapshot (the resync after the overload). The book mirror and the
+   * snapshot service pass the mark on to consumers.
+   */
+  void set_degraded(bool on) {
+    degraded_.store(on, std::memory_order_relaxed);
+  }
+  bool degraded() const { return degraded_.load(std::memory_order_relaxed); }
+
 private:
   mutable std::shared_mutex mutex_; // Thread-safe access
 
+  using BidLadder = std::map<uint64_t, double, std::greater<uint64_t>>;
+  using AskLadder = std::map<uint64_t, double, std::less<uint64_t>>;
+
+  struct Analytics {
+    LadderAnalytics<BidLadder> bids;
+    LadderAnalytics<AskLadder> asks;
+  };
+
   // Internal update without locking (caller must hold lock)
   void apply_update_internal(const OrderBookUpdate &update);
 
   // Bids: Sorted Descending (Highest price first)
-  std::map<uint64_t, double, std::greater<uint64_t>> bids_;
+  BidLadder bids_;
 
   // Asks: Sorted Ascending (Lowest price first)
-  std::map<uint64_t, double, std::less<uint64_t>> asks_;
+  AskLadder asks_;
+
+  std::unique_ptr<Analytics> analytics_; // Optional
+  std::atomic<bool> degraded_{false};
 };
 
 /**
@@ -98,8 +159,8 @@ private:
  */
 class OrderBookManager {
 public:
-  OrderBookManager() = default;
-  ~OrderBookManager() = default;
+  OrderBookManager();
+  ~OrderBookManager();
 
   /**
    * @brief Get the OrderBook for a specific exchange and instrument
@@ -138,6 +199,66 @@ public:
                      const std::vector<OrderBookUpdate> &updates,
                      bool is_snapshot);
 
+  /**
+   * @brief Apply a book parsed by an exchange adapter
+   *
+   * Used by the exchange connections on the feed-handler lcore.
+   *
+   * @param symbol_id SymbolRegistry id of (exchange, book.instrument)
+   * @return The updated book
+   */
+  OrderBook &apply_book(ExchangeId exchange, uint32_t symbol_id,
+                        const ParsedOrderBook &book);
+
+  /**
+   * @brief Mirror the top of every book into a shared-memory file
+   *
+   * Once enabled, apply_book() copies the top `depth` levels of the updated
+   * book into the mirror (layout in aero/book_mirror.h).
+   *
+   * @param path File under /dev/shm or a hugetlbfs mount
+   * @param depth Levels kept per side
+   * @param symbol_capacity Maximum number of mirrored books
+   * @return false if the file could not be created
+   */
+  bool enable_mirror(const std::string &path, uint32_t depth,
+                     uint32_t symbol_capacity);
+
+  /**
+   * @brief Show a top-of-book channel quote in the mirror
+   *
+   * The local book is left alone; its mirror slot gets the quote on top
+   * until the next update of the book (see BookMirror::write_bbo()).
+   */
+  void mirror_bbo(ExchangeId exchange, uint32_t symbol_id,
+                  const std::string &instrument, const BestBidOffer &bbo,
+                  uint64_t exchange_ts_ms, uint64_t rx_tsc);
+
+  /**
+   * @brief The mirror, or nullptr if not enabled
+   */
+  const BookMirror *mirror() const { return mirror_.get(); }
+
+  /**
+   * @brief Merge every venue's book into one book per canonical instrument
+   *
+   * Once enabled, apply_book() also applies each update to the
+   * consolidated book (see ConsolidatedBook).
+   */
+  void enable_consolidated();
+
+  /**
+   * @brief The consolidated book, or nullptr if not enabled
+   */
+  ConsolidatedBook *consolidated() const { return consolidated_.get(); }
+
+  /**
+   * @brief Maintain analytics in every book, existing and future
+   */
+  void enable_analytics(const BookAnalyticsConfig &cfg);
+
+  bool analytics_enabled() const { return analytics_.has_value(); }
+
   /**
    * @brief Get best bid and ask prices for a specific instrument
    */
@@ -148,6 +269,10 @@ public:
 private:
   // Map: ExchangeId -> Map: Instrument -> OrderBook
   std::map<ExchangeId, std::map<std::string, OrderBook>> books_;
+
+  std::unique_ptr<BookMirror> mirror_; // Optional shared-memory mirror
+  std::unique_ptr<ConsolidatedBook> consolidated_; // Optional multi-venue view
+  std::optional<BookAnalyticsConfig> analytics_;   // Applied to new books
 };
 
 } // namespace aero
@@ -0,0 +1,447 @@
+#include "tick_history_writer.h"
+#include "aero/feed_protocol.h"
+#include "core/logging.h"
+#include "core/tsc_clock.h"
+#include "modules/common/symbol_registry.h"
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifdef AERO_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace aero {
+
+static_assert(sizeof(aero_tck_header) == 64, "aero_tck_header layout");
+static_assert(sizeof(aero_tck_block) == 40, "aero_tck_block layout");
+
+static constexpr uint64_t NS_PER_DAY = 86400ULL * 1000000000ULL;
+
+static inline void put_varint(std::vector<uint8_t> &out, uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back(static_cast<uint8_t>(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(v));
+}
+
+static inline uint64_t zigzag(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+TickHistoryWriter::~TickHistoryWriter() { stop(); }
+
+bool TickHistoryWriter::start(const Config &cfg) {
+  if (ring_.is_open())
+    return true;
+  cfg_ = cfg;
+  if (cfg_.block_rows == 0)
+    cfg_.block_rows = 1;
+
+  if (mkdir(cfg_.dir.c_str(), 0755) < 0 && errno != EEXIST) {
+    LOG_SYSTEM("TickHistoryWriter: Failed to create " << cfg_.dir << ": "
+                                                      << strerror(errno));
+    return false;
+  }
+
+  if (!ring_.init(cfg_.queue_events)) {
+    LOG_SYSTEM("TickHistoryWriter: Failed to allocate the event ring");
+    return false;
+  }
+  flush_tsc_ = TscClock::instance().ns_to_tsc(cfg_.flush_ms * 1000000ULL);
+  bbo_.rows.reserve(cfg_.block_rows);
+  trades_.rows.reserve(cfg_.block_rows);
+
+  running_.store(true, std::memory_order_release);
+  thread_ = std::thread(&TickHistoryWriter::run, this);
+
+#ifdef AERO_HAVE_ZSTD
+  const char *codec = "zstd";
+#else
+  const char *codec = "none";
+#endif
+  LOG_SYSTEM("TickHistoryWriter: Writing to " << cfg_.dir << " (block_rows="
+             << cfg_.block_rows << ", flush_ms=" << cfg_.flush_ms
+             << ", queue=" << ring_.capacity() << ", codec=" << codec << ")");
+  return true;
+}
+
+void TickHistoryWriter::stop() {
+  if (!ring_.is_open())
+    return;
+  running_.store(false, std::memory_order_release);
+  if (thread_.joinable())
+    thread_.join();
+  ring_.release();
+}
+
+// ---------------------------------------------------------------------------
+// Producer (feed-handler lcore)
+// ---------------------------------------------------------------------------
+
+void TickHistoryWriter::on_bbo(uint32_t id, const BestBidOffer &bbo,
+                               uint64_t exchange_ts_ms, uint64_t rx_tsc) {
+  if (!ring_.is_open())
+    return;
+  if (id >= last_bbo_.size())
+    last_bbo_.resize(id + 1);
+
+  LastBbo cur{bbo.bid_price, feed_fixed_qty(bbo.bid_qty), bbo.ask_price,
+              feed_fixed_qty(bbo.ask_qty)};
+  LastBbo &last = last_bbo_[id];
+  if (cur.bid_price == last.bid_price && cur.bid_qty == last.bid_qty &&
+      cur.ask_price == last.ask_price && cur.ask_qty == last.ask_qty)
+    return;
+  last = cur;
+
+  Event ev{};
+  ev.table = AERO_TCK_BBO;
+  ev.symbol_id = id;
+  ev.rx_tsc = rx_tsc;
+  ev.exchange_ts_ms = exchange_ts_ms;
+  ev.price[0] = cur.bid_price;
+  ev.qty[0] = cur.bid_qty;
+  ev.price[1] = cur.ask_price;
+  ev.qty[1] = cur.ask_qty;
+  ring_.push(ev);
+}
+
+void TickHistoryWriter::on_trade(uint32_t id, uint64_t price, double qty,
+                                 bool is_sell, uint64_t exchange_ts_ms,
+                                 uint64_t rx_tsc) {
+  if (!ring_.is_open())
+    return;
+  Event ev{};
+  ev.table = AERO_TCK_TRADE;
+  ev.side = is_sell ? 1 : 0;
+  ev.symbol_id = id;
+  ev.rx_tsc = rx_tsc;
+  ev.exchange_ts_ms = exchange_ts_ms;
+  ev.price[0] = price;
+  ev.qty[0] = feed_fixed_qty(qty);
+  ring_.push(ev);
+}
+
+// ---------------------------------------------------------------------------
+// Writer thread
+// ---------------------------------------------------------------------------
+
+void TickHistoryWriter::run() {
+  pthread_setname_np(pthread_self(), "aero-history");
+  if (cfg_.cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cfg_.cpu, &set);
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (err != 0)
+      LOG_SYSTEM("TickHistoryWriter: Cannot pin to CPU " << cfg_.cpu << ": "
+                                                         << strerror(err));
+  }
+
+  while (true) {
+    // Read the flag first so the drain below sees everything pushed
+    // before stop()
+    bool stopping = !running_.load(std::memory_order_acquire);
+    uint64_t now_tsc = TscClock::now_tsc();
+    ring_.drain([this, now_tsc](const Event &ev) { add_row(ev, now_tsc); },
+                256);
+
+    if (stopping)
+      break;
+
+    for (Builder *b : {&bbo_, &trades_}) {
+      if (!b->rows.empty() && now_tsc - b->oldest_tsc >= flush_tsc_)
+        write_block(*b);
+    }
+    if (ring_.empty())
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  write_block(bbo_);
+  write_block(trades_);
+  close_file();
+}
+
+void TickHistoryWriter::add_row(const Event &ev, uint64_t now_tsc) {
+  uint64_t wall_ns = TscClock::instance().tsc_to_wall(ev.rx_tsc);
+  // The day only moves forward: the first row past midnight starts the new
+  // file, and a row received late for the previous day (or a clock step
+  // back) goes into the current one instead of reopening the old file
+  if (wall_ns >= day_end_ns_) {
+    // New UTC day: finish the old file with the rows that belong to it
+    write_block(bbo_);
+    write_block(trades_);
+    close_file();
+    open_day(wall_ns);
+  }
+
+  Builder &b = ev.table == AERO_TCK_TRADE ? trades_ : bbo_;
+  if (b.rows.empty()) {
+    b.first_wall_ns = wall_ns;
+    b.oldest_tsc = now_tsc;
+  }
+  b.rows.push_back(ev);
+  b.rows.back().wall_ns = wall_ns;
+  if (b.rows.size() >= cfg_.block_rows)
+    write_block(b);
+}
+
+void TickHistoryWriter::write_block(Builder &b) {
+  if (b.rows.empty())
+    return;
+  if (fd_ < 0) {
+    // No file for this day (open failed): the rows are lost
+    lost_.fetch_add(b.rows.size(), std::memory_order_relaxed);
+    b.rows.clear();
+    return;
+  }
+
+  // Block-local symbol slots, in order of first appearance
+  std::vector<uint32_t> ids;
+  std::vector<uint32_t> undefined;
+  for (const Event &ev : b.rows) {
+    if (ev.symbol_id >= slot_of_.size())
+      slot_of_.resize(ev.symbol_id + 1, UINT32_MAX);
+    if (slot_of_[ev.symbol_id] != UINT32_MAX)
+      continue;
+    slot_of_[ev.symbol_id] = static_cast<uint32_t>(ids.size());
+    ids.push_back(ev.symbol_id);
+    if (ev.symbol_id >= defined_.size() || !defined_[ev.symbol_id])
+      undefined.push_back(ev.symbol_id);
+  }
+  if (!undefined.empty())
+    write_symbols(undefined);
+
+  const bool bbo = b.table == AERO_TCK_BBO;
+  const int ncols = bbo ? 7 : 6;
+  for (int c = 0; c < ncols; c++)
+    cols_[c].clear();
+
+  std::vector<uint64_t> last(ids.size() * 2, 0); // Per slot: bid/price, ask
+  uint64_t prev_ts = 0;
+  uint64_t prev_exch = 0;
+  for (size_t i = 0; i < b.rows.size(); i++) {
+    const Event &ev = b.rows[i];
+    uint32_t slot = slot_of_[ev.symbol_id];
+    if (i == 0)
+      put_varint(cols_[0], ev.wall_ns);
+    else
+      put_varint(cols_[0],
+                 zigzag(static_cast<int64_t>(ev.wall_ns - prev_ts)));
+    put_varint(cols_[1],
+               zigzag(static_cast<int64_t>(ev.exchange_ts_ms - prev_exch)));
+    put_varint(cols_[2], slot);
+    prev_ts = ev.wall_ns;
+    prev_exch = ev.exchange_ts_ms;
+
+    for (int s = 0; s < (bbo ? 2 : 1); s++) {
+      uint64_t &lp = last[slot * 2 + s];
+      put_varint(cols_[3 + 2 * s],
+                 zigzag(static_cast<int64_t>(ev.price[s] - lp)));
+      put_varint(cols_[4 + 2 * s], ev.qty[s]);
+      lp = ev.price[s];
+    }
+    if (!bbo)
+      cols_[5].push_back(ev.side);
+  }
+
+  raw_.clear();
+  put_varint(raw_, ids.size());
+  for (uint32_t id : ids) {
+    put_varint(raw_, id);
+    slot_of_[id] = UINT32_MAX;
+  }
+  for (int c = 0; c < ncols; c++) {
+    put_varint(raw_, cols_[c].size());
+    raw_.insert(raw_.end(), cols_[c].begin(), cols_[c].end());
+  }
+
+  aero_tck_block blk{};
+  blk.magic = AERO_TCK_BLOCK_MAGIC;
+  blk.table = b.table;
+  blk.codec = AERO_TCK_CODEC_NONE;
+  blk.rows = static_cast<uint32_t>(b.rows.size());
+  blk.raw_size = static_cast<uint32_t>(raw_.size());
+  blk.first_ts_ns = b.first_wall_ns;
+  blk.last_ts_ns = b.rows.back().wall_ns;
+  const uint8_t *data = raw_.data();
+  size_t size = raw_.size();
+
+#ifdef AERO_HAVE_ZSTD
+  stored_.resize(ZSTD_compressBound(raw_.size()));
+  size_t n = ZSTD_compress(stored_.data(), stored_.size(), raw_.data(),
+                           raw_.size(), cfg_.zstd_level);
+  if (!ZSTD_isError(n) && n < raw_.size()) {
+    blk.codec = AERO_TCK_CODEC_ZSTD;
+    data = stored_.data();
+    size = n;
+  }
+#endif
+  blk.stored_size = static_cast<uint32_t>(size);
+
+  if (append(blk, data)) {
+    blocks_.fetch_add(1, std::memory_order_relaxed);
+    raw_bytes_.fetch_add(raw_.size(), std::memory_order_relaxed);
+    stored_bytes_.fetch_add(size, std::memory_order_relaxed);
+  } else {
+    lost_.fetch_add(b.rows.size(), std::memory_order_relaxed);
+  }
+  b.rows.clear();
+}
+
+void TickHistoryWriter::write_symbols(const std::vector<uint32_t> &ids) {
+  std::vector<uint8_t> raw;
+  std::vector<uint32_t> written;
+  SymbolRegistry::Entry entry;
+  for (uint32_t id : ids) {
+    if (!SymbolRegistry::instance().lookup(id, entry))
+      continue;
+    size_t len = std::min<size_t>(entry.instrument.size(), UINT8_MAX);
+    put_varint(raw, id);
+    raw.push_back(static_cast<uint8_t>(entry.exchange));
+    raw.push_back(static_cast<uint8_t>(len));
+    raw.insert(raw.end(), entry.instrument.begin(),
+               entry.instrument.begin() + len);
+    written.push_back(id);
+  }
+  if (written.empty())
+    return;
+
+  aero_tck_block blk{};
+  blk.magic = AERO_TCK_BLOCK_MAGIC;
+  blk.table = AERO_TCK_SYMBOLS;
+  blk.codec = AERO_TCK_CODEC_NONE;
+  blk.rows = static_cast<uint32_t>(written.size());
+  blk.raw_size = static_cast<uint32_t>(raw.size());
+  blk.stored_size = blk.raw_size;
+  if (!append(blk, raw.data()))
+    return;
+  // Only what the file now defines: an id the registry could not name is
+  // tried again with the next block that uses it
+  for (uint32_t id : written) {
+    if (id >= defined_.size())
+      defined_.resize(id + 1, 0);
+    defined_[id] = 1;
+  }
+}
+
+bool TickHistoryWriter::append(const aero_tck_block &blk,
+                               const uint8_t *data) {
+  // One writev per block, so a reader never sees a header without its data
+  // unless the write itself was cut short
+  iovec iov[2] = {{const_cast<aero_tck_block *>(&blk), sizeof(blk)},
+                  {const_cast<uint8_t *>(data), blk.stored_size}};
+  ssize_t want = static_cast<ssize_t>(sizeof(blk) + blk.stored_size);
+  ssize_t n = writev(fd_, iov, 2);
+  if (n == want)
+    return true;
+
+  if (!write_error_logged_) {
+    write_error_logged_ = true;
+    LOG_SYSTEM("TickHistoryWriter: Write failed: "
+               << (n < 0 ? strerror(errno) : "short write"));
+  }
+  // Cut a partial block off so later blocks stay reachable
+  if (n > 0) {
+    off_t end = lseek(fd_, 0, SEEK_END);
+    if (end >= n && ftruncate(fd_, end - n) < 0) {
+      close_file(); // Unusable: the rest of the day is dropped
+    }
+  }
+  return false;
+}
+
+bool TickHistoryWriter::open_day(uint64_t wall_ns) {
+  time_t secs = static_cast<time_t>(wall_ns / 1000000000ULL);
+  struct tm tm_utc;
+  gmtime_r(&secs, &tm_utc);
+  day_ = static_cast<uint32_t>((tm_utc.tm_year + 1900) * 10000 +
+                               (tm_utc.tm_mon + 1) * 100 + tm_utc.tm_mday);
+  day_end_ns_ = (wall_ns / NS_PER_DAY + 1) * NS_PER_DAY;
+  defined_.clear();
+  write_error_logged_ = false;
+
+  char name[32];
+  snprintf(name, sizeof(name), "/aero_ticks_%08u.atk", day_);
+  std::string path = cfg_.dir + name;
+  fd_ = open(path.c_str(), O_CREAT | O_RDWR | O_APPEND, 0644);
+  if (fd_ < 0) {
+    LOG_SYSTEM("TickHistoryWriter: Failed to open " << path << ": "
+                                                    << strerror(errno));
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd_, &st) < 0) {
+    close_file();
+    return false;
+  }
+  if (st.st_size == 0) {
+    aero_tck_header hdr{};
+    hdr.magic = AERO_TCK_MAGIC;
+    hdr.version = AERO_TCK_VERSION;
+    hdr.day = day_;
+    hdr.created_ns = wall_ns;
+    if (write(fd_, &hdr, sizeof(hdr)) != static_cast<ssize_t>(sizeof(hdr))) {
+      LOG_SYSTEM("TickHistoryWriter: Failed to write " << path);
+      close_file();
+      return false;
+    }
+    LOG_SYSTEM("TickHistoryWriter: Started " << path);
+    return true;
+  }
+
+  // Same day after a restart: validate, and drop a torn last block so the
+  // blocks appended now stay reachable
+  aero_tck_header hdr{};
+  if (pread(fd_, &hdr, sizeof(hdr), 0) != static_cast<ssize_t>(sizeof(hdr)) ||
+      hdr.magic != AERO_TCK_MAGIC || hdr.version != AERO_TCK_VERSION) {
+    LOG_SYSTEM("TickHistoryWriter: " << path
+                                     << " is not a tick history file");
+    close_file();
+    return false;
+  }
+  off_t off = sizeof(hdr);
+  aero_tck_block blk;
+  while (off + static_cast<off_t>(sizeof(blk)) <= st.st_size &&
+         pread(fd_, &blk, sizeof(blk), off) ==
+             static_cast<ssize_t>(sizeof(blk)) &&
+         blk.magic == AERO_TCK_BLOCK_MAGIC &&
+         off + static_cast<off_t>(sizeof(blk) + blk.stored_size) <=
+             st.st_size)
+    off += sizeof(blk) + blk.stored_size;
+  if (off != st.st_size && ftruncate(fd_, off) < 0) {
+    LOG_SYSTEM("TickHistoryWriter: Failed to repair " << path << ": "
+                                                      << strerror(errno));
+    close_file();
+    return false;
+  }
+  LOG_SYSTEM("TickHistoryWriter: Appending to " << path);
+  return true;
+}
+
+void TickHistoryWriter::close_file() {
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+void TickHistoryWriter::print_stats() const {
+  uint64_t raw = raw_bytes();
+  uint64_t stored = stored_bytes();
+  LOG_SYSTEM("[History] events="
+             << events() << " dropped=" << dropped() << " lost=" << lost()
+             << " blocks=" << blocks() << " raw_kb=" << raw / 1024
+             << " stored_kb=" << stored / 1024 << " ratio="
+             << (stored ? static_cast<double>(raw) / stored : 0.0));
+}
+
+} // namespace aero
@@ -0,0 +1,165 @@
+/**
+ * @file tick_history_writer.h
+ * @brief Background writer of the columnar BBO/trade history
+ *        (aero/tick_history.h)
+ */
+
+#ifndef AERO_MODULES_MARKET_DATA_TICK_HISTORY_WRITER_H
+#define AERO_MODULES_MARKET_DATA_TICK_HISTORY_WRITER_H
+
+#include "aero/tick_history.h"
+#include "core/spsc_ring.h"
+#include "modules/common/aero_types.h"
+#include "order_book.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Appends BBO changes and trades to per-day columnar files
+ *
+ * The feed-handler lcore only filters unchanged BBOs and copies one 64-byte
+ * event into a lock-free SPSC ring. A writer thread (optionally pinned to
+ * a housekeeping CPU) drains the ring into per-table column builders, and
+ * writes a block once it holds block_rows rows or its oldest row is
+ * flush_ms old. Blocks are compressed with zstd when the build has it.
+ *
+ * A full ring never blocks the feed handler: events are dropped and
+ * counted instead. Rows that cannot be written (no file, disk errors) are
+ * counted as lost.
+ *
+ * on_bbo()/on_trade() must be called from the feed-handler lcore.
+ */
+class TickHistoryWriter {
+public:
+  struct Config {
+    std::string dir = "history"; // Created if missing
+    size_t block_rows = 8192;    // Rows per block (per table)
+    uint32_t flush_ms = 1000;    // Max age of an unwritten row
+    size_t queue_events = 65536; // Ring size (rounded up to a power of two)
+    int cpu = -1;                // Pin the writer thread (-1 = no)
+    int zstd_level = 3;
+  };
+
+  TickHistoryWriter() = default;
+  ~TickHistoryWriter();
+
+  TickHistoryWriter(const TickHistoryWriter &) = delete;
+  TickHistoryWriter &operator=(const TickHistoryWriter &) = delete;
+
+  bool start(const Config &cfg);
+
+  /**
+   * @brief Drain the ring, write the open blocks and stop the thread
+   */
+  void stop();
+
+  bool is_running() const { return ring_.is_open(); }
+
+  /**
+   * @brief Record the top of book if it changed for this symbol
+   *
+   * @param symbol_id SymbolRegistry id (names go into each block's table)
+   */
+  void on_bbo(uint32_t symbol_id, const BestBidOffer &bbo,
+              uint64_t exchange_ts_ms, uint64_t rx_tsc);
+
+  /**
+   * @brief Record a trade
+   *
+   * @param is_sell Aggressor side
+   */
+  void on_trade(uint32_t symbol_id, uint64_t price, double qty, bool is_sell,
+                uint64_t exchange_ts_ms, uint64_t rx_tsc);
+
+  // Counters (any thread)
+  uint64_t events() const { return ring_.pushed(); }
+  uint64_t dropped() const { return ring_.dropped(); }
+  uint64_t lost() const { return lost_.load(std::memory_order_relaxed); }
+  uint64_t blocks() const { return blocks_.load(std::memory_order_relaxed); }
+  uint64_t raw_bytes() const {
+    return raw_bytes_.load(std::memory_order_relaxed);
+  }
+  uint64_t stored_bytes() const {
+    return stored_bytes_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Log counters
+   */
+  void print_stats() const;
+
+private:
+  struct Event {
+    uint8_t table; // AERO_TCK_BBO or AERO_TCK_TRADE
+    uint8_t side;
+    uint16_t reserved;
+    uint32_t symbol_id;
+    uint64_t rx_tsc;
+    uint64_t exchange_ts_ms;
+    uint64_t price[2];
+    uint64_t qty[2];
+    uint64_t wall_ns; // rx_tsc as CLOCK_REALTIME, set by the writer thread
+  };
+  static_assert(sizeof(Event) == 64, "one cache line per event");
+
+  struct LastBbo {
+    uint64_t bid_price = 0;
+    uint64_t bid_qty = 0;
+    uint64_t ask_price = 0;
+    uint64_t ask_qty = 0;
+  };
+
+  // Rows of one table waiting to be written, kept as decoded events
+  struct Builder {
+    uint8_t table;
+    std::vector<Event> rows;
+    uint64_t first_wall_ns = 0;
+    uint64_t oldest_tsc = 0; // Local TSC of the first row, for flush_ms
+  };
+
+  // Writer thread
+  void run();
+  void add_row(const Event &ev, uint64_t now_tsc);
+  void write_block(Builder &b);
+  void write_symbols(const std::vector<uint32_t> &ids);
+  bool open_day(uint64_t wall_ns);
+  void close_file();
+  bool append(const aero_tck_block &blk, const uint8_t *data);
+
+  Config cfg_;
+  SpscRing<Event> ring_;
+
+  // Producer (feed-handler lcore)
+  std::vector<LastBbo> last_bbo_; // By symbol id
+
+  // Consumer (writer thread)
+  alignas(64) std::atomic<bool> running_{false};
+  std::thread thread_;
+  int fd_ = -1;
+  uint32_t day_ = 0;          // YYYYMMDD of the open file
+  uint64_t day_end_ns_ = 0;   // Midnight after the open file's day
+  std::vector<uint8_t> defined_; // By symbol id: in the current file
+  Builder bbo_{AERO_TCK_BBO, {}};
+  Builder trades_{AERO_TCK_TRADE, {}};
+  uint64_t flush_tsc_ = 0;
+  std::vector<uint8_t> raw_;    // Encoded columns of one block
+  std::vector<uint8_t> cols_[7];
+  std::vector<uint8_t> stored_; // Compressed block
+  std::vector<uint32_t> slot_of_; // By symbol id, while encoding a block
+  bool write_error_logged_ = false;
+
+  alignas(64) std::atomic<uint64_t> lost_{0}; // Writer: rows not written
+  std::atomic<uint64_t> blocks_{0};
+  std::atomic<uint64_t> raw_bytes_{0};
+  std::atomic<uint64_t> stored_bytes_{0};
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_MARKET_DATA_TICK_HISTORY_WRITER_H
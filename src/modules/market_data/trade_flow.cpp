@@ -0,0 +1,143 @@
+#include "modules/market_data/trade_flow.h"
+#include "aero/feed_protocol.h"
+#include "core/logging.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace aero {
+
+static inline void bump(std::atomic<uint64_t> &counter, uint64_t n = 1) {
+  counter.store(counter.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+}
+
+void TradeFlowAggregator::configure(const TradeFlowConfig &cfg) {
+  cfg_ = cfg;
+  if (cfg_.window_count > TradeFlow::MAX_WINDOWS)
+    cfg_.window_count = TradeFlow::MAX_WINDOWS;
+  for (uint32_t w = 0; w < cfg_.window_count; w++)
+    if (cfg_.window_ms[w] == 0)
+      cfg_.window_ms[w] = 1;
+  size_t ring = 1;
+  while (ring < std::max<uint32_t>(cfg_.ring_trades, 2))
+    ring <<= 1;
+  cfg_.ring_trades = static_cast<uint32_t>(ring);
+  mask_ = ring - 1;
+  enabled_ = true;
+
+  std::string windows;
+  for (uint32_t w = 0; w < cfg_.window_count; w++)
+    windows += (w ? "," : "") + std::to_string(cfg_.window_ms[w]);
+  LOG_SYSTEM("TradeFlowAggregator: windows_ms="
+             << windows << " ring=" << cfg_.ring_trades << " trades/symbol");
+}
+
+void TradeFlowAggregator::drop_oldest(Window &win, const Entry &e) {
+  (e.is_sell ? win.sell_qty : win.buy_qty) -= e.qty;
+  win.notional -= static_cast<unsigned __int128>(e.price) * e.qty;
+  win.trades--;
+  win.tail++;
+}
+
+void TradeFlowAggregator::push(Symbol &sym, const TradePrint &trade) {
+  size_t capacity = sym.ring.size();
+  // Full: the oldest trade leaves every window still holding it
+  if (sym.head >= capacity) {
+    uint64_t oldest = sym.head - capacity;
+    bool dropped = false;
+    for (uint32_t w = 0; w < cfg_.window_count; w++) {
+      Window &win = sym.windows[w];
+      if (win.tail != oldest)
+        continue;
+      drop_oldest(win, sym.ring[oldest & mask_]);
+      dropped = true;
+    }
+    if (dropped)
+      bump(overflowed_);
+  }
+
+  // Ring times never go back, so expiry can stop at the first trade still
+  // in a window: a trade older than the newest one (or untimed) counts as
+  // happening at the newest time
+  if (trade.timestamp_ms != 0 && trade.timestamp_ms < sym.now_ms)
+    bump(late_);
+  Entry &e = sym.ring[sym.head & mask_];
+  e.ts_ms = std::max(trade.timestamp_ms, sym.now_ms);
+  e.price = trade.price_int;
+  e.qty = feed_fixed_qty(trade.qty);
+  e.is_sell = trade.is_sell;
+  sym.head++;
+  sym.now_ms = e.ts_ms;
+
+  unsigned __int128 notional = static_cast<unsigned __int128>(e.price) * e.qty;
+  for (uint32_t w = 0; w < cfg_.window_count; w++) {
+    Window &win = sym.windows[w];
+    (e.is_sell ? win.sell_qty : win.buy_qty) += e.qty;
+    win.notional += notional;
+    win.trades++;
+  }
+}
+
+void TradeFlowAggregator::add(uint32_t symbol_id,
+                              const std::vector<TradePrint> &trades,
+                              TradeFlow &out) {
+  if (symbol_id >= symbols_.size())
+    symbols_.resize(symbol_id + 1);
+  std::unique_ptr<Symbol> &slot = symbols_[symbol_id];
+  if (!slot) {
+    slot = std::make_unique<Symbol>();
+    slot->ring.resize(cfg_.ring_trades);
+    bump(symbol_count_);
+  }
+  Symbol &sym = *slot;
+
+  for (const TradePrint &t : trades)
+    push(sym, t);
+  bump(trades_, trades.size());
+
+  // Expire up to the newest trade
+  for (uint32_t w = 0; w < cfg_.window_count; w++) {
+    Window &win = sym.windows[w];
+    uint64_t window_ms = cfg_.window_ms[w];
+    while (win.tail != sym.head) {
+      const Entry &e = sym.ring[win.tail & mask_];
+      if (e.ts_ms + window_ms > sym.now_ms)
+        break;
+      drop_oldest(win, e);
+    }
+  }
+  fill(sym, out);
+}
+
+void TradeFlowAggregator::fill(const Symbol &sym, TradeFlow &out) const {
+  out = TradeFlow{};
+  out.windows = cfg_.window_count;
+  for (uint32_t w = 0; w < cfg_.window_count; w++) {
+    const Window &win = sym.windows[w];
+    TradeFlowWindow &o = out.window[w];
+    out.window_ms[w] = cfg_.window_ms[w];
+    o.trades = win.trades;
+    o.buy_qty = static_cast<double>(win.buy_qty) / FEED_QTY_SCALE;
+    o.sell_qty = static_cast<double>(win.sell_qty) / FEED_QTY_SCALE;
+    uint64_t qty = win.buy_qty + win.sell_qty;
+    o.vwap = qty ? static_cast<double>(win.notional) / static_cast<double>(qty)
+                 : 0.0;
+  }
+}
+
+bool TradeFlowAggregator::read(uint32_t symbol_id, TradeFlow &out) const {
+  if (symbol_id >= symbols_.size() || !symbols_[symbol_id])
+    return false;
+  fill(*symbols_[symbol_id], out);
+  return true;
+}
+
+void TradeFlowAggregator::print_stats() const {
+  LOG_SYSTEM("[TradeFlow] symbols="
+             << symbol_count_.load(std::memory_order_relaxed)
+             << " trades=" << trades() << " late=" << late()
+             << " overflowed=" << overflowed());
+}
+
+} // namespace aero
@@ -0,0 +1,157 @@
+/**
+ * @file trade_flow.h
+ * @brief Rolling per-symbol aggregates of public trades
+ */
+
+#ifndef AERO_MODULES_MARKET_DATA_TRADE_FLOW_H
+#define AERO_MODULES_MARKET_DATA_TRADE_FLOW_H
+
+#include "modules/exchange/exchange_adapter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Trades of one symbol within one time window
+ */
+struct TradeFlowWindow {
+  uint32_t trades;
+  double buy_qty;  // Aggressor buys, venue units
+  double sell_qty; // Aggressor sells
+  double vwap;     // PRICE_SCALE units; 0 without trades
+
+  double volume() const { return buy_qty + sell_qty; }
+
+  /**
+   * @brief (buy - sell) / (buy + sell) aggressor volume
+   */
+  double imbalance() const {
+    double sum = buy_qty + sell_qty;
+    return sum > 0.0 ? (buy_qty - sell_qty) / sum : 0.0;
+  }
+};
+
+/**
+ * @brief Aggregates of one symbol as of its last trade
+ */
+struct TradeFlow {
+  static constexpr size_t MAX_WINDOWS = 3;
+
+  uint32_t windows; // Windows configured
+  uint32_t window_ms[MAX_WINDOWS];
+  TradeFlowWindow window[MAX_WINDOWS];
+};
+
+struct TradeFlowConfig {
+  uint32_t window_ms[TradeFlow::MAX_WINDOWS] = {100, 1000, 5000};
+  uint32_t window_count = 3;
+  uint32_t ring_trades = 4096; // Per symbol (rounded up to a power of two)
+};
+
+/**
+ * @brief Volume, VWAP and aggressor imbalance over N-ms windows per symbol
+ *
+ * Each symbol keeps its recent trades in a ring buffer, allocated on its
+ * first trade. Every window has a tail index into the ring and running
+ * sums of the trades between its tail and the head: a new trade is added
+ * to every window, then each tail advances past the trades that left its
+ * window. Work per trade is constant (amortized), independent of how many
+ * trades a window holds. Windows are measured in exchange time, up to the
+ * newest trade of the symbol, so replaying a capture gives the same
+ * aggregates as live. A trade older than the symbol's newest one (counted
+ * in late()) is clamped to the newest time. The sums are integers (fixed-point quantities and
+ * exact notionals), so adding and removing trades never drifts.
+ *
+ * When the ring is full the oldest trade is dropped from every window
+ * still holding it (counted in overflowed()): size the ring for the
+ * longest window at the busiest symbol's trade rate.
+ *
+ * Not thread-safe: everything runs on the feed-handler lcore, except the
+ * counters and print_stats().
+ */
+class TradeFlowAggregator {
+public:
+  TradeFlowAggregator() = default;
+
+  TradeFlowAggregator(const TradeFlowAggregator &) = delete;
+  TradeFlowAggregator &operator=(const TradeFlowAggregator &) = delete;
+
+  /**
+   * @brief Enable the aggregator
+   */
+  void configure(const TradeFlowConfig &cfg);
+
+  bool enabled() const { return enabled_; }
+
+  const TradeFlowConfig &config() const { return cfg_; }
+
+  /**
+   * @brief Add the trades of one message and read the aggregates after them
+   */
+  void add(uint32_t symbol_id, const std::vector<TradePrint> &trades,
+           TradeFlow &out);
+
+  /**
+   * @brief Aggregates as of the symbol's last trade
+   *
+   * @return false if the symbol has had no trade
+   */
+  bool read(uint32_t symbol_id, TradeFlow &out) const;
+
+  // Counters (any thread)
+  uint64_t trades() const { return trades_.load(std::memory_order_relaxed); }
+  uint64_t overflowed() const {
+    return overflowed_.load(std::memory_order_relaxed);
+  }
+  uint64_t late() const { return late_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Log counters
+   */
+  void print_stats() const;
+
+private:
+  struct Entry {
+    uint64_t ts_ms;
+    uint64_t price; // PRICE_SCALE
+    uint64_t qty;   // FEED_QTY_SCALE
+    bool is_sell;
+  };
+
+  struct Window {
+    uint64_t tail = 0; // Oldest trade in the window (ring position)
+    uint64_t buy_qty = 0;
+    uint64_t sell_qty = 0;
+    unsigned __int128 notional = 0; // Sum of price * qty
+    uint32_t trades = 0;
+  };
+
+  struct Symbol {
+    std::vector<Entry> ring;
+    uint64_t head = 0;   // Next ring position
+    uint64_t now_ms = 0; // Newest trade time
+    Window windows[TradeFlow::MAX_WINDOWS];
+  };
+
+  static void drop_oldest(Window &win, const Entry &e);
+  void push(Symbol &sym, const TradePrint &trade);
+  void fill(const Symbol &sym, TradeFlow &out) const;
+
+  bool enabled_ = false;
+  TradeFlowConfig cfg_;
+  uint64_t mask_ = 0;
+  std::vector<std::unique_ptr<Symbol>> symbols_; // By symbol id
+
+  std::atomic<uint64_t> trades_{0};
+  std::atomic<uint64_t> overflowed_{0};
+  std::atomic<uint64_t> late_{0}; // Older than the symbol's newest trade
+  std::atomic<uint64_t> symbol_count_{0};
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_MARKET_DATA_TRADE_FLOW_H
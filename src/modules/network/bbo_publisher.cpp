@@ -0,0 +1,248 @@
+#include "modules/network/bbo_publisher.h"
+#include "core/logging.h"
+#include "core/tsc_clock.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <rte_byteorder.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace aero {
+
+BboPublisher::~BboPublisher() { close(); }
+
+bool BboPublisher::init(const std::string &address, int port, int mcast_ttl,
+                        const std::string &mcast_iface) {
+  memset(&addr_, 0, sizeof(addr_));
+  addr_.sin_family = AF_INET;
+  addr_.sin_port = htons(static_cast<uint16_t>(port));
+  if (inet_pton(AF_INET, address.c_str(), &addr_.sin_addr) <= 0) {
+    LOG_SYSTEM("BboPublisher: Invalid target address: " << address);
+    return false;
+  }
+
+  socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+  if (socket_fd_ < 0) {
+    LOG_SYSTEM("BboPublisher: Failed to create socket: " << strerror(errno));
+    return false;
+  }
+
+  int flags = fcntl(socket_fd_, F_GETFL, 0);
+  if (flags == -1 || fcntl(socket_fd_, F_SETFL, flags | O_NONBLOCK) == -1) {
+    LOG_SYSTEM("BboPublisher: Failed to set non-blocking");
+    close();
+    return false;
+  }
+
+  if ((ntohl(addr_.sin_addr.s_addr) & 0xF0000000) == 0xE0000000) {
+    unsigned char ttl = static_cast<unsigned char>(mcast_ttl);
+    unsigned char loop = 1;
+    setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop,
+               sizeof(loop));
+
+    if (!mcast_iface.empty()) {
+      struct in_addr iface;
+      if (inet_pton(AF_INET, mcast_iface.c_str(), &iface) <= 0 ||
+          setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_IF, &iface,
+                     sizeof(iface)) < 0) {
+        LOG_SYSTEM("BboPublisher: Failed to set multicast interface "
+                   << mcast_iface);
+      }
+    }
+  }
+
+  announce_tsc_ =
+      TscClock::instance().ns_to_tsc(ANNOUNCE_INTERVAL_MS * 1000000ULL);
+
+  LOG_SYSTEM("BboPublisher: Initialized broadcasting to " << address << ":"
+                                                          << port);
+  return true;
+}
+
+void BboPublisher::close() {
+  if (socket_fd_ >= 0) {
+    ::close(socket_fd_);
+    socket_fd_ = -1;
+  }
+}
+
+bool BboPublisher::send_record(const void *record) {
+  ssize_t n = sendto(socket_fd_, record, sizeof(FeedBboRecord), 0,
+                     (struct sockaddr *)&addr_, sizeof(addr_));
+  if (n == static_cast<ssize_t>(sizeof(FeedBboRecord))) {
+    records_sent_++;
+    return true;
+  }
+  // EAGAIN or error: best-effort, the next change supersedes this one
+  records_dropped_++;
+  return false;
+}
+
+void BboPublisher::announce(ExchangeId exchange_id, uint32_t symbol_id,
+                            const std::string &instrument) {
+  FeedBboSymbol rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.magic = rte_cpu_to_le_16(FEED_BBO_MAGIC);
+  rec.msg_type = FEED_BBO_SYMBOL;
+  rec.exchange_id = static_cast<uint8_t>(exchange_id);
+  rec.symbol_id = rte_cpu_to_le_32(symbol_id);
+  rec.seq_num = rte_cpu_to_le_64(next_seq_++);
+  memcpy(rec.name, instrument.data(),
+         std::min(instrument.size(), sizeof(rec.name) - 1));
+  send_record(&rec);
+}
+
+BboPublisher::LastQuote &BboPublisher::symbol(uint32_t id) {
+  if (id >= last_.size())
+    last_.resize(id + 1);
+  return last_[id];
+}
+
+// Symbol records go out with the first record of a symbol and then at most
+// once per interval, so late joiners can map ids without a side channel
+void BboPublisher::announce_if_due(ExchangeId exchange_id, uint32_t id,
+                                   const std::string &instrument,
+                                   LastQuote &last) {
+  uint64_t now = TscClock::now_tsc();
+  if (!last.announced || now >= last.announce_due_tsc) {
+    announce(exchange_id, id, instrument);
+    last.announced = true;
+    last.announce_due_tsc = now + announce_tsc_;
+  }
+}
+
+static inline uint64_t to_fixed_price(double price) {
+  return price > 0.0 ? static_cast<uint64_t>(std::llround(price)) : 0;
+}
+
+static void encode_analytics(const BboAnalytics &in, FeedBboAnalytics &out) {
+  out.microprice = rte_cpu_to_le_64(to_fixed_price(in.microprice));
+  out.bid_vwap = rte_cpu_to_le_64(to_fixed_price(in.bid_vwap));
+  out.ask_vwap = rte_cpu_to_le_64(to_fixed_price(in.ask_vwap));
+  for (size_t i = 0; i < FEED_BBO_DEPTHS; i++) {
+    out.bid_depth[i] = static_cast<float>(in.bid_depth[i]);
+    out.ask_depth[i] = static_cast<float>(in.ask_depth[i]);
+  }
+}
+
+bool BboPublisher::update(ExchangeId exchange_id, uint32_t id,
+                          const std::string &instrument, const BboQuote &quote,
+                          uint64_t exchange_ts_ms, uint64_t rx_tsc,
+                          const BboAnalytics *analytics) {
+  if (socket_fd_ < 0)
+    return false;
+
+  LastQuote &last = symbol(id);
+
+  uint64_t bid_qty = feed_fixed_qty(quote.bid_qty);
+  uint64_t ask_qty = feed_fixed_qty(quote.ask_qty);
+  bool quote_changed = !last.announced || last.bid_price != quote.bid_price ||
+                       last.bid_qty != bid_qty ||
+                       last.ask_price != quote.ask_price ||
+                       last.ask_qty != ask_qty;
+
+  // Everything after the header, compared as sent
+  constexpr size_t PAYLOAD = offsetof(FeedBboAnalytics, microprice);
+  FeedBboAnalytics ana;
+  bool analytics_changed = false;
+  if (analytics) {
+    encode_analytics(*analytics, ana);
+    analytics_changed =
+        memcmp(reinterpret_cast<const char *>(&ana) + PAYLOAD,
+               reinterpret_cast<const char *>(&last.analytics) + PAYLOAD,
+               sizeof(ana) - PAYLOAD) != 0;
+  }
+  if (!quote_changed && !analytics_changed) {
+    unchanged_++;
+    return false;
+  }
+
+  announce_if_due(exchange_id, id, instrument, last);
+
+  bool sent = false;
+  if (quote_changed) {
+    FeedBboRecord rec;
+    rec.magic = rte_cpu_to_le_16(FEED_BBO_MAGIC);
+    rec.msg_type = FEED_BBO_UPDATE;
+    rec.exchange_id = static_cast<uint8_t>(exchange_id);
+    rec.symbol_id = rte_cpu_to_le_32(id);
+    rec.seq_num = rte_cpu_to_le_64(next_seq_++);
+    rec.bid_price = rte_cpu_to_le_64(quote.bid_price);
+    rec.bid_qty = rte_cpu_to_le_64(bid_qty);
+    rec.ask_price = rte_cpu_to_le_64(quote.ask_price);
+    rec.ask_qty = rte_cpu_to_le_64(ask_qty);
+    rec.exchange_ts_ns = rte_cpu_to_le_64(exchange_ts_ms * 1000000ULL);
+    rec.gateway_tsc = rte_cpu_to_le_64(rx_tsc);
+
+    last.bid_price = quote.bid_price;
+    last.bid_qty = bid_qty;
+    last.ask_price = quote.ask_price;
+    last.ask_qty = ask_qty;
+    sent = send_record(&rec);
+  }
+
+  if (analytics_changed) {
+    ana.magic = rte_cpu_to_le_16(FEED_BBO_MAGIC);
+    ana.msg_type = FEED_BBO_ANALYTICS;
+    ana.exchange_id = static_cast<uint8_t>(exchange_id);
+    ana.symbol_id = rte_cpu_to_le_32(id);
+    ana.seq_num = rte_cpu_to_le_64(next_seq_++);
+    last.analytics = ana;
+    sent |= send_record(&ana);
+  }
+  return sent;
+}
+
+bool BboPublisher::trade(ExchangeId exchange_id, uint32_t id,
+                         const std::string &instrument, uint64_t price,
+                         double qty, bool is_sell, uint64_t exchange_ts_ms,
+                         uint64_t rx_tsc) {
+  if (socket_fd_ < 0)
+    return false;
+  LastQuote &last = symbol(id);
+  announce_if_due(exchange_id, id, instrument, last);
+
+  FeedBboTrade rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.magic = rte_cpu_to_le_16(FEED_BBO_MAGIC);
+  rec.msg_type = FEED_BBO_TRADE;
+  rec.exchange_id = static_cast<uint8_t>(exchange_id);
+  rec.symbol_id = rte_cpu_to_le_32(id);
+  rec.seq_num = rte_cpu_to_le_64(next_seq_++);
+  rec.price = rte_cpu_to_le_64(price);
+  rec.qty = rte_cpu_to_le_64(feed_fixed_qty(qty));
+  rec.exchange_ts_ns = rte_cpu_to_le_64(exchange_ts_ms * 1000000ULL);
+  rec.gateway_tsc = rte_cpu_to_le_64(rx_tsc);
+  rec.side = is_sell ? 1 : 0;
+  return send_record(&rec);
+}
+
+bool BboPublisher::trade_flow(ExchangeId exchange_id, uint32_t id,
+                              const std::string &instrument,
+                              const BboTradeFlow &flow) {
+  if (socket_fd_ < 0)
+    return false;
+  LastQuote &last = symbol(id);
+  announce_if_due(exchange_id, id, instrument, last);
+
+  FeedBboTradeFlow rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.magic = rte_cpu_to_le_16(FEED_BBO_MAGIC);
+  rec.msg_type = FEED_BBO_TRADE_FLOW;
+  rec.exchange_id = static_cast<uint8_t>(exchange_id);
+  rec.symbol_id = rte_cpu_to_le_32(id);
+  rec.seq_num = rte_cpu_to_le_64(next_seq_++);
+  for (size_t i = 0; i < FEED_BBO_FLOW_WINDOWS && i < flow.windows; i++) {
+    rec.vwap[i] = rte_cpu_to_le_64(to_fixed_price(flow.vwap[i]));
+    rec.buy_qty[i] = static_cast<float>(flow.buy_qty[i]);
+    rec.sell_qty[i] = static_cast<float>(flow.sell_qty[i]);
+  }
+  return send_record(&rec);
+}
+
+} // namespace aero
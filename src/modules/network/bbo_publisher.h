@@ -0,0 +1,157 @@
+/**
+ * @file bbo_publisher.h
+ * @brief Top-of-book fast channel: one 64-byte record per BBO change
+ */
+
+#ifndef AERO_MODULES_NETWORK_BBO_PUBLISHER_H
+#define AERO_MODULES_NETWORK_BBO_PUBLISHER_H
+
+#include "aero/feed_protocol.h"
+#include "modules/common/aero_types.h"
+#include <cstdint>
+#include <netinet/in.h>
+#include <string>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Top of book as seen by the gateway, in feed units
+ */
+struct BboQuote {
+  uint64_t bid_price; // PRICE_SCALE
+  double bid_qty;
+  uint64_t ask_price;
+  double ask_qty;
+};
+
+/**
+ * @brief Derived book signals sent after the quote (FeedBboAnalytics)
+ */
+struct BboAnalytics {
+  double microprice; // PRICE_SCALE
+  double bid_vwap;   // PRICE_SCALE, 0 if the side is too thin
+  double ask_vwap;
+  double bid_depth[FEED_BBO_DEPTHS];
+  double ask_depth[FEED_BBO_DEPTHS];
+};
+
+/**
+ * @brief Rolling trade aggregates sent after a symbol's trades
+ *        (FeedBboTradeFlow; also the shm bus trade flow event)
+ */
+struct BboTradeFlow {
+  uint32_t windows; // Windows used
+  uint32_t window_ms[FEED_BBO_FLOW_WINDOWS];
+  uint32_t trades[FEED_BBO_FLOW_WINDOWS];
+  double vwap[FEED_BBO_FLOW_WINDOWS]; // PRICE_SCALE, 0 without trades
+  double buy_qty[FEED_BBO_FLOW_WINDOWS];
+  double sell_qty[FEED_BBO_FLOW_WINDOWS];
+};
+
+/**
+ * @brief Sends FeedBboRecord datagrams when a symbol's top of book changes
+ *
+ * Given analytics, a FeedBboAnalytics record follows every quote change and
+ * goes out alone when only the analytics changed.
+ * Public trades go out as they are received (FeedBboTrade), followed by
+ * the symbol's trade flow (FeedBboTradeFlow).
+ *
+ * Unlike UdpPublisher there is no batching: each change goes out with one
+ * non-blocking sendto() as soon as it is seen, since this channel exists
+ * for consumers that only care about the inside market and want it first.
+ *
+ * Not thread-safe: update(), trade() and trade_flow() must be called from
+ * the feed-handler lcore.
+ */
+class BboPublisher {
+public:
+  static constexpr uint64_t ANNOUNCE_INTERVAL_MS = 1000; // FeedBboSymbol repeat
+
+  BboPublisher() = default;
+  ~BboPublisher();
+
+  BboPublisher(const BboPublisher &) = delete;
+  BboPublisher &operator=(const BboPublisher &) = delete;
+
+  /**
+   * @brief Open the socket
+   *
+   * @param address Unicast address or multicast group
+   * @param port Destination port
+   * @param mcast_ttl Multicast TTL (multicast groups only)
+   * @param mcast_iface Local interface IP for multicast egress ("" = default)
+   */
+  bool init(const std::string &address, int port, int mcast_ttl = 1,
+            const std::string &mcast_iface = "");
+
+  // Every record takes the symbol's SymbolRegistry id, resolved once by the
+  // caller; the name only goes into the periodic symbol records
+
+  /**
+   * @brief Publish the top of book if it differs from the last one sent
+   *
+   * @param analytics Optional; sent if it differs from the last one sent
+   * @return true if a record was sent
+   */
+  bool update(ExchangeId exchange_id, uint32_t symbol_id,
+              const std::string &instrument, const BboQuote &quote,
+              uint64_t exchange_ts_ms, uint64_t rx_tsc,
+              const BboAnalytics *analytics = nullptr);
+
+  /**
+   * @brief Publish one public trade (never deduplicated)
+   *
+   * @param is_sell Aggressor side
+   */
+  bool trade(ExchangeId exchange_id, uint32_t symbol_id,
+             const std::string &instrument, uint64_t price, double qty,
+             bool is_sell, uint64_t exchange_ts_ms, uint64_t rx_tsc);
+
+  /**
+   * @brief Publish a symbol's rolling trade aggregates
+   */
+  bool trade_flow(ExchangeId exchange_id, uint32_t symbol_id,
+                  const std::string &instrument, const BboTradeFlow &flow);
+
+  void close();
+
+  bool is_initialized() const { return socket_fd_ >= 0; }
+
+  // Counters (owner thread only)
+  uint64_t records_sent() const { return records_sent_; }
+  uint64_t records_dropped() const { return records_dropped_; }
+  uint64_t unchanged() const { return unchanged_; }
+
+private:
+  struct LastQuote {
+    bool announced = false;
+    uint64_t announce_due_tsc = 0;
+    uint64_t bid_price = 0;
+    uint64_t bid_qty = 0;
+    uint64_t ask_price = 0;
+    uint64_t ask_qty = 0;
+    FeedBboAnalytics analytics{}; // Last sent (payload compared)
+  };
+
+  bool send_record(const void *record);
+  void announce(ExchangeId exchange_id, uint32_t symbol_id,
+                const std::string &instrument);
+  LastQuote &symbol(uint32_t id);
+  void announce_if_due(ExchangeId exchange_id, uint32_t id,
+                       const std::string &instrument, LastQuote &last);
+
+  int socket_fd_ = -1;
+  struct sockaddr_in addr_{};
+  uint64_t next_seq_ = 1;
+  uint64_t announce_tsc_ = 0;
+  std::vector<LastQuote> last_; // Indexed by SymbolRegistry id
+
+  uint64_t records_sent_ = 0;
+  uint64_t records_dropped_ = 0;
+  uint64_t unchanged_ = 0;
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_NETWORK_BBO_PUBLISHER_H
@@ -1,5 +1,6 @@
 #include "boost_websocket_client.h"
 #include "core/logging.h"
+#include "core/tsc_clock.h"
 #include <iostream>
 
 BoostWebSocketClient::BoostWebSocketClient() {
@@ -104,8 +105,8 @@ void BoostWebSocketClient::send(const std::string &message) {
   });
 }
 
-std::optional<std::string> BoostWebSocketClient::get_next_message() {
-  std::string msg;
+std::optional<WsMessage> BoostWebSocketClient::get_next_message() {
+  WsMessage msg;
   if (incoming_queue_.try_dequeue(msg)) {
     return msg;
   }
@@ -115,6 +116,7 @@ std::optional<std::string> BoostWebSocketClient::get_next_message() {
 void BoostWebSocketClient::do_read() {
   ws_->async_read(
       buffer_, [this](beast::error_code ec, std::size_t bytes_transferred) {
+        uint64_t rx_tsc = aero::TscClock::now_tsc();
         if (ec) {
           std::cout << "BoostWebSocketClient Read Error: " << ec.message()
                     << std::endl;
@@ -134,13 +136,14 @@ void BoostWebSocketClient::do_read() {
         // Convert buffer to string and enqueue
         // Limit queue size to prevent memory exhaustion
         if (incoming_queue_.size_approx() < MAX_INCOMING_QUEUE_SIZE) {
-          incoming_queue_.enqueue(beast::buffers_to_string(buffer_.data()));
+          incoming_queue_.enqueue(
+              WsMessage{beast::buffers_to_string(buffer_.data()), rx_tsc});
         } else {
-          // Drop message and log warning (silently log or count)
-          static uint64_t drop_count = 0;
-          if (++drop_count % 1000 == 0) {
+          // Drop the message; the consumer resyncs the affected books
+          overflowed_.store(true, std::memory_order_release);
+          if (++drop_count_ % 1000 == 1) {
             LOG_SYSTEM("WARNING: WebSocket incoming queue full. Dropped "
-                       << drop_count << " messages.");
+                       << drop_count_ << " messages.");
           }
         }
 
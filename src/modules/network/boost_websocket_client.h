@@ -25,6 +25,14 @@ namespace net = boost::asio;            // from <boost/asio.hpp>
 namespace ssl = boost::asio::ssl;       // from <boost/asio/ssl.hpp>
 using tcp = boost::asio::ip::tcp;       // from <boost/asio/ip/tcp.hpp>
 
+/**
+ * @brief A received WebSocket frame with its local receive timestamp
+ */
+struct WsMessage {
+  std::string data;
+  uint64_t rx_tsc; // TSC taken when the frame completed on the I/O thread
+};
+
 class BoostWebSocketClient {
 public:
   explicit BoostWebSocketClient();
@@ -58,9 +66,24 @@ public:
 
   /**
    * @brief Retrieves the next received message from the queue.
-   * @return The message string, or std::nullopt if queue is empty.
+   * @return The message and its receive TSC, or std::nullopt if queue is
+   * empty.
+   */
+  std::optional<WsMessage> get_next_message();
+
+  /**
+   * @brief Approximate number of received messages not yet consumed.
+   */
+  size_t backlog() const { return incoming_queue_.size_approx(); }
+
+  /**
+   * @brief Whether messages were dropped on a full queue since the last
+   * call. Book state built from this stream is then unreliable until the
+   * exchange sends fresh snapshots.
    */
-  std::optional<std::string> get_next_message();
+  bool take_overflow() {
+    return overflowed_.exchange(false, std::memory_order_acq_rel);
+  }
 
   /**
    * @brief Sets the callback to be invoked after a successful reconnection.
@@ -106,9 +129,11 @@ private:
   // Message Queues
   // Queue for outgoing messages (to be sent) - NOT USED YET, we use blocking
   // send for now or post() Queue for incoming messages (received)
-  moodycamel::ConcurrentQueue<std::string> incoming_queue_;
+  moodycamel::ConcurrentQueue<WsMessage> incoming_queue_;
   static constexpr size_t MAX_INCOMING_QUEUE_SIZE =
       10000; // Limit to 10k messages
+  std::atomic<bool> overflowed_{false}; // Set on drop, see take_overflow()
+  uint64_t drop_count_ = 0;             // I/O thread only
 
   // Buffer for reading
   beast::flat_buffer buffer_;
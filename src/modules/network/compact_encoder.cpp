@@ -0,0 +1,316 @@
+#include "modules/network/compact_encoder.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cmath>
+#include <cstring>
+#include <endian.h>
+#include <numeric>
+
+namespace aero {
+
+static inline bool bid_better(uint64_t a, uint64_t b) { return a > b; }
+static inline bool ask_better(uint64_t a, uint64_t b) { return a < b; }
+
+template <typename Level, typename Better>
+static void apply_update(std::vector<Level> &side, const Level &lvl,
+                         Better better) {
+  auto it = std::lower_bound(
+      side.begin(), side.end(), lvl.price,
+      [&](const Level &l, uint64_t p) { return better(l.price, p); });
+  bool found = it != side.end() && it->price == lvl.price;
+  if (lvl.qty == 0) {
+    if (found)
+      side.erase(it);
+  } else if (found) {
+    it->qty = lvl.qty;
+  } else {
+    side.insert(it, lvl);
+  }
+}
+
+// Levels that differ between prev and next, in best-first order; a level
+// missing from next is emitted with qty 0.
+template <typename Level, typename Better>
+static void diff_side(const std::vector<Level> &prev,
+                      const std::vector<Level> &next, Better better,
+                      std::vector<Level> &out) {
+  out.clear();
+  size_t i = 0, j = 0;
+  while (i < prev.size() || j < next.size()) {
+    if (j == next.size() ||
+        (i < prev.size() && better(prev[i].price, next[j].price))) {
+      out.push_back(Level{prev[i].price, 0});
+      i++;
+    } else if (i == prev.size() || better(next[j].price, prev[i].price)) {
+      out.push_back(next[j]);
+      j++;
+    } else {
+      if (prev[i].qty != next[j].qty)
+        out.push_back(next[j]);
+      i++;
+      j++;
+    }
+  }
+}
+
+static inline size_t varint_size(uint64_t v) {
+  size_t n = 1;
+  while (v >= 0x80) {
+    v >>= 7;
+    n++;
+  }
+  return n;
+}
+
+static uint8_t *write_header(uint8_t *out, uint8_t msg_type,
+                             ExchangeId exchange_id, uint16_t channel,
+                             uint32_t symbol_id, uint64_t now_wall_ns,
+                             uint16_t flags = 0) {
+  CompactHeader hdr;
+  hdr.magic = htonl(UDP_FEED_MAGIC);
+  hdr.version = htons(UDP_FEED_VERSION_COMPACT);
+  hdr.msg_type = msg_type;
+  hdr.exchange_id = static_cast<uint8_t>(exchange_id);
+  hdr.channel_id = htole16(channel);
+  hdr.flags = htole16(flags);
+  hdr.symbol_id = htole32(symbol_id);
+  hdr.seq_num = 0;
+  hdr.timestamp_ns = htole64(now_wall_ns);
+  std::memcpy(out, &hdr, sizeof(hdr));
+  return out + sizeof(hdr);
+}
+
+void CompactBookEncoder::set_seq(std::span<uint8_t> msg, uint64_t seq) {
+  uint64_t le = htole64(seq);
+  std::memcpy(msg.data() + offsetof(CompactHeader, seq_num), &le, sizeof(le));
+}
+
+CompactBookEncoder::SymbolState &CompactBookEncoder::state(uint32_t id) {
+  if (id >= symbols_.size())
+    symbols_.resize(id + 1);
+  return symbols_[id];
+}
+
+std::vector<uint8_t> &CompactBookEncoder::next_message(size_t &n) {
+  if (n == msgs_.size())
+    msgs_.emplace_back();
+  return msgs_[n++];
+}
+
+void CompactBookEncoder::build_next(const ParsedOrderBook &book,
+                                    const SymbolState &st) {
+  if (book.is_snapshot) {
+    next_bids_.clear();
+    next_asks_.clear();
+    for (const auto &l : book.bids)
+      if (uint64_t q = feed_fixed_qty(l.size))
+        next_bids_.push_back(Level{l.price_int, q});
+    for (const auto &l : book.asks)
+      if (uint64_t q = feed_fixed_qty(l.size))
+        next_asks_.push_back(Level{l.price_int, q});
+    std::sort(next_bids_.begin(), next_bids_.end(),
+              [](const Level &a, const Level &b) {
+                return bid_better(a.price, b.price);
+              });
+    std::sort(next_asks_.begin(), next_asks_.end(),
+              [](const Level &a, const Level &b) {
+                return ask_better(a.price, b.price);
+              });
+    return;
+  }
+
+  next_bids_ = st.bids;
+  next_asks_ = st.asks;
+  for (const auto &l : book.bids)
+    apply_update(next_bids_, Level{l.price_int, feed_fixed_qty(l.size)},
+                 bid_better);
+  for (const auto &l : book.asks)
+    apply_update(next_asks_, Level{l.price_int, feed_fixed_qty(l.size)},
+                 ask_better);
+}
+
+size_t CompactBookEncoder::encode(const ParsedOrderBook &book,
+                                  ExchangeId exchange_id, uint32_t id,
+                                  uint16_t channel, uint64_t now_tsc,
+                                  uint64_t now_wall_ns) {
+  SymbolState &st = state(id);
+
+  // The tick is learned as the GCD of every price seen. It only ever
+  // shrinks, so levels already published stay representable; consumers
+  // pick up the new value from the re-sent definition.
+  uint64_t tick = st.tick;
+  for (const auto &l : book.bids)
+    tick = std::gcd(tick, l.price_int);
+  for (const auto &l : book.asks)
+    tick = std::gcd(tick, l.price_int);
+  if (tick == 0)
+    tick = 1;
+
+  build_next(book, st);
+
+  bool full = !st.defined ||
+              (refresh_tsc_ != 0 && now_tsc >= st.refresh_due_tsc);
+  bool need_def = full || tick != st.tick;
+
+  if (!full) {
+    diff_side(st.bids, next_bids_, bid_better, out_bids_);
+    diff_side(st.asks, next_asks_, ask_better, out_asks_);
+    if (out_bids_.empty() && out_asks_.empty() && !need_def) {
+      unchanged_++;
+      return 0;
+    }
+  } else {
+    out_bids_ = next_bids_;
+    out_asks_ = next_asks_;
+  }
+
+  size_t n = 0;
+  if (need_def)
+    write_def(next_message(n), id, exchange_id, channel, now_wall_ns,
+              book.instrument, tick);
+
+  if (full || !out_bids_.empty() || !out_asks_.empty()) {
+    uint8_t msg_type = full ? FEED_MSG_SNAPSHOT : FEED_MSG_DELTA;
+    std::vector<uint8_t> &out = next_message(n);
+    write_book(out, msg_type, id, exchange_id, channel, now_wall_ns, tick,
+               out_bids_, out_asks_);
+    // Rare (deep snapshots, bursts of changes): re-encode in chunks rather
+    // than leave the datagram to IP fragmentation
+    if (out.size() > max_datagram_) {
+      n = write_chunks(n - 1, msg_type, id, exchange_id, channel, now_wall_ns,
+                       tick);
+      chunked_++;
+    }
+    if (full)
+      snapshots_++;
+    else
+      deltas_++;
+  }
+
+  st.defined = true;
+  st.tick = tick;
+  if (full)
+    st.refresh_due_tsc = now_tsc + refresh_tsc_;
+  st.bids.swap(next_bids_);
+  st.asks.swap(next_asks_);
+  return n;
+}
+
+void CompactBookEncoder::write_def(std::vector<uint8_t> &out, uint32_t id,
+                                   ExchangeId exchange_id, uint16_t channel,
+                                   uint64_t now_wall_ns,
+                                   const std::string &instrument,
+                                   uint64_t tick) {
+  size_t name_len = std::min<size_t>(instrument.size(), UINT8_MAX);
+  out.resize(sizeof(CompactHeader) + sizeof(CompactSymbolDef) + name_len);
+
+  uint8_t *p = write_header(out.data(), FEED_MSG_SYMBOL_DEF, exchange_id,
+                            channel, id, now_wall_ns);
+  CompactSymbolDef def;
+  def.tick = htole64(tick);
+  def.name_len = static_cast<uint8_t>(name_len);
+  std::memcpy(p, &def, sizeof(def));
+  std::memcpy(p + sizeof(def), instrument.data(), name_len);
+}
+
+void CompactBookEncoder::write_book(std::vector<uint8_t> &out,
+                                    uint8_t msg_type, uint32_t id,
+                                    ExchangeId exchange_id, uint16_t channel,
+                                    uint64_t now_wall_ns, uint64_t tick,
+                                    std::span<const Level> bids,
+                                    std::span<const Level> asks,
+                                    uint16_t chunk_index,
+                                    uint16_t chunk_count) {
+  constexpr size_t MAX_VARINT = 10;
+  size_t levels = bids.size() + asks.size();
+  out.resize(sizeof(CompactHeader) + 5 * MAX_VARINT +
+             levels * 2 * MAX_VARINT);
+
+  uint8_t *start = out.data();
+  uint8_t *p = write_header(start, msg_type, exchange_id, channel, id,
+                            now_wall_ns, chunk_count ? FEED_FLAG_CHUNKED : 0);
+  if (chunk_count) {
+    p += feed_put_varint(p, chunk_index);
+    p += feed_put_varint(p, chunk_count);
+  }
+  p += feed_put_varint(p, bids.size());
+  p += feed_put_varint(p, asks.size());
+
+  const Level *first = !bids.empty()   ? &bids.front()
+                       : !asks.empty() ? &asks.front()
+                                       : nullptr;
+  int64_t prev = first ? static_cast<int64_t>(first->price / tick) : 0;
+  p += feed_put_varint(p, static_cast<uint64_t>(prev));
+
+  for (const auto side : {bids, asks}) {
+    for (const auto &l : side) {
+      int64_t ticks = static_cast<int64_t>(l.price / tick);
+      p += feed_put_varint(p, feed_zigzag(ticks - prev));
+      p += feed_put_varint(p, l.qty);
+      prev = ticks;
+    }
+  }
+  out.resize(static_cast<size_t>(p - start));
+}
+
+size_t CompactBookEncoder::write_chunks(size_t n, uint8_t msg_type, uint32_t id,
+                                        ExchangeId exchange_id,
+                                        uint16_t channel,
+                                        uint64_t now_wall_ns, uint64_t tick) {
+  // Header, chunk and count varints, base price, and the jump from the last
+  // bid to the first ask, which per-side costs below do not cover
+  constexpr size_t CHUNK_OVERHEAD = sizeof(CompactHeader) + 4 * 3 + 2 * 10;
+  size_t budget =
+      max_datagram_ > CHUNK_OVERHEAD ? max_datagram_ - CHUNK_OVERHEAD : 0;
+
+  // Upper bound of a level's encoding: inside a chunk, consecutive levels of
+  // a side are encoded against each other just like in the whole book
+  auto cost = [tick](const std::vector<Level> &side, size_t i) {
+    int64_t ticks = static_cast<int64_t>(side[i].price / tick);
+    int64_t prev =
+        i > 0 ? static_cast<int64_t>(side[i - 1].price / tick) : ticks;
+    return varint_size(feed_zigzag(ticks - prev)) + varint_size(side[i].qty);
+  };
+
+  // Fill chunks best levels first, alternating sides, so chunk 0 holds the
+  // top of both sides
+  chunks_.clear();
+  size_t b = 0, a = 0;
+  while (b < out_bids_.size() || a < out_asks_.size()) {
+    size_t used = 0, nb = 0, na = 0;
+    for (;;) {
+      bool bid = b < out_bids_.size() && (a == out_asks_.size() || nb <= na);
+      if (!bid && a == out_asks_.size())
+        break;
+      size_t c = bid ? cost(out_bids_, b) : cost(out_asks_, a);
+      if (used + c > budget && nb + na > 0)
+        break;
+      used += c;
+      if (bid) {
+        b++;
+        nb++;
+      } else {
+        a++;
+        na++;
+      }
+    }
+    chunks_.push_back(Chunk{b, a});
+  }
+
+  std::span<const Level> bids(out_bids_), asks(out_asks_);
+  uint16_t count = static_cast<uint16_t>(chunks_.size());
+  size_t bid_begin = 0, ask_begin = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    const Chunk &c = chunks_[i];
+    // Chunk 0 replaces the book on a snapshot; the rest only add levels
+    write_book(next_message(n), i == 0 ? msg_type : FEED_MSG_DELTA, id,
+               exchange_id, channel, now_wall_ns, tick,
+               bids.subspan(bid_begin, c.bid_end - bid_begin),
+               asks.subspan(ask_begin, c.ask_end - ask_begin), i, count);
+    bid_begin = c.bid_end;
+    ask_begin = c.ask_end;
+  }
+  return n;
+}
+
+} // namespace aero
@@ -0,0 +1,119 @@
+/**
+ * @file compact_encoder.h
+ * @brief Encoder for the compact (version 3) UDP feed format
+ *
+ * Keeps the last published book of every symbol and turns each update into
+ * the levels that actually changed: prices as varint tick deltas, sizes as
+ * fixed-point varints, the instrument replaced by its SymbolRegistry id.
+ * Books that do not fit one datagram are split into FEED_FLAG_CHUNKED
+ * chunks. See aero/feed_protocol.h for the layout.
+ */
+
+#ifndef AERO_MODULES_NETWORK_COMPACT_ENCODER_H
+#define AERO_MODULES_NETWORK_COMPACT_ENCODER_H
+
+#include "aero/feed_protocol.h"
+#include "modules/common/aero_types.h"
+#include "modules/exchange/exchange_adapter.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace aero {
+
+class CompactBookEncoder {
+public:
+  /**
+   * @param refresh_tsc Interval between full snapshots of a symbol, in TSC
+   *        cycles (0 = only when the symbol is first published)
+   * @param max_datagram Largest datagram to produce; bigger books are split
+   */
+  explicit CompactBookEncoder(uint64_t refresh_tsc = 0,
+                              size_t max_datagram = 1472)
+      : refresh_tsc_(refresh_tsc), max_datagram_(max_datagram) {}
+
+  /**
+   * @brief Encode one update against the last published state
+   *
+   * Produces the datagrams to send, in order (symbol definition, then the
+   * book or its chunks), with seq_num left at 0 for the caller to assign.
+   * `symbol_id` is the book's SymbolRegistry id, already resolved by the
+   * feed sinks. Returns 0 if nothing changed.
+   */
+  size_t encode(const ParsedOrderBook &book, ExchangeId exchange_id,
+                uint32_t symbol_id, uint16_t channel, uint64_t now_tsc,
+                uint64_t now_wall_ns);
+
+  std::span<uint8_t> message(size_t i) {
+    return {msgs_[i].data(), msgs_[i].size()};
+  }
+
+  /**
+   * @brief Stamp the channel sequence number into an encoded datagram
+   */
+  static void set_seq(std::span<uint8_t> msg, uint64_t seq);
+
+  // Counters (owner thread only)
+  uint64_t snapshots() const { return snapshots_; }
+  uint64_t deltas() const { return deltas_; }
+  uint64_t unchanged() const { return unchanged_; }
+  uint64_t chunked() const { return chunked_; } // Books split in chunks
+
+private:
+  struct Level {
+    uint64_t price; // PRICE_SCALE units
+    uint64_t qty;   // FEED_QTY_SCALE units, 0 = removed
+  };
+
+  struct SymbolState {
+    bool defined = false;
+    uint64_t tick = 0;
+    uint64_t refresh_due_tsc = 0;
+    std::vector<Level> bids; // Best (highest) first
+    std::vector<Level> asks; // Best (lowest) first
+  };
+
+  SymbolState &state(uint32_t id);
+  std::vector<uint8_t> &next_message(size_t &n);
+
+  void build_next(const ParsedOrderBook &book, const SymbolState &st);
+  void write_def(std::vector<uint8_t> &out, uint32_t id,
+                 ExchangeId exchange_id, uint16_t channel,
+                 uint64_t now_wall_ns, const std::string &instrument,
+                 uint64_t tick);
+  void write_book(std::vector<uint8_t> &out, uint8_t msg_type, uint32_t id,
+                  ExchangeId exchange_id, uint16_t channel,
+                  uint64_t now_wall_ns, uint64_t tick,
+                  std::span<const Level> bids, std::span<const Level> asks,
+                  uint16_t chunk_index = 0, uint16_t chunk_count = 0);
+  size_t write_chunks(size_t n, uint8_t msg_type, uint32_t id,
+                      ExchangeId exchange_id, uint16_t channel,
+                      uint64_t now_wall_ns, uint64_t tick);
+
+  uint64_t refresh_tsc_;
+  size_t max_datagram_;
+  std::vector<SymbolState> symbols_; // Indexed by SymbolRegistry id
+
+  // Scratch, reused across calls
+  std::vector<Level> next_bids_;
+  std::vector<Level> next_asks_;
+  std::vector<Level> out_bids_;
+  std::vector<Level> out_asks_;
+  std::vector<std::vector<uint8_t>> msgs_; // Grown on demand, never shrunk
+  struct Chunk {
+    size_t bid_end;
+    size_t ask_end;
+  };
+  std::vector<Chunk> chunks_;
+
+  uint64_t snapshots_ = 0;
+  uint64_t deltas_ = 0;
+  uint64_t unchanged_ = 0;
+  uint64_t chunked_ = 0;
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_NETWORK_COMPACT_ENCODER_H
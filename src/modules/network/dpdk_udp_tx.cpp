@@ -0,0 +1,177 @@
+#include "modules/network/dpdk_udp_tx.h"
+#include "core/logging.h"
+#include "modules/network/network_utils.h"
+
+#include <cstring>
+#include <netinet/in.h>
+
+#include <rte_byteorder.h>
+#include <rte_ethdev.h>
+#include <rte_memcpy.h>
+
+namespace aero {
+
+DpdkUdpTx::~DpdkUdpTx() {
+  for (uint16_t i = 0; i < count_; i++)
+    rte_pktmbuf_free(pending_[i]);
+  count_ = 0;
+}
+
+bool DpdkUdpTx::init(const Config &cfg) {
+  if (cfg.mbuf_pool == nullptr) {
+    LOG_SYSTEM("DpdkUdpTx: No mbuf pool");
+    return false;
+  }
+  cfg_ = cfg;
+
+  // Checksum offload only if the port was configured with it
+  hw_ip_cksum_ = (cfg.tx_offloads & RTE_ETH_TX_OFFLOAD_IPV4_CKSUM) != 0;
+  hw_udp_cksum_ = (cfg.tx_offloads & RTE_ETH_TX_OFFLOAD_UDP_CKSUM) != 0;
+
+  uint16_t mtu = RTE_ETHER_MTU;
+  if (rte_eth_dev_get_mtu(cfg.port_id, &mtu) != 0)
+    mtu = RTE_ETHER_MTU;
+  max_payload_ = mtu - sizeof(rte_ipv4_hdr) - sizeof(rte_udp_hdr);
+
+  templates_.clear();
+  add_destination(cfg.dst_ip, cfg.dst_port, cfg.dst_mac);
+
+  LOG_SYSTEM("DpdkUdpTx: port " << cfg.port_id << " queue " << cfg.queue_id
+                                << " -> "
+                                << NetworkUtils::ip_to_string(cfg.dst_ip)
+                                << ":" << cfg.dst_port << " ("
+                                << NetworkUtils::mac_to_string(cfg.dst_mac)
+                                << "), cksum="
+                                << (hw_udp_cksum_ ? "hw" : "sw")
+                                << ", max_payload=" << max_payload_);
+  return true;
+}
+
+uint16_t DpdkUdpTx::add_destination(uint32_t dst_ip, uint16_t dst_port,
+                                    const rte_ether_addr &dst_mac) {
+  // Initialize Cached Headers (Packet Template)
+  std::array<uint8_t, HDR_LEN> tmpl{};
+
+  rte_ether_hdr *eth_hdr = (rte_ether_hdr *)tmpl.data();
+  rte_memcpy(&eth_hdr->src_addr, &cfg_.src_mac, sizeof(rte_ether_addr));
+  rte_memcpy(&eth_hdr->dst_addr, &dst_mac, sizeof(rte_ether_addr));
+  eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+
+  rte_ipv4_hdr *ipv4_hdr = (rte_ipv4_hdr *)(eth_hdr + 1);
+  ipv4_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+  ipv4_hdr->time_to_live = 64;
+  ipv4_hdr->next_proto_id = IPPROTO_UDP;
+  ipv4_hdr->src_addr = rte_cpu_to_be_32(cfg_.src_ip);
+  ipv4_hdr->dst_addr = rte_cpu_to_be_32(dst_ip);
+  ipv4_hdr->fragment_offset = rte_cpu_to_be_16(RTE_IPV4_HDR_DF_FLAG);
+
+  rte_udp_hdr *udp_hdr = (rte_udp_hdr *)(ipv4_hdr + 1);
+  udp_hdr->src_port = rte_cpu_to_be_16(cfg_.src_port);
+  udp_hdr->dst_port = rte_cpu_to_be_16(dst_port);
+
+  templates_.push_back(tmpl);
+  return static_cast<uint16_t>(templates_.size() - 1);
+}
+
+uint8_t *DpdkUdpTx::alloc(size_t payload_len, uint16_t dest) {
+  if (payload_len > max_payload_ || dest >= templates_.size()) {
+    dropped_++;
+    return nullptr;
+  }
+  if (count_ == MAX_BURST)
+    flush();
+
+  rte_mbuf *m = rte_pktmbuf_alloc(cfg_.mbuf_pool);
+  if (m == nullptr) {
+    dropped_++;
+    return nullptr;
+  }
+
+  uint16_t frame_len = static_cast<uint16_t>(HDR_LEN + payload_len);
+  uint8_t *packet_data = (uint8_t *)rte_pktmbuf_append(m, frame_len);
+  if (packet_data == nullptr) {
+    rte_pktmbuf_free(m);
+    dropped_++;
+    return nullptr;
+  }
+  rte_memcpy(packet_data, templates_[dest].data(), HDR_LEN);
+
+  rte_ether_hdr *eth_hdr = (rte_ether_hdr *)packet_data;
+  rte_ipv4_hdr *ipv4_hdr = (rte_ipv4_hdr *)(eth_hdr + 1);
+  rte_udp_hdr *udp_hdr = (rte_udp_hdr *)(ipv4_hdr + 1);
+
+  // Dynamic fields
+  ipv4_hdr->total_length =
+      rte_cpu_to_be_16(frame_len - sizeof(rte_ether_hdr));
+  ipv4_hdr->packet_id = rte_cpu_to_be_16(packet_id_++);
+  udp_hdr->dgram_len = rte_cpu_to_be_16(
+      static_cast<uint16_t>(sizeof(rte_udp_hdr) + payload_len));
+
+  m->l2_len = sizeof(rte_ether_hdr);
+  m->l3_len = sizeof(rte_ipv4_hdr);
+  m->ol_flags = RTE_MBUF_F_TX_IPV4;
+
+  if (hw_ip_cksum_) {
+    m->ol_flags |= RTE_MBUF_F_TX_IP_CKSUM;
+  } else {
+    ipv4_hdr->hdr_checksum = rte_ipv4_cksum(ipv4_hdr);
+  }
+
+  if (hw_udp_cksum_) {
+    // NIC expects the pseudo-header checksum seeded in the UDP header
+    m->ol_flags |= RTE_MBUF_F_TX_UDP_CKSUM;
+    udp_hdr->dgram_cksum = rte_ipv4_phdr_cksum(ipv4_hdr, m->ol_flags);
+  }
+  // Software UDP checksum needs the payload; it is done in flush()
+
+  pending_[count_++] = m;
+  return (uint8_t *)(udp_hdr + 1);
+}
+
+uint16_t DpdkUdpTx::flush() {
+  if (count_ == 0)
+    return 0;
+
+  if (!hw_udp_cksum_) {
+    for (uint16_t i = 0; i < count_; i++) {
+      rte_ipv4_hdr *ipv4_hdr = rte_pktmbuf_mtod_offset(
+          pending_[i], rte_ipv4_hdr *, sizeof(rte_ether_hdr));
+      rte_udp_hdr *udp_hdr = (rte_udp_hdr *)(ipv4_hdr + 1);
+      udp_hdr->dgram_cksum = 0;
+      udp_hdr->dgram_cksum = rte_ipv4_udptcp_cksum(ipv4_hdr, udp_hdr);
+    }
+  }
+
+  uint16_t nb_tx =
+      rte_eth_tx_burst(cfg_.port_id, cfg_.queue_id, pending_, count_);
+  if (unlikely(nb_tx < count_)) {
+    // TX ring full: best-effort feed, drop rather than spin
+    for (uint16_t i = nb_tx; i < count_; i++)
+      rte_pktmbuf_free(pending_[i]);
+    dropped_ += count_ - nb_tx;
+  }
+  sent_ += nb_tx;
+  count_ = 0;
+  return nb_tx;
+}
+
+bool DpdkUdpTx::resolve_dst_mac(uint32_t dst_ip, rte_ether_addr &out_mac) {
+  // IPv4 multicast (224.0.0.0/4) -> 01:00:5e:xx:xx:xx (RFC 1112)
+  if ((dst_ip & 0xF0000000) == 0xE0000000) {
+    out_mac.addr_bytes[0] = 0x01;
+    out_mac.addr_bytes[1] = 0x00;
+    out_mac.addr_bytes[2] = 0x5e;
+    out_mac.addr_bytes[3] = (dst_ip >> 16) & 0x7F;
+    out_mac.addr_bytes[4] = (dst_ip >> 8) & 0xFF;
+    out_mac.addr_bytes[5] = dst_ip & 0xFF;
+    return true;
+  }
+
+  if (NetworkUtils::lookup_arp(dst_ip, out_mac))
+    return true;
+
+  // Off-subnet (or not yet in the ARP cache): hand it to the gateway
+  return NetworkUtils::get_gateway_mac(out_mac);
+}
+
+} // namespace aero
@@ -0,0 +1,115 @@
+/**
+ * @file dpdk_udp_tx.h
+ * @brief Kernel-bypass UDP transmitter on a DPDK TX queue
+ *
+ * Frames are built from a pre-computed Ethernet/IPv4/UDP header template
+ * directly in mbufs; the caller serializes its payload in place and the
+ * frames are sent with rte_eth_tx_burst(). IPv4/UDP checksums are offloaded
+ * to the NIC when the port advertises support, otherwise computed in
+ * software just before transmit.
+ */
+
+#ifndef AERO_MODULES_NETWORK_DPDK_UDP_TX_H
+#define AERO_MODULES_NETWORK_DPDK_UDP_TX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+#include <rte_udp.h>
+
+namespace aero {
+
+class DpdkUdpTx {
+public:
+  static constexpr uint16_t MAX_BURST = 64;
+  static constexpr size_t HDR_LEN =
+      sizeof(rte_ether_hdr) + sizeof(rte_ipv4_hdr) + sizeof(rte_udp_hdr);
+
+  struct Config {
+    uint16_t port_id;
+    uint16_t queue_id;
+    struct rte_mempool *mbuf_pool;
+    uint64_t tx_offloads; // Offloads enabled on the port (RTE_ETH_TX_OFFLOAD_*)
+    uint32_t src_ip;      // Host byte order
+    uint32_t dst_ip;      // Host byte order
+    uint16_t src_port;
+    uint16_t dst_port;
+    rte_ether_addr src_mac;
+    rte_ether_addr dst_mac;
+  };
+
+  DpdkUdpTx() = default;
+  ~DpdkUdpTx();
+
+  DpdkUdpTx(const DpdkUdpTx &) = delete;
+  DpdkUdpTx &operator=(const DpdkUdpTx &) = delete;
+
+  /**
+   * @brief Build the header template and pick the checksum mode
+   *
+   * The destination in cfg becomes destination 0.
+   */
+  bool init(const Config &cfg);
+
+  /**
+   * @brief Add another destination (e.g. a multicast group per channel)
+   * @return Destination index for alloc()
+   */
+  uint16_t add_destination(uint32_t dst_ip, uint16_t dst_port,
+                           const rte_ether_addr &dst_mac);
+
+  /**
+   * @brief Allocate a frame for a payload of the given size
+   *
+   * Headers are filled from the template; the returned pointer is where
+   * the caller writes the UDP payload. The frame is queued for the next
+   * flush(). Returns nullptr if the payload does not fit the MTU or the
+   * mempool is exhausted.
+   */
+  uint8_t *alloc(size_t payload_len, uint16_t dest = 0);
+
+  /**
+   * @brief Transmit all queued frames
+   * @return Number of frames accepted by the NIC (the rest are freed)
+   */
+  uint16_t flush();
+
+  /**
+   * @brief Largest UDP payload that fits in one frame
+   */
+  size_t max_payload() const { return max_payload_; }
+
+  // Every frame accepted by the NIC, including bursts alloc() had to flush
+  uint64_t sent() const { return sent_; }
+  uint64_t dropped() const { return dropped_; }
+
+  /**
+   * @brief Resolve the next-hop MAC for a destination IP
+   *
+   * Multicast groups map to 01:00:5e + low 23 bits. Unicast uses the
+   * system ARP table, falling back to the default gateway.
+   */
+  static bool resolve_dst_mac(uint32_t dst_ip, rte_ether_addr &out_mac);
+
+private:
+  Config cfg_{};
+  std::vector<std::array<uint8_t, HDR_LEN>> templates_; // One per destination
+  size_t max_payload_ = 0;
+  bool hw_ip_cksum_ = false;
+  bool hw_udp_cksum_ = false;
+  uint16_t packet_id_ = 0;
+
+  struct rte_mbuf *pending_[MAX_BURST];
+  uint16_t count_ = 0;
+  uint64_t sent_ = 0;
+  uint64_t dropped_ = 0;
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_NETWORK_DPDK_UDP_TX_H
@@ -0,0 +1,182 @@
+#include "modules/network/feed_retransmit.h"
+#include <arpa/inet.h>
+#include <cstring>
+#include <netinet/in.h>
+#include <rte_byteorder.h>
+
+namespace aero {
+
+// --- FeedRetransmitStore Implementation ---
+
+FeedRetransmitStore::FeedRetransmitStore(uint16_t channels, size_t depth)
+    : channels_(channels), rings_(channels) {
+  size_t pow2 = 1;
+  while (pow2 < depth)
+    pow2 <<= 1;
+  mask_ = pow2 - 1;
+
+  for (auto &ring : rings_)
+    ring.slots = std::make_unique<Slot[]>(pow2);
+}
+
+void FeedRetransmitStore::put(uint16_t channel, uint64_t seq,
+                              const uint8_t *data, size_t len) {
+  if (channel >= channels_)
+    return;
+
+  Channel &ring = rings_[channel];
+  Slot &slot = ring.slots[seq & mask_];
+
+  uint64_t v = slot.version.load(std::memory_order_relaxed);
+  slot.version.store(v + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.seq = seq;
+  if (len <= SLOT_SIZE) {
+    slot.len = static_cast<uint16_t>(len);
+    std::memcpy(slot.data, data, len);
+  } else {
+    slot.len = 0; // Too large to keep; requests for it report PARTIAL
+  }
+
+  slot.version.store(v + 2, std::memory_order_release);
+  ring.next_seq.store(seq + 1, std::memory_order_release);
+}
+
+size_t FeedRetransmitStore::fetch(uint16_t channel, uint64_t seq,
+                                  uint8_t *out) const {
+  if (channel >= channels_)
+    return 0;
+
+  const Channel &ring = rings_[channel];
+  if (seq >= ring.next_seq.load(std::memory_order_acquire))
+    return 0; // Not published yet
+
+  const Slot &slot = ring.slots[seq & mask_];
+  uint64_t v1, v2;
+  uint64_t slot_seq;
+  size_t len;
+  do {
+    v1 = slot.version.load(std::memory_order_acquire);
+    if (v1 & 1)
+      continue;
+    slot_seq = slot.seq;
+    len = slot.len;
+    if (slot_seq == seq && len > 0)
+      std::memcpy(out, slot.data, len);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    v2 = slot.version.load(std::memory_order_relaxed);
+    if (v1 == v2)
+      break;
+  } while (true);
+
+  return slot_seq == seq ? len : 0;
+}
+
+uint64_t FeedRetransmitStore::next_seq(uint16_t channel) const {
+  if (channel >= channels_)
+    return 0;
+  return rings_[channel].next_seq.load(std::memory_order_acquire);
+}
+
+// --- FeedRetransmitServer Implementation ---
+
+FeedRetransmitServer::FeedRetransmitServer(const FeedRetransmitStore &store)
+    : store_(store),
+      server_("FeedRetransmitServer",
+              [this](const uint8_t *in, size_t len, std::vector<uint8_t> &out) {
+                return on_request(in, len, out);
+              }) {}
+
+FeedRetransmitServer::~FeedRetransmitServer() { stop(); }
+
+bool FeedRetransmitServer::start(const std::string &bind_addr, int port) {
+  return server_.start(bind_addr, port);
+}
+
+void FeedRetransmitServer::stop() { server_.stop(); }
+
+// Set FEED_FLAG_RETRANSMIT in whichever header version the datagram carries
+static void mark_retransmit(uint8_t *datagram, size_t len) {
+  if (len < sizeof(CompactHeader))
+    return;
+  uint16_t version;
+  std::memcpy(&version, datagram + offsetof(UdpMarketHeader, version),
+              sizeof(version));
+
+  if (ntohs(version) == UDP_FEED_VERSION_COMPACT) {
+    auto *hdr = reinterpret_cast<CompactHeader *>(datagram);
+    hdr->flags = rte_cpu_to_le_16(rte_le_to_cpu_16(hdr->flags) |
+                                  FEED_FLAG_RETRANSMIT);
+  } else if (len >= sizeof(UdpMarketHeader)) {
+    auto *hdr = reinterpret_cast<UdpMarketHeader *>(datagram);
+    hdr->flags = htons(ntohs(hdr->flags) | FEED_FLAG_RETRANSMIT);
+  }
+}
+
+size_t FeedRetransmitServer::on_request(const uint8_t *in, size_t len,
+                                        std::vector<uint8_t> &out) {
+  if (len < sizeof(RetransRequest))
+    return 0;
+  RetransRequest req;
+  std::memcpy(&req, in, sizeof(req));
+  answer(req, out);
+  return sizeof(req);
+}
+
+void FeedRetransmitServer::answer(const RetransRequest &req,
+                                  std::vector<uint8_t> &out) {
+  uint16_t channel = ntohs(req.channel_id);
+  uint64_t begin = rte_be_to_cpu_64(req.begin_seq);
+  uint32_t count = ntohl(req.count);
+
+  RetransResponse resp;
+  memset(&resp, 0, sizeof(resp));
+  resp.magic = htonl(RETRANS_MAGIC);
+  resp.channel_id = req.channel_id;
+
+  uint16_t status = RETRANS_OK;
+  if (ntohl(req.magic) != RETRANS_MAGIC || count == 0 ||
+      count > RETRANS_MAX_COUNT || begin == 0) {
+    status = RETRANS_BAD_REQUEST;
+  } else if (channel >= store_.channels()) {
+    status = RETRANS_UNKNOWN_CHANNEL;
+  }
+
+  size_t base = out.size();
+  out.resize(base + sizeof(resp));
+  uint64_t first_seq = 0;
+  uint32_t frames = 0;
+
+  if (status == RETRANS_OK) {
+    resp.next_seq = rte_cpu_to_be_64(store_.next_seq(channel));
+
+    uint8_t datagram[FeedRetransmitStore::SLOT_SIZE];
+    for (uint64_t seq = begin; seq < begin + count; seq++) {
+      size_t len = store_.fetch(channel, seq, datagram);
+      if (len == 0) {
+        status = RETRANS_PARTIAL;
+        if (frames > 0)
+          break; // Keep the returned range contiguous
+        continue; // Evicted head: start from the oldest still held
+      }
+      if (frames == 0)
+        first_seq = seq;
+
+      mark_retransmit(datagram, len);
+
+      uint16_t len_be = htons(static_cast<uint16_t>(len));
+      const uint8_t *len_ptr = reinterpret_cast<const uint8_t *>(&len_be);
+      out.insert(out.end(), len_ptr, len_ptr + sizeof(len_be));
+      out.insert(out.end(), datagram, datagram + len);
+      frames++;
+    }
+  }
+
+  resp.status = htons(status);
+  resp.first_seq = rte_cpu_to_be_64(first_seq);
+  resp.count = htonl(frames);
+  std::memcpy(out.data() + base, &resp, sizeof(resp));
+}
+
+} // namespace aero
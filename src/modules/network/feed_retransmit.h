@@ -0,0 +1,100 @@
+/**
+ * @file feed_retransmit.h
+ * @brief Gap-fill support for the UDP feed: datagram ring + TCP service
+ *
+ * FeedRetransmitStore keeps the last N datagrams of every channel in
+ * fixed-size slots. The publisher (single writer) never blocks; readers
+ * copy a slot under its seqlock and retry if it was overwritten meanwhile.
+ *
+ * FeedRetransmitServer answers RetransRequest messages (aero/feed_protocol.h)
+ * from that ring on a background thread, to many consumers at once.
+ */
+
+#ifndef AERO_MODULES_NETWORK_FEED_RETRANSMIT_H
+#define AERO_MODULES_NETWORK_FEED_RETRANSMIT_H
+
+#include "aero/feed_protocol.h"
+#include "modules/network/tcp_request_server.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace aero {
+
+class FeedRetransmitStore {
+public:
+  static constexpr size_t SLOT_SIZE = 2048; // Larger datagrams are not kept
+
+  /**
+   * @param channels Number of feed channels
+   * @param depth Datagrams kept per channel (rounded up to a power of two)
+   */
+  FeedRetransmitStore(uint16_t channels, size_t depth);
+
+  /**
+   * @brief Record a published datagram (publisher thread only)
+   */
+  void put(uint16_t channel, uint64_t seq, const uint8_t *data, size_t len);
+
+  /**
+   * @brief Copy one datagram out of the ring
+   * @return Datagram length, or 0 if seq is evicted, unpublished or was
+   *         too large to keep
+   */
+  size_t fetch(uint16_t channel, uint64_t seq, uint8_t *out) const;
+
+  /**
+   * @brief Next sequence number the channel will publish
+   */
+  uint64_t next_seq(uint16_t channel) const;
+
+  uint16_t channels() const { return channels_; }
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> version{0}; // Odd while being written
+    uint64_t seq = 0;
+    uint16_t len = 0;
+    uint8_t data[SLOT_SIZE];
+  };
+
+  struct Channel {
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> next_seq{1};
+  };
+
+  uint16_t channels_;
+  size_t mask_;
+  std::vector<Channel> rings_;
+};
+
+class FeedRetransmitServer {
+public:
+  explicit FeedRetransmitServer(const FeedRetransmitStore &store);
+  ~FeedRetransmitServer();
+
+  FeedRetransmitServer(const FeedRetransmitServer &) = delete;
+  FeedRetransmitServer &operator=(const FeedRetransmitServer &) = delete;
+
+  /**
+   * @brief Listen on bind_addr:port and start the service thread
+   */
+  bool start(const std::string &bind_addr, int port);
+
+  void stop();
+
+private:
+  size_t on_request(const uint8_t *in, size_t len,
+                    std::vector<uint8_t> &out);
+  void answer(const RetransRequest &req, std::vector<uint8_t> &out);
+
+  const FeedRetransmitStore &store_;
+  TcpRequestServer server_;
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_NETWORK_FEED_RETRANSMIT_H
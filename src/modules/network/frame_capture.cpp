@@ -0,0 +1,304 @@
+#include "modules/network/frame_capture.h"
+#include "core/logging.h"
+#include "core/tsc_clock.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace aero {
+
+static_assert(sizeof(aero_cap_header) == AERO_CAP_HEADER_SIZE,
+              "aero_cap_header layout");
+static_assert(sizeof(aero_cap_record) == 24, "aero_cap_record layout");
+
+FrameCapture::~FrameCapture() { stop(); }
+
+bool FrameCapture::start(const Config &cfg) {
+  if (active())
+    return true;
+
+  cfg_ = cfg;
+  size_t min_size = AERO_CAP_HEADER_SIZE + (1u << 20);
+  if (cfg_.segment_bytes < min_size)
+    cfg_.segment_bytes = min_size;
+  cfg_.segment_bytes = (cfg_.segment_bytes + 4095) / 4096 * 4096;
+
+  if (mkdir(cfg_.dir.c_str(), 0755) < 0 && errno != EEXIST) {
+    LOG_SYSTEM("FrameCapture: Failed to create " << cfg_.dir << ": "
+                                                 << strerror(errno));
+    return false;
+  }
+
+  TscClock &clock = TscClock::instance();
+  session_ns_ = clock.now_wall_ns();
+  time_t secs = static_cast<time_t>(session_ns_ / 1000000000ULL);
+  struct tm tm_utc;
+  gmtime_r(&secs, &tm_utc);
+  char stamp[32];
+  strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%SZ", &tm_utc);
+  session_ = cfg_.dir + "/aero_" + stamp;
+
+  next_index_ = 0;
+  Segment *first = create_segment(next_index_++);
+  if (!first)
+    return false;
+
+  roll_interval_tsc_ =
+      cfg_.roll_s > 0 ? clock.ns_to_tsc(cfg_.roll_s * 1000000000ULL) : 0;
+  stopping_ = false;
+  activate(first, TscClock::now_tsc());
+  helper_ = std::thread(&FrameCapture::run_helper, this);
+  active_.store(true, std::memory_order_release);
+
+  LOG_SYSTEM("FrameCapture: Recording to " << session_ << "_*.cap ("
+             << cfg_.segment_bytes / (1024 * 1024) << " MiB segments, roll_s="
+             << cfg_.roll_s << ")");
+  return true;
+}
+
+void FrameCapture::stop() {
+  if (!active_.exchange(false, std::memory_order_acq_rel))
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_one();
+  if (helper_.joinable())
+    helper_.join();
+
+  // The helper has finished everything retired before it stopped
+  cur_->used = offset_ - AERO_CAP_HEADER_SIZE;
+  cur_->records = seg_records_;
+  finish_segment(cur_);
+  cur_ = nullptr;
+  if (spare_) {
+    munmap(spare_->base, spare_->size);
+    unlink(spare_->path.c_str());
+    delete spare_;
+    spare_ = nullptr;
+  }
+  print_stats();
+}
+
+uint16_t FrameCapture::add_connection(ExchangeId exchange_id,
+                                      const std::string &endpoint) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  connections_.push_back({static_cast<uint8_t>(exchange_id), endpoint});
+  connection_count_.store(connections_.size(), std::memory_order_release);
+  return static_cast<uint16_t>(connections_.size() - 1);
+}
+
+void FrameCapture::append(uint8_t type, uint16_t conn_id,
+                          ExchangeId exchange_id, const char *data, size_t len,
+                          uint64_t rx_tsc) {
+  if (len == 0 || len > cfg_.segment_bytes / 2) {
+    dropped_++; // Empty, or too large for any segment
+    return;
+  }
+  if (connection_count_.load(std::memory_order_acquire) > announced_)
+    announce_connections(rx_tsc);
+  if (roll_tsc_ != 0 && rx_tsc >= roll_tsc_ && !roll(rx_tsc))
+    roll_tsc_ = rx_tsc + TscClock::instance().ns_to_tsc(1000000000ULL);
+
+  if (write_record(type, conn_id, static_cast<uint8_t>(exchange_id), data,
+                   len, rx_tsc))
+    return;
+  // Current segment full
+  if (roll(rx_tsc) && write_record(type, conn_id,
+                                   static_cast<uint8_t>(exchange_id), data,
+                                   len, rx_tsc))
+    return;
+
+  dropped_++;
+  if (!drop_logged_) {
+    drop_logged_ = true;
+    LOG_SYSTEM("FrameCapture: No segment ready, dropping frames");
+  }
+}
+
+bool FrameCapture::write_record(uint8_t type, uint16_t conn_id,
+                                uint8_t exchange_id, const char *data,
+                                size_t len, uint64_t rx_tsc) {
+  size_t size = aero_cap_record_size(static_cast<uint32_t>(len));
+  // Keep a zero length word after the last record as the end marker
+  if (offset_ + size + sizeof(uint32_t) > cur_->size)
+    return false;
+
+  auto *rec = reinterpret_cast<aero_cap_record *>(cur_->base + offset_);
+  rec->type = type;
+  rec->exchange_id = exchange_id;
+  rec->conn_id = conn_id;
+  rec->rx_tsc = rx_tsc;
+  rec->rx_wall_ns = TscClock::instance().tsc_to_wall(rx_tsc);
+  std::memcpy(rec + 1, data, len);
+  // Padding is already zero: segments are fresh files
+  __atomic_store_n(&rec->length, static_cast<uint32_t>(len), __ATOMIC_RELEASE);
+
+  offset_ += size;
+  seg_records_++;
+  records_++;
+  bytes_ += len;
+  return true;
+}
+
+bool FrameCapture::roll(uint64_t now_tsc) {
+  Segment *next;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!spare_)
+      return false;
+    next = spare_;
+    spare_ = nullptr;
+    cur_->used = offset_ - AERO_CAP_HEADER_SIZE;
+    cur_->records = seg_records_;
+    retired_.push_back(cur_);
+  }
+  cv_.notify_one();
+  activate(next, now_tsc);
+  return true;
+}
+
+void FrameCapture::activate(Segment *seg, uint64_t now_tsc) {
+  auto *hdr = reinterpret_cast<aero_cap_header *>(seg->base);
+  hdr->opened_ns = TscClock::instance().tsc_to_wall(now_tsc);
+
+  cur_ = seg;
+  offset_ = AERO_CAP_HEADER_SIZE;
+  seg_records_ = 0;
+  roll_tsc_ = roll_interval_tsc_ ? now_tsc + roll_interval_tsc_ : 0;
+  segments_++;
+  drop_logged_ = false;
+
+  // Each segment names its connections so it can be replayed on its own
+  announced_ = 0;
+  announce_connections(now_tsc);
+}
+
+void FrameCapture::announce_connections(uint64_t now_tsc) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (; announced_ < connections_.size(); announced_++) {
+    const Connection &c = connections_[announced_];
+    if (!write_record(AERO_CAP_CONNECTION,
+                      static_cast<uint16_t>(announced_), c.exchange_id,
+                      c.endpoint.data(), c.endpoint.size(), now_tsc))
+      break;
+  }
+}
+
+FrameCapture::Segment *FrameCapture::create_segment(uint32_t index) {
+  char suffix[16];
+  snprintf(suffix, sizeof(suffix), "_%05u.cap", index);
+  std::string path = session_ + suffix;
+
+  int fd = open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    LOG_SYSTEM("FrameCapture: Failed to create " << path << ": "
+                                                 << strerror(errno));
+    return nullptr;
+  }
+  // Reserve the blocks now: the hot path never waits on the allocator, and
+  // a full disk fails here instead of as SIGBUS on a sparse mapping
+  size_t size = cfg_.segment_bytes;
+  int err = posix_fallocate(fd, 0, static_cast<off_t>(size));
+  if (err != 0) {
+    LOG_SYSTEM("FrameCapture: Failed to allocate " << path << ": "
+                                                   << strerror(err));
+    close(fd);
+    unlink(path.c_str());
+    return nullptr;
+  }
+
+  void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    LOG_SYSTEM("FrameCapture: Failed to map " << path << ": "
+                                              << strerror(errno));
+    unlink(path.c_str());
+    return nullptr;
+  }
+
+  // Take the write faults here: the first store to each page of a shared
+  // file mapping faults even when populated
+  auto *base = static_cast<volatile uint8_t *>(p);
+  for (size_t off = 0; off < size; off += 4096)
+    base[off] = 0;
+
+  auto *hdr = static_cast<aero_cap_header *>(p);
+  hdr->version = AERO_CAP_VERSION;
+  hdr->session_ns = session_ns_;
+  hdr->segment = index;
+  hdr->writer_pid = static_cast<uint32_t>(getpid());
+  hdr->tsc_hz = TscClock::instance().tsc_hz();
+  hdr->magic = AERO_CAP_MAGIC;
+
+  auto *seg = new Segment;
+  seg->path = std::move(path);
+  seg->base = static_cast<uint8_t *>(p);
+  seg->size = size;
+  seg->index = index;
+  return seg;
+}
+
+void FrameCapture::finish_segment(Segment *seg) {
+  auto *hdr = reinterpret_cast<aero_cap_header *>(seg->base);
+  hdr->data_size = seg->used;
+  hdr->records = seg->records;
+  hdr->closed_ns = TscClock::instance().now_wall_ns();
+  hdr->flags |= AERO_CAP_FLAG_CLOSED;
+  munmap(seg->base, seg->size);
+
+  // Give back the preallocated space the segment did not use
+  if (truncate(seg->path.c_str(),
+               static_cast<off_t>(AERO_CAP_HEADER_SIZE + seg->used)) < 0) {
+    LOG_SYSTEM("FrameCapture: Failed to truncate " << seg->path << ": "
+                                                   << strerror(errno));
+  }
+  delete seg;
+}
+
+void FrameCapture::run_helper() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // Without a spare, retry creating one every second (e.g. disk full)
+    cv_.wait_for(lock, std::chrono::seconds(1), [this] {
+      return stopping_ || !retired_.empty() || !spare_;
+    });
+
+    std::vector<Segment *> retired;
+    retired.swap(retired_);
+    bool need_spare = !spare_ && !stopping_;
+    lock.unlock();
+
+    for (Segment *seg : retired)
+      finish_segment(seg);
+    Segment *seg = need_spare ? create_segment(next_index_) : nullptr;
+
+    lock.lock();
+    if (seg) {
+      next_index_++;
+      spare_ = seg;
+    } else if (need_spare) {
+      // Back off before the next attempt instead of spinning
+      cv_.wait_for(lock, std::chrono::seconds(1),
+                   [this] { return stopping_; });
+    }
+    if (stopping_ && retired_.empty())
+      return;
+  }
+}
+
+void FrameCapture::print_stats() const {
+  LOG_SYSTEM("[Capture] records=" << records_ << " bytes=" << bytes_
+                                  << " segments=" << segments_
+                                  << " dropped=" << dropped_);
+}
+
+} // namespace aero
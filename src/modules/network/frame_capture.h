@@ -0,0 +1,162 @@
+/**
+ * @file frame_capture.h
+ * @brief Always-on recording of raw exchange WebSocket frames
+ *
+ * Writes the segment files described in aero/capture.h. Frames are copied
+ * into a preallocated, mapped segment on the feed-handler lcore: no
+ * syscalls and no allocation per frame. Creating the next segment and
+ * finishing the previous one (header, truncation, unmap) happen on a
+ * helper thread, so a roll is a pointer swap on the hot path.
+ */
+
+#ifndef AERO_MODULES_NETWORK_FRAME_CAPTURE_H
+#define AERO_MODULES_NETWORK_FRAME_CAPTURE_H
+
+#include "aero/capture.h"
+#include "modules/common/aero_types.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Single-writer capture of every frame the connections consume
+ *
+ * Frames are recorded as the connections dequeue them, in the order the
+ * feed handler processes them, stamped with the receive TSC taken on the
+ * WebSocket I/O thread. Frames dropped on a full receive queue never
+ * reach the capture.
+ *
+ * The capture never blocks the feed handler: if the helper thread has no
+ * segment ready when the current one is full (disk full, slow storage),
+ * frames are dropped and counted until it does.
+ *
+ * record() must be called from the feed-handler lcore; add_connection()
+ * may be called from any thread.
+ */
+class FrameCapture {
+public:
+  struct Config {
+    std::string dir = "capture";       // Created if missing
+    size_t segment_bytes = 256u << 20; // Preallocated size per segment
+    uint32_t roll_s = 3600;            // Max segment age (0 = size only)
+  };
+
+  static FrameCapture &instance() {
+    static FrameCapture capture;
+    return capture;
+  }
+
+  ~FrameCapture();
+
+  /**
+   * @brief Open the first segment and start the helper thread
+   */
+  bool start(const Config &cfg);
+
+  /**
+   * @brief Finish the current segment and stop (after the feed handler)
+   */
+  void stop();
+
+  bool active() const { return active_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Id for a connection's frames, announced in every segment
+   *
+   * @param endpoint "host:port/path" of the connection
+   */
+  uint16_t add_connection(ExchangeId exchange_id, const std::string &endpoint);
+
+  /**
+   * @brief Append one received frame
+   */
+  inline void record(uint16_t conn_id, ExchangeId exchange_id,
+                     const std::string &frame, uint64_t rx_tsc) {
+    if (active_.load(std::memory_order_relaxed))
+      append(AERO_CAP_FRAME, conn_id, exchange_id, frame.data(),
+             frame.size(), rx_tsc);
+  }
+
+  // Counters (feed-handler lcore)
+  uint64_t records() const { return records_; }
+  uint64_t bytes() const { return bytes_; }
+  uint64_t segments() const { return segments_; }
+  uint64_t dropped() const { return dropped_; }
+
+  /**
+   * @brief Log counters
+   */
+  void print_stats() const;
+
+private:
+  struct Segment {
+    std::string path;
+    uint8_t *base = nullptr;
+    size_t size = 0;
+    uint32_t index = 0;
+    size_t used = 0; // Record bytes, set when retired
+    uint64_t records = 0;
+  };
+
+  struct Connection {
+    uint8_t exchange_id;
+    std::string endpoint;
+  };
+
+  FrameCapture() = default;
+  FrameCapture(const FrameCapture &) = delete;
+  FrameCapture &operator=(const FrameCapture &) = delete;
+
+  void append(uint8_t type, uint16_t conn_id, ExchangeId exchange_id,
+              const char *data, size_t len, uint64_t rx_tsc);
+  bool write_record(uint8_t type, uint16_t conn_id, uint8_t exchange_id,
+                    const char *data, size_t len, uint64_t rx_tsc);
+  bool roll(uint64_t now_tsc);
+  void activate(Segment *seg, uint64_t now_tsc);
+  void announce_connections(uint64_t now_tsc);
+
+  // Helper thread
+  Segment *create_segment(uint32_t index);
+  void finish_segment(Segment *seg);
+  void run_helper();
+
+  Config cfg_;
+  std::string session_;    // File name prefix shared by the session
+  uint64_t session_ns_ = 0;
+  std::atomic<bool> active_{false};
+
+  // Writer state (feed-handler lcore)
+  Segment *cur_ = nullptr;
+  size_t offset_ = 0; // Next record, from the start of the segment
+  uint64_t seg_records_ = 0;
+  uint64_t roll_tsc_ = 0; // Roll by age at this TSC
+  uint64_t roll_interval_tsc_ = 0;
+  size_t announced_ = 0; // Connections written to the current segment
+  uint64_t records_ = 0;
+  uint64_t bytes_ = 0;
+  uint64_t segments_ = 0;
+  uint64_t dropped_ = 0;
+  bool drop_logged_ = false;
+
+  // Shared with the helper thread and add_connection()
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  Segment *spare_ = nullptr;     // Next segment, ready to activate
+  std::vector<Segment *> retired_; // Waiting to be finished
+  uint32_t next_index_ = 0;
+  bool stopping_ = false;
+  std::vector<Connection> connections_;
+  std::atomic<size_t> connection_count_{0};
+  std::thread helper_;
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_NETWORK_FRAME_CAPTURE_H
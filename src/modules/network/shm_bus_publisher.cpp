@@ -0,0 +1,274 @@
+#include "modules/network/shm_bus_publisher.h"
+#include "core/logging.h"
+#include "core/tsc_clock.h"
+#include "modules/common/shm_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace aero {
+
+static_assert(sizeof(aero_shm_bus_header) == 128, "aero_shm_bus_header layout");
+static_assert(sizeof(aero_shm_symbol) == 64, "aero_shm_symbol layout");
+static_assert(sizeof(aero_shm_event) == 40, "aero_shm_event layout");
+static_assert(AERO_SHM_MAX_SLOT_SIZE % 64 == 0 &&
+                  AERO_SHM_MAX_SLOT_SIZE - AERO_SHM_SLOT_HDR <= UINT16_MAX,
+              "every event of the largest slot fits aero_shm_event::len");
+
+ShmBusPublisher::~ShmBusPublisher() { close(); }
+
+bool ShmBusPublisher::init(const std::string &path, size_t slot_count,
+                           size_t slot_size, uint32_t symbol_capacity) {
+  size_t pow2 = 1;
+  while (pow2 < slot_count)
+    pow2 <<= 1;
+  // Every fixed-size event must fit in one slot
+  constexpr size_t min_slot = std::max<size_t>(
+      128, AERO_SHM_SLOT_HDR + sizeof(aero_shm_event) +
+               sizeof(aero_shm_trade_flow));
+  slot_size = round_up(std::max(slot_size, min_slot), 64);
+  // aero_shm_event::len is 16 bits: a larger slot could not be described
+  if (slot_size > AERO_SHM_MAX_SLOT_SIZE) {
+    LOG_SYSTEM("ShmBusPublisher: slot_size " << slot_size << " clamped to "
+                                             << AERO_SHM_MAX_SLOT_SIZE);
+    slot_size = AERO_SHM_MAX_SLOT_SIZE;
+  }
+
+  size_t symbols_offset = AERO_SHM_BUS_HEADER_SIZE;
+  size_t slots_offset = round_up(
+      symbols_offset + symbol_capacity * sizeof(aero_shm_symbol), 4096);
+  size_t size = round_up(slots_offset + pow2 * slot_size, SHM_MAP_ALIGN);
+
+  uint8_t *base = shm_create_mapped("ShmBusPublisher", path, size);
+  if (!base)
+    return false;
+
+  path_ = path;
+  base_ = base;
+  map_size_ = size;
+  hdr_ = reinterpret_cast<aero_shm_bus_header *>(base_);
+  symbols_ = reinterpret_cast<aero_shm_symbol *>(base_ + symbols_offset);
+  slots_ = base_ + slots_offset;
+  slot_size_ = slot_size;
+  mask_ = pow2 - 1;
+  max_levels_ = (slot_size - AERO_SHM_SLOT_HDR - sizeof(aero_shm_event)) /
+                sizeof(aero_shm_level);
+  next_seq_ = 1;
+  announced_.clear();
+  last_bbo_.clear();
+
+  hdr_->version = AERO_SHM_BUS_VERSION;
+  hdr_->slot_size = static_cast<uint32_t>(slot_size);
+  hdr_->slot_count = pow2;
+  hdr_->symbol_capacity = symbol_capacity;
+  hdr_->producer_pid = static_cast<uint32_t>(getpid());
+  hdr_->session_ns = TscClock::instance().now_wall_ns();
+  hdr_->symbols_offset = symbols_offset;
+  hdr_->slots_offset = slots_offset;
+  __atomic_store_n(&hdr_->write_seq, next_seq_, __ATOMIC_RELEASE);
+  __atomic_store_n(&hdr_->magic, AERO_SHM_BUS_MAGIC, __ATOMIC_RELEASE);
+
+  LOG_SYSTEM("ShmBusPublisher: " << path << " (" << pow2 << " slots x "
+                                 << slot_size << " B, " << size / (1024 * 1024)
+                                 << " MiB)");
+  return true;
+}
+
+void ShmBusPublisher::close() {
+  if (base_) {
+    munmap(base_, map_size_);
+    base_ = nullptr;
+    hdr_ = nullptr;
+  }
+}
+
+// False when the id is beyond the symbol table
+bool ShmBusPublisher::announce(uint32_t id, ExchangeId exchange_id,
+                               const std::string &instrument) {
+  if (id >= hdr_->symbol_capacity) {
+    if (!capacity_logged_) {
+      LOG_SYSTEM("ShmBusPublisher: Symbol table full ("
+                 << hdr_->symbol_capacity << "), dropping " << instrument);
+      capacity_logged_ = true;
+    }
+    return false;
+  }
+
+  if (id >= announced_.size())
+    announced_.resize(id + 1, 0);
+  if (!announced_[id]) {
+    // Table entry becomes visible before any event that references it
+    aero_shm_symbol &s = symbols_[id];
+    s.exchange_id = static_cast<uint8_t>(exchange_id);
+    size_t n = std::min(instrument.size(), sizeof(s.name) - 1);
+    memcpy(s.name, instrument.data(), n);
+    s.name[n] = '\0';
+    __atomic_store_n(&s.valid, 1u, __ATOMIC_RELEASE);
+    announced_[id] = 1;
+  }
+  return true;
+}
+
+aero_shm_event *ShmBusPublisher::begin_event(uint64_t &seq) {
+  seq = next_seq_++;
+  uint8_t *slot = slots_ + (seq & mask_) * slot_size_;
+  __atomic_store_n(reinterpret_cast<uint64_t *>(slot), AERO_SHM_SLOT_WRITING,
+                   __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  return reinterpret_cast<aero_shm_event *>(slot + AERO_SHM_SLOT_HDR);
+}
+
+void ShmBusPublisher::commit_event(uint64_t seq) {
+  uint8_t *slot = slots_ + (seq & mask_) * slot_size_;
+  __atomic_store_n(reinterpret_cast<uint64_t *>(slot), seq, __ATOMIC_RELEASE);
+  __atomic_store_n(&hdr_->write_seq, seq + 1, __ATOMIC_RELEASE);
+}
+
+void ShmBusPublisher::publish_book(ExchangeId exchange_id, uint32_t id,
+                                   const ParsedOrderBook &book) {
+  if (!hdr_ || !announce(id, exchange_id, book.instrument))
+    return;
+
+  size_t bids = std::min(book.bids.size(), max_levels_);
+  size_t asks = std::min(book.asks.size(), max_levels_ - bids);
+
+  uint64_t seq;
+  aero_shm_event *ev = begin_event(seq);
+  ev->type = AERO_SHM_EV_BOOK;
+  ev->len = static_cast<uint16_t>(sizeof(aero_shm_event) +
+                                  (bids + asks) * sizeof(aero_shm_level));
+  ev->symbol_id = id;
+  ev->exchange_id = static_cast<uint8_t>(exchange_id);
+  ev->flags = book.is_snapshot ? AERO_SHM_FLAG_SNAPSHOT : 0;
+  if (bids + asks < book.bids.size() + book.asks.size()) {
+    ev->flags |= AERO_SHM_FLAG_TRUNCATED;
+    truncated_++;
+  }
+  ev->bid_count = static_cast<uint16_t>(bids);
+  ev->ask_count = static_cast<uint16_t>(asks);
+  ev->reserved = 0;
+  ev->exchange_ts_ns = book.timestamp_ms * 1000000ULL;
+  ev->rx_tsc = book.rx_tsc;
+
+  aero_shm_level *out = reinterpret_cast<aero_shm_level *>(ev + 1);
+  for (size_t i = 0; i < bids; i++)
+    *out++ = {book.bids[i].price_int, feed_fixed_qty(book.bids[i].size)};
+  for (size_t i = 0; i < asks; i++)
+    *out++ = {book.asks[i].price_int, feed_fixed_qty(book.asks[i].size)};
+
+  ev->publish_tsc = TscClock::now_tsc();
+  commit_event(seq);
+}
+
+void ShmBusPublisher::publish_bbo(ExchangeId exchange_id, uint32_t id,
+                                  const std::string &instrument,
+                                  const BboQuote &quote,
+                                  uint64_t exchange_ts_ms, uint64_t rx_tsc) {
+  if (!hdr_ || !announce(id, exchange_id, instrument))
+    return;
+
+  if (id >= last_bbo_.size())
+    last_bbo_.resize(id + 1);
+  LastBbo &last = last_bbo_[id];
+  uint64_t bid_qty = feed_fixed_qty(quote.bid_qty);
+  uint64_t ask_qty = feed_fixed_qty(quote.ask_qty);
+  if (last.bid_price == quote.bid_price && last.bid_qty == bid_qty &&
+      last.ask_price == quote.ask_price && last.ask_qty == ask_qty)
+    return;
+  last = {quote.bid_price, bid_qty, quote.ask_price, ask_qty};
+
+  uint64_t seq;
+  aero_shm_event *ev = begin_event(seq);
+  ev->type = AERO_SHM_EV_BBO;
+  ev->len = sizeof(aero_shm_event) + sizeof(aero_shm_bbo);
+  ev->symbol_id = id;
+  ev->exchange_id = static_cast<uint8_t>(exchange_id);
+  ev->flags = 0;
+  ev->bid_count = 1;
+  ev->ask_count = 1;
+  ev->reserved = 0;
+  ev->exchange_ts_ns = exchange_ts_ms * 1000000ULL;
+  ev->rx_tsc = rx_tsc;
+
+  aero_shm_bbo *bbo = reinterpret_cast<aero_shm_bbo *>(ev + 1);
+  *bbo = {quote.bid_price, bid_qty, quote.ask_price, ask_qty};
+
+  ev->publish_tsc = TscClock::now_tsc();
+  commit_event(seq);
+}
+
+void ShmBusPublisher::publish_trade(ExchangeId exchange_id, uint32_t id,
+                                    const std::string &instrument,
+                                    uint64_t price, double qty, bool is_sell,
+                                    uint64_t exchange_ts_ms, uint64_t rx_tsc) {
+  if (!hdr_ || !announce(id, exchange_id, instrument))
+    return;
+
+  uint64_t seq;
+  aero_shm_event *ev = begin_event(seq);
+  ev->type = AERO_SHM_EV_TRADE;
+  ev->len = sizeof(aero_shm_event) + sizeof(aero_shm_trade);
+  ev->symbol_id = id;
+  ev->exchange_id = static_cast<uint8_t>(exchange_id);
+  ev->flags = 0;
+  ev->bid_count = 0;
+  ev->ask_count = 0;
+  ev->reserved = 0;
+  ev->exchange_ts_ns = exchange_ts_ms * 1000000ULL;
+  ev->rx_tsc = rx_tsc;
+
+  aero_shm_trade *trade = reinterpret_cast<aero_shm_trade *>(ev + 1);
+  *trade = {};
+  trade->price = price;
+  trade->qty = feed_fixed_qty(qty);
+  trade->side = is_sell ? 1 : 0;
+
+  ev->publish_tsc = TscClock::now_tsc();
+  commit_event(seq);
+}
+
+void ShmBusPublisher::publish_trade_flow(ExchangeId exchange_id,
+                                         uint32_t id,
+                                         const std::string &instrument,
+                                         const BboTradeFlow &flow,
+                                         uint64_t exchange_ts_ms,
+                                         uint64_t rx_tsc) {
+  if (!hdr_ || !announce(id, exchange_id, instrument))
+    return;
+
+  uint64_t seq;
+  aero_shm_event *ev = begin_event(seq);
+  ev->type = AERO_SHM_EV_TRADE_FLOW;
+  ev->len = sizeof(aero_shm_event) + sizeof(aero_shm_trade_flow);
+  ev->symbol_id = id;
+  ev->exchange_id = static_cast<uint8_t>(exchange_id);
+  ev->flags = 0;
+  ev->bid_count = 0;
+  ev->ask_count = 0;
+  ev->reserved = 0;
+  ev->exchange_ts_ns = exchange_ts_ms * 1000000ULL;
+  ev->rx_tsc = rx_tsc;
+
+  static_assert(AERO_SHM_FLOW_WINDOWS == FEED_BBO_FLOW_WINDOWS,
+                "one BboTradeFlow fills the shm flow event");
+  aero_shm_trade_flow *out = reinterpret_cast<aero_shm_trade_flow *>(ev + 1);
+  *out = {};
+  out->windows = std::min<uint32_t>(flow.windows, AERO_SHM_FLOW_WINDOWS);
+  for (uint32_t i = 0; i < out->windows; i++) {
+    out->window_ms[i] = flow.window_ms[i];
+    out->trades[i] = flow.trades[i];
+    out->vwap[i] = flow.vwap[i] > 0.0
+                       ? static_cast<uint64_t>(std::llround(flow.vwap[i]))
+                       : 0;
+    out->buy_qty[i] = feed_fixed_qty(flow.buy_qty[i]);
+    out->sell_qty[i] = feed_fixed_qty(flow.sell_qty[i]);
+  }
+
+  ev->publish_tsc = TscClock::now_tsc();
+  commit_event(seq);
+}
+
+} // namespace aero
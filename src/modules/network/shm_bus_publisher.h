@@ -0,0 +1,126 @@
+/**
+ * @file shm_bus_publisher.h
+ * @brief Producer side of the shared-memory market data bus
+ *
+ * Same-host consumers read the bus with the header-only reader in
+ * aero/shm_bus.h instead of receiving loopback UDP: no syscalls and no
+ * kernel copies on either side.
+ */
+
+#ifndef AERO_MODULES_NETWORK_SHM_BUS_PUBLISHER_H
+#define AERO_MODULES_NETWORK_SHM_BUS_PUBLISHER_H
+
+#include "aero/shm_bus.h"
+#include "modules/common/aero_types.h"
+#include "modules/exchange/exchange_adapter.h"
+#include "modules/network/bbo_publisher.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Single producer of the SPMC ring in aero/shm_bus.h
+ *
+ * Events are written straight into the mapped slot; the slot's sequence is
+ * stored last so readers never see a partial event. There is no
+ * backpressure: slow readers are lapped, not waited for.
+ *
+ * Not thread-safe: publish_*() must be called from the feed-handler lcore.
+ */
+class ShmBusPublisher {
+public:
+  ShmBusPublisher() = default;
+  ~ShmBusPublisher();
+
+  ShmBusPublisher(const ShmBusPublisher &) = delete;
+  ShmBusPublisher &operator=(const ShmBusPublisher &) = delete;
+
+  /**
+   * @brief Create (replace) and map the bus file
+   *
+   * @param path File under /dev/shm or a hugetlbfs mount
+   * @param slot_count Ring size (rounded up to a power of two)
+   * @param slot_size Bytes per slot (rounded up to 64, at most
+   *        AERO_SHM_MAX_SLOT_SIZE)
+   * @param symbol_capacity Entries in the symbol table
+   */
+  bool init(const std::string &path, size_t slot_count, size_t slot_size,
+            uint32_t symbol_capacity = 4096);
+
+  // Every publish takes the symbol's SymbolRegistry id, resolved once by
+  // the caller; the name only fills the symbol table on first sight
+
+  /**
+   * @brief Publish a book update (snapshot or delta) as received
+   */
+  void publish_book(ExchangeId exchange_id, uint32_t symbol_id,
+                    const ParsedOrderBook &book);
+
+  /**
+   * @brief Publish the top of book if it changed for this symbol
+   */
+  void publish_bbo(ExchangeId exchange_id, uint32_t symbol_id,
+                   const std::string &instrument, const BboQuote &quote,
+                   uint64_t exchange_ts_ms, uint64_t rx_tsc);
+
+  /**
+   * @brief Publish one public trade
+   *
+   * @param is_sell Aggressor side
+   */
+  void publish_trade(ExchangeId exchange_id, uint32_t symbol_id,
+                     const std::string &instrument, uint64_t price, double qty,
+                     bool is_sell, uint64_t exchange_ts_ms, uint64_t rx_tsc);
+
+  /**
+   * @brief Publish a symbol's rolling trade aggregates
+   */
+  void publish_trade_flow(ExchangeId exchange_id, uint32_t symbol_id,
+                          const std::string &instrument,
+                          const BboTradeFlow &flow, uint64_t exchange_ts_ms,
+                          uint64_t rx_tsc);
+
+  void close();
+
+  bool is_initialized() const { return hdr_ != nullptr; }
+
+  // Counters (owner thread only)
+  uint64_t events() const { return next_seq_ - 1; }
+  uint64_t truncated() const { return truncated_; }
+
+private:
+  struct LastBbo {
+    uint64_t bid_price = 0;
+    uint64_t bid_qty = 0;
+    uint64_t ask_price = 0;
+    uint64_t ask_qty = 0;
+  };
+
+  bool announce(uint32_t id, ExchangeId exchange_id,
+                const std::string &instrument);
+  aero_shm_event *begin_event(uint64_t &seq);
+  void commit_event(uint64_t seq);
+
+  std::string path_;
+  uint8_t *base_ = nullptr;
+  size_t map_size_ = 0;
+  aero_shm_bus_header *hdr_ = nullptr;
+  aero_shm_symbol *symbols_ = nullptr;
+  uint8_t *slots_ = nullptr;
+  size_t slot_size_ = 0;
+  uint64_t mask_ = 0;
+  size_t max_levels_ = 0;
+
+  uint64_t next_seq_ = 1;
+  std::vector<uint8_t> announced_; // Per symbol id: written to the table
+  std::vector<LastBbo> last_bbo_;  // Per symbol id
+  uint64_t truncated_ = 0;
+  bool capacity_logged_ = false;
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_NETWORK_SHM_BUS_PUBLISHER_H
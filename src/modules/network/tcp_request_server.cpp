@@ -0,0 +1,196 @@
+#include "modules/network/tcp_request_server.h"
+#include "core/logging.h"
+#include "core/tsc_clock.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace aero {
+
+TcpRequestServer::TcpRequestServer(std::string name, Handler handler)
+    : TcpRequestServer(std::move(name), std::move(handler), Options{}) {}
+
+TcpRequestServer::TcpRequestServer(std::string name, Handler handler,
+                                   const Options &opts)
+    : name_(std::move(name)), handler_(std::move(handler)), opts_(opts) {}
+
+TcpRequestServer::~TcpRequestServer() { stop(); }
+
+bool TcpRequestServer::start(const std::string &bind_addr, int port) {
+  listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if (listen_fd_ < 0) {
+    LOG_SYSTEM(name_ << ": Failed to create socket: " << strerror(errno));
+    return false;
+  }
+
+  int one = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  if (inet_pton(AF_INET, bind_addr.c_str(), &addr.sin_addr) <= 0 ||
+      bind(listen_fd_, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+      listen(listen_fd_, 64) < 0) {
+    LOG_SYSTEM(name_ << ": Failed to listen on " << bind_addr << ":" << port
+                     << ": " << strerror(errno));
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+
+  running_ = true;
+  thread_ = std::thread(&TcpRequestServer::run, this);
+  LOG_SYSTEM(name_ << ": Listening on " << bind_addr << ":" << port
+                   << " (max " << opts_.max_clients << " clients, idle "
+                   << opts_.idle_timeout_ms << " ms)");
+  return true;
+}
+
+void TcpRequestServer::stop() {
+  running_ = false;
+  if (thread_.joinable())
+    thread_.join();
+  for (Client &c : clients_)
+    ::close(c.fd);
+  clients_.clear();
+  clients_count_.store(0, std::memory_order_relaxed);
+  if (listen_fd_ >= 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+  }
+}
+
+void TcpRequestServer::run() {
+  // Side channels must never compete with the feed for CPU: one thread,
+  // woken by the sockets, polling running_ every 200 ms
+  std::vector<struct pollfd> pfds;
+  while (running_) {
+    pfds.clear();
+    pfds.push_back({listen_fd_, POLLIN, 0});
+    for (const Client &c : clients_) {
+      short events = 0;
+      if (queued(c) < opts_.max_queued)
+        events |= POLLIN;
+      if (queued(c) > 0)
+        events |= POLLOUT;
+      pfds.push_back({c.fd, events, 0});
+    }
+
+    int ret = poll(pfds.data(), pfds.size(), 200);
+    uint64_t now_tsc = TscClock::now_tsc();
+    if (ret > 0) {
+      for (size_t i = 0; i < clients_.size(); i++) {
+        short revents = pfds[i + 1].revents;
+        Client &c = clients_[i];
+        if (revents & POLLOUT)
+          write_client(c, now_tsc);
+        if (!c.closed && (revents & (POLLIN | POLLHUP | POLLERR)))
+          read_client(c, now_tsc);
+      }
+      if (pfds[0].revents & POLLIN)
+        accept_clients(now_tsc);
+    }
+
+    const TscClock &clock = TscClock::instance();
+    uint64_t idle_ns = static_cast<uint64_t>(opts_.idle_timeout_ms) * 1000000;
+    for (Client &c : clients_) {
+      if (!c.closed &&
+          clock.tsc_to_ns(now_tsc - c.last_active_tsc) >= idle_ns) {
+        c.closed = true;
+        timed_out_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    std::erase_if(clients_, [](const Client &c) {
+      if (c.closed)
+        ::close(c.fd);
+      return c.closed;
+    });
+    clients_count_.store(clients_.size(), std::memory_order_relaxed);
+  }
+}
+
+void TcpRequestServer::accept_clients(uint64_t now_tsc) {
+  while (true) {
+    int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK);
+    if (fd < 0)
+      return; // EAGAIN: backlog drained
+    if (clients_.size() >= opts_.max_clients) {
+      ::close(fd);
+      rejected_.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    Client &c = clients_.emplace_back();
+    c.fd = fd;
+    c.in.resize(opts_.max_request);
+    c.last_active_tsc = now_tsc;
+  }
+}
+
+void TcpRequestServer::read_client(Client &c, uint64_t now_tsc) {
+  if (queued(c) >= opts_.max_queued)
+    return; // Hang-ups are noticed once the client drains
+  ssize_t n = recv(c.fd, c.in.data() + c.in_len, c.in.size() - c.in_len, 0);
+  if (n < 0 && (errno == EAGAIN || errno == EINTR))
+    return;
+  if (n <= 0) {
+    c.closed = true; // Closed or error
+    return;
+  }
+  c.in_len += static_cast<size_t>(n);
+  c.last_active_tsc = now_tsc;
+
+  serve_client(c);
+  if (!c.closed && queued(c) > 0)
+    write_client(c, now_tsc);
+}
+
+void TcpRequestServer::serve_client(Client &c) {
+  // Several requests may arrive in one read
+  size_t done = 0;
+  while (done < c.in_len && queued(c) < opts_.max_queued) {
+    size_t used = handler_(c.in.data() + done, c.in_len - done, c.out);
+    if (used == 0)
+      break;
+    done += used;
+  }
+  if (done > 0) {
+    std::memmove(c.in.data(), c.in.data() + done, c.in_len - done);
+    c.in_len -= done;
+  }
+  if (c.in_len == c.in.size())
+    c.closed = true; // Not a request of this protocol
+}
+
+void TcpRequestServer::write_client(Client &c, uint64_t now_tsc) {
+  while (queued(c) > 0) {
+    ssize_t n = send(c.fd, c.out.data() + c.out_sent, queued(c),
+                     MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno != EAGAIN)
+        c.closed = true;
+      return;
+    }
+    c.out_sent += static_cast<size_t>(n);
+    c.last_active_tsc = now_tsc;
+  }
+  c.out.clear();
+  c.out_sent = 0;
+  // Requests left waiting while the client was behind
+  if (c.in_len > 0)
+    serve_client(c);
+}
+
+} // namespace aero
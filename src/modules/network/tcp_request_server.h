@@ -0,0 +1,112 @@
+/**
+ * @file tcp_request_server.h
+ * @brief Poll-driven TCP service behind the feed's side channels (gap fill,
+ *        snapshots)
+ */
+
+#ifndef AERO_MODULES_NETWORK_TCP_REQUEST_SERVER_H
+#define AERO_MODULES_NETWORK_TCP_REQUEST_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Serves request/response protocols to many clients from one thread
+ *
+ * Every client socket is non-blocking and multiplexed with poll(): a client
+ * that stops reading its responses, or connects and never sends anything,
+ * only holds its own connection until the idle timeout closes it, instead
+ * of locking every other consumer out. Responses are queued per client and
+ * sent as the socket drains; a client with more than max_queued bytes
+ * unsent is not read until it catches up.
+ *
+ * The handler runs on the service thread only, so it may keep scratch
+ * state without locking.
+ */
+class TcpRequestServer {
+public:
+  /**
+   * @brief Consume whole requests from `in`, appending their responses
+   *
+   * @return Bytes consumed (0 while the first request is incomplete)
+   */
+  using Handler =
+      std::function<size_t(const uint8_t *in, size_t len,
+                           std::vector<uint8_t> &out)>;
+
+  struct Options {
+    size_t max_clients = 64;
+    uint32_t idle_timeout_ms = 10000; // No request read or response sent
+    size_t max_request = 4096;        // A request that does not fit closes
+    size_t max_queued = 1 << 20;      // Unsent bytes before reads pause
+  };
+
+  /**
+   * @param name Log prefix (e.g. "FeedRetransmitServer")
+   */
+  TcpRequestServer(std::string name, Handler handler);
+  TcpRequestServer(std::string name, Handler handler, const Options &opts);
+  ~TcpRequestServer();
+
+  TcpRequestServer(const TcpRequestServer &) = delete;
+  TcpRequestServer &operator=(const TcpRequestServer &) = delete;
+
+  /**
+   * @brief Listen on bind_addr:port and start the service thread
+   */
+  bool start(const std::string &bind_addr, int port);
+
+  void stop();
+
+  // Counters (any thread)
+  size_t clients() const {
+    return clients_count_.load(std::memory_order_relaxed);
+  }
+  uint64_t timed_out() const {
+    return timed_out_.load(std::memory_order_relaxed);
+  }
+  uint64_t rejected() const {
+    return rejected_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Client {
+    int fd = -1;
+    std::vector<uint8_t> in; // Sized to max_request
+    size_t in_len = 0;
+    std::vector<uint8_t> out;
+    size_t out_sent = 0;
+    uint64_t last_active_tsc = 0;
+    bool closed = false;
+  };
+
+  void run();
+  void accept_clients(uint64_t now_tsc);
+  void read_client(Client &c, uint64_t now_tsc);
+  void serve_client(Client &c);
+  void write_client(Client &c, uint64_t now_tsc);
+  size_t queued(const Client &c) const { return c.out.size() - c.out_sent; }
+
+  std::string name_;
+  Handler handler_;
+  Options opts_;
+  int listen_fd_ = -1;
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+  std::vector<Client> clients_; // Service thread only
+
+  std::atomic<size_t> clients_count_{0};
+  std::atomic<uint64_t> timed_out_{0};
+  std::atomic<uint64_t> rejected_{0};
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_NETWORK_TCP_REQUEST_SERVER_H
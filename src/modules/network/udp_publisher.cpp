@@ -1,23 +1,122 @@
 #include "modules/network/udp_publisher.h"
 #include "core/logging.h"
+#include "core/tsc_clock.h"
+#include "modules/network/network_utils.h"
+#include <algorithm>
 #include <arpa/inet.h>
-#include <chrono>
 #include <cstring>
 #include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
 #include <rte_byteorder.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#ifndef SOL_UDP
+#define SOL_UDP IPPROTO_UDP
+#endif
+
 namespace aero {
 
-UdpPublisher::UdpPublisher() : socket_fd_(-1), target_port_(0) {}
+UdpPublisher::UdpPublisher() : socket_fd_(-1), target_port_(0) {
+  for (auto &slot : slots_)
+    slot.reserve(2048); // Sufficient for typical OrderBook update
+}
 
 UdpPublisher::~UdpPublisher() { close(); }
 
-bool UdpPublisher::init(const std::string &address, int port) {
+static inline bool is_multicast(uint32_t ip) {
+  return (ip & 0xF0000000) == 0xE0000000;
+}
+
+bool UdpPublisher::setup_channels(uint32_t base_ip, int port,
+                                  const UdpFeedOptions &opts) {
+  uint16_t count = opts.channel_count ? opts.channel_count : 1;
+  if (opts.channel_mode == FeedChannelMode::SINGLE)
+    count = 1;
+
+  channels_.assign(count, Channel{});
+  for (uint16_t i = 0; i < count; i++) {
+    // Multicast: one group per channel. Unicast: one port per channel.
+    uint32_t ip = is_multicast(base_ip) ? base_ip + i : base_ip;
+    int ch_port = is_multicast(base_ip) ? port : port + i;
+    if (ch_port > 65535)
+      return false;
+
+    Channel &ch = channels_[i];
+    memset(&ch.addr, 0, sizeof(ch.addr));
+    ch.addr.sin_family = AF_INET;
+    ch.addr.sin_port = htons(static_cast<uint16_t>(ch_port));
+    ch.addr.sin_addr.s_addr = htonl(ip);
+  }
+  return true;
+}
+
+void UdpPublisher::apply_options(const UdpFeedOptions &opts) {
+  channel_mode_ = opts.channel_mode;
+  pending_ = 0;
+  flush_deadline_tsc_ = opts.flush_us > 0
+                            ? TscClock::instance().ns_to_tsc(
+                                  static_cast<uint64_t>(opts.flush_us) *
+                                  1000ULL)
+                            : 0;
+
+  // Largest datagram the encoders may produce. FEC parity is a header plus
+  // a length-prefixed copy of the largest datagram of its block, so it must
+  // fit the same limit.
+  max_datagram_ = std::clamp<size_t>(opts.max_payload, 256, 65507);
+  if (dpdk_tx_)
+    max_datagram_ = std::min(max_datagram_, dpdk_tx_->max_payload());
+  if (opts.fec_k > 0) {
+    max_datagram_ = std::min(max_datagram_, FEED_FEC_MAX_SYMBOL - 2) -
+                    sizeof(FeedFecHeader) - 2;
+  }
+
+  compact_.reset();
+  if (opts.wire_format == FeedWireFormat::COMPACT) {
+    compact_ = std::make_unique<CompactBookEncoder>(
+        TscClock::instance().ns_to_tsc(
+            static_cast<uint64_t>(std::max(opts.compact_refresh_ms, 0)) *
+            1000000ULL),
+        max_datagram_);
+  }
+
+  fec_.clear();
+  fec_block_tsc_.clear();
+  if (opts.fec_k > 0) {
+    uint8_t k =
+        static_cast<uint8_t>(std::clamp<int>(opts.fec_k, 1, FEED_FEC_MAX_K));
+    uint8_t m =
+        static_cast<uint8_t>(std::clamp<int>(opts.fec_m, 1, FEED_FEC_MAX_M));
+    fec_.assign(channel_count(), FeedFecEncoder(k, m));
+    fec_block_tsc_.assign(channel_count(), 0);
+    fec_delay_tsc_ = TscClock::instance().ns_to_tsc(
+        static_cast<uint64_t>(std::max(opts.fec_max_delay_us, 0)) * 1000ULL);
+  }
+
+  retrans_.reset();
+  if (opts.retrans_depth > 0) {
+    retrans_ = std::make_unique<FeedRetransmitStore>(channel_count(),
+                                                     opts.retrans_depth);
+  }
+}
+
+bool UdpPublisher::init(const std::string &address, int port,
+                        const UdpFeedOptions &opts) {
   target_address_ = address;
   target_port_ = port;
 
+  // Resolve destinations once; the hot path only references channels_
+  struct in_addr base;
+  if (inet_pton(AF_INET, address.c_str(), &base) <= 0) {
+    LOG_SYSTEM("UdpPublisher: Invalid target address: " << address);
+    return false;
+  }
+  if (!setup_channels(ntohl(base.s_addr), port, opts)) {
+    LOG_SYSTEM("UdpPublisher: Channel ports exceed 65535");
+    return false;
+  }
+
   // Create UDP socket
   socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
   if (socket_fd_ < 0) {
@@ -40,77 +139,318 @@ bool UdpPublisher::init(const std::string &address, int port) {
     return false;
   }
 
-  LOG_SYSTEM("UdpPublisher: Initialized broadcasting to " << address << ":"
-                                                          << port);
+  if (is_multicast(ntohl(base.s_addr))) {
+    // Loopback on so same-host consumers can join the groups too
+    unsigned char ttl = static_cast<unsigned char>(opts.mcast_ttl);
+    unsigned char loop = 1;
+    setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop,
+               sizeof(loop));
+
+    if (!opts.mcast_iface.empty()) {
+      struct in_addr iface;
+      if (inet_pton(AF_INET, opts.mcast_iface.c_str(), &iface) <= 0 ||
+          setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_IF, &iface,
+                     sizeof(iface)) < 0) {
+        LOG_SYSTEM("UdpPublisher: Failed to set multicast interface "
+                   << opts.mcast_iface);
+      }
+    }
+  }
+
+  // Probe for UDP GSO (Linux >= 4.18): a zero socket-level segment size is
+  // accepted by kernels that know the option and leaves behaviour unchanged.
+  gso_enabled_ = false;
+#ifdef UDP_SEGMENT
+  if (opts.use_gso) {
+    int zero = 0;
+    gso_enabled_ = setsockopt(socket_fd_, SOL_UDP, UDP_SEGMENT, &zero,
+                              sizeof(zero)) == 0;
+  }
+#endif
+
+  apply_options(opts);
+
+  LOG_SYSTEM("UdpPublisher: Initialized broadcasting to "
+             << address << ":" << port << " (channels=" << channel_count()
+             << ", flush=" << opts.flush_us
+             << "us, gso=" << (gso_enabled_ ? "on" : "off")
+             << ", retrans_depth=" << opts.retrans_depth
+             << ", format=" << (compact_ ? "compact" : "full")
+             << ", max_datagram=" << max_datagram_ << ")");
+  return true;
+}
+
+bool UdpPublisher::init_dpdk(const DpdkUdpTx::Config &cfg,
+                             const UdpFeedOptions &opts) {
+  if (!setup_channels(cfg.dst_ip, cfg.dst_port, opts)) {
+    LOG_SYSTEM("UdpPublisher: Channel ports exceed 65535");
+    return false;
+  }
+
+  auto tx = std::make_unique<DpdkUdpTx>();
+  if (!tx->init(cfg))
+    return false;
+
+  // Channel 0 is the template built by init(); add the others
+  for (uint16_t i = 1; i < channel_count(); i++) {
+    uint32_t ip = ntohl(channels_[i].addr.sin_addr.s_addr);
+    rte_ether_addr mac = cfg.dst_mac;
+    if (ip != cfg.dst_ip && !DpdkUdpTx::resolve_dst_mac(ip, mac)) {
+      LOG_SYSTEM("UdpPublisher: Cannot resolve MAC for channel "
+                 << i << " (" << NetworkUtils::ip_to_string(ip) << ")");
+      return false;
+    }
+    channels_[i].dpdk_dest = tx->add_destination(
+        ip, ntohs(channels_[i].addr.sin_port), mac);
+  }
+  dpdk_tx_ = std::move(tx);
+
+  apply_options(opts);
+
+  LOG_SYSTEM("UdpPublisher: Initialized DPDK TX broadcasting to "
+             << NetworkUtils::ip_to_string(cfg.dst_ip) << ":" << cfg.dst_port
+             << " (channels=" << channel_count()
+             << ", flush=" << opts.flush_us
+             << "us, retrans_depth=" << opts.retrans_depth
+             << ", format=" << (compact_ ? "compact" : "full")
+             << ", max_datagram=" << max_datagram_ << ")");
   return true;
 }
 
 void UdpPublisher::close() {
+  flush();
   if (socket_fd_ >= 0) {
     ::close(socket_fd_);
     socket_fd_ = -1;
   }
+  dpdk_tx_.reset();
 }
 
 void UdpPublisher::publish(const ParsedOrderBook &book,
-                           ExchangeId exchange_id) {
-  if (socket_fd_ < 0)
+                           ExchangeId exchange_id, uint32_t symbol_id) {
+  if (!is_initialized())
     return;
 
-  serialize_and_send(book, exchange_id);
+  last_position_ = {};
+  if (compact_)
+    enqueue_compact(book, exchange_id, symbol_id);
+  else
+    enqueue(book, exchange_id);
+
+  // Flush when the batch is full or the oldest datagram hit its deadline
+  if (pending_ >= MAX_BATCH || flush_deadline_tsc_ == 0 ||
+      TscClock::now_tsc() - first_pending_tsc_ >= flush_deadline_tsc_) {
+    flush();
+  }
 }
 
-void UdpPublisher::serialize_and_send(const ParsedOrderBook &book,
-                                      ExchangeId exchange_id) {
-  // Use thread_local buffer to avoid per-call allocation and make it
-  // thread-safe across multiple threads (e.g., separate exchange threads)
-  thread_local std::vector<uint8_t> buffer;
-  buffer.clear();
-  buffer.reserve(1024); // Sufficient for typical OrderBook update
+void UdpPublisher::publish_batch(std::span<const ParsedOrderBook> books,
+                                 ExchangeId exchange_id,
+                                 std::span<const uint32_t> symbol_ids) {
+  if (!is_initialized())
+    return;
 
-  // 1. Prepare Header
-  UdpMarketHeader header;
-  header.magic = htonl(UDP_FEED_MAGIC);
-  header.version = htons(UDP_FEED_VERSION);
-  header.msg_type = book.is_snapshot ? 1 : 2; // Snapshot=1, Delta=2
-  header.exchange_id = static_cast<uint8_t>(exchange_id);
+  for (size_t i = 0; i < books.size(); i++) {
+    if (compact_)
+      enqueue_compact(books[i], exchange_id, symbol_ids[i]);
+    else
+      enqueue(books[i], exchange_id);
+  }
+  flush();
+}
 
-  // Use current monotonic time for gateway timestamp
-  auto now_ns = std::chrono::steady_clock::now().time_since_epoch().count();
-  header.timestamp_ns = rte_cpu_to_be_64(static_cast<uint64_t>(now_ns));
+uint16_t UdpPublisher::channel_for(const ParsedOrderBook &book,
+                                   ExchangeId exchange_id) const {
+  uint16_t count = channel_count();
+  switch (channel_mode_) {
+  case FeedChannelMode::EXCHANGE:
+    return static_cast<uint16_t>(static_cast<uint8_t>(exchange_id) % count);
+  case FeedChannelMode::SYMBOL:
+    return feed_symbol_channel(book.instrument.data(), book.instrument.size(),
+                               count);
+  default:
+    return 0;
+  }
+}
 
-  const std::string &symbol = book.instrument;
+uint8_t *UdpPublisher::reserve(uint16_t ch, size_t len, bool &queued) {
+  queued = true;
+  // Flush before appending, so a batch never grows past MAX_BATCH (and
+  // DpdkUdpTx never has to flush a full burst behind our back)
+  if (pending_ >= MAX_BATCH)
+    flush();
+  if (dpdk_tx_) {
+    // Serialize straight into the mbuf behind the cached headers
+    uint8_t *out = dpdk_tx_->alloc(len, channels_[ch].dpdk_dest);
+    if (out != nullptr)
+      return out;
+    // Oversized or pool exhausted (counted by DpdkUdpTx). The sequence
+    // number is still consumed, so consumers see the gap and can fill it.
+    scratch_.resize(len);
+    queued = false;
+    return scratch_.data();
+  }
 
-  header.symbol_len = htonl(static_cast<uint32_t>(symbol.length()));
-  header.bid_count = htons(static_cast<uint16_t>(book.bids.size()));
-  header.ask_count = htons(static_cast<uint16_t>(book.asks.size()));
+  slots_[pending_].resize(len);
+  slot_channel_[pending_] = ch;
+  return slots_[pending_].data();
+}
 
-  // 2. Push Header
-  const uint8_t *header_ptr = reinterpret_cast<const uint8_t *>(&header);
-  buffer.insert(buffer.end(), header_ptr, header_ptr + sizeof(header));
+void UdpPublisher::commit(uint16_t ch, uint64_t seq, const uint8_t *data,
+                          size_t len, bool queued) {
+  if (retrans_)
+    retrans_->put(ch, seq, data, len);
 
-  // 3. Push Symbol
-  if (!symbol.empty()) {
-    buffer.insert(buffer.end(), symbol.begin(), symbol.end());
+  if (queued) {
+    if (pending_ == 0)
+      first_pending_tsc_ = TscClock::now_tsc();
+    pending_++;
   }
 
-  // 4. Push Bids
-  for (const auto &level : book.bids) {
-    UdpPriceLevel p_level;
-    p_level.price_int = rte_cpu_to_be_64(level.price_int);
+  // After the slot is counted: parity may need slots of its own
+  if (!fec_.empty())
+    fec_add(ch, seq, data, len);
+}
 
-    // Swap double
-    uint64_t qty_bits;
-    std::memcpy(&qty_bits, &level.size, sizeof(uint64_t));
-    qty_bits = rte_cpu_to_be_64(qty_bits);
-    std::memcpy(&p_level.quantity, &qty_bits, sizeof(uint64_t));
+void UdpPublisher::fec_add(uint16_t ch, uint64_t seq, const uint8_t *data,
+                           size_t len) {
+  FeedFecEncoder &enc = fec_[ch];
+  // Blocks cover consecutive sequence numbers only
+  if (!enc.empty() && enc.next_seq() != seq)
+    fec_emit(ch);
+
+  bool opens_block = enc.empty();
+  if (!enc.add(seq, data, len)) {
+    fec_emit(ch); // Too large to protect; it ends the block
+    return;
+  }
+  if (opens_block)
+    fec_block_tsc_[ch] = TscClock::now_tsc();
+  if (enc.full())
+    fec_emit(ch);
+}
+
+void UdpPublisher::fec_emit(uint16_t ch) {
+  FeedFecEncoder &enc = fec_[ch];
+  if (enc.empty())
+    return;
+
+  fec_emitting_ = true;
+  size_t len = enc.parity_size();
+  for (uint8_t j = 0; j < enc.parity_count(); j++) {
+    bool queued;
+    uint8_t *out = reserve(ch, len, queued);
+    enc.write_parity(j, ch, out);
+    if (queued) {
+      if (pending_ == 0)
+        first_pending_tsc_ = TscClock::now_tsc();
+      pending_++;
+    }
+    fec_parity_sent_++;
+  }
+  enc.reset();
+  fec_block_tsc_[ch] = 0;
+  fec_emitting_ = false;
+}
+
+void UdpPublisher::fec_close_stale() {
+  uint64_t now = TscClock::now_tsc();
+  for (uint16_t ch = 0; ch < fec_.size(); ch++) {
+    if (fec_block_tsc_[ch] != 0 && now - fec_block_tsc_[ch] >= fec_delay_tsc_)
+      fec_emit(ch);
+  }
+}
+
+void UdpPublisher::enqueue_chunk(const ParsedOrderBook &book,
+                                 ExchangeId exchange_id, uint16_t ch,
+                                 const BookChunk &chunk) {
+  size_t len = wire_size(book, chunk);
+
+  bool queued;
+  uint8_t *out = reserve(ch, len, queued);
+  uint64_t seq = channels_[ch].next_seq++;
+  serialize(book, exchange_id, ch, seq, chunk, out);
+  commit(ch, seq, out, len, queued);
+  last_position_ = {ch, seq};
+}
 
-    const uint8_t *level_ptr = reinterpret_cast<const uint8_t *>(&p_level);
-    buffer.insert(buffer.end(), level_ptr, level_ptr + sizeof(p_level));
+// Advance the bid/ask cursors past the next chunk of at most per_chunk
+// levels: an equal share of each side, or more of one once the other runs
+// out
+static void next_chunk(size_t &b, size_t &a, size_t bids, size_t asks,
+                       size_t per_chunk) {
+  size_t nb = std::min(bids - b, std::max(per_chunk / 2,
+                                          per_chunk - std::min(per_chunk,
+                                                               asks - a)));
+  b += nb;
+  a += std::min(asks - a, per_chunk - nb);
+}
+
+void UdpPublisher::enqueue(const ParsedOrderBook &book,
+                           ExchangeId exchange_id) {
+  uint16_t ch = channel_for(book, exchange_id);
+  size_t bids = book.bids.size();
+  size_t asks = book.asks.size();
+  BookChunk chunk{0, bids, 0, asks};
+  size_t fixed = sizeof(UdpMarketHeader) + book.instrument.size();
+  if (fixed + (bids + asks) * sizeof(UdpPriceLevel) <= max_datagram_) {
+    enqueue_chunk(book, exchange_id, ch, chunk);
+    return;
   }
 
-  // 5. Push Asks
-  for (const auto &level : book.asks) {
+  // Split by depth, best levels of both sides first
+  size_t per_chunk = max_datagram_ > fixed + sizeof(UdpPriceLevel)
+                         ? (max_datagram_ - fixed) / sizeof(UdpPriceLevel)
+                         : 1;
+  size_t count = 0;
+  for (size_t b = 0, a = 0; b < bids || a < asks; count++)
+    next_chunk(b, a, bids, asks, per_chunk);
+
+  chunk.bid_end = chunk.ask_end = 0;
+  chunk.count = static_cast<uint16_t>(count);
+  for (chunk.index = 0; chunk.index < count; chunk.index++) {
+    chunk.bid_begin = chunk.bid_end;
+    chunk.ask_begin = chunk.ask_end;
+    next_chunk(chunk.bid_end, chunk.ask_end, bids, asks, per_chunk);
+    enqueue_chunk(book, exchange_id, ch, chunk);
+  }
+  books_chunked_++;
+}
+
+void UdpPublisher::enqueue_compact(const ParsedOrderBook &book,
+                                   ExchangeId exchange_id,
+                                   uint32_t symbol_id) {
+  uint16_t ch = channel_for(book, exchange_id);
+  size_t n = compact_->encode(book, exchange_id, symbol_id, ch,
+                              TscClock::now_tsc(),
+                              TscClock::instance().now_wall_ns());
+
+  // The encoded size is only known afterwards, so compact datagrams are
+  // built in the encoder and copied into the slot/mbuf
+  for (size_t i = 0; i < n; i++) {
+    std::span<uint8_t> msg = compact_->message(i);
+    uint64_t seq = channels_[ch].next_seq++;
+    CompactBookEncoder::set_seq(msg, seq);
+
+    bool queued;
+    uint8_t *out = reserve(ch, msg.size(), queued);
+    std::memcpy(out, msg.data(), msg.size());
+    commit(ch, seq, out, msg.size(), queued);
+    last_position_ = {ch, seq};
+  }
+}
+
+size_t UdpPublisher::wire_size(const ParsedOrderBook &book,
+                               const BookChunk &chunk) {
+  return sizeof(UdpMarketHeader) + book.instrument.size() +
+         (chunk.bid_end - chunk.bid_begin + chunk.ask_end - chunk.ask_begin) *
+             sizeof(UdpPriceLevel);
+}
+
+static inline uint8_t *write_levels(uint8_t *out,
+                                    std::span<const PriceLevel> levels) {
+  for (const auto &level : levels) {
     UdpPriceLevel p_level;
     p_level.price_int = rte_cpu_to_be_64(level.price_int);
 
@@ -120,30 +460,161 @@ void UdpPublisher::serialize_and_send(const ParsedOrderBook &book,
     qty_bits = rte_cpu_to_be_64(qty_bits);
     std::memcpy(&p_level.quantity, &qty_bits, sizeof(uint64_t));
 
-    const uint8_t *level_ptr = reinterpret_cast<const uint8_t *>(&p_level);
-    buffer.insert(buffer.end(), level_ptr, level_ptr + sizeof(p_level));
+    std::memcpy(out, &p_level, sizeof(p_level));
+    out += sizeof(p_level);
+  }
+  return out;
+}
+
+void UdpPublisher::serialize(const ParsedOrderBook &book,
+                             ExchangeId exchange_id, uint16_t channel,
+                             uint64_t seq, const BookChunk &chunk,
+                             uint8_t *out) {
+  std::span<const PriceLevel> bids(book.bids);
+  std::span<const PriceLevel> asks(book.asks);
+  bids = bids.subspan(chunk.bid_begin, chunk.bid_end - chunk.bid_begin);
+  asks = asks.subspan(chunk.ask_begin, chunk.ask_end - chunk.ask_begin);
+
+  // 1. Header. Chunk 0 replaces the book on a snapshot; the rest only add
+  // deeper levels.
+  UdpMarketHeader header;
+  header.magic = htonl(UDP_FEED_MAGIC);
+  header.version = htons(UDP_FEED_VERSION);
+  header.msg_type = book.is_snapshot && chunk.index == 0 ? FEED_MSG_SNAPSHOT
+                                                         : FEED_MSG_DELTA;
+  header.exchange_id = static_cast<uint8_t>(exchange_id);
+  header.channel_id = htons(channel);
+  header.flags = htons(chunk.count ? FEED_FLAG_CHUNKED : 0);
+  header.chunk_index = htons(chunk.index);
+  header.chunk_count = htons(chunk.count);
+  header.seq_num = rte_cpu_to_be_64(seq);
+
+  // Gateway send time on CLOCK_REALTIME, so consumers on other hosts can
+  // compare it against their own (PTP/NTP-synced) clocks
+  header.timestamp_ns =
+      rte_cpu_to_be_64(TscClock::instance().now_wall_ns());
+
+  const std::string &symbol = book.instrument;
+
+  header.symbol_len = htonl(static_cast<uint32_t>(symbol.length()));
+  header.bid_count = htons(static_cast<uint16_t>(bids.size()));
+  header.ask_count = htons(static_cast<uint16_t>(asks.size()));
+
+  std::memcpy(out, &header, sizeof(header));
+  out += sizeof(header);
+
+  // 2. Symbol
+  if (!symbol.empty()) {
+    std::memcpy(out, symbol.data(), symbol.size());
+    out += symbol.size();
+  }
+
+  // 3. Bids, then asks
+  out = write_levels(out, bids);
+  write_levels(out, asks);
+}
+
+size_t UdpPublisher::build_messages(size_t first_slot) {
+  size_t count = 0;
+  size_t i = first_slot;
+  while (i < pending_) {
+    size_t len = slots_[i].size();
+    uint16_t ch = slot_channel_[i];
+    size_t run = 1;
+
+    // Runs of equal-sized datagrams go out as one GSO super-datagram; the
+    // kernel (or NIC) splits it back into `len`-byte datagrams.
+    if (gso_enabled_ && len <= GSO_MAX_SEGMENT_SIZE) {
+      while (i + run < pending_ && run < GSO_MAX_SEGMENTS &&
+             slots_[i + run].size() == len && slot_channel_[i + run] == ch &&
+             (run + 1) * len <= GSO_MAX_PAYLOAD) {
+        run++;
+      }
+    }
+
+    for (size_t k = 0; k < run; ++k) {
+      iovs_[i + k].iov_base = slots_[i + k].data();
+      iovs_[i + k].iov_len = slots_[i + k].size();
+    }
+
+    struct mmsghdr &m = msgs_[count];
+    memset(&m, 0, sizeof(m));
+    m.msg_hdr.msg_name = &channels_[ch].addr;
+    m.msg_hdr.msg_namelen = sizeof(channels_[ch].addr);
+    m.msg_hdr.msg_iov = &iovs_[i];
+    m.msg_hdr.msg_iovlen = run;
+
+#ifdef UDP_SEGMENT
+    if (run > 1) {
+      m.msg_hdr.msg_control = ctrl_[count].data();
+      m.msg_hdr.msg_controllen = ctrl_[count].size();
+      struct cmsghdr *cm = CMSG_FIRSTHDR(&m.msg_hdr);
+      cm->cmsg_level = SOL_UDP;
+      cm->cmsg_type = UDP_SEGMENT;
+      cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+      uint16_t gso_size = static_cast<uint16_t>(len);
+      memcpy(CMSG_DATA(cm), &gso_size, sizeof(gso_size));
+    }
+#endif
+
+    msg_first_slot_[count] = i;
+    count++;
+    i += run;
   }
+  return count;
+}
+
+void UdpPublisher::flush() {
+  // Parity of blocks that did not fill up in time goes out with this batch
+  if (!fec_.empty() && !fec_emitting_)
+    fec_close_stale();
 
-  // 6. Send
-  struct sockaddr_in dest_addr;
-  memset(&dest_addr, 0, sizeof(dest_addr));
-  dest_addr.sin_family = AF_INET;
-  dest_addr.sin_port = htons(target_port_);
+  if (pending_ == 0)
+    return;
 
-  // Note: inet_pton is relatively fast, but ideally we cache the sockaddr.
-  // Given target_address_ might change on re-init, parsing here is safer.
-  if (inet_pton(AF_INET, target_address_.c_str(), &dest_addr.sin_addr) <= 0) {
+  if (dpdk_tx_) {
+    dpdk_tx_->flush(); // Counted by DpdkUdpTx, see datagrams_sent()
+    pending_ = 0;
     return;
   }
+  if (socket_fd_ < 0)
+    return;
 
-  ssize_t sent = sendto(socket_fd_, buffer.data(), buffer.size(), 0,
-                        (struct sockaddr *)&dest_addr, sizeof(dest_addr));
+  size_t count = build_messages(0);
+  size_t done = 0;
+  while (done < count) {
+    int sent = sendmmsg(socket_fd_, &msgs_[done],
+                        static_cast<unsigned int>(count - done), 0);
+    syscalls_++;
+    if (sent > 0) {
+      for (size_t k = done; k < done + static_cast<size_t>(sent); ++k)
+        datagrams_sent_ += msgs_[k].msg_hdr.msg_iovlen;
+      done += static_cast<size_t>(sent);
+      continue;
+    }
+    if (sent < 0 && errno == EINTR)
+      continue;
 
-  if (sent < 0) {
-    if (errno != EAGAIN && errno != EWOULDBLOCK) {
-      // Error handling (omitted for hot-path)
+    // A GSO send can be rejected (e.g. EIO when the egress device lacks
+    // checksum offload). Fall back to one datagram per message for good.
+    if (sent < 0 && gso_enabled_ && msgs_[done].msg_hdr.msg_iovlen > 1 &&
+        (errno == EIO || errno == EINVAL || errno == EOPNOTSUPP)) {
+      LOG_SYSTEM("UdpPublisher: UDP GSO rejected (" << strerror(errno)
+                                                    << "), disabling");
+      gso_enabled_ = false;
+      count = build_messages(msg_first_slot_[done]);
+      done = 0;
+      continue;
     }
+
+    // EAGAIN (socket buffer full) or hard error: UDP is best-effort, drop
+    // the rest of the batch rather than stall the feed thread.
+    for (size_t k = done; k < count; ++k)
+      datagrams_dropped_ += msgs_[k].msg_hdr.msg_iovlen;
+    break;
   }
+
+  pending_ = 0;
 }
 
 } // namespace aero
@@ -1,60 +1,162 @@
 #ifndef AERO_MODULES_NETWORK_UDP_PUBLISHER_H
 #define AERO_MODULES_NETWORK_UDP_PUBLISHER_H
 
+#include "aero/feed_fec.h"
+#include "aero/feed_protocol.h"
 #include "modules/common/aero_types.h"
 #include "modules/exchange/exchange_adapter.h"
+#include "modules/network/compact_encoder.h"
+#include "modules/network/dpdk_udp_tx.h"
+#include "modules/network/feed_retransmit.h"
+#include <array>
 #include <cstdint>
+#include <memory>
+#include <netinet/in.h>
+#include <span>
 #include <string>
+#include <sys/socket.h>
 #include <vector>
 
 namespace aero {
 
-// Binary Protocol Constants
-constexpr uint32_t UDP_FEED_MAGIC = 0x48465444; // "HFTD"
-constexpr uint16_t UDP_FEED_VERSION = 1;
-
-// Packet Header Structure (packed)
-struct __attribute__((packed)) UdpMarketHeader {
-  uint32_t magic;
-  uint16_t version;
-  uint8_t msg_type;    // 1=Snapshot, 2=Delta
-  uint8_t exchange_id; // See ExchangeId
-  uint64_t timestamp_ns;
-  uint32_t symbol_len;
-  uint16_t bid_count;
-  uint16_t ask_count;
+enum class FeedChannelMode : uint8_t {
+  SINGLE,   // Everything on channel 0
+  EXCHANGE, // One channel per ExchangeId
+  SYMBOL,   // feed_symbol_channel(instrument) % channel_count
 };
 
-// Price Level Structure (packed)
-struct __attribute__((packed)) UdpPriceLevel {
-  uint64_t price_int; // Scaled by 1e8
-  double quantity;    // Floating point size
+enum class FeedWireFormat : uint8_t {
+  FULL,    // Version 2: full levels, symbol string, network byte order
+  COMPACT, // Version 3: changed levels only, varint ticks, symbol ids
 };
 
+/**
+ * @brief Where a book update went on the feed
+ */
+struct FeedPosition {
+  uint16_t channel = 0;
+  uint64_t seq = 0; // 0 = no datagram was produced
+};
+
+/**
+ * @brief Publisher options shared by the kernel and DPDK backends
+ *
+ * Channel i is sent to base_address + i when the base address is a
+ * multicast group, otherwise to base_address:(port + i).
+ */
+struct UdpFeedOptions {
+  int flush_us = 0;    // Max batching delay (0 = send on every publish)
+  bool use_gso = true; // Coalesce equal-sized datagrams (kernel backend)
+  FeedChannelMode channel_mode = FeedChannelMode::SINGLE;
+  uint16_t channel_count = 1;
+  int mcast_ttl = 1;
+  std::string mcast_iface; // Local interface IP for multicast egress
+  size_t retrans_depth = 0; // Datagrams kept per channel for gap fill
+  FeedWireFormat wire_format = FeedWireFormat::FULL;
+  int compact_refresh_ms = 1000; // Full snapshot interval per symbol (compact)
+  int fec_k = 0;               // Data datagrams per FEC block (0 = no FEC)
+  int fec_m = 1;               // Parity datagrams per block
+  int fec_max_delay_us = 1000; // Close a partial block after this long
+  size_t max_payload = 1472;   // Largest UDP payload; bigger books are split
+};
+
+/**
+ * @brief Order book broadcaster over UDP
+ *
+ * Datagrams are serialized into a fixed set of reusable slots and sent with
+ * sendmmsg(). A batch is flushed when it fills up, when the oldest pending
+ * datagram is older than the flush deadline, or when the owner calls
+ * flush() at the end of its poll cycle. Runs of equal-sized datagrams are
+ * coalesced into a single UDP_SEGMENT (GSO) send where the kernel supports
+ * it.
+ *
+ * Books are spread over channels (multicast groups) by exchange or by
+ * symbol hash. Each channel numbers its datagrams 1, 2, 3, ... and, when
+ * retrans_depth is set, keeps the most recent ones in a FeedRetransmitStore
+ * so a FeedRetransmitServer can fill consumer gaps.
+ *
+ * In the compact format a CompactBookEncoder diffs every update against
+ * the last published book of its symbol, so only changed levels go on the
+ * wire; definitions and full snapshots are repeated every
+ * compact_refresh_ms for consumers that join late.
+ *
+ * With fec_k set, every k datagrams of a channel are followed by fec_m
+ * parity datagrams (aero/feed_fec.h) so consumers rebuild lost datagrams
+ * locally. A block that has not filled up within fec_max_delay_us is
+ * closed early at the next flush(), bounding the recovery delay on quiet
+ * channels.
+ *
+ * No datagram exceeds max_payload (nor the DPDK port MTU, nor the FEC
+ * symbol limit when FEC is on): a book that does not fit is split by depth
+ * into FEED_FLAG_CHUNKED datagrams on consecutive sequence numbers instead
+ * of being left to IP fragmentation, where losing one fragment loses the
+ * whole book.
+ *
+ * With init_dpdk() the same batching drives a kernel-bypass backend
+ * instead: datagrams are serialized directly into mbufs behind a cached
+ * Ethernet/IPv4/UDP header and sent on a dedicated DPDK TX queue.
+ *
+ * Not thread-safe: publish()/flush() must be called from one thread (the
+ * feed-handler lcore).
+ */
 class UdpPublisher {
 public:
+  static constexpr size_t MAX_BATCH = 64; // Datagrams per sendmmsg()
+  static constexpr size_t GSO_MAX_SEGMENTS = 64;
+  static constexpr size_t GSO_MAX_SEGMENT_SIZE = 1472; // Ethernet MTU payload
+  static constexpr size_t GSO_MAX_PAYLOAD = 65000;
+
   UdpPublisher();
   ~UdpPublisher();
 
   /**
    * @brief Initialize the UDP socket
    *
-   * @param address IP address to bind/send to (e.g., "127.0.0.1")
+   * @param address IP address (or multicast base group) to send to
    * @param port Port to send to (e.g., 13988)
+   * @param opts Batching, channel and recovery options
+   * @return true on success, false on failure
+   */
+  bool init(const std::string &address, int port,
+            const UdpFeedOptions &opts = {});
+
+  /**
+   * @brief Initialize the DPDK TX backend instead of a kernel socket
+   *
+   * @param cfg Port/queue, mempool and resolved L2/L3 addressing of
+   *        channel 0
+   * @param opts Batching, channel and recovery options
    * @return true on success, false on failure
    */
-  bool init(const std::string &address, int port);
+  bool init_dpdk(const DpdkUdpTx::Config &cfg,
+                 const UdpFeedOptions &opts = {});
 
   /**
-   * @brief Broadcast an OrderBook update
+   * @brief Queue an OrderBook update for broadcast
    *
-   * Serializes the book into the binary format and sends it via UDP.
+   * Serializes the book into the binary format and appends it to the
+   * current batch. The batch is sent when full or past its deadline.
    * This method is non-blocking.
    *
    * @param book The parsed order book data
    * @param exchange_id The exchange this book belongs to
+   * @param symbol_id The book's SymbolRegistry id
+   */
+  void publish(const ParsedOrderBook &book, ExchangeId exchange_id,
+               uint32_t symbol_id);
+
+  /**
+   * @brief Queue several updates and send them in as few syscalls as possible
+   * @param symbol_ids SymbolRegistry id of each book
+   */
+  void publish_batch(std::span<const ParsedOrderBook> books,
+                     ExchangeId exchange_id,
+                     std::span<const uint32_t> symbol_ids);
+
+  /**
+   * @brief Send all pending datagrams now
    */
-  void publish(const ParsedOrderBook &book, ExchangeId exchange_id);
+  void flush();
 
   /**
    * @brief Close the socket
@@ -62,7 +164,41 @@ public:
   void close();
 
   // Helper to check if initialized
-  bool is_initialized() const { return socket_fd_ >= 0; }
+  bool is_initialized() const { return socket_fd_ >= 0 || dpdk_tx_; }
+  bool is_dpdk() const { return dpdk_tx_ != nullptr; }
+  bool gso_enabled() const { return gso_enabled_; }
+
+  // Counters (owner thread only)
+  uint64_t datagrams_sent() const {
+    return datagrams_sent_ + (dpdk_tx_ ? dpdk_tx_->sent() : 0);
+  }
+  uint64_t datagrams_dropped() const {
+    return datagrams_dropped_ + (dpdk_tx_ ? dpdk_tx_->dropped() : 0);
+  }
+  uint64_t syscalls() const { return syscalls_; }
+  uint64_t fec_parity_sent() const { return fec_parity_sent_; }
+  uint64_t books_chunked() const {
+    return books_chunked_ + (compact_ ? compact_->chunked() : 0);
+  }
+  size_t max_datagram() const { return max_datagram_; }
+  const CompactBookEncoder *compact_encoder() const { return compact_.get(); }
+
+  /**
+   * @brief Channel and seq of the last datagram queued by the latest
+   *        publish() (seq 0 if it produced none, e.g. an unchanged book)
+   */
+  const FeedPosition &last_position() const { return last_position_; }
+
+  uint16_t channel_count() const {
+    return static_cast<uint16_t>(channels_.size());
+  }
+
+  /**
+   * @brief Ring of recent datagrams, or nullptr if gap fill is disabled
+   */
+  const FeedRetransmitStore *retransmit_store() const {
+    return retrans_.get();
+  }
 
   friend class UdpPublisherTest;
 
@@ -70,8 +206,77 @@ private:
   int socket_fd_;
   std::string target_address_;
   int target_port_;
+  std::unique_ptr<DpdkUdpTx> dpdk_tx_; // Set when using the DPDK backend
+
+  struct Channel {
+    struct sockaddr_in addr; // Resolved once in init()
+    uint16_t dpdk_dest = 0;  // DpdkUdpTx destination index
+    uint64_t next_seq = 1;
+  };
+  FeedChannelMode channel_mode_ = FeedChannelMode::SINGLE;
+  std::vector<Channel> channels_;
+  std::unique_ptr<FeedRetransmitStore> retrans_;
+  std::vector<uint8_t> scratch_; // Serialization target for DPDK drops
+  std::unique_ptr<CompactBookEncoder> compact_; // Set in the compact format
+  FeedPosition last_position_;
+  size_t max_datagram_ = 1472; // Effective limit, see apply_options()
+
+  // Forward error correction, one encoder per channel (empty = off)
+  std::vector<FeedFecEncoder> fec_;
+  std::vector<uint64_t> fec_block_tsc_; // When each open block started
+  uint64_t fec_delay_tsc_ = 0;
+  bool fec_emitting_ = false;
+  uint64_t fec_parity_sent_ = 0;
+
+  // Pending batch
+  std::array<std::vector<uint8_t>, MAX_BATCH> slots_;
+  std::array<uint16_t, MAX_BATCH> slot_channel_;
+  size_t pending_ = 0;
+  uint64_t first_pending_tsc_ = 0;
+  uint64_t flush_deadline_tsc_ = 0;
+
+  // sendmmsg() scratch, rebuilt on every flush
+  std::array<struct mmsghdr, MAX_BATCH> msgs_;
+  std::array<struct iovec, MAX_BATCH> iovs_;
+  std::array<size_t, MAX_BATCH> msg_first_slot_;
+  alignas(struct cmsghdr) std::array<
+      std::array<char, CMSG_SPACE(sizeof(uint16_t))>, MAX_BATCH> ctrl_;
+  bool gso_enabled_ = false;
+
+  uint64_t datagrams_sent_ = 0;
+  uint64_t datagrams_dropped_ = 0;
+  uint64_t syscalls_ = 0;
+  uint64_t books_chunked_ = 0;
+
+  // Level ranges of one full-format datagram
+  struct BookChunk {
+    size_t bid_begin, bid_end;
+    size_t ask_begin, ask_end;
+    uint16_t index = 0;
+    uint16_t count = 0; // 0 = whole book, not chunked
+  };
+
+  bool setup_channels(uint32_t base_ip, int port, const UdpFeedOptions &opts);
+  void apply_options(const UdpFeedOptions &opts);
+  uint16_t channel_for(const ParsedOrderBook &book,
+                       ExchangeId exchange_id) const;
 
-  void serialize_and_send(const ParsedOrderBook &book, ExchangeId exchange_id);
+  static size_t wire_size(const ParsedOrderBook &book, const BookChunk &chunk);
+  void serialize(const ParsedOrderBook &book, ExchangeId exchange_id,
+                 uint16_t channel, uint64_t seq, const BookChunk &chunk,
+                 uint8_t *out);
+  void enqueue_chunk(const ParsedOrderBook &book, ExchangeId exchange_id,
+                     uint16_t ch, const BookChunk &chunk);
+  void enqueue(const ParsedOrderBook &book, ExchangeId exchange_id);
+  void enqueue_compact(const ParsedOrderBook &book, ExchangeId exchange_id,
+                       uint32_t symbol_id);
+  uint8_t *reserve(uint16_t ch, size_t len, bool &queued);
+  void commit(uint16_t ch, uint64_t seq, const uint8_t *data, size_t len,
+              bool queued);
+  void fec_add(uint16_t ch, uint64_t seq, const uint8_t *data, size_t len);
+  void fec_emit(uint16_t ch);
+  void fec_close_stale();
+  size_t build_messages(size_t first_slot);
 };
 
 } // namespace aero
@@ -0,0 +1,185 @@
+/**
+ * @file arbitrage_engine.h
+ * @brief Cross-exchange spread and arbitrage opportunity detection
+ */
+
+#ifndef AERO_MODULES_STRATEGY_ARBITRAGE_ENGINE_H
+#define AERO_MODULES_STRATEGY_ARBITRAGE_ENGINE_H
+
+#include "modules/common/aero_types.h"
+#include "modules/common/instrument_map.h"
+#include "modules/market_data/order_book.h"
+#include "modules/telemetry/feed_latency_monitor.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief One direction of a cross-exchange opportunity
+ *
+ * Buy on `buy_exchange` at its ask, sell on `sell_exchange` at its bid.
+ */
+struct ArbOpportunity {
+  enum State : uint8_t {
+    OPEN = 1,   // Started qualifying
+    UPDATE = 2, // Still qualifies; a leg's quote changed
+    CLOSE = 3,  // Stopped qualifying (edge, size or a stale/empty leg)
+  };
+
+  State state;
+  ExchangeId buy_exchange;
+  ExchangeId sell_exchange;
+  uint32_t instrument;      // InstrumentMap index (canonical name)
+  uint32_t buy_symbol_id;   // SymbolRegistry ids of the legs
+  uint32_t sell_symbol_id;
+  uint64_t buy_price;       // Ask, 1e8 units
+  uint64_t sell_price;      // Bid, 1e8 units
+  double qty;               // Base units, min of both legs
+  double edge_bps;          // After both taker fees, vs the buy price
+  uint64_t trigger_rx_tsc;  // Receive TSC of the update that caused it
+  uint64_t detect_tsc;      // When the engine emitted it
+};
+
+/**
+ * @brief Keeps every venue's top of book per canonical instrument and
+ *        evaluates fee-adjusted cross spreads on each BBO change
+ *
+ * on_bbo() is fed from the feed-handler lcore with the top of book just
+ * computed for the outputs, so the engine never reads or locks a book. A
+ * change on one leg re-evaluates that leg against each other venue of the
+ * instrument (at most five), in both directions: constant work per update,
+ * independent of the number of instruments.
+ *
+ * An opportunity qualifies when its edge after taker fees reaches
+ * min_edge_bps, the executable size reaches min_qty and the other leg
+ * spoke within max_leg_age_ms. Transitions and changes are passed to the
+ * handler with the triggering update's receive TSC; detection latency
+ * (emit time minus receive TSC) is kept in a histogram.
+ *
+ * Not thread-safe: everything runs on the feed-handler lcore, except the
+ * counters and print_stats().
+ */
+class ArbitrageEngine {
+public:
+  static constexpr size_t MAX_VENUES = MAX_EXCHANGES;
+
+  struct Config {
+    double fee_bps[MAX_VENUES] = {}; // Taker fee per venue (ExchangeId)
+    double min_edge_bps = 2.0;
+    double min_qty = 0.0;            // Base units
+    uint32_t max_leg_age_ms = 500;   // Other leg must be this fresh
+  };
+
+  using Handler = std::function<void(const ArbOpportunity &)>;
+
+  ArbitrageEngine() = default;
+
+  ArbitrageEngine(const ArbitrageEngine &) = delete;
+  ArbitrageEngine &operator=(const ArbitrageEngine &) = delete;
+
+  /**
+   * @brief Enable the engine
+   */
+  void configure(const Config &cfg);
+
+  bool enabled() const { return enabled_; }
+
+  void set_handler(Handler handler) { handler_ = std::move(handler); }
+
+  /**
+   * @brief Base units per quantity unit of a symbol (default 1)
+   *
+   * For venues that quote contracts, e.g. OKX ETH-USDT-SWAP = 0.1 ETH.
+   */
+  void set_contract_size(ExchangeId exchange, std::string_view instrument,
+                         double base_per_unit);
+
+  /**
+   * @brief Top of book of one symbol after an update (feed-handler lcore)
+   *
+   * @param bbo Null while a side of the book is empty
+   * @param rx_tsc Receive TSC of the update
+   */
+  void on_bbo(ExchangeId exchange, uint32_t symbol_id, const BestBidOffer *bbo,
+              uint64_t rx_tsc);
+
+  /**
+   * @brief Close open opportunities with a leg silent for max_leg_age_ms
+   *        (feed-handler lcore, every poll cycle)
+   *
+   * on_bbo() only catches a stale leg when the other one speaks; this
+   * covers both going quiet. Scans at most every max_leg_age_ms / 4.
+   */
+  void expire(uint64_t now_tsc);
+
+  /**
+   * @brief Canonical name of an ArbOpportunity::instrument (feed-handler
+   *        lcore, e.g. from the handler)
+   */
+  const std::string &instrument_name(uint32_t instrument) const {
+    return instruments_map_.name(instrument);
+  }
+
+  // Counters (any thread)
+  uint64_t evaluations() const {
+    return evaluations_.load(std::memory_order_relaxed);
+  }
+  uint64_t opened() const { return opened_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Log counters and detection latency
+   */
+  void print_stats() const;
+
+private:
+  struct Leg {
+    bool valid = false;
+    uint32_t symbol_id = 0;
+    uint64_t bid_price = 0;
+    uint64_t ask_price = 0;
+    double bid_qty = 0.0; // Base units
+    double ask_qty = 0.0;
+    double eff_bid = 0.0; // bid * (1 - fee)
+    double eff_ask = 0.0; // ask * (1 + fee)
+    uint64_t rx_tsc = 0;
+  };
+
+  struct Instrument {
+    Leg legs[MAX_VENUES];
+    uint8_t venues = 0; // Bit per venue with a leg
+    uint64_t open = 0;  // Bit buy * MAX_VENUES + sell: qualifying now
+  };
+
+  void close_stale(uint32_t index, Instrument &ins, uint64_t now_tsc);
+  void evaluate(uint32_t index, Instrument &ins, size_t buy, size_t sell,
+                bool fresh, uint64_t trigger_rx_tsc);
+  void emit(ArbOpportunity::State state, uint32_t index, const Leg &buy,
+            size_t buy_venue, const Leg &sell, size_t sell_venue, double qty,
+            double edge_bps, uint64_t trigger_rx_tsc);
+
+  bool enabled_ = false;
+  Config cfg_;
+  double fee_[MAX_VENUES] = {}; // Fractions
+  uint64_t max_age_tsc_ = 0;
+  uint64_t next_expire_tsc_ = 0;
+  Handler handler_;
+
+  InstrumentMap instruments_map_;
+  std::vector<Instrument> instruments_; // By canonical index
+  std::vector<double> contract_size_;   // By symbol id (0 = unset, 1)
+
+  std::atomic<uint64_t> evaluations_{0};
+  std::atomic<uint64_t> opened_{0};
+  std::atomic<uint64_t> emitted_{0};
+  LatencyDistribution detect_ns_; // Emit minus receive TSC, in ns
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_STRATEGY_ARBITRAGE_ENGINE_H
@@ -0,0 +1,307 @@
+#include "modules/strategy/strategy_host.h"
+#include "aero/feed_protocol.h"
+#include "core/logging.h"
+#include "core/tsc_clock.h"
+#include "modules/common/symbol_registry.h"
+#include "modules/market_data/book_mirror.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <dlfcn.h>
+#include <rte_pause.h>
+
+namespace aero {
+
+static inline bool same_quote(const aero_strategy_quote &a,
+                              const aero_strategy_quote &b) {
+  return a.bid_price == b.bid_price && a.bid_qty == b.bid_qty &&
+         a.ask_price == b.ask_price && a.ask_qty == b.ask_qty;
+}
+
+StrategyHost::~StrategyHost() { unload(); }
+
+void StrategyHost::set_order_route(ExchangeId exchange_id, OrderRoute route) {
+  size_t idx = static_cast<size_t>(exchange_id);
+  if (idx >= routes_.size())
+    routes_.resize(idx + 1);
+  routes_[idx] = std::move(route);
+}
+
+void StrategyHost::set_book_mirror(const BookMirror *mirror) {
+  if (mirror && mirror->local_reader(mirror_))
+    host_.book_mirror = &mirror_;
+  else
+    host_.book_mirror = nullptr;
+}
+
+bool StrategyHost::load(const Config &cfg, unsigned int lcore_id) {
+  if (ring_.is_open())
+    return true;
+  cfg_ = cfg;
+
+  handle_ = dlopen(cfg_.path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!handle_) {
+    LOG_SYSTEM("StrategyHost: Failed to load " << cfg_.path << ": "
+                                               << dlerror());
+    return false;
+  }
+  auto init = reinterpret_cast<aero_strategy_init_fn>(
+      dlsym(handle_, AERO_STRATEGY_INIT_SYMBOL));
+  if (!init) {
+    LOG_SYSTEM("StrategyHost: " << cfg_.path << " does not export "
+                                << AERO_STRATEGY_INIT_SYMBOL);
+    dlclose(handle_);
+    handle_ = nullptr;
+    return false;
+  }
+
+  host_.abi_version = AERO_STRATEGY_ABI_VERSION;
+  host_.lcore_id = lcore_id;
+  host_.tsc_hz = TscClock::instance().tsc_hz();
+  host_.args = cfg_.args.c_str();
+  host_.ctx = this;
+  host_.send_order = &StrategyHost::host_send_order;
+  host_.symbol_id = &StrategyHost::host_symbol_id;
+  host_.symbol_name = &StrategyHost::host_symbol_name;
+  host_.log = &StrategyHost::host_log;
+
+  plugin_ = aero_strategy_plugin{};
+  int rc = init(&host_, &plugin_);
+  if (rc != 0 || plugin_.abi_version != AERO_STRATEGY_ABI_VERSION) {
+    LOG_SYSTEM("StrategyHost: " << cfg_.path << " refused to start (rc=" << rc
+                                << ", abi=" << plugin_.abi_version << ")");
+    dlclose(handle_);
+    handle_ = nullptr;
+    return false;
+  }
+
+  if (!ring_.init(cfg_.queue_events)) {
+    LOG_SYSTEM("StrategyHost: Failed to allocate the event ring");
+    if (plugin_.on_stop)
+      plugin_.on_stop(plugin_.state);
+    dlclose(handle_);
+    handle_ = nullptr;
+    return false;
+  }
+
+  LOG_SYSTEM("StrategyHost: Loaded "
+             << (plugin_.name ? plugin_.name : "(unnamed)") << " from "
+             << cfg_.path << " (queue=" << ring_.capacity() << ", execution="
+             << (cfg_.execution ? "on" : "off") << ", book_mirror="
+             << (host_.book_mirror ? "yes" : "no") << ")");
+  return true;
+}
+
+void StrategyHost::unload() {
+  if (!handle_)
+    return;
+  dlclose(handle_);
+  handle_ = nullptr;
+  ring_.release();
+}
+
+// ---------------------------------------------------------------------------
+// Producer (feed-handler lcore)
+// ---------------------------------------------------------------------------
+
+// Last quote passed on per symbol, from either source
+bool StrategyHost::quote_changed(uint32_t symbol_id,
+                                 const aero_strategy_quote &quote) {
+  if (symbol_id >= last_quote_.size())
+    last_quote_.resize(symbol_id + 1, aero_strategy_quote{});
+  aero_strategy_quote &last = last_quote_[symbol_id];
+  if (same_quote(quote, last))
+    return false;
+  last = quote;
+  return true;
+}
+
+void StrategyHost::on_book(ExchangeId exchange_id, uint32_t symbol_id,
+                           const ParsedOrderBook &book,
+                           const BestBidOffer *bbo, bool bbo_fresh) {
+  if (!ring_.is_open())
+    return;
+  Event ev{};
+  ev.type = EV_BOOK;
+  ev.exchange_id = static_cast<uint8_t>(exchange_id);
+  ev.symbol_id = symbol_id;
+  ev.levels = static_cast<uint32_t>(book.bids.size() + book.asks.size());
+  ev.exchange_ts_ms = book.timestamp_ms;
+  ev.rx_tsc = book.rx_tsc;
+  if (book.is_snapshot)
+    ev.flags |= AERO_STRATEGY_FLAG_SNAPSHOT;
+
+  if (bbo)
+    ev.quote = {bbo->bid_price, feed_fixed_qty(bbo->bid_qty), bbo->ask_price,
+                feed_fixed_qty(bbo->ask_qty)};
+
+  if (bbo_fresh && quote_changed(ev.symbol_id, ev.quote))
+    ev.flags |= AERO_STRATEGY_FLAG_BBO_CHANGED;
+  ring_.push(ev);
+}
+
+void StrategyHost::on_bbo(ExchangeId exchange_id, uint32_t symbol_id,
+                          const BestBidOffer *bbo, uint64_t exchange_ts_ms,
+                          uint64_t rx_tsc) {
+  if (!ring_.is_open())
+    return;
+  Event ev{};
+  ev.type = EV_BBO;
+  ev.exchange_id = static_cast<uint8_t>(exchange_id);
+  ev.flags = AERO_STRATEGY_FLAG_BBO_CHANGED | AERO_STRATEGY_FLAG_BBO_CHANNEL;
+  ev.symbol_id = symbol_id;
+  ev.exchange_ts_ms = exchange_ts_ms;
+  ev.rx_tsc = rx_tsc;
+  if (bbo)
+    ev.quote = {bbo->bid_price, feed_fixed_qty(bbo->bid_qty), bbo->ask_price,
+                feed_fixed_qty(bbo->ask_qty)};
+  if (quote_changed(ev.symbol_id, ev.quote))
+    ring_.push(ev);
+}
+
+void StrategyHost::on_trade(ExchangeId exchange_id, uint32_t symbol_id,
+                            uint64_t price, double qty, bool is_sell,
+                            uint64_t exchange_ts_ms, uint64_t rx_tsc) {
+  if (!ring_.is_open())
+    return;
+  Event ev{};
+  ev.type = EV_TRADE;
+  ev.exchange_id = static_cast<uint8_t>(exchange_id);
+  ev.flags = is_sell ? 1 : 0;
+  ev.symbol_id = symbol_id;
+  ev.exchange_ts_ms = exchange_ts_ms;
+  ev.rx_tsc = rx_tsc;
+  ev.quote.bid_price = price;
+  ev.quote.bid_qty = feed_fixed_qty(qty);
+  ring_.push(ev);
+}
+
+// ---------------------------------------------------------------------------
+// Strategy lcore
+// ---------------------------------------------------------------------------
+
+void StrategyHost::deliver(const Event &ev) {
+  if (ev.type == EV_TRADE) {
+    if (!plugin_.on_trade)
+      return;
+    aero_strategy_trade t{};
+    t.symbol_id = ev.symbol_id;
+    t.exchange_id = ev.exchange_id;
+    t.side = ev.flags;
+    t.exchange_ts_ms = ev.exchange_ts_ms;
+    t.rx_tsc = ev.rx_tsc;
+    t.price = ev.quote.bid_price;
+    t.qty = ev.quote.bid_qty;
+    plugin_.on_trade(plugin_.state, &t);
+    return;
+  }
+
+  if (ev.type == EV_BOOK && plugin_.on_book) {
+    aero_strategy_book b{};
+    b.symbol_id = ev.symbol_id;
+    b.exchange_id = ev.exchange_id;
+    b.flags = ev.flags;
+    b.levels = static_cast<uint16_t>(std::min<uint32_t>(ev.levels, 0xFFFF));
+    b.exchange_ts_ms = ev.exchange_ts_ms;
+    b.rx_tsc = ev.rx_tsc;
+    b.top = ev.quote;
+    plugin_.on_book(plugin_.state, &b);
+  }
+
+  if (!(ev.flags & AERO_STRATEGY_FLAG_BBO_CHANGED))
+    return;
+  if (ev.symbol_id >= prev_quote_.size())
+    prev_quote_.resize(ev.symbol_id + 1, aero_strategy_quote{});
+  if (plugin_.on_bbo) {
+    aero_strategy_bbo q{};
+    q.symbol_id = ev.symbol_id;
+    q.exchange_id = ev.exchange_id;
+    q.flags = ev.flags & AERO_STRATEGY_FLAG_BBO_CHANNEL;
+    q.exchange_ts_ms = ev.exchange_ts_ms;
+    q.rx_tsc = ev.rx_tsc;
+    q.quote = ev.quote;
+    q.prev = prev_quote_[ev.symbol_id];
+    plugin_.on_bbo(plugin_.state, &q);
+  }
+  prev_quote_[ev.symbol_id] = ev.quote;
+}
+
+void StrategyHost::run(const volatile bool &quit) {
+  if (!ring_.is_open())
+    return;
+  LOG_SYSTEM("StrategyHost: Running "
+             << (plugin_.name ? plugin_.name : "(unnamed)") << " on core "
+             << host_.lcore_id);
+
+  while (true) {
+    // Read the flag first so the drain below sees everything pushed
+    // before the feed handler stopped
+    bool stopping = quit;
+    // Free each slot as soon as it is delivered: the callback may be slow
+    if (ring_.drain([this](const Event &ev) { deliver(ev); }) == 0) {
+      if (stopping)
+        break;
+      if (plugin_.on_idle)
+        plugin_.on_idle(plugin_.state, TscClock::now_tsc());
+      rte_pause();
+    }
+  }
+
+  if (plugin_.on_stop)
+    plugin_.on_stop(plugin_.state);
+  print_stats();
+}
+
+// ---------------------------------------------------------------------------
+// Host functions (strategy lcore)
+// ---------------------------------------------------------------------------
+
+int StrategyHost::host_send_order(void *ctx, uint8_t exchange_id,
+                                  const char *msg, size_t len) {
+  auto *self = static_cast<StrategyHost *>(ctx);
+  bool sent = false;
+  if (self->cfg_.execution && exchange_id < self->routes_.size() &&
+      self->routes_[exchange_id])
+    sent = self->routes_[exchange_id](std::string(msg, len));
+
+  std::atomic<uint64_t> &counter =
+      sent ? self->orders_sent_ : self->orders_rejected_;
+  counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+  return sent ? 0 : -1;
+}
+
+uint32_t StrategyHost::host_symbol_id(void *, uint8_t exchange_id,
+                                      const char *name) {
+  return SymbolRegistry::instance().get_or_assign(
+      static_cast<ExchangeId>(exchange_id), name);
+}
+
+int StrategyHost::host_symbol_name(void *, uint32_t symbol_id,
+                                   uint8_t *exchange_id, char *buf,
+                                   size_t buf_len) {
+  SymbolRegistry::Entry entry;
+  if (!SymbolRegistry::instance().lookup(symbol_id, entry) || buf_len == 0)
+    return -1;
+  if (exchange_id)
+    *exchange_id = static_cast<uint8_t>(entry.exchange);
+  size_t n = std::min(entry.instrument.size(), buf_len - 1);
+  std::memcpy(buf, entry.instrument.data(), n);
+  buf[n] = '\0';
+  return 0;
+}
+
+void StrategyHost::host_log(void *ctx, const char *msg) {
+  auto *self = static_cast<StrategyHost *>(ctx);
+  LOG_SYSTEM("[Strategy:" << (self->plugin_.name ? self->plugin_.name : "?")
+                          << "] " << msg);
+}
+
+void StrategyHost::print_stats() const {
+  LOG_SYSTEM("[Strategy] events=" << events() << " dropped=" << dropped()
+                                  << " orders_sent=" << orders_sent()
+                                  << " orders_rejected="
+                                  << orders_rejected());
+}
+
+} // namespace aero
@@ -0,0 +1,185 @@
+/**
+ * @file strategy_host.h
+ * @brief Loads a strategy plugin (aero/strategy.h) and feeds it market data
+ */
+
+#ifndef AERO_MODULES_STRATEGY_STRATEGY_HOST_H
+#define AERO_MODULES_STRATEGY_STRATEGY_HOST_H
+
+#include "aero/strategy.h"
+#include "core/spsc_ring.h"
+#include "modules/common/aero_types.h"
+#include "modules/exchange/exchange_adapter.h"
+#include "modules/market_data/order_book.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace aero {
+
+class BookMirror;
+
+/**
+ * @brief Runs one strategy plugin on a dedicated lcore
+ *
+ * The feed-handler lcore calls on_book()/on_bbo()/on_trade(), which copy
+ * one 64-byte event into a lock-free SPSC ring; run() drains the ring on
+ * the strategy lcore and invokes the plugin's callbacks. A full ring drops
+ * events and counts them instead of blocking the feed.
+ *
+ * Orders from the plugin go to the routes registered with
+ * set_order_route(), and only while execution is enabled.
+ */
+class StrategyHost {
+public:
+  struct Config {
+    std::string path;            // Shared object to dlopen()
+    std::string args;            // Passed to the plugin as host->args
+    size_t queue_events = 16384; // Ring size (rounded up to a power of two)
+    bool execution = false;      // Let send_order() through
+  };
+
+  // Sends one raw order message; false if the connection is down
+  using OrderRoute = std::function<bool(const std::string &msg)>;
+
+  StrategyHost() = default;
+  ~StrategyHost();
+
+  StrategyHost(const StrategyHost &) = delete;
+  StrategyHost &operator=(const StrategyHost &) = delete;
+
+  /**
+   * @brief Order path for one exchange; set before load()
+   */
+  void set_order_route(ExchangeId exchange_id, OrderRoute route);
+
+  /**
+   * @brief Expose the local book mirror to the plugin; set before load()
+   */
+  void set_book_mirror(const BookMirror *mirror);
+
+  /**
+   * @brief dlopen the plugin and call its init function
+   *
+   * @param lcore_id Lcore run() will be launched on (reported to the plugin)
+   * @return false if the plugin cannot be loaded or refuses to start
+   */
+  bool load(const Config &cfg, unsigned int lcore_id);
+
+  bool is_loaded() const { return ring_.is_open(); }
+
+  /**
+   * @brief Queue a book update just applied to the local book (feed-handler
+   *        lcore)
+   *
+   * @param bbo Top of book after the update; null while a side is empty
+   * @param bbo_fresh false when the top-of-book channel already delivered
+   *        a newer quote: the plugin's on_bbo is then not raised
+   */
+  void on_book(ExchangeId exchange_id, uint32_t symbol_id,
+               const ParsedOrderBook &book, const BestBidOffer *bbo,
+               bool bbo_fresh = true);
+
+  /**
+   * @brief Queue a quote from a top-of-book channel (feed-handler lcore)
+   *
+   * Raises the plugin's on_bbo alone when the quote differs from the last
+   * one passed on, whichever source that came from.
+   *
+   * @param bbo The quote; null while a side is empty
+   */
+  void on_bbo(ExchangeId exchange_id, uint32_t symbol_id,
+              const BestBidOffer *bbo, uint64_t exchange_ts_ms,
+              uint64_t rx_tsc);
+
+  /**
+   * @brief Queue a trade (feed-handler lcore)
+   *
+   * @param is_sell Aggressor side
+   */
+  void on_trade(ExchangeId exchange_id, uint32_t symbol_id, uint64_t price,
+                double qty, bool is_sell, uint64_t exchange_ts_ms,
+                uint64_t rx_tsc);
+
+  /**
+   * @brief Strategy loop: deliver events until `quit` is set
+   *
+   * Delivers what is still queued, then calls on_stop.
+   */
+  void run(const volatile bool &quit);
+
+  /**
+   * @brief Unload the plugin (after run() has returned)
+   */
+  void unload();
+
+  // Counters (any thread)
+  uint64_t events() const { return ring_.pushed(); }
+  uint64_t dropped() const { return ring_.dropped(); }
+  uint64_t orders_sent() const {
+    return orders_sent_.load(std::memory_order_relaxed);
+  }
+  uint64_t orders_rejected() const {
+    return orders_rejected_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Log counters
+   */
+  void print_stats() const;
+
+private:
+  struct Event {
+    uint8_t type; // EV_BOOK, EV_BBO or EV_TRADE
+    uint8_t exchange_id;
+    uint8_t flags; // AERO_STRATEGY_FLAG_* (trades: side)
+    uint8_t reserved;
+    uint32_t symbol_id;
+    uint32_t levels;
+    uint32_t reserved2;
+    uint64_t exchange_ts_ms;
+    uint64_t rx_tsc;
+    aero_strategy_quote quote; // Trades: bid_price/bid_qty
+  };
+  static_assert(sizeof(Event) == 64, "one cache line per event");
+
+  static constexpr uint8_t EV_BOOK = 1;
+  static constexpr uint8_t EV_TRADE = 2;
+  static constexpr uint8_t EV_BBO = 3;
+
+  bool quote_changed(uint32_t symbol_id, const aero_strategy_quote &quote);
+  void deliver(const Event &ev);
+
+  // aero_strategy_host functions
+  static int host_send_order(void *ctx, uint8_t exchange_id, const char *msg,
+                             size_t len);
+  static uint32_t host_symbol_id(void *ctx, uint8_t exchange_id,
+                                 const char *name);
+  static int host_symbol_name(void *ctx, uint32_t symbol_id,
+                              uint8_t *exchange_id, char *buf, size_t buf_len);
+  static void host_log(void *ctx, const char *msg);
+
+  Config cfg_;
+  void *handle_ = nullptr; // dlopen() handle
+  aero_strategy_host host_{};
+  aero_strategy_plugin plugin_{};
+  aero_book_mirror_reader mirror_{};
+  std::vector<OrderRoute> routes_; // By ExchangeId
+  SpscRing<Event> ring_;
+
+  // Producer (feed-handler lcore)
+  std::vector<aero_strategy_quote> last_quote_; // By symbol id
+
+  // Consumer (strategy lcore)
+  std::vector<aero_strategy_quote> prev_quote_; // By symbol id, for on_bbo
+
+  alignas(64) std::atomic<uint64_t> orders_sent_{0};
+  std::atomic<uint64_t> orders_rejected_{0};
+};
+
+} // namespace aero
+
+#endif // AERO_MODULES_STRATEGY_STRATEGY_HOST_H
@@ -0,0 +1,195 @@
+/**
+ * @file feed_latency_monitor.cpp
+ * @brief Exchange-to-gateway latency monitor implementation
+ */
+
+#include "modules/telemetry/feed_latency_monitor.h"
+#include "core/logging.h"
+#include "core/tsc_clock.h"
+#include <algorithm>
+
+namespace aero {
+
+// --- LatencyDistribution Implementation ---
+
+LatencyDistribution::LatencyDistribution() { reset(); }
+
+int LatencyDistribution::bucket_index(uint64_t us) {
+  if (us < SUB_BUCKETS)
+    return static_cast<int>(us);
+  if (us >= (1ULL << 32))
+    return NUM_BUCKETS - 1;
+  int msb = 63 - __builtin_clzll(us);
+  int sub = static_cast<int>((us >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+  return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyDistribution::bucket_lower_bound(int idx) {
+  if (idx < SUB_BUCKETS)
+    return static_cast<uint64_t>(idx);
+  int msb = idx / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+  uint64_t sub = static_cast<uint64_t>(idx % SUB_BUCKETS);
+  return (SUB_BUCKETS + sub) << (msb - SUB_BUCKET_BITS);
+}
+
+void LatencyDistribution::record_us(uint64_t us) {
+  buckets_[bucket_index(us)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  if (us > max_us_.load(std::memory_order_relaxed))
+    max_us_.store(us, std::memory_order_relaxed);
+}
+
+uint64_t LatencyDistribution::percentile_us(double q) const {
+  uint64_t total = count();
+  if (total == 0)
+    return 0;
+
+  uint64_t threshold = static_cast<uint64_t>(total * q);
+  if (threshold == 0)
+    threshold = 1;
+
+  uint64_t running = 0;
+  for (int i = 0; i < NUM_BUCKETS; ++i) {
+    running += buckets_[i].load(std::memory_order_relaxed);
+    if (running >= threshold)
+      return bucket_lower_bound(i);
+  }
+  return max_us();
+}
+
+void LatencyDistribution::reset() {
+  for (int i = 0; i < NUM_BUCKETS; ++i)
+    buckets_[i].store(0, std::memory_order_relaxed);
+  count_.store(0, std::memory_order_relaxed);
+  max_us_.store(0, std::memory_order_relaxed);
+}
+
+// --- FeedLatencyMonitor Implementation ---
+
+FeedLatencyMonitor::ExchangeState *
+FeedLatencyMonitor::state_for(ExchangeId exchange) {
+  size_t idx = static_cast<size_t>(exchange);
+  if (idx >= NUM_EXCHANGES)
+    return nullptr;
+  return &exchanges_[idx];
+}
+
+void FeedLatencyMonitor::on_ping_sent(ExchangeId exchange, uint64_t tsc) {
+  ExchangeState *st = state_for(exchange);
+  if (st)
+    st->ping_sent_tsc = tsc;
+}
+
+void FeedLatencyMonitor::on_pong_received(ExchangeId exchange,
+                                          uint64_t rx_tsc) {
+  ExchangeState *st = state_for(exchange);
+  if (!st || st->ping_sent_tsc == 0 || rx_tsc < st->ping_sent_tsc)
+    return;
+
+  uint64_t rtt = TscClock::instance().tsc_to_ns(rx_tsc - st->ping_sent_tsc);
+  st->ping_sent_tsc = 0;
+
+  st->rtt_ns[st->rtt_samples % RTT_WINDOW] = rtt;
+  st->rtt_samples++;
+
+  size_t n = std::min(st->rtt_samples, RTT_WINDOW);
+  uint64_t min_rtt = *std::min_element(st->rtt_ns.begin(),
+                                       st->rtt_ns.begin() + n);
+  st->min_rtt_ns.store(min_rtt, std::memory_order_relaxed);
+  update_offset(*st);
+}
+
+void FeedLatencyMonitor::update_offset(ExchangeState &st) {
+  int64_t min_delay = std::min(st.delay_min_cur, st.delay_min_prev);
+  if (st.rtt_samples == 0 || min_delay == INT64_MAX) {
+    // No RTT yet: report raw (exchange_ts vs local clock) latencies
+    st.offset_ns.store(0, std::memory_order_relaxed);
+    st.offset_valid.store(false, std::memory_order_relaxed);
+    return;
+  }
+
+  int64_t half_rtt =
+      static_cast<int64_t>(st.min_rtt_ns.load(std::memory_order_relaxed) / 2);
+  st.offset_ns.store(half_rtt - min_delay, std::memory_order_relaxed);
+  st.offset_valid.store(true, std::memory_order_relaxed);
+}
+
+void FeedLatencyMonitor::record(ExchangeId exchange,
+                                const std::string &instrument,
+                                uint64_t exchange_ts_ms, uint64_t rx_tsc) {
+  ExchangeState *st = state_for(exchange);
+  if (!st || exchange_ts_ms == 0 || rx_tsc == 0)
+    return;
+
+  uint64_t rx_ns = TscClock::instance().tsc_to_wall(rx_tsc);
+  int64_t delay = static_cast<int64_t>(rx_ns) -
+                  static_cast<int64_t>(exchange_ts_ms * 1000000ULL);
+
+  // Rotate the min-filter window so stale minima (e.g. from before a route
+  // change or an exchange clock step) age out.
+  if (rx_ns - st->delay_window_start_ns > DELAY_WINDOW_NS) {
+    st->delay_min_prev = st->delay_min_cur;
+    st->delay_min_cur = INT64_MAX;
+    st->delay_window_start_ns = rx_ns;
+  }
+  if (delay < st->delay_min_cur) {
+    st->delay_min_cur = delay;
+    update_offset(*st);
+  }
+
+  auto &slot = st->symbols[instrument];
+  if (!slot)
+    slot = std::make_unique<SymbolStats>();
+
+  int64_t latency = delay + st->offset_ns.load(std::memory_order_relaxed);
+  if (latency < 0) {
+    slot->negative.fetch_add(1, std::memory_order_relaxed);
+    latency = 0;
+  }
+  slot->latency.record_us(static_cast<uint64_t>(latency) / 1000);
+}
+
+int64_t FeedLatencyMonitor::clock_offset_ns(ExchangeId exchange) const {
+  size_t idx = static_cast<size_t>(exchange);
+  if (idx >= NUM_EXCHANGES)
+    return 0;
+  return exchanges_[idx].offset_ns.load(std::memory_order_relaxed);
+}
+
+void FeedLatencyMonitor::print_stats() {
+  for (size_t i = 0; i < NUM_EXCHANGES; ++i) {
+    ExchangeState &st = exchanges_[i];
+    if (st.symbols.empty())
+      continue;
+
+    const char *name = exchange_name(static_cast<ExchangeId>(i));
+    if (st.offset_valid.load(std::memory_order_relaxed)) {
+      LOG_SYSTEM("[FeedLatency] "
+                 << name << " clock_offset="
+                 << st.offset_ns.load(std::memory_order_relaxed) / 1000
+                 << "us min_rtt="
+                 << st.min_rtt_ns.load(std::memory_order_relaxed) / 1000
+                 << "us rtt_samples=" << st.rtt_samples);
+    } else {
+      LOG_SYSTEM("[FeedLatency] " << name
+                                  << " clock_offset=n/a (no pong yet, raw)");
+    }
+
+    for (auto &[symbol, stats] : st.symbols) {
+      LatencyDistribution &d = stats->latency;
+      if (d.count() == 0)
+        continue;
+      LOG_SYSTEM("[FeedLatency]   "
+                 << symbol << " n=" << d.count()
+                 << " p50=" << d.percentile_us(0.50)
+                 << "us p99=" << d.percentile_us(0.99)
+                 << "us p99.9=" << d.percentile_us(0.999)
+                 << "us max=" << d.max_us() << "us neg="
+                 << stats->negative.load(std::memory_order_relaxed));
+      d.reset();
+      stats->negative.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+} // namespace aero
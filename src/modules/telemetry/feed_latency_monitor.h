@@ -0,0 +1,152 @@
+/**
+ * @file feed_latency_monitor.h
+ * @brief Exchange-to-gateway one-way latency tracking per exchange/symbol
+ *
+ * Every market data message carries the exchange's own event timestamp
+ * (OKX `ts`, Bybit `ts`). Comparing it against the local receive time gives
+ * the one-way feed latency, but only after the two clocks are aligned:
+ *
+ * - Local receive TSC is converted to CLOCK_REALTIME with the shared
+ *   calibrated TscClock.
+ * - The exchange clock offset is estimated NTP-style: the minimum apparent
+ *   delay (local_rx - exchange_ts) seen in a sliding window is assumed to
+ *   correspond to the minimum one-way path, which is approximated by half
+ *   the minimum ping RTT in a sliding window of heartbeats.
+ *
+ *   offset = min_rtt / 2 - min_apparent_delay
+ *   latency = (local_rx - exchange_ts) + offset
+ */
+
+#ifndef AERO_FEED_LATENCY_MONITOR_H
+#define AERO_FEED_LATENCY_MONITOR_H
+
+#include "modules/common/aero_types.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace aero {
+
+/**
+ * @brief Log-linear histogram of microsecond latencies
+ *
+ * Exact buckets below 16us, then 16 sub-buckets per power of two
+ * (~6% relative resolution) up to ~4000s. Recording is lock-free.
+ */
+class LatencyDistribution {
+public:
+  static constexpr int SUB_BUCKET_BITS = 4;
+  static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static constexpr int NUM_BUCKETS = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  LatencyDistribution();
+
+  void record_us(uint64_t us);
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t max_us() const { return max_us_.load(std::memory_order_relaxed); }
+
+  // Lower bound (in us) of the bucket holding the given quantile
+  uint64_t percentile_us(double q) const;
+
+  void reset();
+
+private:
+  static int bucket_index(uint64_t us);
+  static uint64_t bucket_lower_bound(int idx);
+
+  std::atomic<uint64_t> buckets_[NUM_BUCKETS];
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> max_us_;
+};
+
+/**
+ * @brief Per-exchange feed latency monitor with clock-offset estimation
+ *
+ * All calls are expected from the feed-handler thread; print_stats() also
+ * resets the per-interval distributions. clock_offset_ns() may be read from
+ * any thread.
+ */
+class FeedLatencyMonitor {
+public:
+  static constexpr size_t NUM_EXCHANGES = 6; // Matches ExchangeId::OKX..MEXC
+  static constexpr size_t RTT_WINDOW = 32;   // Ping samples kept for min-RTT
+  static constexpr uint64_t DELAY_WINDOW_NS = 60ULL * 1000000000ULL;
+
+  static FeedLatencyMonitor &instance() {
+    static FeedLatencyMonitor monitor;
+    return monitor;
+  }
+
+  /**
+   * @brief Note that a heartbeat ping was sent to the exchange
+   * @param tsc TSC at send time
+   */
+  void on_ping_sent(ExchangeId exchange, uint64_t tsc);
+
+  /**
+   * @brief Note that the matching pong arrived; records one RTT sample
+   * @param rx_tsc TSC at which the pong frame was received
+   */
+  void on_pong_received(ExchangeId exchange, uint64_t rx_tsc);
+
+  /**
+   * @brief Record one market data message
+   * @param instrument Exchange symbol
+   * @param exchange_ts_ms Exchange event timestamp (Unix ms)
+   * @param rx_tsc TSC at which the WebSocket frame was received
+   */
+  void record(ExchangeId exchange, const std::string &instrument,
+              uint64_t exchange_ts_ms, uint64_t rx_tsc);
+
+  /**
+   * @brief Current estimate of (exchange clock - local clock) in ns
+   */
+  int64_t clock_offset_ns(ExchangeId exchange) const;
+
+  /**
+   * @brief Log per-exchange offset/RTT and per-symbol latency percentiles
+   */
+  void print_stats();
+
+private:
+  FeedLatencyMonitor() = default;
+  FeedLatencyMonitor(const FeedLatencyMonitor &) = delete;
+  FeedLatencyMonitor &operator=(const FeedLatencyMonitor &) = delete;
+
+  struct SymbolStats {
+    LatencyDistribution latency; // Offset-corrected one-way latency
+    std::atomic<uint64_t> negative{0}; // Samples that corrected below zero
+  };
+
+  struct ExchangeState {
+    // Ping/pong RTT (ns), min-filtered over the last RTT_WINDOW samples
+    uint64_t ping_sent_tsc = 0;
+    std::array<uint64_t, RTT_WINDOW> rtt_ns{};
+    size_t rtt_samples = 0;
+    std::atomic<uint64_t> min_rtt_ns{0};
+
+    // Apparent delay (local_rx - exchange_ts) min-filtered over two
+    // rotating windows so old minima age out after DELAY_WINDOW_NS
+    int64_t delay_min_cur = INT64_MAX;
+    int64_t delay_min_prev = INT64_MAX;
+    uint64_t delay_window_start_ns = 0;
+
+    std::atomic<int64_t> offset_ns{0};
+    std::atomic<bool> offset_valid{false};
+
+    std::unordered_map<std::string, std::unique_ptr<SymbolStats>> symbols;
+  };
+
+  ExchangeState *state_for(ExchangeId exchange);
+  void update_offset(ExchangeState &st);
+
+  std::array<ExchangeState, NUM_EXCHANGES> exchanges_;
+};
+
+} // namespace aero
+
+#endif // AERO_FEED_LATENCY_MONITOR_H
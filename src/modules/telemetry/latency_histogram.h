@@ -5,10 +5,12 @@
 #include <atomic>
 #include <cmath>
 #include <cstdio>
-#include <rte_cycles.h>
 #include <stdint.h>
+#include <string>
 #include <vector>
 
+#include "core/tsc_clock.h"
+
 namespace aero {
 
 // A simple fixed-bucket linear/log histogram for latency tracking
@@ -26,41 +28,27 @@ public:
     total_count_.store(0, std::memory_order_relaxed);
   }
 
-  // Record latency in CPU cycles
+  // Record latency in TSC cycles
   inline void record(uint64_t cycles) {
-    // Convert to microseconds approximately for bucketing,
-    // to keep bucket logic simple independent of TSC frequency for now,
-    // or just use raw cycles?
-    // Better to use cycles for speed, but need conversion for human readability
-    // later. Let's use raw cycles for the buckets to be super fast! But TSC hz
-    // varies. Let's pre-calculate a scale factor or just use microseconds.
-    // rte_get_timer_hz() is relatively expensive to call every time? No, it's
-    // variable. Let's assume we want microseconds.
-
-    // Fast approximation: assume 2GHz+ CPU, so 2000 cycles = 1us.
-    // To be precise, let's just bucket by "units" where unit is somewhat
-    // arbitrary but stable. Or we can just do:
-
-    static uint64_t tsc_hz = rte_get_timer_hz();
-    double us = (double)cycles * 1000000.0 / tsc_hz;
-
-    int bucket_idx = 0;
-    if (us < 1.0) {
+    // Multiply-shift conversion; the divisions below are by constants and
+    // compile to multiplies, so recording never divides at runtime.
+    uint64_t ns = TscClock::instance().tsc_to_ns(cycles);
+
+    uint64_t bucket_idx;
+    if (ns < 1000) {
       // sub-microsecond: bucket 0 to 9 (0.0 - 0.9)
-      bucket_idx = (int)(us * 10);
-    } else if (us < 100.0) {
+      bucket_idx = ns / 100;
+    } else if (ns < 100000) {
       // 1us - 99us: bucket 10 to 109
-      bucket_idx = 10 + (int)us;
+      bucket_idx = 10 + ns / 1000;
     } else {
-      // >= 100us: Log scale or clamped
+      // >= 100us: 10us buckets, clamped
       // Simple clamp for HFT context (if > 150us we largely failed)
-      bucket_idx = 110 + (int)(us / 10.0);
+      bucket_idx = 110 + ns / 10000;
     }
 
-    if (bucket_idx >= NUM_BUCKETS)
+    if (bucket_idx >= static_cast<uint64_t>(NUM_BUCKETS))
       bucket_idx = NUM_BUCKETS - 1;
-    if (bucket_idx < 0)
-      bucket_idx = 0;
 
     buckets_[bucket_idx].fetch_add(1, std::memory_order_relaxed);
     total_count_.fetch_add(1, std::memory_order_relaxed);
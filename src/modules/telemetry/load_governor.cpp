@@ -0,0 +1,134 @@
+#include "load_governor.h"
+#include "core/logging.h"
+#include "core/tsc_clock.h"
+#include "modules/common/symbol_registry.h"
+
+namespace aero {
+
+void LoadGovernor::configure(const Config &cfg) {
+  cfg_ = cfg;
+  if (cfg_.exit_backlog > cfg_.enter_backlog)
+    cfg_.exit_backlog = cfg_.enter_backlog;
+  if (cfg_.exit_loop_us > cfg_.enter_loop_us)
+    cfg_.exit_loop_us = cfg_.enter_loop_us;
+  if (cfg_.top_levels == 0)
+    cfg_.top_levels = 1; // Never shed the BBO itself
+
+  TscClock &clock = TscClock::instance();
+  enter_loop_tsc_ = clock.ns_to_tsc(cfg_.enter_loop_us * 1000ULL);
+  exit_loop_tsc_ = clock.ns_to_tsc(cfg_.exit_loop_us * 1000ULL);
+  exit_hold_tsc_ = clock.ns_to_tsc(cfg_.exit_hold_ms * 1000000ULL);
+
+  if (cfg_.enabled) {
+    LOG_SYSTEM("LoadGovernor: shedding above backlog="
+               << cfg_.enter_backlog << " or loop=" << cfg_.enter_loop_us
+               << "us, until backlog<=" << cfg_.exit_backlog << " and loop<="
+               << cfg_.exit_loop_us << "us for " << cfg_.exit_hold_ms
+               << "ms; top_levels=" << cfg_.top_levels);
+  }
+}
+
+void LoadGovernor::add_priority(const std::string &instrument) {
+  priority_names_.insert(instrument);
+  priority_.clear(); // Re-resolve ids lazily
+}
+
+bool LoadGovernor::is_priority(uint32_t id) {
+  if (priority_names_.empty())
+    return true;
+  if (id >= priority_.size())
+    priority_.resize(id + 1, -1);
+  if (priority_[id] < 0) {
+    SymbolRegistry::Entry entry;
+    priority_[id] = SymbolRegistry::instance().lookup(id, entry) &&
+                    priority_names_.count(entry.instrument) != 0;
+  }
+  return priority_[id] != 0;
+}
+
+void LoadGovernor::on_cycle(size_t backlog, uint64_t cycle_tsc,
+                            uint64_t now_tsc) {
+  if (!cfg_.enabled)
+    return;
+
+  // One long cycle alone is not overload; a run of them is
+  loop_ewma_tsc_ = loop_ewma_tsc_ - loop_ewma_tsc_ / 8 + cycle_tsc / 8;
+
+  if (!shedding()) {
+    if (backlog >= cfg_.enter_backlog || loop_ewma_tsc_ >= enter_loop_tsc_)
+      set_shedding(true, now_tsc, backlog);
+    return;
+  }
+
+  if (backlog > cfg_.exit_backlog || loop_ewma_tsc_ > exit_loop_tsc_) {
+    calm_since_tsc_ = 0;
+    return;
+  }
+  if (calm_since_tsc_ == 0)
+    calm_since_tsc_ = now_tsc;
+  else if (now_tsc - calm_since_tsc_ >= exit_hold_tsc_)
+    set_shedding(false, now_tsc, backlog);
+}
+
+void LoadGovernor::set_shedding(bool on, uint64_t now_tsc, size_t backlog) {
+  TscClock &clock = TscClock::instance();
+  uint64_t loop_us = clock.tsc_to_ns(loop_ewma_tsc_) / 1000;
+  calm_since_tsc_ = 0;
+
+  if (on) {
+    shed_since_tsc_.store(now_tsc, std::memory_order_relaxed);
+    episodes_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    uint64_t since = shed_since_tsc_.exchange(0, std::memory_order_relaxed);
+    shed_tsc_.fetch_add(now_tsc - since, std::memory_order_relaxed);
+  }
+  // Logged before/after the switch so the transition itself is never shed
+  if (!on)
+    logging_set_shed(false);
+  LOG_SYSTEM("LoadGovernor: " << (on ? "overload, shedding" : "recovered")
+                              << " (backlog=" << backlog
+                              << " loop=" << loop_us << "us)");
+  if (on)
+    logging_set_shed(true);
+  shedding_.store(on, std::memory_order_relaxed);
+}
+
+void LoadGovernor::on_trimmed(uint32_t id, size_t levels) {
+  levels_trimmed_.fetch_add(levels, std::memory_order_relaxed);
+  if (id >= trimmed_.size())
+    trimmed_.resize(id + 1, 0);
+  if (!trimmed_[id]) {
+    trimmed_[id] = 1;
+    trimmed_count_++;
+  }
+}
+
+bool LoadGovernor::take_trimmed(ExchangeId exchange,
+                                const std::string &instrument) {
+  uint32_t id = SymbolRegistry::instance().find(exchange, instrument);
+  if (id >= trimmed_.size() || !trimmed_[id])
+    return false;
+  trimmed_[id] = 0;
+  trimmed_count_--;
+  return true;
+}
+
+uint64_t LoadGovernor::shed_ms() const {
+  uint64_t tsc = shed_tsc_.load(std::memory_order_relaxed);
+  uint64_t since = shed_since_tsc_.load(std::memory_order_relaxed);
+  if (since != 0)
+    tsc += TscClock::now_tsc() - since;
+  return TscClock::instance().tsc_to_ns(tsc) / 1000000;
+}
+
+void LoadGovernor::print_stats() const {
+  if (!cfg_.enabled)
+    return;
+  LOG_SYSTEM("[LoadShed] active=" << shedding() << " episodes=" << episodes()
+                                  << " shed_ms=" << shed_ms()
+                                  << " levels_trimmed=" << levels_trimmed()
+                                  << " deferred=" << deferred()
+                                  << " logs_skipped=" << logging_shed_count());
+}
+
+} // namespace aero
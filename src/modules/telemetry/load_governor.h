@@ -0,0 +1,150 @@
+/**
+ * @file load_governor.h
+ * @brief Overload detection and shedding policy for the feed handler
+ */
+
+#ifndef AERO_LOAD_GOVERNOR_H
+#define AERO_LOAD_GOVERNOR_H
+
+#include "modules/common/aero_types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace aero {
+
+/**
+ * @brief Decides when the gateway is overloaded and what it may skip
+ *
+ * Fed once per feed-handler cycle with the WebSocket receive backlog and
+ * the cycle's duration (smoothed). Shedding starts as soon as either
+ * crosses its enter threshold and ends only after both have stayed at or
+ * below their (lower) exit thresholds for exit_hold_ms, so the mode does
+ * not flap around a single threshold.
+ *
+ * While shedding:
+ *   - priority symbols are processed and published in full, BBO included
+ *   - other symbols are applied only within the top `top_levels` of their
+ *     book (level removals always apply) and their outputs are conflated
+ *     until the overload ends; they are re-subscribed afterwards so the
+ *     exchange's snapshot restores the skipped depth
+ *   - hot-path logging is skipped (logging_shed_skip())
+ *
+ * With no priority symbols configured every symbol counts as priority,
+ * and only logging is shed.
+ *
+ * Policy and counters are updated on the feed-handler lcore; shedding()
+ * and the counters may be read from any thread.
+ */
+class LoadGovernor {
+public:
+  struct Config {
+    bool enabled = false;
+    size_t enter_backlog = 2000;  // Receive queue depth (frames)
+    size_t exit_backlog = 200;
+    uint32_t enter_loop_us = 1000; // Smoothed feed cycle time
+    uint32_t exit_loop_us = 200;
+    uint32_t exit_hold_ms = 1000; // Calm period before shedding ends
+    size_t top_levels = 10;       // Depth kept for non-priority symbols
+  };
+
+  static LoadGovernor &instance() {
+    static LoadGovernor governor;
+    return governor;
+  }
+
+  void configure(const Config &cfg);
+
+  /**
+   * @brief Mark an instrument as priority on every exchange
+   */
+  void add_priority(const std::string &instrument);
+
+  /**
+   * @brief Feed one feed-handler cycle's load sample
+   *
+   * @param backlog Largest WebSocket receive backlog of the cycle
+   * @param cycle_tsc Duration of the cycle
+   * @param now_tsc Current TSC
+   */
+  void on_cycle(size_t backlog, uint64_t cycle_tsc, uint64_t now_tsc);
+
+  bool shedding() const { return shedding_.load(std::memory_order_relaxed); }
+  size_t top_levels() const { return cfg_.top_levels; }
+
+  /**
+   * @brief Whether a SymbolRegistry id keeps full fidelity under overload
+   */
+  bool is_priority(uint32_t id);
+
+  /**
+   * @brief Note that levels of a symbol were skipped (feed-handler lcore)
+   */
+  void on_trimmed(uint32_t id, size_t levels);
+
+  /**
+   * @brief Note that a symbol's outputs were conflated by shedding
+   */
+  void on_deferred() { deferred_.fetch_add(1, std::memory_order_relaxed); }
+
+  /**
+   * @brief Whether trimmed symbols are waiting to be re-subscribed
+   */
+  bool has_trimmed() const { return trimmed_count_ > 0; }
+
+  /**
+   * @brief Clear and return a symbol's trimmed mark (feed-handler lcore)
+   */
+  bool take_trimmed(ExchangeId exchange, const std::string &instrument);
+
+  // Counters
+  uint64_t episodes() const {
+    return episodes_.load(std::memory_order_relaxed);
+  }
+  uint64_t shed_ms() const; // Total time spent shedding
+  uint64_t levels_trimmed() const {
+    return levels_trimmed_.load(std::memory_order_relaxed);
+  }
+  uint64_t deferred() const {
+    return deferred_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Log state and counters
+   */
+  void print_stats() const;
+
+private:
+  LoadGovernor() = default;
+  LoadGovernor(const LoadGovernor &) = delete;
+  LoadGovernor &operator=(const LoadGovernor &) = delete;
+
+  void set_shedding(bool on, uint64_t now_tsc, size_t backlog);
+
+  Config cfg_;
+  uint64_t enter_loop_tsc_ = 0;
+  uint64_t exit_loop_tsc_ = 0;
+  uint64_t exit_hold_tsc_ = 0;
+
+  uint64_t loop_ewma_tsc_ = 0; // 1/8 smoothing of cycle_tsc
+  uint64_t calm_since_tsc_ = 0; // 0 = not calm
+  std::atomic<uint64_t> shed_since_tsc_{0}; // Start of the current episode
+  std::atomic<bool> shedding_{false};
+
+  std::unordered_set<std::string> priority_names_;
+  std::vector<int8_t> priority_; // By symbol id: -1 unknown, 0 no, 1 yes
+  std::vector<uint8_t> trimmed_; // By symbol id
+  size_t trimmed_count_ = 0;
+
+  std::atomic<uint64_t> episodes_{0};
+  std::atomic<uint64_t> shed_tsc_{0}; // Finished episodes
+  std::atomic<uint64_t> levels_trimmed_{0};
+  std::atomic<uint64_t> deferred_{0};
+};
+
+} // namespace aero
+
+#endif // AERO_LOAD_GOVERNOR_H
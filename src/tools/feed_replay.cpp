@@ -0,0 +1,334 @@
+/**
+ * @file feed_replay.cpp
+ * @brief Replays captured exchange frames through the feed pipeline
+ *
+ * Usage: aero-replay [options] <segment.cap>...
+ *
+ * Reads the segments written by FrameCapture (aero/capture.h) in the order
+ * given and pushes every frame through the same path the exchange
+ * connections use: adapter parse, then route_book() into the local books
+ * and the configured outputs. No exchange connection is made; the UDP feed
+ * (--udp) goes to whatever address is given, loopback by default.
+ *
+ * Two modes:
+ *   - as fast as possible (default): throughput and regression runs
+ *   - paced (--speed X): frames are released at their recorded spacing
+ *     divided by X, for latency measurements under realistic arrival
+ *
+ * Reports frames/s and latency distributions per stage: parse, dispatch
+ * (book apply and outputs), flush (per poll cycle) and frame (release to
+ * done, which in paced mode includes time spent waiting behind earlier
+ * frames).
+ */
+
+#include "aero/capture.h"
+#include "config.h"
+#include "core/logging.h"
+#include "core/tsc_clock.h"
+#include "modules/exchange/bybit_adapter.h"
+#include "modules/exchange/feed_sinks.h"
+#include "modules/exchange/okx_adapter.h"
+#include "modules/market_data/bbo_arbiter.h"
+#include "modules/market_data/order_book.h"
+#include "modules/market_data/trade_flow.h"
+#include "modules/network/shm_bus_publisher.h"
+#include "modules/network/udp_publisher.h"
+#include "modules/telemetry/feed_latency_monitor.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+  double speed = 0.0; // 0 = as fast as possible
+  int loops = 1;
+  int batch = 1; // Frames per simulated poll cycle
+  std::string udp;
+  bool compact = false;
+  std::string shm;
+  std::vector<std::string> files;
+};
+
+// Stage timings in ns (the distribution's buckets are unit-agnostic)
+struct Stage {
+  const char *name;
+  aero::LatencyDistribution ns;
+};
+
+struct Counters {
+  uint64_t frames = 0;
+  uint64_t books = 0;
+  uint64_t bbos = 0;  // Top-of-book channel updates
+  uint64_t trades = 0; // Trades messages
+  uint64_t other = 0; // Pings, subscription replies, unknown
+  uint64_t bytes = 0;
+  uint64_t late = 0; // Paced frames released behind schedule
+};
+
+void usage(const char *prog) {
+  std::fprintf(
+      stderr,
+      "Usage: %s [options] <segment.cap>...\n"
+      "  --speed X      Pace at recorded timing, X times faster (default: "
+      "as fast as possible)\n"
+      "  --loops N      Replay the input N times\n"
+      "  --batch N      Frames per poll cycle, flushed together (default 1)\n"
+      "  --udp H:P      Publish the UDP feed to H:P\n"
+      "  --compact      Use the compact feed format\n"
+      "  --shm PATH     Publish to a shared-memory bus at PATH\n",
+      prog);
+}
+
+bool parse_args(int argc, char **argv, Options &opt) {
+  static const option longopts[] = {
+      {"speed", required_argument, nullptr, 's'},
+      {"loops", required_argument, nullptr, 'l'},
+      {"batch", required_argument, nullptr, 'b'},
+      {"udp", required_argument, nullptr, 'u'},
+      {"compact", no_argument, nullptr, 'c'},
+      {"shm", required_argument, nullptr, 'm'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, 0, nullptr, 0},
+  };
+  int c;
+  while ((c = getopt_long(argc, argv, "s:l:b:u:cm:h", longopts, nullptr)) !=
+         -1) {
+    switch (c) {
+    case 's':
+      opt.speed = std::atof(optarg);
+      break;
+    case 'l':
+      opt.loops = std::max(std::atoi(optarg), 1);
+      break;
+    case 'b':
+      opt.batch = std::max(std::atoi(optarg), 1);
+      break;
+    case 'u':
+      opt.udp = optarg;
+      break;
+    case 'c':
+      opt.compact = true;
+      break;
+    case 'm':
+      opt.shm = optarg;
+      break;
+    default:
+      return false;
+    }
+  }
+  for (int i = optind; i < argc; i++)
+    opt.files.push_back(argv[i]);
+  return !opt.files.empty();
+}
+
+void print_stage(const Stage &s) {
+  if (s.ns.count() == 0)
+    return;
+  std::printf("  %-9s n=%-10" PRIu64 " p50=%-8" PRIu64 " p90=%-8" PRIu64
+              " p99=%-8" PRIu64 " p99.9=%-8" PRIu64 " max=%" PRIu64 " ns\n",
+              s.name, s.ns.count(), s.ns.percentile_us(0.50),
+              s.ns.percentile_us(0.90), s.ns.percentile_us(0.99),
+              s.ns.percentile_us(0.999), s.ns.max_us());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  // No config_load(): nothing here needs credentials. Module errors go to
+  // stdout; per-message logging stays off.
+  app_config.log_system_enabled = true;
+
+  aero::TscClock &clock = aero::TscClock::instance();
+  aero::OrderBookManager books;
+  aero::OkxAdapter okx;
+  aero::BybitAdapter bybit;
+
+  aero::UdpPublisher udp;
+  if (!opt.udp.empty()) {
+    size_t colon = opt.udp.rfind(':');
+    aero::UdpFeedOptions feed_opts;
+    if (opt.compact)
+      feed_opts.wire_format = aero::FeedWireFormat::COMPACT;
+    if (colon == std::string::npos ||
+        !udp.init(opt.udp.substr(0, colon),
+                  std::atoi(opt.udp.c_str() + colon + 1), feed_opts)) {
+      std::fprintf(stderr, "Cannot publish to %s\n", opt.udp.c_str());
+      return 1;
+    }
+  }
+  aero::ShmBusPublisher shm;
+  if (!opt.shm.empty() && !shm.init(opt.shm, 16384, 2048)) {
+    std::fprintf(stderr, "Cannot create bus %s\n", opt.shm.c_str());
+    return 1;
+  }
+
+  aero::FeedSinks sinks;
+  sinks.books = &books;
+  sinks.udp = &udp;
+  sinks.shm_bus = &shm;
+  // Attached at the first BBO channel frame, as live with BBO_CHANNELS_ENABLED
+  aero::BboArbiter bbo_arbiter;
+  // Trade flow with the default windows, so trades frames cost what they do
+  // live with TRADES_ENABLED
+  aero::TradeFlowAggregator trade_flow;
+  trade_flow.configure(aero::TradeFlowConfig{});
+  sinks.trade_flow = &trade_flow;
+  aero::ParsedTrades trades; // Reused, as by the connections
+  aero::ParsedBbo bbo;
+  aero::ParsedOrderBook book;
+
+  Stage parse{"parse", {}};
+  Stage dispatch{"dispatch", {}};
+  Stage flush{"flush", {}};
+  Stage frame{"frame", {}};
+  Counters n;
+
+  const uint64_t start_tsc = aero::TscClock::now_tsc();
+  uint64_t first_wall_ns = 0; // Of the recording, for pacing
+  uint64_t loop_offset_ns = 0; // Recorded span of the finished loops
+  uint64_t last_wall_ns = 0;
+  int in_cycle = 0;
+
+  auto end_cycle = [&]() {
+    if (udp.is_initialized()) {
+      uint64_t t = aero::TscClock::now_tsc();
+      udp.flush();
+      flush.ns.record_us(clock.tsc_to_ns(aero::TscClock::now_tsc() - t));
+    }
+    in_cycle = 0;
+  };
+
+  for (int loop = 0; loop < opt.loops; loop++) {
+    for (const std::string &path : opt.files) {
+      aero_cap_reader r;
+      if (aero_cap_reader_open(&r, path.c_str()) != 0) {
+        std::fprintf(stderr, "Cannot read capture segment %s\n", path.c_str());
+        return 1;
+      }
+
+      const aero_cap_record *rec;
+      while ((rec = aero_cap_reader_next(&r)) != nullptr) {
+        if (rec->type != AERO_CAP_FRAME)
+          continue;
+        auto ex = static_cast<aero::ExchangeId>(rec->exchange_id);
+        aero::IExchangeAdapter *adapter = nullptr;
+        if (ex == aero::ExchangeId::OKX)
+          adapter = &okx;
+        else if (ex == aero::ExchangeId::BYBIT)
+          adapter = &bybit;
+        if (!adapter)
+          continue;
+
+        // Release time: now, or the recorded offset scaled by --speed
+        uint64_t release_tsc = aero::TscClock::now_tsc();
+        if (opt.speed > 0.0) {
+          if (first_wall_ns == 0)
+            first_wall_ns = rec->rx_wall_ns;
+          last_wall_ns = rec->rx_wall_ns;
+          uint64_t offset_ns = loop_offset_ns + rec->rx_wall_ns - first_wall_ns;
+          uint64_t due_tsc = start_tsc + clock.ns_to_tsc(static_cast<uint64_t>(
+                                             offset_ns / opt.speed));
+          if (release_tsc < due_tsc) {
+            if (in_cycle > 0)
+              end_cycle(); // Idle until the next frame: the cycle ends
+            while ((release_tsc = aero::TscClock::now_tsc()) < due_tsc) {
+            }
+          } else if (release_tsc - due_tsc > clock.ns_to_tsc(1000)) {
+            n.late++;
+          }
+          release_tsc = due_tsc;
+        }
+
+        const char *data = aero_cap_record_payload(rec);
+        uint64_t t0 = aero::TscClock::now_tsc();
+        bbo.clear();
+        book.clear();
+        bool is_bbo = adapter->parse_bbo_message(data, rec->length, bbo);
+        bool is_trades =
+            !is_bbo &&
+            adapter->parse_trades_message(data, rec->length, trades);
+        bool ok = is_bbo || is_trades ||
+                  adapter->parse_orderbook_message(data, rec->length, book);
+        uint64_t t1 = aero::TscClock::now_tsc();
+        n.frames++;
+        n.bytes += rec->length;
+        if (ok) {
+          if (is_bbo) {
+            sinks.bbo_arbiter = &bbo_arbiter;
+            bbo.rx_tsc = release_tsc;
+            aero::route_bbo(sinks, ex, bbo);
+            n.bbos++;
+          } else if (is_trades) {
+            trades.rx_tsc = release_tsc;
+            aero::route_trades(sinks, ex, trades);
+            n.trades++;
+          } else {
+            book.rx_tsc = release_tsc;
+            aero::route_book(sinks, ex, book, false);
+            n.books++;
+          }
+          uint64_t t2 = aero::TscClock::now_tsc();
+          parse.ns.record_us(clock.tsc_to_ns(t1 - t0));
+          dispatch.ns.record_us(clock.tsc_to_ns(t2 - t1));
+          frame.ns.record_us(clock.tsc_to_ns(t2 - release_tsc));
+        } else {
+          n.other++;
+        }
+
+        if (++in_cycle >= opt.batch)
+          end_cycle();
+      }
+      aero_cap_reader_close(&r);
+    }
+    if (first_wall_ns != 0)
+      loop_offset_ns += last_wall_ns - first_wall_ns + 1;
+    first_wall_ns = 0;
+  }
+  if (in_cycle > 0)
+    end_cycle();
+
+  double secs = static_cast<double>(clock.tsc_to_ns(aero::TscClock::now_tsc() -
+                                                    start_tsc)) /
+                1e9;
+  std::printf("Replayed %" PRIu64 " frames (%" PRIu64 " books, %" PRIu64
+              " bbo, %" PRIu64 " trades, %" PRIu64
+              " other, %.1f MB) in %.3f s%s\n",
+              n.frames, n.books, n.bbos, n.trades, n.other, n.bytes / 1e6,
+              secs,
+              opt.speed > 0.0 ? "" : " (unpaced)");
+  std::printf("  %.0f frames/s, %.1f MB/s", n.frames / secs,
+              n.bytes / 1e6 / secs);
+  if (opt.speed > 0.0)
+    std::printf(", %" PRIu64 " released late (>1us)", n.late);
+  std::printf("\n");
+  print_stage(parse);
+  print_stage(dispatch);
+  print_stage(flush);
+  print_stage(frame);
+  if (udp.is_initialized())
+    std::printf("  udp datagrams=%" PRIu64 " dropped=%" PRIu64 "\n",
+                udp.datagrams_sent(), udp.datagrams_dropped());
+  if (trade_flow.trades() > 0)
+    std::printf("  trades=%" PRIu64 " flow overflowed=%" PRIu64 "\n",
+                trade_flow.trades(), trade_flow.overflowed());
+  if (sinks.bbo_arbiter)
+    std::printf("  bbo channel accepted=%" PRIu64 " stale=%" PRIu64
+                ", depth accepted=%" PRIu64 " stale=%" PRIu64 "\n",
+                bbo_arbiter.accepted(aero::BboArbiter::CHANNEL),
+                bbo_arbiter.stale(aero::BboArbiter::CHANNEL),
+                bbo_arbiter.accepted(aero::BboArbiter::DEPTH),
+                bbo_arbiter.stale(aero::BboArbiter::DEPTH));
+  return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file reference_book.h
+ * @brief Test helpers: a plain map-based book to check decoded or merged
+ *        updates against, and random update sides
+ */
+
+#ifndef AERO_TESTS_REFERENCE_BOOK_H
+#define AERO_TESTS_REFERENCE_BOOK_H
+
+#include "modules/exchange/exchange_adapter.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace aero::test {
+
+constexpr uint64_t TICK = 10000000; // 0.1 in PRICE_SCALE units
+
+// A consumer's view of one symbol: the book as the gateway applied it
+struct ReferenceBook {
+  std::map<uint64_t, double, std::greater<uint64_t>> bids;
+  std::map<uint64_t, double> asks;
+
+  void apply(const ParsedOrderBook &book) {
+    if (book.is_snapshot) {
+      bids.clear();
+      asks.clear();
+    }
+    for (const PriceLevel &l : book.bids)
+      set(bids, l);
+    for (const PriceLevel &l : book.asks)
+      set(asks, l);
+  }
+
+  template <typename Side> static void set(Side &side, const PriceLevel &l) {
+    if (l.size > 0.0)
+      side[l.price_int] = l.size;
+    else
+      side.erase(l.price_int);
+  }
+
+  bool operator==(const ReferenceBook &o) const {
+    return bids == o.bids && asks == o.asks;
+  }
+};
+
+// Shape of the levels random_side() draws
+struct RandomSide {
+  uint64_t first_tick; // Prices in [first_tick, first_tick + ticks) * TICK
+  uint64_t ticks;
+  size_t max_levels;   // Up to max_levels - 1 draws (duplicates skipped)
+  uint64_t size_steps; // Sizes k / size_scale, k in [1, size_steps]
+  double size_scale;
+  uint32_t removal_one_in = 0; // One draw in this many is a removal (0: none)
+};
+
+// One side of an update: distinct prices, in no particular order
+inline std::vector<PriceLevel> random_side(std::mt19937_64 &rng,
+                                           const RandomSide &spec) {
+  std::set<uint64_t> used;
+  std::vector<PriceLevel> side;
+  size_t count = rng() % spec.max_levels;
+  for (size_t i = 0; i < count; i++) {
+    uint64_t price = (spec.first_tick + rng() % spec.ticks) * TICK;
+    if (!used.insert(price).second)
+      continue;
+    double size = spec.removal_one_in != 0 && rng() % spec.removal_one_in == 0
+                      ? 0.0
+                      : static_cast<double>(1 + rng() % spec.size_steps) /
+                            spec.size_scale;
+    side.push_back({price, size});
+  }
+  return side;
+}
+
+} // namespace aero::test
+
+#endif // AERO_TESTS_REFERENCE_BOOK_H
@@ -0,0 +1,130 @@
+/**
+ * @file test_arbitrage_engine.cpp
+ * @brief Cross-exchange opportunity state machine: OPEN, UPDATE and CLOSE on
+ *        quote changes, and CLOSE once a leg goes quiet
+ */
+
+#include "core/tsc_clock.h"
+#include "modules/common/symbol_registry.h"
+#include "modules/strategy/arbitrage_engine.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+
+class ArbitrageEngineTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ArbitrageEngine::Config cfg;
+    cfg.min_edge_bps = 1.0;
+    cfg.max_leg_age_ms = 500;
+    engine.configure(cfg);
+    engine.set_handler(
+        [this](const ArbOpportunity &opp) { events.push_back(opp); });
+    // Both map to ARBT-USDT-PERP
+    okx = SymbolRegistry::instance().get_or_assign(ExchangeId::OKX,
+                                                   "ARBT-USDT-SWAP");
+    bybit = SymbolRegistry::instance().get_or_assign(ExchangeId::BYBIT,
+                                                     "ARBTUSDT");
+    t0 = TscClock::now_tsc();
+  }
+
+  uint64_t at_ms(uint64_t ms) const {
+    return t0 + TscClock::instance().ns_to_tsc(ms * 1000000ULL);
+  }
+
+  void quote(ExchangeId venue, uint64_t bid, uint64_t ask, uint64_t ms) {
+    BestBidOffer bbo{bid * SCALE, 1.0, ask * SCALE, 1.0};
+    engine.on_bbo(venue, venue == ExchangeId::OKX ? okx : bybit, &bbo,
+                  at_ms(ms));
+  }
+
+  ArbitrageEngine engine;
+  std::vector<ArbOpportunity> events;
+  uint32_t okx = 0;
+  uint32_t bybit = 0;
+  uint64_t t0 = 0;
+};
+
+} // namespace
+
+TEST_F(ArbitrageEngineTest, OpenUpdateClose) {
+  quote(ExchangeId::OKX, 99, 100, 0);
+  quote(ExchangeId::BYBIT, 101, 102, 10); // Buy OKX at 100, sell Bybit at 101
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(ArbOpportunity::OPEN, events[0].state);
+  EXPECT_EQ(ExchangeId::OKX, events[0].buy_exchange);
+  EXPECT_EQ(ExchangeId::BYBIT, events[0].sell_exchange);
+  EXPECT_EQ(100 * SCALE, events[0].buy_price);
+  EXPECT_EQ(101 * SCALE, events[0].sell_price);
+  EXPECT_EQ(1u, engine.opened());
+
+  quote(ExchangeId::BYBIT, 102, 103, 20);
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ(ArbOpportunity::UPDATE, events[1].state);
+  EXPECT_EQ(102 * SCALE, events[1].sell_price);
+
+  quote(ExchangeId::BYBIT, 100, 101, 30); // Edge gone
+  ASSERT_EQ(3u, events.size());
+  EXPECT_EQ(ArbOpportunity::CLOSE, events[2].state);
+  EXPECT_EQ(1u, engine.opened());
+}
+
+TEST_F(ArbitrageEngineTest, EmptyLegCloses) {
+  quote(ExchangeId::OKX, 99, 100, 0);
+  quote(ExchangeId::BYBIT, 101, 102, 10);
+  ASSERT_EQ(1u, events.size());
+  engine.on_bbo(ExchangeId::OKX, okx, nullptr, at_ms(20));
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ(ArbOpportunity::CLOSE, events[1].state);
+}
+
+TEST_F(ArbitrageEngineTest, StaleLegDoesNotOpen) {
+  quote(ExchangeId::OKX, 99, 100, 0);
+  quote(ExchangeId::BYBIT, 101, 102, 600);
+  EXPECT_TRUE(events.empty());
+}
+
+// The moving leg keeps repeating itself while the other one went silent
+TEST_F(ArbitrageEngineTest, UnchangedQuoteClosesOnSilentLeg) {
+  quote(ExchangeId::OKX, 99, 100, 0);
+  quote(ExchangeId::BYBIT, 101, 102, 10);
+  ASSERT_EQ(1u, events.size());
+
+  quote(ExchangeId::BYBIT, 101, 102, 400); // OKX still within 500 ms
+  EXPECT_EQ(1u, events.size());
+  quote(ExchangeId::BYBIT, 101, 102, 600);
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ(ArbOpportunity::CLOSE, events[1].state);
+  quote(ExchangeId::BYBIT, 101, 102, 700);
+  EXPECT_EQ(2u, events.size());
+}
+
+// An unchanged quote refreshes its leg without re-emitting
+TEST_F(ArbitrageEngineTest, UnchangedQuoteKeepsLegFresh) {
+  quote(ExchangeId::OKX, 99, 100, 0);
+  quote(ExchangeId::BYBIT, 101, 102, 10);
+  quote(ExchangeId::OKX, 99, 100, 400);
+  EXPECT_EQ(1u, events.size());
+  quote(ExchangeId::BYBIT, 102, 103, 800); // OKX spoke 400 ms ago
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ(ArbOpportunity::UPDATE, events[1].state);
+}
+
+TEST_F(ArbitrageEngineTest, ExpireClosesWhenBothLegsGoQuiet) {
+  quote(ExchangeId::OKX, 99, 100, 0);
+  quote(ExchangeId::BYBIT, 101, 102, 10);
+  ASSERT_EQ(1u, events.size());
+
+  engine.expire(at_ms(300));
+  EXPECT_EQ(1u, events.size());
+  engine.expire(at_ms(600)); // OKX leg is 600 ms old
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ(ArbOpportunity::CLOSE, events[1].state);
+  engine.expire(at_ms(2000));
+  EXPECT_EQ(2u, events.size());
+}
@@ -0,0 +1,208 @@
+/**
+ * @file test_bbo_channels.cpp
+ * @brief Top-of-book channels: OKX bbo-tbt and Bybit orderbook.1 parsing,
+ *        including Bybit deltas that only carry the side that changed, and
+ *        the newest-wins arbiter against the depth feed
+ */
+
+#include "modules/common/symbol_registry.h"
+#include "modules/exchange/bybit_adapter.h"
+#include "modules/exchange/feed_sinks.h"
+#include "modules/exchange/okx_adapter.h"
+#include "modules/market_data/bbo_arbiter.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+
+bool parse(IExchangeAdapter &adapter, const std::string &msg, ParsedBbo &out) {
+  return adapter.parse_bbo_message(msg.data(), msg.size(), out);
+}
+
+std::string bybit_bbo(const char *type, const char *bids, const char *asks,
+                      uint64_t ts) {
+  return std::string(R"({"topic":"orderbook.1.BTCUSDT","type":")") + type +
+         R"(","ts":)" + std::to_string(ts) + R"(,"data":{"s":"BTCUSDT","b":)" +
+         bids + R"(,"a":)" + asks + R"(,"u":1,"seq":2},"cts":1})";
+}
+
+} // namespace
+
+TEST(BboChannels, OkxBboTbt) {
+  OkxAdapter okx;
+  ParsedBbo bbo;
+  ASSERT_TRUE(parse(okx,
+                    R"({"arg":{"channel":"bbo-tbt","instId":"BTC-USDT-SWAP"},)"
+                    R"("data":[{"asks":[["65001.5","2","0","1"]],)"
+                    R"("bids":[["65000.1","3.5","0","2"]],)"
+                    R"("ts":"1700000000123","seqId":9}]})",
+                    bbo));
+  EXPECT_EQ("BTC-USDT-SWAP", bbo.instrument);
+  EXPECT_EQ(6500010000000u, bbo.bid_price);
+  EXPECT_DOUBLE_EQ(3.5, bbo.bid_qty);
+  EXPECT_EQ(6500150000000u, bbo.ask_price);
+  EXPECT_DOUBLE_EQ(2.0, bbo.ask_qty);
+  EXPECT_EQ(1700000000123u, bbo.timestamp_ms);
+}
+
+TEST(BboChannels, OkxIgnoresDepthAndEvents) {
+  OkxAdapter okx;
+  ParsedBbo bbo;
+  EXPECT_FALSE(parse(okx,
+                     R"({"arg":{"channel":"books5","instId":"BTC-USDT"},)"
+                     R"("data":[{"asks":[],"bids":[],"ts":"1"}]})",
+                     bbo));
+  EXPECT_FALSE(parse(okx,
+                     R"({"event":"subscribe","arg":{"channel":"bbo-tbt",)"
+                     R"("instId":"BTC-USDT"},"connId":"a"})",
+                     bbo));
+}
+
+TEST(BboChannels, BybitSnapshot) {
+  BybitAdapter bybit;
+  ParsedBbo bbo;
+  ASSERT_TRUE(parse(bybit,
+                    bybit_bbo("snapshot", R"([["100.5","2"]])",
+                              R"([["100.6","3"]])", 1000),
+                    bbo));
+  EXPECT_EQ("BTCUSDT", bbo.instrument);
+  EXPECT_EQ(1005 * SCALE / 10, bbo.bid_price);
+  EXPECT_DOUBLE_EQ(2.0, bbo.bid_qty);
+  EXPECT_EQ(1006 * SCALE / 10, bbo.ask_price);
+  EXPECT_DOUBLE_EQ(3.0, bbo.ask_qty);
+  EXPECT_EQ(1000u, bbo.timestamp_ms);
+}
+
+// Deltas leave the unchanged side's array empty: it keeps its last value
+TEST(BboChannels, BybitDeltaMergesChangedSide) {
+  BybitAdapter bybit;
+  ParsedBbo bbo;
+  ASSERT_TRUE(parse(bybit,
+                    bybit_bbo("snapshot", R"([["100.5","2"]])",
+                              R"([["100.6","3"]])", 1000),
+                    bbo));
+
+  ASSERT_TRUE(
+      parse(bybit, bybit_bbo("delta", "[]", R"([["100.7","1"]])", 1001), bbo));
+  EXPECT_EQ(1005 * SCALE / 10, bbo.bid_price);
+  EXPECT_DOUBLE_EQ(2.0, bbo.bid_qty);
+  EXPECT_EQ(1007 * SCALE / 10, bbo.ask_price);
+  EXPECT_DOUBLE_EQ(1.0, bbo.ask_qty);
+
+  ASSERT_TRUE(
+      parse(bybit, bybit_bbo("delta", R"([["100.4","5"]])", "[]", 1002), bbo));
+  EXPECT_EQ(1004 * SCALE / 10, bbo.bid_price);
+  EXPECT_DOUBLE_EQ(5.0, bbo.bid_qty);
+  EXPECT_EQ(1007 * SCALE / 10, bbo.ask_price);
+  EXPECT_EQ(1002u, bbo.timestamp_ms);
+}
+
+TEST(BboChannels, BybitSnapshotReplacesBothSides) {
+  BybitAdapter bybit;
+  ParsedBbo bbo;
+  ASSERT_TRUE(parse(bybit,
+                    bybit_bbo("snapshot", R"([["100.5","2"]])",
+                              R"([["100.6","3"]])", 1000),
+                    bbo));
+  // An empty side in a snapshot means the side is empty, not unchanged
+  ASSERT_TRUE(parse(bybit, bybit_bbo("snapshot", R"([["99","1"]])", "[]", 1001),
+                    bbo));
+  EXPECT_EQ(99 * SCALE, bbo.bid_price);
+  EXPECT_EQ(0u, bbo.ask_price);
+}
+
+TEST(BboChannels, BybitZeroSizeEmptiesSide) {
+  BybitAdapter bybit;
+  ParsedBbo bbo;
+  ASSERT_TRUE(parse(bybit,
+                    bybit_bbo("snapshot", R"([["100.5","2"]])",
+                              R"([["100.6","3"]])", 1000),
+                    bbo));
+  ASSERT_TRUE(
+      parse(bybit, bybit_bbo("delta", R"([["100.5","0"]])", "[]", 1001), bbo));
+  EXPECT_EQ(0u, bbo.bid_price);
+  EXPECT_EQ(1006 * SCALE / 10, bbo.ask_price);
+}
+
+TEST(BboChannels, BybitQuotesKeptPerInstrument) {
+  BybitAdapter bybit;
+  ParsedBbo bbo;
+  ASSERT_TRUE(parse(bybit,
+                    bybit_bbo("snapshot", R"([["100.5","2"]])",
+                              R"([["100.6","3"]])", 1000),
+                    bbo));
+  std::string eth = R"({"topic":"orderbook.1.ETHUSDT","type":"delta","ts":5,)"
+                    R"("data":{"s":"ETHUSDT","b":[],"a":[["3000","1"]]}})";
+  ASSERT_TRUE(parse(bybit, eth, bbo));
+  EXPECT_EQ("ETHUSDT", bbo.instrument);
+  EXPECT_EQ(0u, bbo.bid_price); // Never seen a bid for ETHUSDT
+  EXPECT_EQ(3000 * SCALE, bbo.ask_price);
+}
+
+TEST(BboChannels, BybitIgnoresDepth) {
+  BybitAdapter bybit;
+  ParsedBbo bbo;
+  std::string depth = R"({"topic":"orderbook.50.BTCUSDT","type":"snapshot",)"
+                      R"("ts":1,"data":{"s":"BTCUSDT","b":[],"a":[]}})";
+  EXPECT_FALSE(parse(bybit, depth, bbo));
+}
+
+// --- Newest-wins arbitration between the channel and the depth feed ---
+
+TEST(BboArbiter, OlderCandidateIsStale) {
+  BboArbiter arb;
+  EXPECT_TRUE(arb.accept(1, 1000, BboArbiter::CHANNEL));
+  EXPECT_FALSE(arb.accept(1, 999, BboArbiter::DEPTH));
+  EXPECT_TRUE(arb.accept(1, 1000, BboArbiter::DEPTH)); // As new: accepted
+  EXPECT_TRUE(arb.accept(1, 1001, BboArbiter::DEPTH));
+  EXPECT_FALSE(arb.accept(1, 1000, BboArbiter::CHANNEL));
+  EXPECT_EQ(1u, arb.accepted(BboArbiter::CHANNEL));
+  EXPECT_EQ(1u, arb.stale(BboArbiter::CHANNEL));
+  EXPECT_EQ(2u, arb.accepted(BboArbiter::DEPTH));
+  EXPECT_EQ(1u, arb.stale(BboArbiter::DEPTH));
+}
+
+TEST(BboArbiter, SymbolsAreIndependent) {
+  BboArbiter arb;
+  EXPECT_TRUE(arb.accept(7, 5000, BboArbiter::CHANNEL));
+  EXPECT_TRUE(arb.accept(2, 10, BboArbiter::DEPTH));
+  EXPECT_TRUE(arb.fresh(3, 1));
+}
+
+TEST(BboArbiter, UntimedCandidateLeavesReference) {
+  BboArbiter arb;
+  EXPECT_TRUE(arb.accept(1, 1000, BboArbiter::CHANNEL));
+  EXPECT_TRUE(arb.accept(1, 0, BboArbiter::DEPTH));
+  EXPECT_FALSE(arb.fresh(1, 999));
+  EXPECT_TRUE(arb.fresh(1, 1000));
+  EXPECT_TRUE(arb.fresh(1, 0));
+}
+
+// A one-sided channel quote must not become the newest top of book
+TEST(BboArbiter, OneSidedChannelQuoteNotArbitrated) {
+  BboArbiter arb;
+  FeedSinks sinks;
+  sinks.bbo_arbiter = &arb;
+
+  ParsedBbo bbo;
+  bbo.instrument = "ARB-ONE-SIDED";
+  bbo.bid_price = 100 * SCALE;
+  bbo.bid_qty = 1.0;
+  bbo.timestamp_ms = 2000;
+  route_bbo(sinks, ExchangeId::OKX, bbo);
+  EXPECT_EQ(0u, arb.accepted(BboArbiter::CHANNEL));
+
+  uint32_t id = SymbolRegistry::instance().get_or_assign(ExchangeId::OKX,
+                                                         bbo.instrument);
+  EXPECT_TRUE(arb.accept(id, 1500, BboArbiter::DEPTH));
+
+  bbo.ask_price = 101 * SCALE;
+  bbo.ask_qty = 1.0;
+  route_bbo(sinks, ExchangeId::OKX, bbo);
+  EXPECT_EQ(1u, arb.accepted(BboArbiter::CHANNEL));
+  EXPECT_FALSE(arb.fresh(id, 1500));
+}
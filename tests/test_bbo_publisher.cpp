@@ -0,0 +1,140 @@
+/**
+ * @file test_bbo_publisher.cpp
+ * @brief Top-of-book fast channel: 64-byte records sent only on change,
+ *        received on a loopback socket
+ */
+
+#include "aero/feed_protocol.h"
+#include "modules/network/bbo_publisher.h"
+#include <arpa/inet.h>
+#include <cstring>
+#include <endian.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+
+class BboPublisherTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)));
+    socklen_t len = sizeof(addr);
+    ASSERT_EQ(0, getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len));
+    timeval tv{2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ASSERT_TRUE(pub.init("127.0.0.1", ntohs(addr.sin_port)));
+  }
+
+  void TearDown() override {
+    pub.close();
+    ::close(fd);
+  }
+
+  bool update(uint64_t bid, double bid_qty, uint64_t ask,
+              const BboAnalytics *analytics = nullptr) {
+    return pub.update(ExchangeId::BYBIT, 12, "BBOPUBUSDT",
+                      BboQuote{bid * SCALE, bid_qty, ask * SCALE, 1.0},
+                      1700000000123, 99, analytics);
+  }
+
+  // Next record, or msg_type 0 if none is waiting (or it is not 64 bytes)
+  const FeedBboRecord &receive(bool wait = true) {
+    std::memset(buf, 0, sizeof(buf));
+    ssize_t n = recv(fd, buf, sizeof(buf), wait ? 0 : MSG_DONTWAIT);
+    if (n != static_cast<ssize_t>(sizeof(FeedBboRecord)))
+      std::memset(buf, 0, sizeof(buf));
+    return buf[0];
+  }
+
+  int fd = -1;
+  BboPublisher pub;
+  FeedBboRecord buf[2]; // Room to detect oversized datagrams
+};
+
+} // namespace
+
+TEST_F(BboPublisherTest, FirstUpdateAnnouncesTheSymbol) {
+  ASSERT_TRUE(update(100, 1.5, 101));
+
+  const auto &sym = reinterpret_cast<const FeedBboSymbol &>(receive());
+  EXPECT_EQ(FEED_BBO_MAGIC, le16toh(sym.magic));
+  EXPECT_EQ(FEED_BBO_SYMBOL, sym.msg_type);
+  EXPECT_EQ(12u, le32toh(sym.symbol_id));
+  EXPECT_EQ(1u, le64toh(sym.seq_num));
+  EXPECT_STREQ("BBOPUBUSDT", sym.name);
+
+  const FeedBboRecord &r = receive();
+  EXPECT_EQ(FEED_BBO_UPDATE, r.msg_type);
+  EXPECT_EQ(static_cast<uint8_t>(ExchangeId::BYBIT), r.exchange_id);
+  EXPECT_EQ(2u, le64toh(r.seq_num));
+  EXPECT_EQ(100 * SCALE, le64toh(r.bid_price));
+  EXPECT_EQ(feed_fixed_qty(1.5), le64toh(r.bid_qty));
+  EXPECT_EQ(101 * SCALE, le64toh(r.ask_price));
+  EXPECT_EQ(1700000000123000000u, le64toh(r.exchange_ts_ns));
+  EXPECT_EQ(99u, le64toh(r.gateway_tsc));
+  EXPECT_EQ(2u, pub.records_sent());
+}
+
+TEST_F(BboPublisherTest, OnlyChangesAreSent) {
+  ASSERT_TRUE(update(100, 1.5, 101));
+  receive();
+  receive();
+
+  EXPECT_FALSE(update(100, 1.5, 101));
+  EXPECT_EQ(1u, pub.unchanged());
+  EXPECT_EQ(0, receive(false).msg_type);
+
+  ASSERT_TRUE(update(100, 2.0, 101)); // Size alone is a change
+  const FeedBboRecord &r = receive();
+  EXPECT_EQ(FEED_BBO_UPDATE, r.msg_type);
+  EXPECT_EQ(3u, le64toh(r.seq_num));
+  EXPECT_EQ(feed_fixed_qty(2.0), le64toh(r.bid_qty));
+}
+
+TEST_F(BboPublisherTest, AnalyticsFollowTheQuoteOrGoAlone) {
+  BboAnalytics a{};
+  a.microprice = 100.5 * SCALE;
+  a.bid_depth[0] = 1.5;
+  a.ask_depth[0] = 1.0;
+  ASSERT_TRUE(update(100, 1.5, 101, &a));
+  receive(); // Symbol
+  EXPECT_EQ(FEED_BBO_UPDATE, receive().msg_type);
+  const auto &ana = reinterpret_cast<const FeedBboAnalytics &>(receive());
+  ASSERT_EQ(FEED_BBO_ANALYTICS, ana.msg_type);
+  EXPECT_EQ(static_cast<uint64_t>(100.5 * SCALE), le64toh(ana.microprice));
+  EXPECT_DOUBLE_EQ(0.2, feed_bbo_imbalance(ana, 0));
+
+  EXPECT_FALSE(update(100, 1.5, 101, &a));
+
+  a.ask_depth[0] = 3.0; // Deeper book moved, top did not
+  ASSERT_TRUE(update(100, 1.5, 101, &a));
+  EXPECT_EQ(FEED_BBO_ANALYTICS, receive().msg_type);
+  EXPECT_EQ(0, receive(false).msg_type);
+}
+
+TEST_F(BboPublisherTest, TradesAreNeverDeduplicated) {
+  for (int i = 0; i < 2; i++) {
+    pub.trade(ExchangeId::BYBIT, 12, "BBOPUBUSDT", 100 * SCALE, 0.5, true,
+              1700000000200, 7);
+  }
+  receive(); // Symbol
+  for (int i = 0; i < 2; i++) {
+    const auto &t = reinterpret_cast<const FeedBboTrade &>(receive());
+    ASSERT_EQ(FEED_BBO_TRADE, t.msg_type);
+    EXPECT_EQ(100 * SCALE, le64toh(t.price));
+    EXPECT_EQ(feed_fixed_qty(0.5), le64toh(t.qty));
+    EXPECT_EQ(1, t.side);
+  }
+}
@@ -0,0 +1,200 @@
+/**
+ * @file test_book_analytics.cpp
+ * @brief Book analytics: the sums LadderAnalytics adjusts per level change
+ *        match a full recompute from the ladder after random changes
+ */
+
+#include "modules/market_data/book_analytics.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace aero;
+
+namespace {
+
+using BidLadder = std::map<uint64_t, double, std::greater<uint64_t>>;
+using AskLadder = std::map<uint64_t, double, std::less<uint64_t>>;
+
+constexpr uint64_t BASE_PRICE = 1000000;
+constexpr uint64_t PRICE_RANGE = 48; // Ticks levels are drawn from
+
+// Depth windows and VWAP-to-size recomputed by walking the ladder
+template <typename Ladder>
+void recompute(const Ladder &ladder, const BookAnalyticsConfig &cfg,
+               double *depth, double &vwap) {
+  for (uint32_t w = 0; w < cfg.level_count; w++) {
+    depth[w] = 0.0;
+    uint32_t n = 0;
+    for (auto it = ladder.begin();
+         it != ladder.end() && n < cfg.depth_levels[w]; ++it, ++n)
+      depth[w] += it->second;
+  }
+  vwap = 0.0;
+  if (cfg.vwap_qty <= 0.0)
+    return;
+  double qty = 0.0, cost = 0.0;
+  for (const auto &[price, size] : ladder) {
+    if (qty + size >= cfg.vwap_qty) {
+      vwap = (cost + static_cast<double>(price) * (cfg.vwap_qty - qty)) /
+             cfg.vwap_qty;
+      return;
+    }
+    qty += size;
+    cost += static_cast<double>(price) * size;
+  }
+}
+
+// Incremental against recomputed; `tol` is relative (0 = exact)
+template <typename Ladder>
+void expect_matches(const LadderAnalytics<Ladder> &a, const Ladder &ladder,
+                    double tol, const char *where) {
+  const BookAnalyticsConfig &cfg = a.config();
+  BookAnalytics got{};
+  a.read(got, true);
+  double depth[BookAnalytics::MAX_LEVELS];
+  double vwap;
+  recompute(ladder, cfg, depth, vwap);
+  for (uint32_t w = 0; w < cfg.level_count; w++)
+    EXPECT_NEAR(got.bid_depth[w], depth[w], tol * std::max(1.0, depth[w]))
+        << where << ", window " << cfg.depth_levels[w] << " of "
+        << ladder.size() << " levels";
+  EXPECT_NEAR(got.bid_vwap, vwap, tol * std::max(1.0, vwap))
+      << where << ", vwap_qty " << cfg.vwap_qty;
+}
+
+// Dyadic sizes: every sum is exact in a double, so the incremental result
+// must equal the recompute bit for bit
+double exact_qty(std::mt19937_64 &rng) {
+  return static_cast<double>(1 + rng() % 800) / 8.0;
+}
+
+double real_qty(std::mt19937_64 &rng) {
+  return std::uniform_real_distribution<double>(0.0001, 250.0)(rng);
+}
+
+/**
+ * Random inserts, size changes and removals within PRICE_RANGE ticks, with
+ * the odd removal of every level and snapshot-style reset, checked after
+ * every change
+ */
+template <typename Ladder>
+void run_random(const BookAnalyticsConfig &cfg, uint64_t seed, int steps,
+                double (*qty_of)(std::mt19937_64 &), double tol) {
+  std::mt19937_64 rng(seed);
+  Ladder ladder;
+  LadderAnalytics<Ladder> a;
+  a.configure(cfg);
+  a.reset(ladder);
+
+  for (int step = 0; step < steps; step++) {
+    uint32_t op = rng() % 100;
+    if (op == 0) {
+      // Side emptied level by level, best first or worst first
+      std::vector<uint64_t> prices;
+      for (const auto &[price, size] : ladder)
+        prices.push_back(price);
+      if (rng() & 1)
+        std::reverse(prices.begin(), prices.end());
+      for (uint64_t price : prices) {
+        a.set(ladder, price, 0.0);
+        expect_matches(a, ladder, tol, "clearing");
+      }
+      continue;
+    }
+    if (op == 1) {
+      // Snapshot: the map replaced, then the sums recomputed
+      ladder.clear();
+      for (uint32_t i = rng() % 30; i > 0; i--)
+        ladder[BASE_PRICE + rng() % PRICE_RANGE] = qty_of(rng);
+      a.reset(ladder);
+      expect_matches(a, ladder, tol, "snapshot");
+      continue;
+    }
+
+    uint64_t price = BASE_PRICE + rng() % PRICE_RANGE;
+    // Removals about a third of the time keep the side around half full
+    double qty = op < 35 ? 0.0 : qty_of(rng);
+    a.set(ladder, price, qty);
+    ASSERT_EQ(ladder.count(price), qty > 0.0 ? 1u : 0u);
+    expect_matches(a, ladder, tol, qty > 0.0 ? "set" : "remove");
+    if (::testing::Test::HasFailure())
+      FAIL() << "seed " << seed << ", step " << step << ", price " << price
+             << ", qty " << qty;
+  }
+}
+
+std::vector<BookAnalyticsConfig> configs() {
+  std::vector<BookAnalyticsConfig> out;
+  out.push_back({}); // Defaults: 5/10/20 levels, no VWAP
+  out.push_back({{1, 2, 3}, 3, 1.0});
+  out.push_back({{5, 10, 20}, 3, 100.0});
+  out.push_back({{8, 0, 0}, 1, 2500.0}); // Size often beyond the side
+  out.push_back({{64, 1, 16}, 3, 0.125});
+  return out;
+}
+
+template <typename Ladder> class LadderAnalyticsTest : public ::testing::Test {
+};
+
+using Ladders = ::testing::Types<BidLadder, AskLadder>;
+TYPED_TEST_SUITE(LadderAnalyticsTest, Ladders);
+
+} // namespace
+
+TYPED_TEST(LadderAnalyticsTest, ExactSizesMatchRecompute) {
+  uint64_t seed = 1;
+  for (const BookAnalyticsConfig &cfg : configs())
+    run_random<TypeParam>(cfg, seed++, 20000, exact_qty, 0.0);
+}
+
+TYPED_TEST(LadderAnalyticsTest, RealSizesMatchRecompute) {
+  uint64_t seed = 100;
+  for (const BookAnalyticsConfig &cfg : configs())
+    run_random<TypeParam>(cfg, seed++, 20000, real_qty, 1e-9);
+}
+
+// Past RESYNC_CHANGES the sums are recomputed in the middle of a run
+TYPED_TEST(LadderAnalyticsTest, MatchesAcrossResync) {
+  run_random<TypeParam>({{3, 10, 40}, 3, 50.0}, 7,
+                        LadderAnalytics<TypeParam>::RESYNC_CHANGES + 5000,
+                        real_qty, 1e-9);
+}
+
+TYPED_TEST(LadderAnalyticsTest, ZeroDepthWindowIsOneLevel) {
+  TypeParam ladder;
+  LadderAnalytics<TypeParam> a;
+  a.configure({{0, 2, 0}, 2, 0.0});
+  EXPECT_EQ(a.config().depth_levels[0], 1u);
+  a.reset(ladder);
+  a.set(ladder, BASE_PRICE, 2.0);
+  a.set(ladder, BASE_PRICE + 1, 3.0);
+  expect_matches(a, ladder, 0.0, "two levels");
+  BookAnalytics out{};
+  a.read(out, true);
+  EXPECT_EQ(out.bid_depth[0], ladder.begin()->second);
+  EXPECT_EQ(out.bid_depth[1], 5.0);
+}
+
+TYPED_TEST(LadderAnalyticsTest, VwapIsZeroWhileTooThin) {
+  TypeParam ladder;
+  LadderAnalytics<TypeParam> a;
+  a.configure({{5, 10, 20}, 1, 10.0});
+  a.reset(ladder);
+  a.set(ladder, BASE_PRICE, 4.0);
+  a.set(ladder, BASE_PRICE + 2, 5.0);
+  BookAnalytics out{};
+  a.read(out, true);
+  EXPECT_EQ(out.bid_vwap, 0.0);
+  a.set(ladder, BASE_PRICE + 1, 1.0);
+  a.read(out, true);
+  // All three levels: (4 * B + 1 * (B + 1) + 5 * (B + 2)) / 10
+  EXPECT_DOUBLE_EQ(out.bid_vwap, static_cast<double>(BASE_PRICE) + 1.1);
+  a.set(ladder, BASE_PRICE + 1, 0.0);
+  a.read(out, true);
+  EXPECT_EQ(out.bid_vwap, 0.0);
+}
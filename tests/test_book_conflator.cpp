@@ -0,0 +1,202 @@
+/**
+ * @file test_book_conflator.cpp
+ * @brief BookConflator merge logic: folding deltas, superseding snapshots,
+ *        FIFO draining
+ */
+
+#include "modules/market_data/book_conflator.h"
+#include "reference_book.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace aero;
+using namespace aero::test;
+
+namespace {
+
+ParsedOrderBook make_book(bool is_snapshot, std::vector<PriceLevel> bids,
+                          std::vector<PriceLevel> asks, uint64_t ts_ms = 0,
+                          uint64_t rx_tsc = 0) {
+  ParsedOrderBook book;
+  book.instrument = "BTC-USDT";
+  book.is_snapshot = is_snapshot;
+  book.bids = std::move(bids);
+  book.asks = std::move(asks);
+  book.timestamp_ms = ts_ms;
+  book.rx_tsc = rx_tsc;
+  return book;
+}
+
+// Drains everything pending into a vector of (id, book)
+std::vector<std::pair<uint32_t, ParsedOrderBook>>
+drain_all(BookConflator &c) {
+  std::vector<std::pair<uint32_t, ParsedOrderBook>> out;
+  c.drain([&](uint32_t id, ExchangeId, const ParsedOrderBook &book) {
+    out.emplace_back(id, book);
+    return true;
+  });
+  return out;
+}
+
+std::vector<uint64_t> prices(const std::vector<PriceLevel> &side) {
+  std::vector<uint64_t> out;
+  for (const PriceLevel &l : side)
+    out.push_back(l.price_int);
+  return out;
+}
+
+} // namespace
+
+TEST(BookConflator, LatestSizeWinsAndRemovalsSurviveInDeltas) {
+  BookConflator c;
+  c.add(0, ExchangeId::OKX,
+        make_book(false, {{100 * TICK, 1.0}, {99 * TICK, 2.0}},
+                  {{101 * TICK, 1.0}}));
+  c.add(0, ExchangeId::OKX,
+        make_book(false, {{100 * TICK, 3.0}, {98 * TICK, 0.0}},
+                  {{101 * TICK, 0.0}, {102 * TICK, 4.0}}));
+  EXPECT_EQ(1u, c.size());
+  EXPECT_EQ(1u, c.merged());
+
+  auto out = drain_all(c);
+  ASSERT_EQ(1u, out.size());
+  const ParsedOrderBook &m = out[0].second;
+  EXPECT_FALSE(m.is_snapshot);
+  // Best first, one entry per price; removals stay so the consumer drops
+  // the levels it still holds
+  EXPECT_EQ((std::vector<uint64_t>{100 * TICK, 99 * TICK, 98 * TICK}),
+            prices(m.bids));
+  EXPECT_DOUBLE_EQ(3.0, m.bids[0].size);
+  EXPECT_DOUBLE_EQ(2.0, m.bids[1].size);
+  EXPECT_DOUBLE_EQ(0.0, m.bids[2].size);
+  EXPECT_EQ((std::vector<uint64_t>{101 * TICK, 102 * TICK}), prices(m.asks));
+  EXPECT_DOUBLE_EQ(0.0, m.asks[0].size);
+  EXPECT_DOUBLE_EQ(4.0, m.asks[1].size);
+  EXPECT_TRUE(c.empty());
+}
+
+TEST(BookConflator, SnapshotSupersedesPendingDelta) {
+  BookConflator c;
+  c.add(0, ExchangeId::OKX,
+        make_book(false, {{100 * TICK, 1.0}}, {{101 * TICK, 1.0}}));
+  c.add(0, ExchangeId::OKX,
+        make_book(true, {{95 * TICK, 5.0}, {96 * TICK, 6.0}},
+                  {{97 * TICK, 7.0}}));
+
+  auto out = drain_all(c);
+  ASSERT_EQ(1u, out.size());
+  const ParsedOrderBook &m = out[0].second;
+  EXPECT_TRUE(m.is_snapshot);
+  EXPECT_EQ((std::vector<uint64_t>{96 * TICK, 95 * TICK}), prices(m.bids));
+  EXPECT_EQ((std::vector<uint64_t>{97 * TICK}), prices(m.asks));
+  EXPECT_EQ(1u, c.merged());
+}
+
+TEST(BookConflator, DeltaOnPendingSnapshotStaysSnapshot) {
+  BookConflator c;
+  c.add(0, ExchangeId::OKX,
+        make_book(true, {{100 * TICK, 1.0}, {99 * TICK, 2.0}},
+                  {{101 * TICK, 1.0}}));
+  c.add(0, ExchangeId::OKX,
+        make_book(false, {{99 * TICK, 0.0}, {98 * TICK, 0.0}},
+                  {{102 * TICK, 3.0}}));
+
+  auto out = drain_all(c);
+  ASSERT_EQ(1u, out.size());
+  const ParsedOrderBook &m = out[0].second;
+  EXPECT_TRUE(m.is_snapshot);
+  // A snapshot carries no removals: the removed level is simply gone
+  EXPECT_EQ((std::vector<uint64_t>{100 * TICK}), prices(m.bids));
+  EXPECT_EQ((std::vector<uint64_t>{101 * TICK, 102 * TICK}), prices(m.asks));
+}
+
+TEST(BookConflator, SnapshotDropsItsOwnRemovals) {
+  BookConflator c;
+  c.add(0, ExchangeId::OKX,
+        make_book(true, {{100 * TICK, 0.0}, {99 * TICK, 2.0}}, {}));
+  auto out = drain_all(c);
+  ASSERT_EQ(1u, out.size());
+  EXPECT_EQ((std::vector<uint64_t>{99 * TICK}), prices(out[0].second.bids));
+}
+
+TEST(BookConflator, NewestTimestampOldestRxTsc) {
+  BookConflator c;
+  c.add(0, ExchangeId::OKX, make_book(false, {{100 * TICK, 1.0}}, {}, 10, 500));
+  c.add(0, ExchangeId::OKX, make_book(false, {{100 * TICK, 2.0}}, {}, 20, 900));
+  c.add(0, ExchangeId::OKX, make_book(true, {{100 * TICK, 3.0}}, {}, 30, 950));
+
+  auto out = drain_all(c);
+  ASSERT_EQ(1u, out.size());
+  EXPECT_EQ(30u, out[0].second.timestamp_ms);
+  EXPECT_EQ(500u, out[0].second.rx_tsc); // Latency covers the wait here
+}
+
+TEST(BookConflator, DrainsInFirstPendingOrderAndStopsOnRefusal) {
+  BookConflator c;
+  c.add(7, ExchangeId::BYBIT, make_book(false, {{1 * TICK, 1.0}}, {}));
+  c.add(2, ExchangeId::OKX, make_book(false, {{2 * TICK, 1.0}}, {}));
+  c.add(7, ExchangeId::BYBIT, make_book(false, {{3 * TICK, 1.0}}, {}));
+  c.add(4, ExchangeId::OKX, make_book(false, {{4 * TICK, 1.0}}, {}));
+  EXPECT_EQ(3u, c.size());
+  EXPECT_TRUE(c.pending(7));
+  EXPECT_FALSE(c.pending(3));
+  EXPECT_FALSE(c.pending(100));
+
+  // Refuse the second update: it stays at the front
+  std::vector<uint32_t> ids;
+  size_t n = c.drain([&](uint32_t id, ExchangeId exchange_id,
+                         const ParsedOrderBook &) {
+    if (ids.size() == 1)
+      return false;
+    EXPECT_EQ(ExchangeId::BYBIT, exchange_id);
+    ids.push_back(id);
+    return true;
+  });
+  EXPECT_EQ(1u, n);
+  EXPECT_FALSE(c.pending(7));
+  EXPECT_TRUE(c.pending(2));
+
+  for (const auto &[id, book] : drain_all(c))
+    ids.push_back(id);
+  EXPECT_EQ((std::vector<uint32_t>{7, 2, 4}), ids);
+
+  // A drained symbol queues again behind the others
+  c.add(4, ExchangeId::OKX, make_book(false, {{5 * TICK, 1.0}}, {}));
+  c.add(7, ExchangeId::BYBIT, make_book(false, {{6 * TICK, 1.0}}, {}));
+  auto out = drain_all(c);
+  ASSERT_EQ(2u, out.size());
+  EXPECT_EQ(4u, out[0].first);
+  EXPECT_EQ((std::vector<uint64_t>{5 * TICK}), prices(out[0].second.bids));
+  EXPECT_EQ(7u, out[1].first);
+}
+
+// The merged update must take a consumer to the same book as every update
+// it replaces, whatever the consumer held before
+TEST(BookConflator, MergedUpdateMatchesSequentialApply) {
+  std::mt19937_64 rng(42);
+  auto side = [&](bool allow_removals) {
+    return random_side(rng, {90, 20, 6, 50, 10.0, allow_removals ? 3u : 0u});
+  };
+
+  BookConflator c;
+  for (int round = 0; round < 2000; round++) {
+    ReferenceBook start;
+    start.apply(make_book(true, side(false), side(false)));
+    ReferenceBook sequential = start;
+
+    size_t updates = 1 + rng() % 8;
+    for (size_t i = 0; i < updates; i++) {
+      bool snapshot = rng() % 5 == 0;
+      ParsedOrderBook u = make_book(snapshot, side(!snapshot), side(!snapshot),
+                                    round);
+      sequential.apply(u);
+      c.add(3, ExchangeId::OKX, u);
+    }
+
+    auto out = drain_all(c);
+    ASSERT_EQ(1u, out.size());
+    ReferenceBook merged = start;
+    merged.apply(out[0].second);
+    ASSERT_TRUE(merged == sequential) << "round " << round;
+  }
+}
@@ -0,0 +1,179 @@
+/**
+ * @file test_book_mirror.cpp
+ * @brief Shared-memory book mirror: slots read back with the header-only
+ *        reader, channel quote overlays and torn-read protection
+ */
+
+#include "aero/book_mirror.h"
+#include "aero/feed_protocol.h"
+#include "modules/market_data/book_mirror.h"
+#include "modules/market_data/order_book.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+
+// Bids best - i, asks best + 1 + i, every level the same size
+ParsedOrderBook ladder(uint64_t best_bid, size_t levels, double qty) {
+  ParsedOrderBook b;
+  b.instrument = "MIR-BTC-USDT";
+  for (size_t i = 0; i < levels; i++) {
+    b.bids.push_back({(best_bid - i) * SCALE, qty});
+    b.asks.push_back({(best_bid + 1 + i) * SCALE, qty});
+  }
+  b.is_snapshot = true;
+  return b;
+}
+
+class BookMirrorTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path = "/tmp/aero_test_book_mirror_" + std::to_string(getpid());
+  }
+
+  void TearDown() override {
+    aero_book_mirror_close(&reader);
+    mirror.close();
+    unlink(path.c_str());
+  }
+
+  void open(uint32_t depth) {
+    ASSERT_TRUE(mirror.init(path, depth, 16));
+    ASSERT_EQ(0, aero_book_mirror_open(&reader, path.c_str()));
+    buf.assign(reader.hdr->slot_size, 0);
+  }
+
+  void write(const ParsedOrderBook &b, uint64_t ts_ms) {
+    OrderBook &ob = books.apply_book(ExchangeId::OKX, ID, b);
+    mirror.write(ExchangeId::OKX, ID, b.instrument, ob, ts_ms, 42);
+  }
+
+  const aero_book_mirror_book *read() {
+    if (aero_book_mirror_read(&reader, ID, buf.data(), 100) != 0)
+      return nullptr;
+    return reinterpret_cast<const aero_book_mirror_book *>(buf.data());
+  }
+
+  static constexpr uint32_t ID = 3; // Slot index
+  std::string path;
+  BookMirror mirror;
+  OrderBookManager books;
+  aero_book_mirror_reader reader{};
+  std::vector<uint8_t> buf;
+};
+
+} // namespace
+
+TEST_F(BookMirrorTest, SlotKeepsTopLevels) {
+  open(3);
+  write(ladder(100, 5, 1.5), 1700000000123);
+
+  EXPECT_EQ(ID, aero_book_mirror_find(&reader, 0, "MIR-BTC-USDT"));
+  EXPECT_EQ(-1, aero_book_mirror_find(&reader, 1, "MIR-BTC-USDT"));
+  const aero_book_mirror_book *b = read();
+  ASSERT_NE(nullptr, b);
+  EXPECT_EQ(0u, b->seq & 1);
+  EXPECT_EQ(1u, b->update_count);
+  EXPECT_EQ(1700000000123000000u, b->exchange_ts_ns);
+  EXPECT_EQ(42u, b->rx_tsc);
+  ASSERT_EQ(3u, b->bid_count);
+  ASSERT_EQ(3u, b->ask_count);
+  EXPECT_EQ(0u, b->flags);
+  const aero_book_mirror_level *bids = aero_book_mirror_bids(b);
+  const aero_book_mirror_level *asks = aero_book_mirror_asks(b, 3);
+  EXPECT_EQ(100 * SCALE, bids[0].price);
+  EXPECT_EQ(98 * SCALE, bids[2].price);
+  EXPECT_EQ(feed_fixed_qty(1.5), bids[2].qty);
+  EXPECT_EQ(101 * SCALE, asks[0].price);
+
+  write(ladder(100, 1, 2.0), 1700000000124); // Shallower: the rest zeroed
+  b = read();
+  ASSERT_NE(nullptr, b);
+  EXPECT_EQ(2u, b->update_count);
+  EXPECT_EQ(1u, b->bid_count);
+  EXPECT_EQ(0u, aero_book_mirror_bids(b)[1].price);
+  EXPECT_EQ(-1, aero_book_mirror_read(&reader, 16, buf.data(), 1));
+}
+
+// A newer channel quote sits on top until depth catches up with it
+TEST_F(BookMirrorTest, ChannelQuoteOverlaysDepth) {
+  open(4);
+  write(ladder(100, 4, 1.0), 1000);
+  OrderBook &ob = books.apply_book(ExchangeId::OKX, ID, ladder(100, 4, 1.0));
+  mirror.write_bbo(ExchangeId::OKX, ID, "MIR-BTC-USDT", ob,
+                   BestBidOffer{101 * SCALE, 0.5, 102 * SCALE, 0.25}, 2000,
+                   43);
+
+  const aero_book_mirror_book *b = read();
+  ASSERT_NE(nullptr, b);
+  EXPECT_EQ(static_cast<uint32_t>(AERO_BOOK_MIRROR_BBO), b->flags);
+  const aero_book_mirror_level *bids = aero_book_mirror_bids(b);
+  const aero_book_mirror_level *asks = aero_book_mirror_asks(b, 4);
+  EXPECT_EQ(101 * SCALE, bids[0].price);
+  EXPECT_EQ(100 * SCALE, bids[1].price);
+  EXPECT_EQ(102 * SCALE, asks[0].price);
+  EXPECT_EQ(103 * SCALE, asks[1].price); // 101 and 102 were crossed
+
+  write(ladder(100, 4, 1.0), 1500); // Older than the quote
+  b = read();
+  ASSERT_NE(nullptr, b);
+  EXPECT_EQ(101 * SCALE, aero_book_mirror_bids(b)[0].price);
+
+  write(ladder(100, 4, 1.0), 2500);
+  b = read();
+  ASSERT_NE(nullptr, b);
+  EXPECT_EQ(0u, b->flags);
+  EXPECT_EQ(100 * SCALE, aero_book_mirror_bids(b)[0].price);
+}
+
+// Every copy the reader accepts is one whole write
+TEST_F(BookMirrorTest, ReaderNeverSeesTornSlot) {
+  const uint32_t depth = 8;
+  open(depth);
+  write(ladder(1000, depth, 1.0), 1);
+
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    for (uint64_t k = 1; k <= 20000; k++)
+      write(ladder(1000 + k % 50, depth, static_cast<double>(k)), k + 1);
+    done.store(true, std::memory_order_release);
+  });
+
+  uint64_t reads = 0;
+  while (!done.load(std::memory_order_acquire)) {
+    const aero_book_mirror_book *b = read();
+    if (!b)
+      continue;
+    const aero_book_mirror_level *bids = aero_book_mirror_bids(b);
+    const aero_book_mirror_level *asks = aero_book_mirror_asks(b, depth);
+    ASSERT_EQ(depth, b->bid_count);
+    for (uint32_t i = 0; i < depth; i++) {
+      ASSERT_EQ(bids[0].price - i * SCALE, bids[i].price);
+      ASSERT_EQ(bids[0].price + (1 + i) * SCALE, asks[i].price);
+      ASSERT_EQ(bids[0].qty, bids[i].qty);
+      ASSERT_EQ(bids[0].qty, asks[i].qty);
+    }
+    ASSERT_EQ(b->update_count * 1000000ULL, b->exchange_ts_ns);
+    reads++;
+  }
+  writer.join();
+  EXPECT_GT(reads, 0u);
+}
+
+TEST_F(BookMirrorTest, ReplacedFileIsStale) {
+  open(2);
+  EXPECT_FALSE(aero_book_mirror_stale(&reader, path.c_str()));
+  mirror.close();
+  BookMirror restarted;
+  ASSERT_TRUE(restarted.init(path, 2, 16));
+  EXPECT_TRUE(aero_book_mirror_stale(&reader, path.c_str()));
+  restarted.close();
+}
@@ -0,0 +1,146 @@
+/**
+ * @file test_book_snapshot_server.cpp
+ * @brief Snapshot-on-demand service: books and feed positions served over
+ *        TCP, and the configured symbol capacity
+ */
+
+#include "aero/feed_protocol.h"
+#include "modules/common/symbol_registry.h"
+#include "modules/market_data/book_snapshot_server.h"
+#include "modules/market_data/order_book.h"
+#include <arpa/inet.h>
+#include <cstring>
+#include <endian.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+
+int test_port() { return 30000 + getpid() % 20000; }
+
+// One request/response exchange on a fresh connection
+bool request(int port, const std::string &name, SnapshotResponse &resp,
+             std::vector<SnapshotLevel> &levels) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return false;
+  timeval tv{5, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  bool ok = false;
+  for (int attempt = 0; attempt < 50 && !ok; attempt++) {
+    ok = connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0;
+    if (!ok)
+      usleep(10000); // Service thread still starting
+  }
+
+  std::vector<uint8_t> out(sizeof(SnapshotRequest) + name.size());
+  SnapshotRequest req{};
+  req.magic = htonl(SNAPSHOT_MAGIC);
+  req.symbol_id = htonl(SNAPSHOT_BY_NAME);
+  req.exchange_id = static_cast<uint8_t>(ExchangeId::OKX);
+  req.name_len = static_cast<uint8_t>(name.size());
+  std::memcpy(out.data(), &req, sizeof(req));
+  std::memcpy(out.data() + sizeof(req), name.data(), name.size());
+  ok = ok && send(fd, out.data(), out.size(), 0) ==
+                 static_cast<ssize_t>(out.size());
+
+  auto read_all = [fd](void *dst, size_t len) {
+    uint8_t *p = static_cast<uint8_t *>(dst);
+    while (len > 0) {
+      ssize_t n = recv(fd, p, len, 0);
+      if (n <= 0)
+        return false;
+      p += n;
+      len -= static_cast<size_t>(n);
+    }
+    return true;
+  };
+  ok = ok && read_all(&resp, sizeof(resp));
+  if (ok && ntohs(resp.status) == SNAPSHOT_OK) {
+    levels.resize(ntohs(resp.bid_count) + ntohs(resp.ask_count));
+    std::vector<char> echoed(resp.name_len);
+    ok = read_all(levels.data(), levels.size() * sizeof(SnapshotLevel)) &&
+         read_all(echoed.data(), echoed.size());
+  }
+  close(fd);
+  return ok;
+}
+
+ParsedOrderBook snapshot(const std::string &instrument) {
+  ParsedOrderBook b;
+  b.instrument = instrument;
+  b.bids = {{100 * SCALE, 1.0}, {99 * SCALE, 2.0}};
+  b.asks = {{101 * SCALE, 3.0}};
+  b.is_snapshot = true;
+  b.timestamp_ms = 1700000000000;
+  return b;
+}
+
+} // namespace
+
+TEST(BookSnapshotServer, ServesBookWithFeedPosition) {
+  OrderBookManager books;
+  ParsedOrderBook book = snapshot("SNAP-BTC-USDT");
+  uint32_t id =
+      SymbolRegistry::instance().get_or_assign(ExchangeId::OKX, book.instrument);
+
+  BookSnapshotServer server(id + 1);
+  int port = test_port();
+  ASSERT_TRUE(server.start("127.0.0.1", port));
+
+  uint32_t slot = server.begin_update(ExchangeId::OKX, id, book.instrument);
+  ASSERT_EQ(id, slot);
+  OrderBook &ob = books.apply_book(ExchangeId::OKX, id, book);
+  server.end_update(slot, ob, 3, 77, book.timestamp_ms);
+
+  SnapshotResponse resp;
+  std::vector<SnapshotLevel> levels;
+  ASSERT_TRUE(request(port, book.instrument, resp, levels));
+  ASSERT_EQ(SNAPSHOT_OK, ntohs(resp.status));
+  EXPECT_EQ(id, ntohl(resp.symbol_id));
+  EXPECT_EQ(3, ntohs(resp.channel_id));
+  EXPECT_EQ(77u, be64toh(resp.seq_num));
+  ASSERT_EQ(2, ntohs(resp.bid_count));
+  ASSERT_EQ(1, ntohs(resp.ask_count));
+  EXPECT_EQ(100 * SCALE, be64toh(levels[0].price_int));
+  EXPECT_EQ(99 * SCALE, be64toh(levels[1].price_int));
+  EXPECT_EQ(3 * FEED_QTY_SCALE, be64toh(levels[2].quantity));
+  EXPECT_EQ(1u, server.served());
+
+  SnapshotResponse unknown;
+  ASSERT_TRUE(request(port, "SNAP-NEVER-SEEN", unknown, levels));
+  EXPECT_EQ(SNAPSHOT_UNKNOWN_SYMBOL, ntohs(unknown.status));
+  server.stop();
+}
+
+// Ids past the configured capacity are not bracketed and never served
+TEST(BookSnapshotServer, SymbolsBeyondCapacityNotServed) {
+  uint32_t inside = SymbolRegistry::instance().get_or_assign(
+      ExchangeId::OKX, "SNAP-CAP-INSIDE");
+  uint32_t outside = SymbolRegistry::instance().get_or_assign(
+      ExchangeId::OKX, "SNAP-CAP-OUTSIDE");
+  ASSERT_LT(inside, outside);
+
+  BookSnapshotServer server(outside);
+  EXPECT_EQ(inside,
+            server.begin_update(ExchangeId::OKX, inside, "SNAP-CAP-INSIDE"));
+  OrderBookManager books;
+  server.end_update(inside,
+                    books.apply_book(ExchangeId::OKX, inside,
+                                     snapshot("SNAP-CAP-INSIDE")),
+                    0, 0, 0);
+  EXPECT_EQ(SymbolRegistry::INVALID_ID,
+            server.begin_update(ExchangeId::OKX, outside, "SNAP-CAP-OUTSIDE"));
+}
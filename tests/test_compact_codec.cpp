@@ -0,0 +1,567 @@
+/**
+ * @file test_compact_codec.cpp
+ * @brief Compact (v3) feed format: varints, encoder/decoder round trips,
+ *        chunk reassembly and receiver sequencing
+ */
+
+#include "aero/feed_chunk.h"
+#include "aero/feed_fec.h"
+#include "aero/feed_receiver.h"
+#include "modules/common/symbol_registry.h"
+#include "modules/network/compact_encoder.h"
+#include "reference_book.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace aero;
+using namespace aero::test;
+
+namespace {
+
+// The feed sinks resolve the id before publishing
+uint32_t okx_id(const std::string &instrument) {
+  return SymbolRegistry::instance().get_or_assign(ExchangeId::OKX, instrument);
+}
+
+template <typename Side>
+void expect_side(const Side &expected, std::span<const FeedBook::Level> got) {
+  ASSERT_EQ(expected.size(), got.size());
+  size_t i = 0;
+  for (const auto &[price, qty] : expected) {
+    EXPECT_EQ(price, got[i].price_int) << "level " << i;
+    EXPECT_DOUBLE_EQ(qty, got[i].qty) << "level " << i;
+    i++;
+  }
+}
+
+// Encodes updates and feeds every datagram to a receiver, stamping seqs
+class CompactRoundTrip {
+public:
+  explicit CompactRoundTrip(size_t max_datagram = 1472)
+      : encoder_(0, max_datagram) {}
+
+  size_t send(const ParsedOrderBook &book) {
+    size_t n = encoder_.encode(book, ExchangeId::OKX, okx_id(book.instrument),
+                               0, 0, 0);
+    for (size_t i = 0; i < n; i++) {
+      std::span<uint8_t> msg = encoder_.message(i);
+      CompactBookEncoder::set_seq(msg, next_seq_++);
+      datagrams_.emplace_back(msg.begin(), msg.end());
+      rx_.on_datagram(msg.data(), msg.size(), 0,
+                      [](const FeedBook &, const FeedDatagram &) {});
+    }
+    return n;
+  }
+
+  const FeedBook *book(const std::string &instrument) const {
+    uint32_t id =
+        SymbolRegistry::instance().get_or_assign(ExchangeId::OKX, instrument);
+    return rx_.book((uint64_t(ExchangeId::OKX) << 32) | id);
+  }
+
+  CompactBookEncoder &encoder() { return encoder_; }
+  FeedReceiver &receiver() { return rx_; }
+  const std::vector<std::vector<uint8_t>> &datagrams() const {
+    return datagrams_;
+  }
+
+private:
+  CompactBookEncoder encoder_;
+  FeedReceiver rx_;
+  uint64_t next_seq_ = 1;
+  std::vector<std::vector<uint8_t>> datagrams_;
+};
+
+ParsedOrderBook snapshot(const std::string &instrument, size_t levels,
+                         uint64_t mid_ticks) {
+  ParsedOrderBook book;
+  book.instrument = instrument;
+  book.is_snapshot = true;
+  for (size_t i = 0; i < levels; i++) {
+    book.bids.push_back({(mid_ticks - 1 - i) * TICK, 0.001 * double(i + 1)});
+    book.asks.push_back({(mid_ticks + 1 + i) * TICK, 0.5 + double(i)});
+  }
+  return book;
+}
+
+} // namespace
+
+TEST(FeedVarint, EdgeValuesRoundTrip) {
+  const std::pair<uint64_t, size_t> cases[] = {
+      {0, 1},
+      {1, 1},
+      {127, 1},
+      {128, 2},
+      {16383, 2},
+      {16384, 3},
+      {(1ULL << 56) - 1, 8},
+      {1ULL << 56, 9},
+      {(1ULL << 63) - 1, 9},
+      {1ULL << 63, 10},
+      {UINT64_MAX, 10},
+  };
+  for (const auto &[value, size] : cases) {
+    uint8_t buf[16];
+    ASSERT_EQ(size, feed_put_varint(buf, value)) << value;
+    uint64_t back;
+    EXPECT_EQ(size, feed_get_varint(buf, size, back)) << value;
+    EXPECT_EQ(value, back);
+    // One byte short: truncated, not a different value
+    EXPECT_EQ(0u, feed_get_varint(buf, size - 1, back)) << value;
+  }
+}
+
+TEST(FeedVarint, RejectsOverlongEncoding) {
+  uint8_t buf[11];
+  std::memset(buf, 0x80, sizeof(buf)); // Continuation bit on every byte
+  uint64_t v;
+  EXPECT_EQ(0u, feed_get_varint(buf, sizeof(buf), v));
+}
+
+TEST(FeedVarint, ZigzagEdgeValues) {
+  const int64_t cases[] = {0, 1, -1, 63, -64, INT32_MAX, INT32_MIN,
+                           INT64_MAX, INT64_MIN};
+  for (int64_t v : cases)
+    EXPECT_EQ(v, feed_unzigzag(feed_zigzag(v))) << v;
+  EXPECT_EQ(0u, feed_zigzag(0));
+  EXPECT_EQ(1u, feed_zigzag(-1));
+  EXPECT_EQ(2u, feed_zigzag(1));
+  EXPECT_EQ(UINT64_MAX, feed_zigzag(INT64_MIN));
+}
+
+TEST(CompactCodec, SnapshotRoundTrip) {
+  CompactRoundTrip rt;
+  ParsedOrderBook book = snapshot("CODEC-SNAP", 20, 650000);
+  // Definition + snapshot
+  ASSERT_EQ(2u, rt.send(book));
+
+  ReferenceBook ref;
+  ref.apply(book);
+  const FeedBook *got = rt.book("CODEC-SNAP");
+  ASSERT_NE(nullptr, got);
+  EXPECT_FALSE(got->stale());
+  EXPECT_EQ("CODEC-SNAP", got->symbol());
+  expect_side(ref.bids, got->bids());
+  expect_side(ref.asks, got->asks());
+  EXPECT_EQ(1u, rt.encoder().snapshots());
+}
+
+TEST(CompactCodec, DeltasCarryOnlyChangesAndRoundTrip) {
+  CompactRoundTrip rt;
+  ReferenceBook ref;
+  ParsedOrderBook book = snapshot("CODEC-DELTA", 10, 1000);
+  rt.send(book);
+  ref.apply(book);
+
+  ParsedOrderBook delta;
+  delta.instrument = "CODEC-DELTA";
+  delta.bids = {{999 * TICK, 7.25},  // Changed
+                {995 * TICK, 0.0},   // Removed
+                {900 * TICK, 1.5}};  // Added, far from the rest
+  delta.asks = {{1001 * TICK, 0.5}}; // Unchanged: not re-sent
+  ASSERT_EQ(1u, rt.send(delta));
+  ref.apply(delta);
+
+  FeedDatagram d;
+  const std::vector<uint8_t> &last = rt.datagrams().back();
+  ASSERT_TRUE(feed_decode(last.data(), last.size(), d));
+  EXPECT_EQ(FEED_MSG_DELTA, d.msg_type);
+  EXPECT_EQ(3u, d.bid_count);
+  EXPECT_EQ(0u, d.ask_count);
+
+  const FeedBook *got = rt.book("CODEC-DELTA");
+  ASSERT_NE(nullptr, got);
+  expect_side(ref.bids, got->bids());
+  expect_side(ref.asks, got->asks());
+
+  // Nothing changed at all: nothing is sent
+  EXPECT_EQ(0u, rt.send(delta));
+  EXPECT_EQ(1u, rt.encoder().unchanged());
+}
+
+TEST(CompactCodec, FixedPointQuantities) {
+  CompactRoundTrip rt;
+  ParsedOrderBook book;
+  book.instrument = "CODEC-QTY";
+  book.is_snapshot = true;
+  book.bids = {{100 * TICK, 0.00000001}, // One FEED_QTY_SCALE unit
+               {99 * TICK, 123456.78901234},
+               {98 * TICK, 0.000000004}}; // Rounds to 0: not published
+  book.asks = {{101 * TICK, 9e9}};
+  rt.send(book);
+
+  const FeedBook *got = rt.book("CODEC-QTY");
+  ASSERT_NE(nullptr, got);
+  ASSERT_EQ(2u, got->bids().size());
+  EXPECT_DOUBLE_EQ(0.00000001, got->bids()[0].qty);
+  EXPECT_DOUBLE_EQ(123456.78901234, got->bids()[1].qty);
+  ASSERT_EQ(1u, got->asks().size());
+  EXPECT_DOUBLE_EQ(9e9, got->asks()[0].qty);
+}
+
+TEST(CompactCodec, TickShrinksAndIsReannounced) {
+  CompactRoundTrip rt;
+  ReferenceBook ref;
+  ParsedOrderBook book = snapshot("CODEC-TICK", 5, 500);
+  rt.send(book);
+  ref.apply(book);
+
+  // A price off the learned tick: new definition, then the delta
+  ParsedOrderBook delta;
+  delta.instrument = "CODEC-TICK";
+  delta.bids = {{499 * TICK + 1000, 2.0}};
+  ASSERT_EQ(2u, rt.send(delta));
+  ref.apply(delta);
+
+  const FeedBook *got = rt.book("CODEC-TICK");
+  ASSERT_NE(nullptr, got);
+  expect_side(ref.bids, got->bids());
+  expect_side(ref.asks, got->asks());
+}
+
+TEST(CompactCodec, RandomUpdatesMatchReference) {
+  CompactRoundTrip rt(400); // Small datagrams: bursts are chunked
+  ReferenceBook ref;
+  std::mt19937_64 rng(42);
+
+  ParsedOrderBook book = snapshot("CODEC-RANDOM", 50, 100000);
+  rt.send(book);
+  ref.apply(book);
+
+  for (int i = 0; i < 2000; i++) {
+    ParsedOrderBook u;
+    u.instrument = "CODEC-RANDOM";
+    u.is_snapshot = rng() % 100 == 0;
+    // Sizes on the 1e-8 grid, a quarter of the delta levels removals
+    RandomSide bids{100000 - 80, 80, u.is_snapshot ? 31u : 21u, 100000000,
+                    1e8, u.is_snapshot ? 0u : 4u};
+    RandomSide asks = bids;
+    asks.first_tick = 100000 + 1;
+    u.bids = random_side(rng, bids);
+    u.asks = random_side(rng, asks);
+    rt.send(u);
+    ref.apply(u);
+
+    const FeedBook *got = rt.book("CODEC-RANDOM");
+    ASSERT_NE(nullptr, got);
+    ASSERT_NO_FATAL_FAILURE(expect_side(ref.bids, got->bids())) << "i=" << i;
+    ASSERT_NO_FATAL_FAILURE(expect_side(ref.asks, got->asks())) << "i=" << i;
+  }
+  EXPECT_GT(rt.encoder().chunked(), 0u);
+  EXPECT_EQ(0u, rt.receiver().stats().malformed);
+  EXPECT_EQ(0u, rt.receiver().stats().gaps);
+}
+
+// --- Chunk reassembly ---
+
+namespace {
+
+struct Delivery {
+  size_t parts;
+  bool complete;
+  std::vector<uint16_t> chunk_indexes;
+};
+
+// A snapshot deep enough to be split; returns its chunk datagrams
+std::vector<std::vector<uint8_t>> chunked_book(const std::string &instrument,
+                                               uint64_t first_seq) {
+  CompactBookEncoder enc(0, 300);
+  size_t n = enc.encode(snapshot(instrument, 100, 50000), ExchangeId::OKX,
+                        okx_id(instrument), 0, 0, 0);
+  std::vector<std::vector<uint8_t>> out;
+  for (size_t i = 1; i < n; i++) { // Skip the symbol definition
+    std::span<uint8_t> msg = enc.message(i);
+    CompactBookEncoder::set_seq(msg, first_seq + i - 1);
+    out.emplace_back(msg.begin(), msg.end());
+  }
+  return out;
+}
+
+class ChunkRecorder {
+public:
+  void feed(FeedChunkAssembler &asm_, const std::vector<uint8_t> &d) {
+    asm_.on_datagram(d.data(), d.size(), Sink{this});
+  }
+  void flush(FeedChunkAssembler &asm_) { asm_.flush(Sink{this}); }
+
+  std::vector<Delivery> deliveries;
+
+private:
+  struct Sink {
+    ChunkRecorder *rec;
+    void operator()(std::span<const std::span<const uint8_t>> parts,
+                    bool complete) const {
+      Delivery d{parts.size(), complete, {}};
+      for (const auto &p : parts) {
+        FeedChunkInfo info;
+        EXPECT_TRUE(feed_chunk_info(p.data(), p.size(), info));
+        d.chunk_indexes.push_back(info.chunk_index);
+      }
+      rec->deliveries.push_back(std::move(d));
+    }
+  };
+};
+
+} // namespace
+
+TEST(FeedChunkAssembler, InOrderChunksFormOneBook) {
+  auto chunks = chunked_book("CHUNK-IN-ORDER", 10);
+  ASSERT_GT(chunks.size(), 2u);
+  FeedChunkInfo info;
+  ASSERT_TRUE(feed_chunk_info(chunks[0].data(), chunks[0].size(), info));
+  EXPECT_EQ(chunks.size(), info.chunk_count);
+
+  FeedChunkAssembler asm_;
+  ChunkRecorder rec;
+  for (const auto &c : chunks)
+    rec.feed(asm_, c);
+  ASSERT_EQ(1u, rec.deliveries.size());
+  EXPECT_TRUE(rec.deliveries[0].complete);
+  EXPECT_EQ(chunks.size(), rec.deliveries[0].parts);
+  for (size_t i = 0; i < chunks.size(); i++)
+    EXPECT_EQ(i, rec.deliveries[0].chunk_indexes[i]);
+  EXPECT_EQ(1u, asm_.complete());
+  EXPECT_FALSE(asm_.pending());
+}
+
+TEST(FeedChunkAssembler, MissingChunkDeliversWhatArrived) {
+  auto chunks = chunked_book("CHUNK-MISSING", 10);
+  ASSERT_GT(chunks.size(), 2u);
+  FeedChunkAssembler asm_;
+  ChunkRecorder rec;
+  for (size_t i = 0; i < chunks.size(); i++)
+    if (i != 1)
+      rec.feed(asm_, chunks[i]);
+
+  // Chunk 0 held until the break, then each later chunk on its own
+  ASSERT_EQ(chunks.size() - 1, rec.deliveries.size());
+  EXPECT_FALSE(rec.deliveries[0].complete);
+  EXPECT_EQ(std::vector<uint16_t>{0}, rec.deliveries[0].chunk_indexes);
+  for (size_t k = 1; k < rec.deliveries.size(); k++) {
+    EXPECT_FALSE(rec.deliveries[k].complete);
+    EXPECT_EQ(1u, rec.deliveries[k].parts);
+    EXPECT_EQ(k + 1, rec.deliveries[k].chunk_indexes[0]);
+  }
+  EXPECT_EQ(0u, asm_.complete());
+}
+
+TEST(FeedChunkAssembler, OutOfOrderChunksAreNotReassembled) {
+  auto chunks = chunked_book("CHUNK-REORDER", 10);
+  ASSERT_GT(chunks.size(), 2u);
+  std::swap(chunks[1], chunks[2]);
+  FeedChunkAssembler asm_;
+  ChunkRecorder rec;
+  for (const auto &c : chunks)
+    rec.feed(asm_, c);
+  rec.flush(asm_);
+
+  // Every chunk is still delivered exactly once, none as a complete book
+  size_t parts = 0;
+  for (const Delivery &d : rec.deliveries) {
+    EXPECT_FALSE(d.complete);
+    parts += d.parts;
+  }
+  EXPECT_EQ(chunks.size(), parts);
+  EXPECT_EQ(0u, asm_.complete());
+}
+
+TEST(FeedChunkAssembler, LostLastChunkIsFlushed) {
+  auto chunks = chunked_book("CHUNK-TAIL", 10);
+  FeedChunkAssembler asm_;
+  ChunkRecorder rec;
+  for (size_t i = 0; i + 1 < chunks.size(); i++)
+    rec.feed(asm_, chunks[i]);
+  EXPECT_TRUE(rec.deliveries.empty());
+  EXPECT_TRUE(asm_.pending());
+
+  rec.flush(asm_);
+  ASSERT_EQ(1u, rec.deliveries.size());
+  EXPECT_FALSE(rec.deliveries[0].complete);
+  EXPECT_EQ(chunks.size() - 1, rec.deliveries[0].parts);
+  EXPECT_FALSE(asm_.pending());
+}
+
+TEST(FeedChunkAssembler, RetransmittedChunkStandsAlone) {
+  auto chunks = chunked_book("CHUNK-RETRANS", 10);
+  CompactHeader h;
+  std::memcpy(&h, chunks[0].data(), sizeof(h));
+  h.flags |= FEED_FLAG_RETRANSMIT;
+  std::memcpy(chunks[0].data(), &h, sizeof(h));
+
+  FeedChunkAssembler asm_;
+  ChunkRecorder rec;
+  rec.feed(asm_, chunks[0]);
+  ASSERT_EQ(1u, rec.deliveries.size());
+  EXPECT_FALSE(rec.deliveries[0].complete);
+  EXPECT_FALSE(asm_.pending());
+}
+
+// --- Receiver sequencing ---
+
+namespace {
+
+// A snapshot and `deltas` single-level updates, on seqs from 1
+std::vector<std::vector<uint8_t>> sequenced_updates(const std::string &name,
+                                                    size_t deltas,
+                                                    ReferenceBook &ref) {
+  CompactBookEncoder enc(0, 1472);
+  std::vector<std::vector<uint8_t>> out;
+  uint64_t seq = 1;
+  auto encode = [&](const ParsedOrderBook &book) {
+    ref.apply(book);
+    size_t n =
+        enc.encode(book, ExchangeId::OKX, okx_id(book.instrument), 0, 0, 0);
+    for (size_t i = 0; i < n; i++) {
+      std::span<uint8_t> msg = enc.message(i);
+      CompactBookEncoder::set_seq(msg, seq++);
+      out.emplace_back(msg.begin(), msg.end());
+    }
+  };
+  encode(snapshot(name, 10, 50000));
+  for (size_t i = 0; i < deltas; i++) {
+    ParsedOrderBook u;
+    u.instrument = name;
+    u.bids.push_back({(50000 - 1 - i % 10) * TICK, double(i + 1)});
+    encode(u);
+  }
+  return out;
+}
+
+const FeedBook *okx_book(const FeedReceiver &rx, const std::string &name) {
+  uint32_t id = SymbolRegistry::instance().get_or_assign(ExchangeId::OKX, name);
+  return rx.book((uint64_t(ExchangeId::OKX) << 32) | id);
+}
+
+void feed(FeedReceiver &rx, const std::vector<uint8_t> &d,
+          std::vector<uint64_t> *applied = nullptr) {
+  rx.on_datagram(d.data(), d.size(), 0,
+                 [&](const FeedBook &, const FeedDatagram &dg) {
+                   if (applied)
+                     applied->push_back(dg.seq);
+                 });
+}
+
+} // namespace
+
+TEST(FeedReceiverSequencing, ReorderedDatagramsApplyInSeqOrder) {
+  ReferenceBook ref;
+  auto dgs = sequenced_updates("SEQ-REORDER", 20, ref);
+  FeedReceiver rx;
+  std::vector<uint64_t> applied;
+  feed(rx, dgs[0], &applied);
+  feed(rx, dgs[1], &applied);
+  // Swap each following pair, and hold one datagram back for longer
+  for (size_t i = 3; i < dgs.size(); i += 2) {
+    if (i + 1 < dgs.size())
+      feed(rx, dgs[i + 1], &applied);
+    feed(rx, dgs[i], &applied);
+  }
+  feed(rx, dgs[2], &applied);
+
+  // Every book update (seq 1 is the symbol definition), in order
+  ASSERT_EQ(dgs.size() - 1, applied.size());
+  for (size_t i = 0; i < applied.size(); i++)
+    EXPECT_EQ(i + 2, applied[i]);
+  const FeedReceiverStats &s = rx.stats();
+  EXPECT_EQ(0u, s.gaps);
+  EXPECT_EQ(0u, s.duplicates);
+  EXPECT_GT(s.reordered, 0u);
+
+  const FeedBook *got = okx_book(rx, "SEQ-REORDER");
+  ASSERT_NE(nullptr, got);
+  EXPECT_FALSE(got->stale());
+  expect_side(ref.bids, got->bids());
+  expect_side(ref.asks, got->asks());
+
+  // Replays below the sequence are duplicates
+  feed(rx, dgs[5]);
+  EXPECT_EQ(1u, rx.stats().duplicates);
+}
+
+TEST(FeedReceiverSequencing, GapIsSkippedWhenTheWindowFills) {
+  ReferenceBook ref;
+  auto dgs = sequenced_updates("SEQ-GAP", 10, ref);
+  FeedReceiver rx;
+  rx.set_reorder_window(4, 1000000000);
+  std::vector<uint64_t> applied;
+  for (size_t i = 0; i < dgs.size(); i++)
+    if (i != 4)
+      feed(rx, dgs[i], &applied);
+
+  const FeedReceiverStats &s = rx.stats();
+  EXPECT_EQ(1u, s.gaps);
+  EXPECT_EQ(1u, s.lost);
+  ASSERT_EQ(dgs.size() - 2, applied.size());
+  EXPECT_EQ(4u, applied[2]);
+  EXPECT_EQ(6u, applied[3]);
+  const FeedBook *got = okx_book(rx, "SEQ-GAP");
+  ASSERT_NE(nullptr, got);
+  EXPECT_TRUE(got->stale());
+
+  // Too late: the gap was given up on
+  feed(rx, dgs[4]);
+  EXPECT_EQ(1u, s.duplicates);
+}
+
+TEST(FeedReceiverSequencing, ReorderWindowExpiresByTime) {
+  ReferenceBook ref;
+  auto dgs = sequenced_updates("SEQ-TIME", 4, ref);
+  FeedReceiver rx;
+  rx.set_reorder_window(1000, 1000);
+  auto on_update = [](const FeedBook &, const FeedDatagram &) {};
+  rx.on_datagram(dgs[0].data(), dgs[0].size(), 10000, on_update);
+  rx.on_datagram(dgs[2].data(), dgs[2].size(), 10000, on_update);
+  EXPECT_EQ(0u, rx.stats().gaps);
+  rx.on_datagram(dgs[3].data(), dgs[3].size(), 11000, on_update);
+  EXPECT_EQ(1u, rx.stats().gaps);
+  EXPECT_EQ(3u, rx.stats().datagrams);
+}
+
+TEST(FeedReceiverSequencing, FlushSkipsOpenGaps) {
+  ReferenceBook ref;
+  auto dgs = sequenced_updates("SEQ-FLUSH", 4, ref);
+  FeedReceiver rx;
+  feed(rx, dgs[0]);
+  feed(rx, dgs[1]);
+  feed(rx, dgs[3]);
+  EXPECT_EQ(2u, rx.stats().datagrams);
+  rx.flush([](const FeedBook &, const FeedDatagram &) {});
+  EXPECT_EQ(3u, rx.stats().datagrams);
+  EXPECT_EQ(1u, rx.stats().gaps);
+}
+
+TEST(FeedReceiverSequencing, ParityRebuildsLostDatagrams) {
+  for (uint8_t m : {uint8_t(1), uint8_t(3)}) {
+    ReferenceBook ref;
+    auto dgs = sequenced_updates("SEQ-FEC-" + std::to_string(m), 30, ref);
+    FeedReceiver rx;
+    FeedFecEncoder enc(8, m);
+    std::vector<uint8_t> parity;
+    size_t block = 0;
+    for (size_t i = 0; i < dgs.size(); i++) {
+      enc.add(i + 1, dgs[i].data(), dgs[i].size());
+      // The first block primes the decoder; later ones lose m datagrams
+      if (block == 0 || i % 8 >= m)
+        feed(rx, dgs[i]);
+      if (enc.full() || i + 1 == dgs.size()) {
+        parity.resize(enc.parity_size());
+        for (uint8_t j = 0; j < enc.parity_count(); j++) {
+          enc.write_parity(j, 0, parity.data());
+          feed(rx, parity);
+        }
+        enc.reset();
+        block++;
+      }
+    }
+
+    const FeedReceiverStats &s = rx.stats();
+    EXPECT_EQ(0u, s.gaps) << "m=" << int(m);
+    EXPECT_GT(s.recovered, 0u) << "m=" << int(m);
+    EXPECT_EQ(dgs.size(), s.datagrams) << "m=" << int(m);
+    const FeedBook *got = okx_book(rx, "SEQ-FEC-" + std::to_string(m));
+    ASSERT_NE(nullptr, got);
+    EXPECT_FALSE(got->stale());
+    expect_side(ref.bids, got->bids());
+    expect_side(ref.asks, got->asks());
+  }
+}
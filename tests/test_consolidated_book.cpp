@@ -0,0 +1,143 @@
+/**
+ * @file test_consolidated_book.cpp
+ * @brief Multi-venue book: levels merged across OKX and Bybit with venue
+ *        attribution, snapshot replacement and pro-rata sweeps
+ */
+
+#include "modules/common/symbol_registry.h"
+#include "modules/market_data/consolidated_book.h"
+#include "modules/market_data/order_book.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+constexpr size_t OKX = static_cast<size_t>(ExchangeId::OKX);
+constexpr size_t BYBIT = static_cast<size_t>(ExchangeId::BYBIT);
+
+ParsedOrderBook book(const std::string &instrument,
+                     std::vector<PriceLevel> bids,
+                     std::vector<PriceLevel> asks, bool snapshot = true) {
+  ParsedOrderBook b;
+  b.instrument = instrument;
+  b.bids = std::move(bids);
+  b.asks = std::move(asks);
+  b.is_snapshot = snapshot;
+  return b;
+}
+
+class ConsolidatedBookTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    books.enable_consolidated();
+    cb = books.consolidated();
+    ASSERT_NE(nullptr, cb);
+  }
+
+  void apply(ExchangeId exchange, const ParsedOrderBook &b) {
+    uint32_t id =
+        SymbolRegistry::instance().get_or_assign(exchange, b.instrument);
+    books.apply_book(exchange, id, b);
+  }
+
+  OrderBookManager books;
+  ConsolidatedBook *cb = nullptr;
+};
+
+} // namespace
+
+// OKX ...-SWAP and Bybit ...USDT are the same perpetual
+TEST_F(ConsolidatedBookTest, MergesVenuesWithAttribution) {
+  apply(ExchangeId::OKX, book("CBA-USDT-SWAP", {{100 * SCALE, 1.0}},
+                              {{102 * SCALE, 2.0}}));
+  apply(ExchangeId::BYBIT,
+        book("CBAUSDT", {{100 * SCALE, 3.0}, {99 * SCALE, 1.0}},
+             {{101 * SCALE, 0.5}}));
+
+  uint32_t idx = cb->find("CBA-USDT-PERP");
+  ASSERT_NE(InstrumentMap::NONE, idx);
+  ConsolidatedQuote q;
+  ASSERT_TRUE(cb->best(idx, q));
+  EXPECT_EQ(100 * SCALE, q.bid.price);
+  EXPECT_DOUBLE_EQ(4.0, q.bid.qty);
+  EXPECT_DOUBLE_EQ(1.0, q.bid.venue_qty[OKX]);
+  EXPECT_DOUBLE_EQ(3.0, q.bid.venue_qty[BYBIT]);
+  EXPECT_EQ((1u << OKX) | (1u << BYBIT), q.bid.venues);
+  EXPECT_EQ(101 * SCALE, q.ask.price);
+  EXPECT_EQ(1u << BYBIT, q.ask.venues);
+
+  std::vector<ConsolidatedLevel> bids, asks;
+  cb->get_depth(idx, 10, bids, asks);
+  ASSERT_EQ(2u, bids.size());
+  ASSERT_EQ(2u, asks.size());
+  EXPECT_EQ(99 * SCALE, bids[1].price);
+  EXPECT_EQ(102 * SCALE, asks[1].price);
+  EXPECT_DOUBLE_EQ(2.0, asks[1].venue_qty[OKX]);
+}
+
+// A snapshot replaces only its own venue's levels; a zero size deletes one
+TEST_F(ConsolidatedBookTest, UpdatesTouchOnlyTheirVenue) {
+  apply(ExchangeId::OKX, book("CBB-USDT-SWAP",
+                              {{100 * SCALE, 1.0}, {99 * SCALE, 1.0}}, {}));
+  apply(ExchangeId::BYBIT, book("CBBUSDT", {{99 * SCALE, 2.0}}, {}));
+  apply(ExchangeId::OKX, book("CBB-USDT-SWAP", {{98 * SCALE, 5.0}}, {}));
+  uint32_t idx = cb->find("CBB-USDT-PERP");
+
+  std::vector<ConsolidatedLevel> bids, asks;
+  cb->get_depth(idx, 10, bids, asks);
+  ASSERT_EQ(2u, bids.size());
+  EXPECT_EQ(99 * SCALE, bids[0].price);
+  EXPECT_EQ(1u << BYBIT, bids[0].venues);
+  EXPECT_DOUBLE_EQ(2.0, bids[0].qty);
+  EXPECT_EQ(98 * SCALE, bids[1].price);
+
+  apply(ExchangeId::BYBIT, book("CBBUSDT", {{99 * SCALE, 0.0}}, {}, false));
+  cb->get_depth(idx, 10, bids, asks);
+  ASSERT_EQ(1u, bids.size());
+  EXPECT_EQ(98 * SCALE, bids[0].price);
+  ConsolidatedQuote q;
+  EXPECT_FALSE(cb->best(idx, q)); // No asks
+}
+
+TEST_F(ConsolidatedBookTest, ContractSizesConvertToBaseUnits) {
+  cb->set_contract_size(ExchangeId::OKX, "CBC-USDT-SWAP", 0.1);
+  apply(ExchangeId::OKX, book("CBC-USDT-SWAP", {{100 * SCALE, 10.0}},
+                              {{101 * SCALE, 20.0}}));
+  apply(ExchangeId::BYBIT,
+        book("CBCUSDT", {{100 * SCALE, 1.0}}, {{101 * SCALE, 1.0}}));
+
+  ConsolidatedQuote q;
+  ASSERT_TRUE(cb->best(cb->find("CBC-USDT-PERP"), q));
+  EXPECT_DOUBLE_EQ(1.0, q.bid.venue_qty[OKX]);
+  EXPECT_DOUBLE_EQ(2.0, q.bid.qty);
+  EXPECT_DOUBLE_EQ(2.0, q.ask.venue_qty[OKX]);
+}
+
+// A price quoted by both venues fills pro rata to their sizes
+TEST_F(ConsolidatedBookTest, SweepSplitsSharedLevelsProRata) {
+  apply(ExchangeId::OKX, book("CBD-USDT-SWAP", {},
+                              {{101 * SCALE, 1.0}, {102 * SCALE, 2.0}}));
+  apply(ExchangeId::BYBIT, book("CBDUSDT", {}, {{101 * SCALE, 3.0}}));
+  uint32_t idx = cb->find("CBD-USDT-PERP");
+
+  SweepResult r;
+  ASSERT_TRUE(cb->sweep(idx, Side::ASK, 2.0, r));
+  EXPECT_DOUBLE_EQ(2.0, r.filled);
+  EXPECT_DOUBLE_EQ(0.5, r.venue_qty[OKX]);
+  EXPECT_DOUBLE_EQ(1.5, r.venue_qty[BYBIT]);
+  EXPECT_EQ(101 * SCALE, r.worst_price);
+  EXPECT_EQ(1u, r.levels);
+
+  ASSERT_TRUE(cb->sweep(idx, Side::ASK, 10.0, r)); // More than is there
+  EXPECT_DOUBLE_EQ(6.0, r.filled);
+  EXPECT_DOUBLE_EQ(3.0, r.venue_qty[OKX]);
+  EXPECT_DOUBLE_EQ(101.0 * 4 + 102.0 * 2, r.cost);
+  EXPECT_EQ(102 * SCALE, r.worst_price);
+  EXPECT_EQ(2u, r.levels);
+
+  EXPECT_FALSE(cb->sweep(idx, Side::BID, 1.0, r));
+}
@@ -0,0 +1,266 @@
+/**
+ * @file test_feed_fec.cpp
+ * @brief Feed FEC codec: byte-exact recovery for the XOR and Cauchy
+ *        Reed-Solomon codes, up to the FEED_FEC_MAX_K / MAX_M bounds
+ */
+
+#include "aero/feed_fec.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+
+using namespace aero;
+
+namespace {
+
+// A full-format data datagram: the header fields FEC reads, random payload
+std::vector<uint8_t> make_datagram(uint64_t seq, size_t len,
+                                   std::mt19937_64 &rng) {
+  std::vector<uint8_t> d(std::max(len, sizeof(UdpMarketHeader)));
+  for (uint8_t &b : d)
+    b = static_cast<uint8_t>(rng());
+  const uint32_t magic = UDP_FEED_MAGIC;
+  for (int i = 0; i < 4; i++)
+    d[i] = static_cast<uint8_t>(magic >> (24 - 8 * i));
+  d[4] = 0;
+  d[5] = UDP_FEED_VERSION;
+  fec_detail::store_be64(d.data() + offsetof(UdpMarketHeader, seq_num), seq);
+  return d;
+}
+
+struct EncodedBlock {
+  std::vector<std::vector<uint8_t>> data;
+  std::vector<std::vector<uint8_t>> parity;
+};
+
+// One block of `count` datagrams from first_seq, of random lengths
+EncodedBlock encode_block(FeedFecEncoder &enc, uint64_t first_seq,
+                          size_t count, std::mt19937_64 &rng,
+                          size_t max_len = 1472) {
+  EncodedBlock b;
+  for (size_t i = 0; i < count; i++) {
+    size_t len = sizeof(UdpMarketHeader) +
+                 rng() % (max_len - sizeof(UdpMarketHeader) + 1);
+    b.data.push_back(make_datagram(first_seq + i, len, rng));
+    EXPECT_TRUE(enc.add(first_seq + i, b.data.back().data(), len));
+  }
+  for (uint8_t j = 0; j < enc.parity_count(); j++) {
+    b.parity.emplace_back(enc.parity_size());
+    enc.write_parity(j, 0, b.parity.back().data());
+  }
+  enc.reset();
+  return b;
+}
+
+// Feeds the block minus the dropped data / parity datagrams; returns what
+// the decoder rebuilt, by seq
+std::map<uint64_t, std::vector<uint8_t>>
+decode(FeedFecDecoder &dec, const EncodedBlock &b,
+       const std::set<size_t> &dropped_data,
+       const std::set<size_t> &dropped_parity = {},
+       bool parity_first = false) {
+  std::map<uint64_t, std::vector<uint8_t>> out;
+  auto on_recovered = [&](const uint8_t *d, size_t len) {
+    uint64_t seq = 0;
+    EXPECT_TRUE(feed_datagram_seq(d, len, seq));
+    EXPECT_TRUE(out.emplace(seq, std::vector<uint8_t>(d, d + len)).second)
+        << "seq " << seq << " rebuilt twice";
+  };
+  auto feed_parity = [&] {
+    for (size_t j = 0; j < b.parity.size(); j++)
+      if (!dropped_parity.count(j))
+        dec.on_datagram(b.parity[j].data(), b.parity[j].size(), on_recovered);
+  };
+  if (parity_first)
+    feed_parity();
+  for (size_t i = 0; i < b.data.size(); i++)
+    if (!dropped_data.count(i))
+      dec.on_datagram(b.data[i].data(), b.data[i].size(), on_recovered);
+  if (!parity_first)
+    feed_parity();
+  return out;
+}
+
+void expect_rebuilt(const EncodedBlock &b, uint64_t first_seq,
+                    const std::set<size_t> &dropped,
+                    const std::map<uint64_t, std::vector<uint8_t>> &got) {
+  ASSERT_EQ(dropped.size(), got.size());
+  for (size_t i : dropped) {
+    auto it = got.find(first_seq + i);
+    ASSERT_NE(got.end(), it) << "index " << i << " not rebuilt";
+    EXPECT_EQ(b.data[i], it->second) << "index " << i;
+  }
+}
+
+std::set<size_t> random_drops(size_t k, size_t n, std::mt19937_64 &rng) {
+  std::vector<size_t> idx(k);
+  std::iota(idx.begin(), idx.end(), 0);
+  std::shuffle(idx.begin(), idx.end(), rng);
+  return std::set<size_t>(idx.begin(), idx.begin() + n);
+}
+
+} // namespace
+
+TEST(FeedFec, XorRebuildsAnySingleLoss) {
+  std::mt19937_64 rng(1);
+  constexpr size_t K = 8;
+  for (size_t lost = 0; lost < K; lost++) {
+    FeedFecEncoder enc(K, 1);
+    uint64_t first = 100 + lost * K;
+    EncodedBlock b = encode_block(enc, first, K, rng);
+    ASSERT_EQ(1u, b.parity.size());
+    EXPECT_EQ(FEED_FEC_XOR, b.parity[0][offsetof(FeedFecHeader, scheme)]);
+
+    FeedFecDecoder dec;
+    auto got = decode(dec, b, {lost});
+    expect_rebuilt(b, first, {lost}, got);
+    EXPECT_EQ(1u, dec.recovered());
+  }
+}
+
+TEST(FeedFec, XorCannotRebuildTwoLosses) {
+  std::mt19937_64 rng(2);
+  FeedFecEncoder enc(8, 1);
+  EncodedBlock b = encode_block(enc, 1, 8, rng);
+  FeedFecDecoder dec;
+  EXPECT_TRUE(decode(dec, b, {2, 5}).empty());
+  EXPECT_EQ(0u, dec.recovered());
+}
+
+TEST(FeedFec, ReedSolomonRebuildsUpToMLosses) {
+  std::mt19937_64 rng(3);
+  constexpr size_t K = 16, M = 4;
+  uint64_t first = 1;
+  for (int round = 0; round < 200; round++, first += K) {
+    FeedFecEncoder enc(K, M);
+    EncodedBlock b = encode_block(enc, first, K, rng);
+    ASSERT_EQ(M, b.parity.size());
+    EXPECT_EQ(FEED_FEC_RS, b.parity[0][offsetof(FeedFecHeader, scheme)]);
+
+    // Lose n data datagrams and any M - n parity datagrams, in either
+    // arrival order
+    size_t n = 1 + rng() % M;
+    std::set<size_t> dropped = random_drops(K, n, rng);
+    std::set<size_t> dropped_parity = random_drops(M, M - n, rng);
+    FeedFecDecoder dec;
+    auto got = decode(dec, b, dropped, dropped_parity, round & 1);
+    ASSERT_NO_FATAL_FAILURE(expect_rebuilt(b, first, dropped, got))
+        << "round " << round;
+  }
+}
+
+TEST(FeedFec, ReedSolomonCannotRebuildMoreThanParity) {
+  std::mt19937_64 rng(4);
+  FeedFecEncoder enc(16, 4);
+  EncodedBlock b = encode_block(enc, 1, 16, rng);
+  FeedFecDecoder dec;
+  EXPECT_TRUE(decode(dec, b, random_drops(16, 5, rng)).empty());
+  // Nor the full loss count when a parity datagram is lost as well
+  FeedFecDecoder dec2;
+  EXPECT_TRUE(decode(dec2, b, random_drops(16, 4, rng), {0}).empty());
+}
+
+TEST(FeedFec, PartialBlockIsRebuilt) {
+  // The publisher's max delay closes a block before k datagrams
+  std::mt19937_64 rng(5);
+  FeedFecEncoder enc(16, 2);
+  EncodedBlock b = encode_block(enc, 50, 5, rng);
+  EXPECT_EQ(5, b.parity[0][offsetof(FeedFecHeader, data_count)]);
+  FeedFecDecoder dec;
+  expect_rebuilt(b, 50, {0, 4}, decode(dec, b, {0, 4}));
+}
+
+TEST(FeedFec, LargestBlockRebuildsMaxLosses) {
+  std::mt19937_64 rng(6);
+  uint64_t first = 1;
+  for (int round = 0; round < 20; round++, first += FEED_FEC_MAX_K) {
+    FeedFecEncoder enc(FEED_FEC_MAX_K, FEED_FEC_MAX_M);
+    EncodedBlock b = encode_block(enc, first, FEED_FEC_MAX_K, rng);
+    ASSERT_EQ(FEED_FEC_MAX_M, b.parity.size());
+    std::set<size_t> dropped = random_drops(FEED_FEC_MAX_K, FEED_FEC_MAX_M,
+                                            rng);
+    if (round == 0) {
+      // The extreme coefficient indexes
+      dropped = {0, FEED_FEC_MAX_K - 1};
+      for (size_t i = 1; dropped.size() < FEED_FEC_MAX_M; i++)
+        dropped.insert(i);
+    }
+    FeedFecDecoder dec;
+    auto got = decode(dec, b, dropped, {}, round & 1);
+    ASSERT_NO_FATAL_FAILURE(expect_rebuilt(b, first, dropped, got))
+        << "round " << round;
+  }
+}
+
+TEST(FeedFec, LargestSymbolIsRebuilt) {
+  std::mt19937_64 rng(7);
+  FeedFecEncoder enc(4, 2);
+  std::vector<uint8_t> big = make_datagram(1, FEED_FEC_MAX_SYMBOL - 2, rng);
+  EXPECT_FALSE(enc.add(1, big.data(), big.size() + 1)); // Unprotected
+  EncodedBlock b;
+  for (uint64_t s = 1; s <= 4; s++) {
+    b.data.push_back(s == 3 ? make_datagram(3, big.size(), rng)
+                            : make_datagram(s, 64, rng));
+    ASSERT_TRUE(enc.add(s, b.data.back().data(), b.data.back().size()));
+  }
+  EXPECT_EQ(sizeof(FeedFecHeader) + FEED_FEC_MAX_SYMBOL, enc.parity_size());
+  for (uint8_t j = 0; j < 2; j++) {
+    b.parity.emplace_back(enc.parity_size());
+    enc.write_parity(j, 0, b.parity.back().data());
+  }
+  FeedFecDecoder dec;
+  expect_rebuilt(b, 1, {1, 2}, decode(dec, b, {1, 2}));
+}
+
+TEST(FeedFec, EncoderClampsToBounds) {
+  FeedFecEncoder big(255, 255);
+  EXPECT_EQ(FEED_FEC_MAX_M, big.parity_count());
+  std::mt19937_64 rng(8);
+  std::vector<uint8_t> d = make_datagram(1, 100, rng);
+  for (size_t i = 0; i < FEED_FEC_MAX_K; i++) {
+    EXPECT_FALSE(big.full());
+    big.add(1 + i, d.data(), d.size());
+  }
+  EXPECT_TRUE(big.full());
+
+  FeedFecEncoder small(0, 0);
+  EXPECT_EQ(1, small.parity_count());
+  small.add(1, d.data(), d.size());
+  EXPECT_TRUE(small.full());
+}
+
+TEST(FeedFec, DecoderIgnoresParityBeyondBounds) {
+  std::mt19937_64 rng(9);
+  FeedFecEncoder enc(8, 2);
+  EncodedBlock b = encode_block(enc, 1, 8, rng);
+  auto corrupt = [&](size_t field, uint8_t value) {
+    EncodedBlock bad = b;
+    for (auto &p : bad.parity)
+      p[field] = value;
+    FeedFecDecoder dec;
+    return decode(dec, bad, {3}).size();
+  };
+  EXPECT_EQ(0u, corrupt(offsetof(FeedFecHeader, data_count),
+                        FEED_FEC_MAX_K + 1));
+  EXPECT_EQ(0u, corrupt(offsetof(FeedFecHeader, parity_count),
+                        FEED_FEC_MAX_M + 1));
+  EXPECT_EQ(0u, corrupt(offsetof(FeedFecHeader, scheme), 0));
+  EXPECT_EQ(1u, corrupt(offsetof(FeedFecHeader, reserved), 0xff));
+}
+
+TEST(FeedFec, LateParityForAFinishedBlockIsIgnored) {
+  std::mt19937_64 rng(10);
+  FeedFecEncoder enc(8, 2);
+  EncodedBlock b = encode_block(enc, 1, 8, rng);
+  FeedFecDecoder dec;
+  expect_rebuilt(b, 1, {6}, decode(dec, b, {6}));
+  // The second parity datagram is a repeat of a solved block
+  size_t calls = 0;
+  dec.on_datagram(b.parity[1].data(), b.parity[1].size(),
+                  [&](const uint8_t *, size_t) { calls++; });
+  EXPECT_EQ(0u, calls);
+  EXPECT_EQ(1u, dec.recovered());
+}
@@ -0,0 +1,107 @@
+/**
+ * @file test_feed_latency_monitor.cpp
+ * @brief Feed latency: log-linear histogram buckets and the NTP-style
+ *        exchange clock-offset estimate
+ */
+
+#include "core/tsc_clock.h"
+#include "modules/telemetry/feed_latency_monitor.h"
+#include <gtest/gtest.h>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t MS = 1000000ULL;
+constexpr int64_t HALF_RTT_NS = 2000000; // Of the 4 ms minimum RTT
+
+// The monitor is a process-wide singleton: each test owns one venue
+class FeedLatencyTest : public ::testing::Test {
+protected:
+  void SetUp() override { t0 = TscClock::now_tsc(); }
+
+  uint64_t at_ms(uint64_t ms) const {
+    return t0 + TscClock::instance().ns_to_tsc(ms * MS);
+  }
+
+  // Apparent delay (local_rx - exchange_ts) of a message stamped ts_ms
+  int64_t delay_ns(uint64_t ts_ms, uint64_t rx_tsc) const {
+    return static_cast<int64_t>(TscClock::instance().tsc_to_wall(rx_tsc)) -
+           static_cast<int64_t>(ts_ms * MS);
+  }
+
+  void rtt(ExchangeId venue, uint64_t sent_ms, uint64_t rtt_ms) {
+    monitor.on_ping_sent(venue, at_ms(sent_ms));
+    monitor.on_pong_received(venue, at_ms(sent_ms + rtt_ms));
+  }
+
+  FeedLatencyMonitor &monitor = FeedLatencyMonitor::instance();
+  uint64_t t0 = 0;
+};
+
+} // namespace
+
+TEST(LatencyDistribution, ExactBelowSixteenMicros) {
+  LatencyDistribution d;
+  for (uint64_t us = 0; us < 16; us++)
+    d.record_us(us);
+  EXPECT_EQ(16u, d.count());
+  EXPECT_EQ(7u, d.percentile_us(0.50));
+  EXPECT_EQ(15u, d.percentile_us(1.0));
+  EXPECT_EQ(15u, d.max_us());
+}
+
+TEST(LatencyDistribution, LogLinearBuckets) {
+  LatencyDistribution d;
+  d.record_us(1000);
+  uint64_t p = d.percentile_us(0.5);
+  EXPECT_LE(p, 1000u);
+  EXPECT_GE(p, 1000u - 1000u / 16); // One sub-bucket
+  d.record_us(uint64_t{1} << 40);   // Past the range: last bucket
+  EXPECT_EQ(2u, d.count());
+  EXPECT_EQ(uint64_t{1} << 40, d.max_us());
+
+  d.reset();
+  EXPECT_EQ(0u, d.count());
+  EXPECT_EQ(0u, d.percentile_us(0.99));
+}
+
+// Without a pong there is nothing to align against: latencies are raw
+TEST_F(FeedLatencyTest, NoOffsetBeforeFirstPong) {
+  monitor.record(ExchangeId::GATE, "LAT-A", 1700000000000, at_ms(0));
+  EXPECT_EQ(0, monitor.clock_offset_ns(ExchangeId::GATE));
+}
+
+TEST_F(FeedLatencyTest, OffsetIsHalfMinRttLessMinDelay) {
+  ExchangeId venue = ExchangeId::BITGET;
+  uint64_t wall_ms = TscClock::instance().tsc_to_wall(at_ms(0)) / MS;
+
+  uint64_t rx = at_ms(0);
+  monitor.record(venue, "LAT-B", wall_ms - 5, rx);
+  int64_t min_delay = delay_ns(wall_ms - 5, rx);
+
+  rtt(venue, 10, 4);
+  EXPECT_NEAR(static_cast<double>(HALF_RTT_NS - min_delay),
+              static_cast<double>(monitor.clock_offset_ns(venue)), 1000.0);
+
+  // A slower pong does not raise the minimum RTT
+  rtt(venue, 20, 9);
+  EXPECT_NEAR(static_cast<double>(HALF_RTT_NS - min_delay),
+              static_cast<double>(monitor.clock_offset_ns(venue)), 1000.0);
+
+  // A faster path lowers the minimum delay
+  rx = at_ms(30);
+  monitor.record(venue, "LAT-B", wall_ms + 28, rx);
+  min_delay = delay_ns(wall_ms + 28, rx);
+  EXPECT_NEAR(static_cast<double>(HALF_RTT_NS - min_delay),
+              static_cast<double>(monitor.clock_offset_ns(venue)), 1000.0);
+}
+
+// A pong with no ping outstanding is not an RTT sample
+TEST_F(FeedLatencyTest, UnmatchedPongIgnored) {
+  ExchangeId venue = ExchangeId::MEXC;
+  uint64_t wall_ms = TscClock::instance().tsc_to_wall(at_ms(0)) / MS;
+  monitor.record(venue, "LAT-C", wall_ms - 3, at_ms(0));
+  monitor.on_pong_received(venue, at_ms(5));
+  EXPECT_EQ(0, monitor.clock_offset_ns(venue));
+}
@@ -0,0 +1,230 @@
+/**
+ * @file test_feed_retransmit.cpp
+ * @brief Feed channels and gap fill: per-channel sequence numbers, the
+ *        datagram ring and the TCP retransmission service
+ */
+
+#include "aero/feed_protocol.h"
+#include "modules/network/feed_retransmit.h"
+#include "modules/network/udp_publisher.h"
+#include <arpa/inet.h>
+#include <cstring>
+#include <endian.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+
+int test_port() { return 30000 + (getpid() + 7) % 20000; }
+
+// Smallest full-format datagram: a header carrying seq
+std::vector<uint8_t> datagram(uint16_t channel, uint64_t seq) {
+  UdpMarketHeader h{};
+  h.magic = htonl(UDP_FEED_MAGIC);
+  h.version = htons(UDP_FEED_VERSION);
+  h.channel_id = htons(channel);
+  h.seq_num = htobe64(seq);
+  std::vector<uint8_t> d(sizeof(h));
+  std::memcpy(d.data(), &h, sizeof(h));
+  return d;
+}
+
+void put(FeedRetransmitStore &store, uint16_t channel, uint64_t seq) {
+  std::vector<uint8_t> d = datagram(channel, seq);
+  store.put(channel, seq, d.data(), d.size());
+}
+
+struct Reply {
+  RetransResponse resp{};
+  std::vector<std::vector<uint8_t>> frames;
+};
+
+// One request/response exchange on a fresh connection
+bool request(int port, uint16_t channel, uint64_t begin, uint32_t count,
+             Reply &reply) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return false;
+  timeval tv{5, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  bool ok = false;
+  for (int attempt = 0; attempt < 50 && !ok; attempt++) {
+    ok = connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0;
+    if (!ok)
+      usleep(10000); // Service thread still starting
+  }
+
+  RetransRequest req{};
+  req.magic = htonl(RETRANS_MAGIC);
+  req.channel_id = htons(channel);
+  req.begin_seq = htobe64(begin);
+  req.count = htonl(count);
+  ok = ok && send(fd, &req, sizeof(req), 0) == sizeof(req);
+
+  auto read_all = [fd](void *dst, size_t len) {
+    uint8_t *p = static_cast<uint8_t *>(dst);
+    while (len > 0) {
+      ssize_t n = recv(fd, p, len, 0);
+      if (n <= 0)
+        return false;
+      p += n;
+      len -= static_cast<size_t>(n);
+    }
+    return true;
+  };
+  ok = ok && read_all(&reply.resp, sizeof(reply.resp));
+  for (uint32_t i = 0; ok && i < ntohl(reply.resp.count); i++) {
+    uint16_t len_be;
+    ok = read_all(&len_be, sizeof(len_be));
+    std::vector<uint8_t> frame(ok ? ntohs(len_be) : 0);
+    ok = ok && read_all(frame.data(), frame.size());
+    reply.frames.push_back(std::move(frame));
+  }
+  close(fd);
+  return ok;
+}
+
+UdpMarketHeader header(const uint8_t *d) {
+  UdpMarketHeader h;
+  std::memcpy(&h, d, sizeof(h));
+  return h;
+}
+
+} // namespace
+
+// --- Datagram ring ---
+
+TEST(FeedRetransmitStore, KeepsTheLastDepthDatagrams) {
+  FeedRetransmitStore store(2, 3); // Rounded up to 4
+  for (uint64_t seq = 1; seq <= 6; seq++)
+    put(store, 1, seq);
+  EXPECT_EQ(7u, store.next_seq(1));
+  EXPECT_EQ(1u, store.next_seq(0));
+
+  uint8_t out[FeedRetransmitStore::SLOT_SIZE];
+  EXPECT_EQ(0u, store.fetch(1, 2, out)); // Evicted
+  for (uint64_t seq = 3; seq <= 6; seq++) {
+    ASSERT_EQ(sizeof(UdpMarketHeader), store.fetch(1, seq, out));
+    EXPECT_EQ(seq, be64toh(header(out).seq_num));
+  }
+  EXPECT_EQ(0u, store.fetch(1, 7, out)); // Not published yet
+  EXPECT_EQ(0u, store.fetch(0, 3, out)); // Other channel
+  EXPECT_EQ(0u, store.fetch(2, 3, out)); // No such channel
+}
+
+TEST(FeedRetransmitStore, OversizedDatagramIsNotKept) {
+  FeedRetransmitStore store(1, 4);
+  std::vector<uint8_t> big(FeedRetransmitStore::SLOT_SIZE + 1, 0xAB);
+  store.put(0, 1, big.data(), big.size());
+  put(store, 0, 2);
+  uint8_t out[FeedRetransmitStore::SLOT_SIZE];
+  EXPECT_EQ(0u, store.fetch(0, 1, out));
+  EXPECT_EQ(sizeof(UdpMarketHeader), store.fetch(0, 2, out));
+}
+
+// --- Gap-fill service ---
+
+TEST(FeedRetransmitServer, ServesHeldRangeMarkedAsRetransmit) {
+  FeedRetransmitStore store(2, 4);
+  for (uint64_t seq = 1; seq <= 8; seq++)
+    put(store, 1, seq);
+  FeedRetransmitServer server(store);
+  int port = test_port();
+  ASSERT_TRUE(server.start("127.0.0.1", port));
+
+  Reply full;
+  ASSERT_TRUE(request(port, 1, 6, 3, full));
+  EXPECT_EQ(RETRANS_OK, ntohs(full.resp.status));
+  EXPECT_EQ(6u, be64toh(full.resp.first_seq));
+  EXPECT_EQ(9u, be64toh(full.resp.next_seq));
+  ASSERT_EQ(3u, full.frames.size());
+  for (uint64_t i = 0; i < 3; i++) {
+    UdpMarketHeader h = header(full.frames[i].data());
+    EXPECT_EQ(6 + i, be64toh(h.seq_num));
+    EXPECT_EQ(FEED_FLAG_RETRANSMIT, ntohs(h.flags));
+  }
+
+  // 3 and 4 were evicted: the reply starts at the oldest one still held
+  Reply partial;
+  ASSERT_TRUE(request(port, 1, 3, 4, partial));
+  EXPECT_EQ(RETRANS_PARTIAL, ntohs(partial.resp.status));
+  EXPECT_EQ(5u, be64toh(partial.resp.first_seq));
+  EXPECT_EQ(2u, partial.frames.size());
+
+  Reply unknown;
+  ASSERT_TRUE(request(port, 5, 1, 1, unknown));
+  EXPECT_EQ(RETRANS_UNKNOWN_CHANNEL, ntohs(unknown.resp.status));
+  EXPECT_TRUE(unknown.frames.empty());
+
+  Reply bad;
+  ASSERT_TRUE(request(port, 1, 0, 1, bad)); // Sequence numbers start at 1
+  EXPECT_EQ(RETRANS_BAD_REQUEST, ntohs(bad.resp.status));
+  server.stop();
+}
+
+// --- Channels ---
+
+// Each exchange gets its own channel, numbered from 1, and every datagram
+// is kept for gap fill
+TEST(FeedChannels, SequencedPerChannel) {
+  UdpFeedOptions opts;
+  opts.channel_mode = FeedChannelMode::EXCHANGE;
+  opts.channel_count = 3;
+  opts.retrans_depth = 16;
+  opts.flush_us = 10000000;
+  UdpPublisher pub;
+  ASSERT_TRUE(pub.init("127.0.0.1", test_port(), opts));
+  ASSERT_EQ(3, pub.channel_count());
+
+  ParsedOrderBook book;
+  book.instrument = "GAP-BTC-USDT";
+  book.bids = {{100 * SCALE, 1.0}};
+  pub.publish(book, ExchangeId::OKX, 1);
+  EXPECT_EQ(0, pub.last_position().channel);
+  EXPECT_EQ(1u, pub.last_position().seq);
+  pub.publish(book, ExchangeId::BYBIT, 1);
+  EXPECT_EQ(1, pub.last_position().channel);
+  EXPECT_EQ(1u, pub.last_position().seq);
+  pub.publish(book, ExchangeId::OKX, 1);
+  EXPECT_EQ(0, pub.last_position().channel);
+  EXPECT_EQ(2u, pub.last_position().seq);
+
+  const FeedRetransmitStore *store = pub.retransmit_store();
+  ASSERT_NE(nullptr, store);
+  EXPECT_EQ(3u, store->next_seq(0));
+  EXPECT_EQ(2u, store->next_seq(1));
+  EXPECT_EQ(1u, store->next_seq(2));
+  uint8_t out[FeedRetransmitStore::SLOT_SIZE];
+  ASSERT_GT(store->fetch(1, 1, out), sizeof(UdpMarketHeader));
+  EXPECT_EQ(1, ntohs(header(out).channel_id));
+  EXPECT_EQ(static_cast<uint8_t>(ExchangeId::BYBIT), header(out).exchange_id);
+  pub.close();
+}
+
+TEST(FeedChannels, SymbolHashPicksTheChannel) {
+  UdpFeedOptions opts;
+  opts.channel_mode = FeedChannelMode::SYMBOL;
+  opts.channel_count = 4;
+  UdpPublisher pub;
+  ASSERT_TRUE(pub.init("127.0.0.1", test_port(), opts));
+
+  ParsedOrderBook book;
+  for (const char *name : {"GAP-A", "GAP-B", "GAP-C", "GAP-D", "GAP-E"}) {
+    book.instrument = name;
+    pub.publish(book, ExchangeId::OKX, 1);
+    EXPECT_EQ(feed_symbol_channel(name, std::strlen(name), 4),
+              pub.last_position().channel);
+  }
+  pub.close();
+}
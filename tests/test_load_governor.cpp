@@ -0,0 +1,171 @@
+/**
+ * @file test_load_governor.cpp
+ * @brief Overload shedding: enter/exit hysteresis, priority symbols and
+ *        depth trimming of the other symbols while shedding
+ */
+
+#include "core/tsc_clock.h"
+#include "modules/common/symbol_registry.h"
+#include "modules/exchange/feed_sinks.h"
+#include "modules/market_data/book_conflator.h"
+#include "modules/market_data/order_book.h"
+#include "modules/telemetry/load_governor.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+
+// The governor is a process-wide singleton: every test starts calm
+class LoadGovernorTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    cfg.enabled = true;
+    cfg.enter_backlog = 100;
+    cfg.exit_backlog = 10;
+    cfg.enter_loop_us = 1000;
+    cfg.exit_loop_us = 200;
+    cfg.exit_hold_ms = 1000;
+    cfg.top_levels = 5;
+    gov.configure(cfg);
+    now = TscClock::now_tsc();
+    calm_down();
+  }
+
+  void TearDown() override { calm_down(); }
+
+  uint64_t ms(uint64_t n) const {
+    return TscClock::instance().ns_to_tsc(n * 1000000ULL);
+  }
+
+  // Quiet cycles until the smoothed cycle time decays and shedding ends
+  void calm_down() {
+    for (int i = 0; i < 200; i++) {
+      now += ms(cfg.exit_hold_ms);
+      gov.on_cycle(0, 0, now);
+    }
+    ASSERT_FALSE(gov.shedding());
+  }
+
+  void cycle(size_t backlog, uint64_t after_ms = 0) {
+    now += ms(after_ms);
+    gov.on_cycle(backlog, 0, now);
+  }
+
+  LoadGovernor &gov = LoadGovernor::instance();
+  LoadGovernor::Config cfg;
+  uint64_t now = 0;
+};
+
+ParsedOrderBook snapshot(const std::string &instrument, size_t levels) {
+  ParsedOrderBook b;
+  b.instrument = instrument;
+  for (size_t i = 0; i < levels; i++) {
+    b.bids.push_back({(1000 - i) * SCALE, 1.0});
+    b.asks.push_back({(1001 + i) * SCALE, 1.0});
+  }
+  b.is_snapshot = true;
+  return b;
+}
+
+} // namespace
+
+TEST_F(LoadGovernorTest, BacklogEntersAndCalmHoldExits) {
+  uint64_t episodes = gov.episodes();
+  cycle(99);
+  EXPECT_FALSE(gov.shedding());
+  cycle(100);
+  EXPECT_TRUE(gov.shedding());
+  EXPECT_EQ(episodes + 1, gov.episodes());
+
+  cycle(50); // Below enter, above exit: still shedding
+  cycle(5);
+  cycle(5, 500);
+  EXPECT_TRUE(gov.shedding());
+  cycle(11, 100); // Restarts the calm period
+  cycle(5, 100);
+  cycle(5, 900);
+  EXPECT_TRUE(gov.shedding());
+  cycle(5, 100);
+  EXPECT_FALSE(gov.shedding());
+  EXPECT_EQ(episodes + 1, gov.episodes());
+}
+
+// One slow cycle is noise; a run of them is overload
+TEST_F(LoadGovernorTest, SustainedSlowCyclesEnter) {
+  uint64_t slow = TscClock::instance().ns_to_tsc(2000000); // 2 ms
+  gov.on_cycle(0, slow, now);
+  EXPECT_FALSE(gov.shedding());
+  for (int i = 0; i < 10; i++)
+    gov.on_cycle(0, slow, now);
+  EXPECT_TRUE(gov.shedding());
+}
+
+TEST_F(LoadGovernorTest, DisabledNeverSheds) {
+  LoadGovernor::Config off = cfg;
+  off.enabled = false;
+  gov.configure(off);
+  cycle(1000000);
+  EXPECT_FALSE(gov.shedding());
+  gov.configure(cfg);
+}
+
+TEST_F(LoadGovernorTest, TrimmedSymbolsAreTakenOnce) {
+  uint32_t id = SymbolRegistry::instance().get_or_assign(ExchangeId::OKX,
+                                                         "GOV-TRIM-USDT");
+  uint64_t before = gov.levels_trimmed();
+  gov.on_trimmed(id, 3);
+  gov.on_trimmed(id, 2);
+  EXPECT_EQ(before + 5, gov.levels_trimmed());
+  EXPECT_TRUE(gov.has_trimmed());
+  EXPECT_TRUE(gov.take_trimmed(ExchangeId::OKX, "GOV-TRIM-USDT"));
+  EXPECT_FALSE(gov.take_trimmed(ExchangeId::OKX, "GOV-TRIM-USDT"));
+  EXPECT_FALSE(gov.take_trimmed(ExchangeId::BYBIT, "GOV-TRIM-USDT"));
+}
+
+// Priority symbols keep full depth; the rest keep the top levels, degraded
+// until a snapshot arrives outside the overload
+TEST_F(LoadGovernorTest, SheddingTrimsOnlyNonPrioritySymbols) {
+  uint32_t keep = SymbolRegistry::instance().get_or_assign(ExchangeId::OKX,
+                                                           "GOV-KEEP-USDT");
+  uint32_t shed = SymbolRegistry::instance().get_or_assign(ExchangeId::OKX,
+                                                           "GOV-SHED-USDT");
+  EXPECT_TRUE(gov.is_priority(shed)); // No priority list: all are
+  gov.add_priority("GOV-KEEP-USDT");
+  EXPECT_TRUE(gov.is_priority(keep));
+  EXPECT_FALSE(gov.is_priority(shed));
+
+  OrderBookManager books;
+  BookConflator conflator;
+  FeedSinks sinks;
+  sinks.books = &books;
+  sinks.conflator = &conflator;
+  cycle(100);
+  ASSERT_TRUE(gov.shedding());
+
+  uint64_t deferred = gov.deferred();
+  ParsedOrderBook k = snapshot("GOV-KEEP-USDT", 20);
+  ParsedOrderBook s = snapshot("GOV-SHED-USDT", 20);
+  route_book(sinks, ExchangeId::OKX, k, false);
+  route_book(sinks, ExchangeId::OKX, s, false);
+  EXPECT_EQ(20u, k.bids.size());
+  EXPECT_EQ(5u, s.bids.size());
+  EXPECT_EQ(5u, s.asks.size());
+  EXPECT_EQ(1000 * SCALE, s.bids[0].price_int); // The best ones
+  EXPECT_EQ(deferred + 1, gov.deferred());
+
+  OrderBook &shed_book = books.get_book(ExchangeId::OKX, "GOV-SHED-USDT");
+  EXPECT_TRUE(shed_book.degraded());
+  EXPECT_FALSE(books.get_book(ExchangeId::OKX, "GOV-KEEP-USDT").degraded());
+  EXPECT_TRUE(gov.take_trimmed(ExchangeId::OKX, "GOV-SHED-USDT"));
+
+  calm_down();
+  ParsedOrderBook resync = snapshot("GOV-SHED-USDT", 20);
+  route_book(sinks, ExchangeId::OKX, resync, false);
+  EXPECT_EQ(20u, resync.bids.size());
+  EXPECT_FALSE(shed_book.degraded());
+}
@@ -0,0 +1,149 @@
+/**
+ * @file test_shm_bus.cpp
+ * @brief Shared-memory bus: publisher events read back with the header-only
+ *        reader, lapped readers, skipped events and the slot size limit
+ */
+
+#include "aero/shm_bus.h"
+#include "modules/common/symbol_registry.h"
+#include "modules/network/shm_bus_publisher.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+
+class ShmBusTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path = "/tmp/aero_test_shm_bus_" + std::to_string(getpid());
+    id = SymbolRegistry::instance().get_or_assign(ExchangeId::OKX,
+                                                  "SHM-BTC-USDT");
+  }
+
+  void TearDown() override {
+    aero_shm_reader_close(&reader);
+    bus.close();
+    unlink(path.c_str());
+  }
+
+  void open(size_t slots, size_t slot_size) {
+    ASSERT_TRUE(bus.init(path, slots, slot_size, 64));
+    ASSERT_EQ(0, aero_shm_reader_open(&reader, path.c_str()));
+    buf.assign(reader.hdr->slot_size, 0);
+  }
+
+  ParsedOrderBook book(size_t bids, size_t asks) const {
+    ParsedOrderBook b;
+    b.instrument = "SHM-BTC-USDT";
+    for (size_t i = 0; i < bids; i++)
+      b.bids.push_back({(100 - i) * SCALE, 1.0 + static_cast<double>(i)});
+    for (size_t i = 0; i < asks; i++)
+      b.asks.push_back({(101 + i) * SCALE, 0.5});
+    b.is_snapshot = true;
+    b.timestamp_ms = 1700000000123;
+    b.rx_tsc = 42;
+    return b;
+  }
+
+  void trade(uint64_t price) {
+    bus.publish_trade(ExchangeId::OKX, id, "SHM-BTC-USDT", price * SCALE, 1.0,
+                      false, 1, 1);
+  }
+
+  int poll() { return aero_shm_reader_poll(&reader, buf.data(), buf.size()); }
+  const aero_shm_event *event() const {
+    return reinterpret_cast<const aero_shm_event *>(buf.data());
+  }
+
+  std::string path;
+  uint32_t id = 0;
+  ShmBusPublisher bus;
+  aero_shm_reader reader{};
+  std::vector<uint8_t> buf;
+};
+
+} // namespace
+
+TEST_F(ShmBusTest, EventsRoundTrip) {
+  open(64, 512);
+  EXPECT_EQ(0, poll());
+
+  bus.publish_book(ExchangeId::OKX, id, book(3, 2));
+  bus.publish_bbo(ExchangeId::OKX, id, "SHM-BTC-USDT",
+                  BboQuote{100 * SCALE, 1.0, 101 * SCALE, 0.5}, 1700000000123,
+                  42);
+  trade(100);
+
+  ASSERT_EQ(static_cast<int>(sizeof(aero_shm_event) + 5 * 16), poll());
+  EXPECT_EQ(AERO_SHM_EV_BOOK, event()->type);
+  EXPECT_EQ(id, event()->symbol_id);
+  EXPECT_EQ(AERO_SHM_FLAG_SNAPSHOT, event()->flags);
+  ASSERT_EQ(3, event()->bid_count);
+  ASSERT_EQ(2, event()->ask_count);
+  EXPECT_EQ(1700000000123000000u, event()->exchange_ts_ns);
+  const aero_shm_level *levels = aero_shm_event_levels(event());
+  EXPECT_EQ(99 * SCALE, levels[1].price);
+  EXPECT_EQ(2 * SCALE, levels[1].qty);
+  EXPECT_EQ(102 * SCALE, levels[4].price);
+
+  ASSERT_GT(poll(), 0);
+  EXPECT_EQ(AERO_SHM_EV_BBO, event()->type);
+  EXPECT_EQ(101 * SCALE, aero_shm_event_bbo(event())->ask_price);
+
+  ASSERT_GT(poll(), 0);
+  EXPECT_EQ(AERO_SHM_EV_TRADE, event()->type);
+  EXPECT_EQ(100 * SCALE, aero_shm_event_trade(event())->price);
+  EXPECT_EQ(0, poll());
+
+  const aero_shm_symbol *sym = aero_shm_reader_symbol(&reader, id);
+  ASSERT_NE(nullptr, sym);
+  EXPECT_STREQ("SHM-BTC-USDT", sym->name);
+}
+
+TEST_F(ShmBusTest, LappedReaderMovesToHead) {
+  open(8, 128);
+  for (uint64_t i = 0; i < 20; i++)
+    trade(100 + i);
+  EXPECT_EQ(-1, poll());
+  EXPECT_EQ(1u, reader.overruns);
+  EXPECT_EQ(0, poll());
+
+  trade(200);
+  ASSERT_GT(poll(), 0);
+  EXPECT_EQ(200 * SCALE, aero_shm_event_trade(event())->price);
+}
+
+TEST_F(ShmBusTest, EventLargerThanBufferIsCounted) {
+  open(64, 1024);
+  bus.publish_book(ExchangeId::OKX, id, book(20, 20));
+  trade(100);
+
+  EXPECT_EQ(0, aero_shm_reader_poll(&reader, buf.data(), 128));
+  EXPECT_EQ(1u, reader.dropped);
+  ASSERT_GT(poll(), 0); // The cursor moved past it
+  EXPECT_EQ(AERO_SHM_EV_TRADE, event()->type);
+}
+
+// Event lengths are 16 bits: larger slots are clamped, not overflowed
+TEST_F(ShmBusTest, SlotSizeClamped) {
+  open(4, 1 << 20);
+  EXPECT_EQ(static_cast<uint32_t>(AERO_SHM_MAX_SLOT_SIZE),
+            reader.hdr->slot_size);
+
+  bus.publish_book(ExchangeId::OKX, id, book(5000, 5000));
+  int len = poll();
+  ASSERT_GT(len, 0);
+  EXPECT_EQ(len, event()->len);
+  EXPECT_EQ(event()->len, sizeof(aero_shm_event) +
+                              (event()->bid_count + event()->ask_count) *
+                                  sizeof(aero_shm_level));
+  EXPECT_TRUE(event()->flags & AERO_SHM_FLAG_TRUNCATED);
+  EXPECT_EQ(1u, bus.truncated());
+  EXPECT_EQ(0u, reader.dropped);
+}
@@ -0,0 +1,80 @@
+/**
+ * @file test_spsc_ring.cpp
+ * @brief Strategy event ring: capacity, drops on a full ring and ordered
+ *        hand-off between two threads
+ */
+
+#include "core/spsc_ring.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace aero;
+
+namespace {
+
+struct Event {
+  uint64_t seq;
+  uint64_t check; // ~seq, to spot a torn slot
+};
+
+Event event(uint64_t seq) { return Event{seq, ~seq}; }
+
+} // namespace
+
+TEST(SpscRing, CapacityRoundsUpToPowerOfTwo) {
+  SpscRing<Event> ring;
+  EXPECT_FALSE(ring.is_open());
+  EXPECT_EQ(0u, ring.capacity());
+  ASSERT_TRUE(ring.init(5));
+  EXPECT_TRUE(ring.is_open());
+  EXPECT_EQ(8u, ring.capacity());
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRing, FullRingDropsNewest) {
+  SpscRing<Event> ring;
+  ASSERT_TRUE(ring.init(4));
+  for (uint64_t i = 0; i < 6; i++)
+    EXPECT_EQ(i < 4, ring.push(event(i)));
+  EXPECT_EQ(4u, ring.pushed());
+  EXPECT_EQ(2u, ring.dropped());
+
+  std::vector<uint64_t> seen;
+  EXPECT_EQ(4u, ring.drain([&](const Event &e) { seen.push_back(e.seq); }));
+  EXPECT_EQ((std::vector<uint64_t>{0, 1, 2, 3}), seen);
+  EXPECT_TRUE(ring.empty());
+
+  EXPECT_TRUE(ring.push(event(4))); // Room again, across the wrap
+  seen.clear();
+  ring.drain([&](const Event &e) { seen.push_back(e.seq); }, 16);
+  EXPECT_EQ(std::vector<uint64_t>{4}, seen);
+}
+
+// The consumer sees every accepted event once, in order, and whole
+TEST(SpscRing, ConsumerThreadSeesProducerOrder) {
+  SpscRing<Event> ring;
+  ASSERT_TRUE(ring.init(64));
+  const uint64_t total = 200000;
+
+  std::thread producer([&] {
+    for (uint64_t i = 0; i < total;)
+      if (ring.push(event(i)))
+        i++;
+  });
+
+  uint64_t next = 0;
+  bool ordered = true;
+  while (next < total) {
+    ring.drain(
+        [&](const Event &e) {
+          ordered = ordered && e.seq == next && e.check == ~next;
+          next++;
+        },
+        8);
+  }
+  producer.join();
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(total, ring.pushed());
+  EXPECT_TRUE(ring.empty());
+}
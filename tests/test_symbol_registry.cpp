@@ -0,0 +1,40 @@
+/**
+ * @file test_symbol_registry.cpp
+ * @brief Symbol ids: registry assignment and the per-owner id cache in front
+ *        of it
+ */
+
+#include "modules/common/symbol_registry.h"
+#include <gtest/gtest.h>
+
+using namespace aero;
+
+TEST(SymbolRegistry, IdsPerExchangeAndInstrument) {
+  SymbolRegistry &reg = SymbolRegistry::instance();
+  uint32_t okx = reg.get_or_assign(ExchangeId::OKX, "REG-USDT");
+  uint32_t bybit = reg.get_or_assign(ExchangeId::BYBIT, "REG-USDT");
+  EXPECT_NE(okx, bybit);
+  EXPECT_EQ(okx, reg.get_or_assign(ExchangeId::OKX, "REG-USDT"));
+  EXPECT_EQ(okx, reg.find(ExchangeId::OKX, "REG-USDT"));
+  EXPECT_EQ(SymbolRegistry::INVALID_ID,
+            reg.find(ExchangeId::OKX, "REG-NEVER-SEEN"));
+
+  SymbolRegistry::Entry entry;
+  ASSERT_TRUE(reg.lookup(bybit, entry));
+  EXPECT_EQ(ExchangeId::BYBIT, entry.exchange);
+  EXPECT_EQ("REG-USDT", entry.instrument);
+}
+
+TEST(SymbolIdCache, SameIdsAsRegistry) {
+  SymbolRegistry &reg = SymbolRegistry::instance();
+  uint32_t known = reg.get_or_assign(ExchangeId::OKX, "CACHE-KNOWN");
+
+  SymbolIdCache cache;
+  EXPECT_EQ(known, cache.get_or_assign(ExchangeId::OKX, "CACHE-KNOWN"));
+  EXPECT_EQ(known, cache.get_or_assign(ExchangeId::OKX, "CACHE-KNOWN"));
+
+  // New symbols are assigned through to the registry
+  uint32_t fresh = cache.get_or_assign(ExchangeId::BYBIT, "CACHE-NEW");
+  EXPECT_EQ(fresh, reg.find(ExchangeId::BYBIT, "CACHE-NEW"));
+  EXPECT_NE(fresh, cache.get_or_assign(ExchangeId::OKX, "CACHE-NEW"));
+}
@@ -0,0 +1,212 @@
+/**
+ * @file test_tick_history.cpp
+ * @brief Tick history files: writer output decoded back with the public
+ *        reader, and per-day files across midnight
+ */
+
+#include "aero/feed_protocol.h"
+#include "aero/tick_history.h"
+#include "core/tsc_clock.h"
+#include "modules/common/symbol_registry.h"
+#include "modules/market_data/tick_history_writer.h"
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef AERO_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+constexpr uint64_t NS_PER_DAY = 86400ULL * 1000000000ULL;
+
+// Everything one file holds, decoded
+struct HistoryFile {
+  uint32_t day = 0;
+  std::map<uint32_t, std::string> symbols; // Id -> name
+  std::vector<aero_tck_row> bbo;
+  std::vector<aero_tck_row> trades;
+};
+
+bool read_history(const std::string &path, HistoryFile &out) {
+  aero_tck_reader r;
+  if (aero_tck_reader_open(&r, path.c_str()) != 0)
+    return false;
+  out.day = r.hdr->day;
+  bool ok = true;
+  const aero_tck_block *blk;
+  const uint8_t *stored;
+  std::vector<uint8_t> raw;
+  while (ok && (blk = aero_tck_reader_next(&r, &stored)) != nullptr) {
+    raw.assign(stored, stored + blk->stored_size);
+    if (blk->codec == AERO_TCK_CODEC_ZSTD) {
+#ifdef AERO_HAVE_ZSTD
+      raw.resize(blk->raw_size);
+      ok = ZSTD_decompress(raw.data(), raw.size(), stored, blk->stored_size) ==
+           blk->raw_size;
+#else
+      ok = false;
+#endif
+    }
+    if (!ok)
+      break;
+
+    if (blk->table == AERO_TCK_SYMBOLS) {
+      const uint8_t *p = raw.data();
+      aero_tck_symbol sym;
+      for (uint32_t i = 0; i < blk->rows; i++) {
+        ok = aero_tck_next_symbol(&p, raw.data() + raw.size(), &sym) == 0;
+        if (!ok)
+          break;
+        out.symbols[sym.id] = std::string(sym.name, sym.name_len);
+      }
+      continue;
+    }
+    // Data rows may only use ids a SYMBOLS block already defined
+    std::vector<aero_tck_row> rows(blk->rows);
+    ok = aero_tck_decode_rows(blk, raw.data(), raw.size(), rows.data()) == 0;
+    for (const aero_tck_row &row : rows)
+      ok = ok && out.symbols.count(row.symbol_id) == 1;
+    auto &dst = blk->table == AERO_TCK_BBO ? out.bbo : out.trades;
+    dst.insert(dst.end(), rows.begin(), rows.end());
+  }
+  aero_tck_reader_close(&r);
+  return ok;
+}
+
+std::string day_path(const std::string &dir, uint64_t wall_ns) {
+  time_t secs = static_cast<time_t>(wall_ns / 1000000000ULL);
+  struct tm tm_utc;
+  gmtime_r(&secs, &tm_utc);
+  char name[64];
+  snprintf(name, sizeof(name), "/aero_ticks_%04d%02d%02d.atk",
+           tm_utc.tm_year + 1900, tm_utc.tm_mon + 1, tm_utc.tm_mday);
+  return dir + name;
+}
+
+class TickHistoryTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char tmpl[] = "/tmp/aero_tick_history_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(tmpl));
+    dir = tmpl;
+    cfg.dir = dir;
+    cfg.flush_ms = 60000; // Blocks only by size or at stop()
+    cfg.queue_events = 1024;
+    btc = SymbolRegistry::instance().get_or_assign(ExchangeId::OKX,
+                                                   "HIST-BTC-USDT");
+    eth = SymbolRegistry::instance().get_or_assign(ExchangeId::BYBIT,
+                                                   "HISTETHUSDT");
+    wall0 = TscClock::instance().now_wall_ns();
+    tsc0 = TscClock::now_tsc();
+  }
+
+  void TearDown() override {
+    writer.stop();
+    std::filesystem::remove_all(dir);
+  }
+
+  // Receive TSC of a wall time (the writer maps it back)
+  uint64_t tsc_at(uint64_t wall_ns) const {
+    return wall_ns >= wall0
+               ? tsc0 + TscClock::instance().ns_to_tsc(wall_ns - wall0)
+               : tsc0 - TscClock::instance().ns_to_tsc(wall0 - wall_ns);
+  }
+
+  std::string dir;
+  TickHistoryWriter::Config cfg;
+  TickHistoryWriter writer;
+  uint32_t btc = 0;
+  uint32_t eth = 0;
+  uint64_t wall0 = 0;
+  uint64_t tsc0 = 0;
+};
+
+} // namespace
+
+TEST_F(TickHistoryTest, RoundTrip) {
+  cfg.block_rows = 16; // Several blocks per table
+  ASSERT_TRUE(writer.start(cfg));
+
+  std::vector<BestBidOffer> quotes;
+  for (uint64_t i = 0; i < 40; i++) {
+    uint32_t id = i % 3 == 0 ? eth : btc;
+    BestBidOffer bbo{(1000 + i % 7) * SCALE, 1.5 + static_cast<double>(i),
+                     (1001 + i % 5) * SCALE, 0.25 * static_cast<double>(i + 1)};
+    writer.on_bbo(id, bbo, 1700000000000 + i, tsc_at(wall0 + i * 1000));
+    writer.on_trade(id, (999 + i % 4) * SCALE, 0.01 * static_cast<double>(i + 1),
+                    i % 2 == 1, 1700000000000 + i, tsc_at(wall0 + i * 1000));
+  }
+  // Unchanged quotes are not recorded
+  writer.on_bbo(btc, BestBidOffer{1001 * SCALE, 40.5, 1000 * SCALE, 9.75},
+                1700000000999, tsc_at(wall0 + 40000));
+  writer.on_bbo(btc, BestBidOffer{1001 * SCALE, 40.5, 1000 * SCALE, 9.75},
+                1700000001000, tsc_at(wall0 + 41000));
+  writer.stop();
+  EXPECT_EQ(0u, writer.dropped());
+  EXPECT_EQ(0u, writer.lost());
+
+  HistoryFile file;
+  ASSERT_TRUE(read_history(day_path(dir, wall0), file));
+  EXPECT_EQ("HIST-BTC-USDT", file.symbols[btc]);
+  EXPECT_EQ("HISTETHUSDT", file.symbols[eth]);
+  ASSERT_EQ(41u, file.bbo.size());
+  ASSERT_EQ(40u, file.trades.size());
+
+  for (uint64_t i = 0; i < 40; i++) {
+    uint32_t id = i % 3 == 0 ? eth : btc;
+    const aero_tck_row &b = file.bbo[i];
+    EXPECT_EQ(id, b.symbol_id) << "row " << i;
+    EXPECT_EQ(1700000000000 + i, b.exchange_ts_ms);
+    EXPECT_NEAR(static_cast<double>(wall0 + i * 1000),
+                static_cast<double>(b.ts_ns), 1000.0);
+    EXPECT_EQ((1000 + i % 7) * SCALE, b.price[0]);
+    EXPECT_EQ(feed_fixed_qty(1.5 + static_cast<double>(i)), b.qty[0]);
+    EXPECT_EQ((1001 + i % 5) * SCALE, b.price[1]);
+    EXPECT_EQ(feed_fixed_qty(0.25 * static_cast<double>(i + 1)), b.qty[1]);
+
+    const aero_tck_row &t = file.trades[i];
+    EXPECT_EQ(id, t.symbol_id);
+    EXPECT_EQ((999 + i % 4) * SCALE, t.price[0]);
+    EXPECT_EQ(feed_fixed_qty(0.01 * static_cast<double>(i + 1)), t.qty[0]);
+    EXPECT_EQ(i % 2 == 1 ? 1 : 0, t.side);
+  }
+}
+
+// The first row past midnight starts the next file; a row that arrives
+// after it but was received before midnight stays in the new file
+TEST_F(TickHistoryTest, DayOnlyMovesForward) {
+  cfg.block_rows = 1024;
+  ASSERT_TRUE(writer.start(cfg));
+  uint64_t midnight = (wall0 / NS_PER_DAY + 1) * NS_PER_DAY;
+  uint64_t second = 1000000000ULL;
+
+  auto quote = [&](uint64_t bid, uint64_t wall_ns) {
+    writer.on_bbo(btc, BestBidOffer{bid * SCALE, 1.0, (bid + 1) * SCALE, 1.0},
+                  wall_ns / 1000000, tsc_at(wall_ns));
+  };
+  quote(100, midnight - 2 * second);
+  quote(101, midnight + second);
+  quote(102, midnight - second); // Late
+  quote(103, midnight + 2 * second);
+  writer.stop();
+
+  HistoryFile before, after;
+  ASSERT_TRUE(read_history(day_path(dir, midnight - second), before));
+  ASSERT_TRUE(read_history(day_path(dir, midnight), after));
+  ASSERT_EQ(1u, before.bbo.size());
+  EXPECT_EQ(100 * SCALE, before.bbo[0].price[0]);
+
+  ASSERT_EQ(3u, after.bbo.size());
+  EXPECT_EQ(101 * SCALE, after.bbo[0].price[0]);
+  EXPECT_EQ(102 * SCALE, after.bbo[1].price[0]);
+  EXPECT_LT(after.bbo[1].ts_ns, midnight);
+  EXPECT_EQ(103 * SCALE, after.bbo[2].price[0]);
+  EXPECT_EQ("HIST-BTC-USDT", after.symbols[btc]); // Redefined per file
+}
@@ -0,0 +1,177 @@
+/**
+ * @file test_trades.cpp
+ * @brief Public trades: OKX and Bybit trade parsing, and the rolling
+ *        trade-flow windows built from them
+ */
+
+#include "aero/feed_protocol.h"
+#include "modules/exchange/bybit_adapter.h"
+#include "modules/exchange/okx_adapter.h"
+#include "modules/market_data/trade_flow.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+
+bool parse(IExchangeAdapter &adapter, const std::string &msg,
+           ParsedTrades &out) {
+  return adapter.parse_trades_message(msg.data(), msg.size(), out);
+}
+
+TradePrint print(uint64_t price, double qty, bool is_sell, uint64_t ts_ms) {
+  return TradePrint{price * SCALE, qty, ts_ms, is_sell};
+}
+
+// 100 ms and 1 s windows
+void configure(TradeFlowAggregator &flow, uint32_t ring_trades = 4096) {
+  TradeFlowConfig cfg;
+  cfg.window_ms[0] = 100;
+  cfg.window_ms[1] = 1000;
+  cfg.window_count = 2;
+  cfg.ring_trades = ring_trades;
+  flow.configure(cfg);
+}
+
+} // namespace
+
+// --- Parsing ---
+
+TEST(TradeParsing, OkxTrades) {
+  OkxAdapter okx;
+  ParsedTrades trades;
+  ASSERT_TRUE(parse(okx,
+                    R"({"arg":{"channel":"trades","instId":"BTC-USDT"},)"
+                    R"("data":[{"instId":"BTC-USDT","tradeId":"1",)"
+                    R"("px":"65000.5","sz":"0.25","side":"sell",)"
+                    R"("ts":"1700000000001","count":"1"},)"
+                    R"({"instId":"BTC-USDT","tradeId":"2","px":"65001",)"
+                    R"("sz":"1","side":"buy","ts":"1700000000002"}]})",
+                    trades));
+  EXPECT_EQ("BTC-USDT", trades.instrument);
+  ASSERT_EQ(2u, trades.trades.size());
+  EXPECT_EQ(6500050000000u, trades.trades[0].price_int);
+  EXPECT_DOUBLE_EQ(0.25, trades.trades[0].qty);
+  EXPECT_TRUE(trades.trades[0].is_sell);
+  EXPECT_EQ(1700000000001u, trades.trades[0].timestamp_ms);
+  EXPECT_FALSE(trades.trades[1].is_sell);
+}
+
+// Only served on /ws/v5/business; the gateway reads /ws/v5/public
+TEST(TradeParsing, OkxIgnoresTradesAll) {
+  OkxAdapter okx;
+  ParsedTrades trades;
+  EXPECT_FALSE(parse(okx,
+                     R"({"arg":{"channel":"trades-all","instId":"BTC-USDT"},)"
+                     R"("data":[{"px":"1","sz":"1","side":"buy","ts":"1"}]})",
+                     trades));
+  EXPECT_FALSE(parse(okx,
+                     R"({"arg":{"channel":"books","instId":"BTC-USDT"},)"
+                     R"("data":[]})",
+                     trades));
+}
+
+TEST(TradeParsing, BybitPublicTrade) {
+  BybitAdapter bybit;
+  ParsedTrades trades;
+  ASSERT_TRUE(parse(bybit,
+                    R"({"topic":"publicTrade.BTCUSDT","type":"snapshot",)"
+                    R"("ts":1700000000010,"data":[{"T":1700000000009,)"
+                    R"("s":"BTCUSDT","S":"Buy","v":"0.5","p":"64999.9",)"
+                    R"("L":"PlusTick","i":"abc","BT":false}]})",
+                    trades));
+  EXPECT_EQ("BTCUSDT", trades.instrument);
+  ASSERT_EQ(1u, trades.trades.size());
+  EXPECT_EQ(6499990000000u, trades.trades[0].price_int);
+  EXPECT_DOUBLE_EQ(0.5, trades.trades[0].qty);
+  EXPECT_FALSE(trades.trades[0].is_sell);
+  EXPECT_EQ(1700000000009u, trades.trades[0].timestamp_ms);
+}
+
+TEST(TradeParsing, MalformedTradeRejected) {
+  OkxAdapter okx;
+  ParsedTrades trades;
+  EXPECT_FALSE(parse(okx,
+                     R"({"arg":{"channel":"trades","instId":"BTC-USDT"},)"
+                     R"("data":[{"px":"abc","sz":"1","side":"buy"}]})",
+                     trades));
+}
+
+// --- Rolling windows ---
+
+TEST(TradeFlow, SumsAndVwap) {
+  TradeFlowAggregator flow;
+  configure(flow);
+  TradeFlow out;
+  flow.add(1, {print(100, 1.0, false, 1000), print(102, 3.0, true, 1010)},
+           out);
+  ASSERT_EQ(2u, out.windows);
+  const TradeFlowWindow &w = out.window[0];
+  EXPECT_EQ(2u, w.trades);
+  EXPECT_DOUBLE_EQ(1.0, w.buy_qty);
+  EXPECT_DOUBLE_EQ(3.0, w.sell_qty);
+  EXPECT_DOUBLE_EQ(101.5 * SCALE, w.vwap);
+  EXPECT_DOUBLE_EQ(-0.5, w.imbalance());
+}
+
+TEST(TradeFlow, WindowsExpireByExchangeTime) {
+  TradeFlowAggregator flow;
+  configure(flow);
+  TradeFlow out;
+  flow.add(1, {print(100, 1.0, false, 1000)}, out);
+  flow.add(1, {print(101, 2.0, false, 1099)}, out);
+  EXPECT_EQ(2u, out.window[0].trades);
+
+  flow.add(1, {print(102, 4.0, true, 1100)}, out);
+  EXPECT_EQ(2u, out.window[0].trades); // 1000 left the 100 ms window
+  EXPECT_DOUBLE_EQ(2.0, out.window[0].buy_qty);
+  EXPECT_EQ(3u, out.window[1].trades);
+
+  flow.add(1, {print(103, 1.0, false, 2100)}, out);
+  EXPECT_EQ(1u, out.window[0].trades);
+  EXPECT_EQ(1u, out.window[1].trades);
+  EXPECT_DOUBLE_EQ(103.0 * SCALE, out.window[1].vwap);
+}
+
+// A trade older than the newest one must not hold later ones in a window
+TEST(TradeFlow, LateTradeClampedToNewest) {
+  TradeFlowAggregator flow;
+  configure(flow);
+  TradeFlow out;
+  flow.add(1, {print(100, 1.0, false, 5000)}, out);
+  flow.add(1, {print(100, 1.0, false, 4000)}, out); // Late
+  EXPECT_EQ(1u, flow.late());
+  EXPECT_EQ(2u, out.window[0].trades); // Counted as of 5000
+
+  flow.add(1, {print(100, 1.0, false, 5100)}, out);
+  EXPECT_EQ(1u, out.window[0].trades);
+  EXPECT_EQ(3u, out.window[1].trades);
+  flow.add(1, {print(100, 1.0, false, 6000)}, out);
+  EXPECT_EQ(2u, out.window[1].trades);
+}
+
+TEST(TradeFlow, SymbolsAreIndependent) {
+  TradeFlowAggregator flow;
+  configure(flow);
+  TradeFlow out;
+  flow.add(1, {print(100, 1.0, false, 1000)}, out);
+  flow.add(2, {print(200, 2.0, true, 9000)}, out);
+  ASSERT_TRUE(flow.read(1, out));
+  EXPECT_EQ(1u, out.window[0].trades);
+  EXPECT_DOUBLE_EQ(100.0 * SCALE, out.window[0].vwap);
+  EXPECT_FALSE(flow.read(3, out));
+}
+
+TEST(TradeFlow, FullRingDropsOldest) {
+  TradeFlowAggregator flow;
+  configure(flow, 4);
+  TradeFlow out;
+  for (uint64_t i = 0; i < 6; i++)
+    flow.add(1, {print(100, 1.0, false, 1000 + i)}, out);
+  EXPECT_EQ(4u, out.window[1].trades);
+  EXPECT_EQ(2u, flow.overflowed());
+}
@@ -0,0 +1,222 @@
+/**
+ * @file test_udp_publisher.cpp
+ * @brief UDP feed publisher: sendmmsg batching and flush deadlines, books
+ *        split to the payload limit, received on a loopback socket, and
+ *        DPDK TX addressing
+ */
+
+#include "aero/feed_protocol.h"
+#include "modules/network/udp_publisher.h"
+#include <arpa/inet.h>
+#include <cstring>
+#include <endian.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace aero;
+
+namespace {
+
+constexpr uint64_t SCALE = 100000000; // PRICE_SCALE
+
+// Loopback socket the publisher sends to
+class UdpPublisherTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)));
+    socklen_t len = sizeof(addr);
+    ASSERT_EQ(0, getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len));
+    port = ntohs(addr.sin_port);
+    timeval tv{2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  }
+
+  void TearDown() override {
+    pub.close();
+    ::close(fd);
+  }
+
+  bool init(UdpFeedOptions opts) {
+    opts.use_gso = false; // One datagram per message, whatever the kernel
+    return pub.init("127.0.0.1", port, opts);
+  }
+
+  static ParsedOrderBook book(const std::string &instrument, size_t levels) {
+    ParsedOrderBook b;
+    b.instrument = instrument;
+    for (size_t i = 0; i < levels; i++) {
+      b.bids.push_back({(100 - i) * SCALE, 1.0});
+      b.asks.push_back({(101 + i) * SCALE, 2.0});
+    }
+    b.is_snapshot = true;
+    return b;
+  }
+
+  // Next datagram, or an empty vector if none is waiting
+  std::vector<uint8_t> receive(bool wait = true) {
+    std::vector<uint8_t> buf(65536);
+    ssize_t n = recv(fd, buf.data(), buf.size(), wait ? 0 : MSG_DONTWAIT);
+    buf.resize(n > 0 ? static_cast<size_t>(n) : 0);
+    return buf;
+  }
+
+  static UdpMarketHeader header(const std::vector<uint8_t> &dgram) {
+    UdpMarketHeader h{};
+    if (dgram.size() >= sizeof(h))
+      std::memcpy(&h, dgram.data(), sizeof(h));
+    return h;
+  }
+
+  int fd = -1;
+  int port = 0;
+  UdpPublisher pub;
+};
+
+} // namespace
+
+TEST_F(UdpPublisherTest, SendsEveryPublishWithoutFlushDelay) {
+  ASSERT_TRUE(init({}));
+  pub.publish(book("UDP-BTC-USDT", 2), ExchangeId::OKX, 1);
+  EXPECT_EQ(1u, pub.syscalls());
+  EXPECT_EQ(1u, pub.datagrams_sent());
+  EXPECT_FALSE(pub.is_dpdk());
+
+  std::vector<uint8_t> d = receive();
+  ASSERT_EQ(sizeof(UdpMarketHeader) + 12 + 4 * sizeof(UdpPriceLevel),
+            d.size());
+  UdpMarketHeader h = header(d);
+  EXPECT_EQ(UDP_FEED_MAGIC, ntohl(h.magic));
+  EXPECT_EQ(FEED_MSG_SNAPSHOT, h.msg_type);
+  EXPECT_EQ(2, ntohs(h.bid_count));
+  EXPECT_EQ(1u, be64toh(h.seq_num));
+  EXPECT_EQ("UDP-BTC-USDT",
+            std::string(reinterpret_cast<const char *>(d.data()) + sizeof(h),
+                        ntohl(h.symbol_len)));
+}
+
+TEST_F(UdpPublisherTest, BatchWaitsForFlush) {
+  UdpFeedOptions opts;
+  opts.flush_us = 10000000; // Never reached in the test
+  ASSERT_TRUE(init(opts));
+  for (int i = 0; i < 3; i++)
+    pub.publish(book("UDP-ETH-USDT", 1), ExchangeId::OKX, 2);
+  EXPECT_EQ(0u, pub.syscalls());
+  EXPECT_TRUE(receive(false).empty());
+
+  pub.flush();
+  EXPECT_EQ(1u, pub.syscalls()); // One sendmmsg for the batch
+  EXPECT_EQ(3u, pub.datagrams_sent());
+  for (uint64_t seq = 1; seq <= 3; seq++)
+    EXPECT_EQ(seq, be64toh(header(receive()).seq_num));
+}
+
+TEST_F(UdpPublisherTest, FullBatchSendsItself) {
+  UdpFeedOptions opts;
+  opts.flush_us = 10000000;
+  ASSERT_TRUE(init(opts));
+  for (size_t i = 0; i < UdpPublisher::MAX_BATCH; i++)
+    pub.publish(book("UDP-SOL-USDT", 1), ExchangeId::OKX, 3);
+  EXPECT_EQ(1u, pub.syscalls());
+  EXPECT_EQ(UdpPublisher::MAX_BATCH, pub.datagrams_sent());
+
+  pub.publish(book("UDP-SOL-USDT", 1), ExchangeId::OKX, 3);
+  EXPECT_EQ(1u, pub.syscalls()); // Starts the next batch
+}
+
+TEST_F(UdpPublisherTest, PublishBatchIsOneSyscall) {
+  UdpFeedOptions opts;
+  opts.flush_us = 10000000;
+  ASSERT_TRUE(init(opts));
+  std::vector<ParsedOrderBook> books = {book("UDP-A", 1), book("UDP-B", 3),
+                                        book("UDP-C", 2)};
+  std::vector<uint32_t> ids = {4, 5, 6};
+  pub.publish_batch(books, ExchangeId::BYBIT, ids);
+  EXPECT_EQ(1u, pub.syscalls());
+  EXPECT_EQ(3u, pub.datagrams_sent());
+  for (int bids : {1, 3, 2})
+    EXPECT_EQ(bids, ntohs(header(receive()).bid_count));
+}
+
+// Best levels of both sides first, every chunk within max_payload
+TEST_F(UdpPublisherTest, LargeBookSplitIntoChunks) {
+  UdpFeedOptions opts;
+  opts.max_payload = 256;
+  ASSERT_TRUE(init(opts));
+  pub.publish(book("UDP-DEEP-USDT", 20), ExchangeId::OKX, 8);
+  EXPECT_EQ(1u, pub.books_chunked());
+
+  size_t per_chunk = (256 - sizeof(UdpMarketHeader) - 13) /
+                     sizeof(UdpPriceLevel); // 7 levels
+  size_t chunks = (40 + per_chunk - 1) / per_chunk;
+  ASSERT_EQ(chunks, pub.datagrams_sent());
+  EXPECT_EQ(chunks, pub.last_position().seq);
+
+  size_t bids = 0, asks = 0;
+  for (size_t i = 0; i < chunks; i++) {
+    std::vector<uint8_t> d = receive();
+    ASSERT_LE(d.size(), 256u);
+    UdpMarketHeader h = header(d);
+    EXPECT_EQ(FEED_FLAG_CHUNKED, ntohs(h.flags));
+    EXPECT_EQ(i, ntohs(h.chunk_index));
+    EXPECT_EQ(chunks, ntohs(h.chunk_count));
+    EXPECT_EQ(i == 0 ? FEED_MSG_SNAPSHOT : FEED_MSG_DELTA, h.msg_type);
+
+    // Levels continue where the previous chunk stopped
+    UdpPriceLevel first;
+    std::memcpy(&first, d.data() + sizeof(h) + ntohl(h.symbol_len),
+                sizeof(first));
+    if (ntohs(h.bid_count) > 0) {
+      EXPECT_EQ((100 - bids) * SCALE, be64toh(first.price_int));
+    }
+    bids += ntohs(h.bid_count);
+    asks += ntohs(h.ask_count);
+  }
+  EXPECT_EQ(20u, bids);
+  EXPECT_EQ(20u, asks);
+}
+
+TEST_F(UdpPublisherTest, SmallBookIsNotChunked) {
+  UdpFeedOptions opts;
+  opts.max_payload = 256;
+  ASSERT_TRUE(init(opts));
+  pub.publish(book("UDP-THIN-USDT", 3), ExchangeId::OKX, 9);
+  EXPECT_EQ(0u, pub.books_chunked());
+  UdpMarketHeader h = header(receive());
+  EXPECT_EQ(0, ntohs(h.flags));
+  EXPECT_EQ(0, ntohs(h.chunk_count));
+}
+
+TEST_F(UdpPublisherTest, RejectsBadAddress) {
+  UdpPublisher bad;
+  EXPECT_FALSE(bad.init("not-an-ip", port));
+  EXPECT_FALSE(bad.is_initialized());
+  bad.publish(book("UDP-X", 1), ExchangeId::OKX, 7); // Ignored
+  EXPECT_EQ(0u, bad.datagrams_sent());
+}
+
+// --- DPDK TX ---
+
+TEST(DpdkUdpTx, FramesCarryEthernetIpv4UdpHeaders) {
+  EXPECT_EQ(14u + 20u + 8u, DpdkUdpTx::HDR_LEN);
+}
+
+// RFC 1112: 01:00:5e + the low 23 bits of the group
+TEST(DpdkUdpTx, MulticastGroupMac) {
+  rte_ether_addr mac{};
+  ASSERT_TRUE(DpdkUdpTx::resolve_dst_mac(0xEF010203, mac)); // 239.1.2.3
+  const uint8_t want[6] = {0x01, 0x00, 0x5e, 0x01, 0x02, 0x03};
+  EXPECT_EQ(0, std::memcmp(want, mac.addr_bytes, 6));
+
+  rte_ether_addr high{};
+  ASSERT_TRUE(DpdkUdpTx::resolve_dst_mac(0xEF810203, high)); // 239.129.2.3
+  EXPECT_EQ(0, std::memcmp(want, high.addr_bytes, 6));
+}